@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/yama-dispatch.dir/dispatch.cpp.o"
+  "CMakeFiles/yama-dispatch.dir/dispatch.cpp.o.d"
+  "CMakeFiles/yama-dispatch.dir/dispatch_avx2.cpp.o"
+  "CMakeFiles/yama-dispatch.dir/dispatch_avx2.cpp.o.d"
+  "CMakeFiles/yama-dispatch.dir/dispatch_avx512.cpp.o"
+  "CMakeFiles/yama-dispatch.dir/dispatch_avx512.cpp.o.d"
+  "CMakeFiles/yama-dispatch.dir/dispatch_scalar.cpp.o"
+  "CMakeFiles/yama-dispatch.dir/dispatch_scalar.cpp.o.d"
+  "CMakeFiles/yama-dispatch.dir/dispatch_sse2.cpp.o"
+  "CMakeFiles/yama-dispatch.dir/dispatch_sse2.cpp.o.d"
+  "libyama-dispatch.a"
+  "libyama-dispatch.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yama-dispatch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
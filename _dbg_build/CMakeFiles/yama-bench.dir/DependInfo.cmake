@@ -0,0 +1,42 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/bench/aabb.cpp" "CMakeFiles/yama-bench.dir/aabb.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/aabb.cpp.o.d"
+  "/root/repo/test/bench/aligned.cpp" "CMakeFiles/yama-bench.dir/aligned.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/aligned.cpp.o.d"
+  "/root/repo/test/bench/batch.cpp" "CMakeFiles/yama-bench.dir/batch.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/batch.cpp.o.d"
+  "/root/repo/test/bench/bvh.cpp" "CMakeFiles/yama-bench.dir/bvh.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/bvh.cpp.o.d"
+  "/root/repo/test/bench/dispatch.cpp" "CMakeFiles/yama-bench.dir/dispatch.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/dispatch.cpp.o.d"
+  "/root/repo/test/bench/expr.cpp" "CMakeFiles/yama-bench.dir/expr.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/expr.cpp.o.d"
+  "/root/repo/test/bench/frustum.cpp" "CMakeFiles/yama-bench.dir/frustum.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/frustum.cpp.o.d"
+  "/root/repo/test/bench/hierarchy.cpp" "CMakeFiles/yama-bench.dir/hierarchy.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/hierarchy.cpp.o.d"
+  "/root/repo/test/bench/macro.cpp" "CMakeFiles/yama-bench.dir/macro.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/macro.cpp.o.d"
+  "/root/repo/test/bench/main.cpp" "CMakeFiles/yama-bench.dir/main.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/main.cpp.o.d"
+  "/root/repo/test/bench/matrix2x3.cpp" "CMakeFiles/yama-bench.dir/matrix2x3.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/matrix2x3.cpp.o.d"
+  "/root/repo/test/bench/matrix3x4.cpp" "CMakeFiles/yama-bench.dir/matrix3x4.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/matrix3x4.cpp.o.d"
+  "/root/repo/test/bench/matrix4x4.cpp" "CMakeFiles/yama-bench.dir/matrix4x4.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/matrix4x4.cpp.o.d"
+  "/root/repo/test/bench/parallel.cpp" "CMakeFiles/yama-bench.dir/parallel.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/parallel.cpp.o.d"
+  "/root/repo/test/bench/quaternion.cpp" "CMakeFiles/yama-bench.dir/quaternion.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/quaternion.cpp.o.d"
+  "/root/repo/test/bench/ray.cpp" "CMakeFiles/yama-bench.dir/ray.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/ray.cpp.o.d"
+  "/root/repo/test/bench/skinning.cpp" "CMakeFiles/yama-bench.dir/skinning.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/skinning.cpp.o.d"
+  "/root/repo/test/bench/soa.cpp" "CMakeFiles/yama-bench.dir/soa.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/soa.cpp.o.d"
+  "/root/repo/test/bench/strided.cpp" "CMakeFiles/yama-bench.dir/strided.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/strided.cpp.o.d"
+  "/root/repo/test/bench/transform.cpp" "CMakeFiles/yama-bench.dir/transform.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/transform.cpp.o.d"
+  "/root/repo/test/bench/vector2.cpp" "CMakeFiles/yama-bench.dir/vector2.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/vector2.cpp.o.d"
+  "/root/repo/test/bench/vector3.cpp" "CMakeFiles/yama-bench.dir/vector3.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/vector3.cpp.o.d"
+  "/root/repo/test/bench/vector4.cpp" "CMakeFiles/yama-bench.dir/vector4.cpp.o" "gcc" "CMakeFiles/yama-bench.dir/vector4.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg_build/yama-dispatch/CMakeFiles/yama-dispatch.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
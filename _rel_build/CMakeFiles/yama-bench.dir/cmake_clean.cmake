@@ -0,0 +1,55 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/yama-bench.dir/aabb.cpp.o"
+  "CMakeFiles/yama-bench.dir/aabb.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/aligned.cpp.o"
+  "CMakeFiles/yama-bench.dir/aligned.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/batch.cpp.o"
+  "CMakeFiles/yama-bench.dir/batch.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/bvh.cpp.o"
+  "CMakeFiles/yama-bench.dir/bvh.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/dispatch.cpp.o"
+  "CMakeFiles/yama-bench.dir/dispatch.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/expr.cpp.o"
+  "CMakeFiles/yama-bench.dir/expr.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/frustum.cpp.o"
+  "CMakeFiles/yama-bench.dir/frustum.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/hierarchy.cpp.o"
+  "CMakeFiles/yama-bench.dir/hierarchy.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/macro.cpp.o"
+  "CMakeFiles/yama-bench.dir/macro.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/main.cpp.o"
+  "CMakeFiles/yama-bench.dir/main.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/matrix2x3.cpp.o"
+  "CMakeFiles/yama-bench.dir/matrix2x3.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/matrix3x4.cpp.o"
+  "CMakeFiles/yama-bench.dir/matrix3x4.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/matrix4x4.cpp.o"
+  "CMakeFiles/yama-bench.dir/matrix4x4.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/parallel.cpp.o"
+  "CMakeFiles/yama-bench.dir/parallel.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/quaternion.cpp.o"
+  "CMakeFiles/yama-bench.dir/quaternion.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/ray.cpp.o"
+  "CMakeFiles/yama-bench.dir/ray.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/skinning.cpp.o"
+  "CMakeFiles/yama-bench.dir/skinning.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/soa.cpp.o"
+  "CMakeFiles/yama-bench.dir/soa.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/strided.cpp.o"
+  "CMakeFiles/yama-bench.dir/strided.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/transform.cpp.o"
+  "CMakeFiles/yama-bench.dir/transform.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/vector2.cpp.o"
+  "CMakeFiles/yama-bench.dir/vector2.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/vector3.cpp.o"
+  "CMakeFiles/yama-bench.dir/vector3.cpp.o.d"
+  "CMakeFiles/yama-bench.dir/vector4.cpp.o"
+  "CMakeFiles/yama-bench.dir/vector4.cpp.o.d"
+  "yama-bench"
+  "yama-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yama-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
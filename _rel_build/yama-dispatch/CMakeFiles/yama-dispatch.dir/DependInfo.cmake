@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/dispatch.cpp" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch.cpp.o" "gcc" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch.cpp.o.d"
+  "/root/repo/src/dispatch_avx2.cpp" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_avx2.cpp.o" "gcc" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_avx2.cpp.o.d"
+  "/root/repo/src/dispatch_avx512.cpp" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_avx512.cpp.o" "gcc" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_avx512.cpp.o.d"
+  "/root/repo/src/dispatch_scalar.cpp" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_scalar.cpp.o" "gcc" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_scalar.cpp.o.d"
+  "/root/repo/src/dispatch_sse2.cpp" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_sse2.cpp.o" "gcc" "yama-dispatch/CMakeFiles/yama-dispatch.dir/dispatch_sse2.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,890 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Axis-aligned bounding boxes
+// aabb_t holds the min and max corners of a box. A box with any component of
+// min greater than the corresponding component of max is empty. empty() is
+// the identity of merge.
+//
+// aabb_soa_t keeps boxes in six streams, like the containers in soa.hpp, for
+// the batch functions at the end of the file. With YAMA_THREADS bounds and
+// transform_aabbs have overloads which take a parallel::thread_pool.
+
+#include "vector3.hpp"
+#include "matrix3x4.hpp"
+#include "matrix4x4.hpp"
+#include "soa.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace yama
+{
+
+template <typename T>
+class aabb_t
+{
+public:
+    typedef T value_type;
+
+    vector3_t<value_type> min;
+    vector3_t<value_type> max;
+
+    ////////////////////////////////////////////////////////
+    // named constructors
+
+    static constexpr aabb_t from_min_max(const vector3_t<value_type>& min, const vector3_t<value_type>& max)
+    {
+        return { min, max };
+    }
+
+    static aabb_t from_center_half_extents(const vector3_t<value_type>& center, const vector3_t<value_type>& half_extents)
+    {
+        return { center - half_extents, center + half_extents };
+    }
+
+    static constexpr aabb_t from_point(const vector3_t<value_type>& p)
+    {
+        return { p, p };
+    }
+
+    static aabb_t empty()
+    {
+        return {
+            vector3_t<value_type>::uniform(std::numeric_limits<value_type>::max()),
+            vector3_t<value_type>::uniform(-std::numeric_limits<value_type>::max())
+        };
+    }
+
+    ////////////////////////////////////////////////////////
+    // properties
+
+    bool is_empty() const
+    {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    vector3_t<value_type> center() const
+    {
+        return (min + max) * value_type(0.5);
+    }
+
+    vector3_t<value_type> half_extents() const
+    {
+        return (max - min) * value_type(0.5);
+    }
+
+    vector3_t<value_type> size() const
+    {
+        return max - min;
+    }
+
+    value_type volume() const
+    {
+        const auto s = size();
+        return s.x * s.y * s.z;
+    }
+
+    value_type surface_area() const
+    {
+        const auto s = size();
+        return 2 * (s.x * s.y + s.y * s.z + s.z * s.x);
+    }
+
+    ////////////////////////////////////////////////////////
+    // tests
+
+    // boundary points are contained
+    bool contains(const vector3_t<value_type>& p) const
+    {
+        return p.x >= min.x && p.x <= max.x
+            && p.y >= min.y && p.y <= max.y
+            && p.z >= min.z && p.z <= max.z;
+    }
+
+    bool contains(const aabb_t& b) const
+    {
+        return b.min.x >= min.x && b.max.x <= max.x
+            && b.min.y >= min.y && b.max.y <= max.y
+            && b.min.z >= min.z && b.max.z <= max.z;
+    }
+
+    // touching boxes intersect
+    bool intersects(const aabb_t& b) const
+    {
+        return b.min.x <= max.x && b.max.x >= min.x
+            && b.min.y <= max.y && b.max.y >= min.y
+            && b.min.z <= max.z && b.max.z >= min.z;
+    }
+
+    ////////////////////////////////////////////////////////
+    // modification
+
+    void merge(const vector3_t<value_type>& p)
+    {
+        min = yama::min(min, p);
+        max = yama::max(max, p);
+    }
+
+    void merge(const aabb_t& b)
+    {
+        min = yama::min(min, b.min);
+        max = yama::max(max, b.max);
+    }
+};
+
+template <typename T>
+bool operator==(const aabb_t<T>& a, const aabb_t<T>& b)
+{
+    return a.min == b.min && a.max == b.max;
+}
+
+template <typename T>
+bool operator!=(const aabb_t<T>& a, const aabb_t<T>& b)
+{
+    return a.min != b.min || a.max != b.max;
+}
+
+template <typename T>
+bool close(const aabb_t<T>& a, const aabb_t<T>& b, const T& epsilon = constants_t<T>::EPSILON())
+{
+    return close(a.min, b.min, epsilon) && close(a.max, b.max, epsilon);
+}
+
+template <typename T>
+aabb_t<T> merge(const aabb_t<T>& a, const aabb_t<T>& b)
+{
+    return aabb_t<T>::from_min_max(min(a.min, b.min), max(a.max, b.max));
+}
+
+template <typename T>
+aabb_t<T> merge(const aabb_t<T>& a, const vector3_t<T>& p)
+{
+    return aabb_t<T>::from_min_max(min(a.min, p), max(a.max, p));
+}
+
+// empty if the boxes don't intersect
+template <typename T>
+aabb_t<T> intersection(const aabb_t<T>& a, const aabb_t<T>& b)
+{
+    return aabb_t<T>::from_min_max(max(a.min, b.min), min(a.max, b.max));
+}
+
+template <typename T>
+bool intersects(const aabb_t<T>& a, const aabb_t<T>& b)
+{
+    return a.intersects(b);
+}
+
+namespace internal
+{
+
+// Arvo: the center is transformed as a point and each half extent of the
+// result is the sum of the half extents weighted by the absolute values of
+// the corresponding row of the matrix
+template <typename T, typename M>
+aabb_t<T> transform_aabb(const aabb_t<T>& b, const M& m)
+{
+    if (b.is_empty()) return b;
+
+    const auto c = b.center();
+    const auto e = b.half_extents();
+    const auto tc = vector3_t<T>::coord(
+        m.m00*c.x + m.m01*c.y + m.m02*c.z + m.m03,
+        m.m10*c.x + m.m11*c.y + m.m12*c.z + m.m13,
+        m.m20*c.x + m.m21*c.y + m.m22*c.z + m.m23
+    );
+    const auto te = vector3_t<T>::coord(
+        std::abs(m.m00)*e.x + std::abs(m.m01)*e.y + std::abs(m.m02)*e.z,
+        std::abs(m.m10)*e.x + std::abs(m.m11)*e.y + std::abs(m.m12)*e.z,
+        std::abs(m.m20)*e.x + std::abs(m.m21)*e.y + std::abs(m.m22)*e.z
+    );
+    return aabb_t<T>::from_center_half_extents(tc, te);
+}
+
+}
+
+// the smallest box containing the transformed box
+template <typename T>
+aabb_t<T> transform_aabb(const aabb_t<T>& b, const matrix3x4_t<T>& m)
+{
+    return internal::transform_aabb(b, m);
+}
+
+// the matrix must be affine, as projections don't keep boxes as boxes
+template <typename T>
+aabb_t<T> transform_aabb(const aabb_t<T>& b, const matrix4x4_t<T>& m)
+{
+    YAMA_ASSERT_WARN(m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1, "yama::transform_aabb with a non-affine matrix");
+    return internal::transform_aabb(b, m);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// bounds of points
+
+// The points are read as a flat array of floats, three packs (P::width points)
+// at a time, with no shuffling. Lane j of the three packs holds component j % 3.
+template <typename T>
+aabb_t<T> bounds(const vector3_t<T>* points, size_t count)
+{
+    typedef internal::pack<T> P;
+    const size_t W = P::width;
+
+    auto ret = aabb_t<T>::empty();
+    const size_t packed = count - count % W;
+    if (packed)
+    {
+        const T* f = points->data();
+        P lo[3], hi[3];
+        for (size_t k = 0; k < 3; ++k)
+        {
+            lo[k] = hi[k] = P::load(f + k * W);
+        }
+        for (size_t i = W; i < packed; i += W)
+        {
+            const T* p = f + 3 * i;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const P v = P::load(p + k * W);
+                lo[k] = vmin(lo[k], v);
+                hi[k] = vmax(hi[k], v);
+            }
+        }
+
+        T l[3 * W], h[3 * W];
+        for (size_t k = 0; k < 3; ++k)
+        {
+            lo[k].store(l + k * W);
+            hi[k].store(h + k * W);
+        }
+        for (size_t j = 0; j < 3 * W; ++j)
+        {
+            auto& rl = ret.min.at(j % 3);
+            auto& rh = ret.max.at(j % 3);
+            rl = l[j] < rl ? l[j] : rl;
+            rh = h[j] > rh ? h[j] : rh;
+        }
+    }
+
+    for (size_t i = packed; i < count; ++i)
+    {
+        ret.merge(points[i]);
+    }
+    return ret;
+}
+
+namespace internal
+{
+
+// each pack is gathered into x, y and z
+template <typename T>
+aabb_t<T> strided_bounds(const vector3_t<T>* p, size_t stride, size_t count)
+{
+    typedef pack<T> P;
+    const size_t W = P::width;
+
+    auto ret = aabb_t<T>::empty();
+    size_t i = 0;
+    if (count >= W)
+    {
+        P lo[3], hi[3];
+        load3(p, stride, lo[0], lo[1], lo[2]);
+        for (size_t k = 0; k < 3; ++k)
+        {
+            hi[k] = lo[k];
+        }
+        for (i = W; i + W <= count; i += W)
+        {
+            P v[3];
+            load3(byte_offset(p, i * stride), stride, v[0], v[1], v[2]);
+            for (size_t k = 0; k < 3; ++k)
+            {
+                lo[k] = vmin(lo[k], v[k]);
+                hi[k] = vmax(hi[k], v[k]);
+            }
+        }
+
+        T l[W], h[W];
+        for (size_t k = 0; k < 3; ++k)
+        {
+            lo[k].store(l);
+            hi[k].store(h);
+            auto& rl = ret.min.at(k);
+            auto& rh = ret.max.at(k);
+            for (size_t j = 0; j < W; ++j)
+            {
+                rl = l[j] < rl ? l[j] : rl;
+                rh = h[j] > rh ? h[j] : rh;
+            }
+        }
+    }
+
+    for (; i < count; ++i)
+    {
+        ret.merge(*byte_offset(p, i * stride));
+    }
+    return ret;
+}
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+// With room for a fourth float in the stride each point is a single load, and
+// the float after it only ends up in the unused lane. The last point is merged
+// alone, as nothing may follow it.
+inline aabb_t<float> strided_bounds(const vector3_t<float>* p, size_t stride, size_t count)
+{
+    if (stride < 4 * sizeof(float) || count < 2) return strided_bounds<float>(p, stride, count);
+
+    typedef float4_sse P;
+    P lo[2], hi[2];
+    lo[0] = lo[1] = hi[0] = hi[1] = P::load(p->data());
+
+    size_t i = 1;
+    for (; i + 2 < count; i += 2)
+    {
+        const P a = P::load(byte_offset(p, i * stride)->data());
+        const P b = P::load(byte_offset(p, (i + 1) * stride)->data());
+        lo[0] = vmin(lo[0], a);
+        hi[0] = vmax(hi[0], a);
+        lo[1] = vmin(lo[1], b);
+        hi[1] = vmax(hi[1], b);
+    }
+    if (i + 1 < count)
+    {
+        const P a = P::load(byte_offset(p, i * stride)->data());
+        lo[0] = vmin(lo[0], a);
+        hi[0] = vmax(hi[0], a);
+    }
+
+    float l[4], h[4];
+    vmin(lo[0], lo[1]).store(l);
+    vmax(hi[0], hi[1]).store(h);
+    auto ret = aabb_t<float>::from_min_max(vector3_t<float>::coord(l[0], l[1], l[2]), vector3_t<float>::coord(h[0], h[1], h[2]));
+    ret.merge(*byte_offset(p, (count - 1) * stride));
+    return ret;
+}
+#endif
+
+}
+
+// Points of a view, for example the positions of interleaved vertices. The
+// same as bounds of an array when the points are contiguous.
+template <typename T>
+aabb_t<T> bounds(const strided_span<const vector3_t<T>>& points)
+{
+    if (points.contiguous()) return bounds(points.data(), points.size());
+    return internal::strided_bounds(points.data(), points.stride(), points.size());
+}
+
+template <typename T>
+aabb_t<T> bounds(const strided_span<vector3_t<T>>& points)
+{
+    return bounds(strided_span<const vector3_t<T>>(points));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// structure of arrays
+
+template <typename T>
+class aabb_soa_ref_t
+{
+public:
+    vector3_soa_ref_t<T> min;
+    vector3_soa_ref_t<T> max;
+
+    typedef T value_type;
+
+    aabb_soa_ref_t(const vector3_soa_ref_t<T>& min, const vector3_soa_ref_t<T>& max)
+        : min(min), max(max)
+    {}
+
+    aabb_soa_ref_t(const aabb_soa_ref_t&) = default;
+
+    aabb_soa_ref_t& operator=(const aabb_soa_ref_t& b)
+    {
+        return *this = b.value();
+    }
+
+    aabb_soa_ref_t& operator=(const aabb_t<T>& b)
+    {
+        min = b.min;
+        max = b.max;
+        return *this;
+    }
+
+    aabb_t<T> value() const
+    {
+        return aabb_t<T>::from_min_max(min.value(), max.value());
+    }
+
+    operator aabb_t<T>() const
+    {
+        return value();
+    }
+
+    friend bool operator==(const aabb_soa_ref_t& a, const aabb_t<T>& b) { return a.value() == b; }
+    friend bool operator==(const aabb_t<T>& a, const aabb_soa_ref_t& b) { return a == b.value(); }
+    friend bool operator!=(const aabb_soa_ref_t& a, const aabb_t<T>& b) { return a.value() != b; }
+    friend bool operator!=(const aabb_t<T>& a, const aabb_soa_ref_t& b) { return a != b.value(); }
+};
+
+// streams: min x, y, z, max x, y, z
+template <typename T>
+class aabb_soa_t : public internal::soa_streams<T, 6>
+{
+    typedef internal::soa_streams<T, 6> base;
+public:
+    typedef typename base::size_type size_type;
+    typedef aabb_soa_ref_t<T> reference;
+    typedef aabb_t<T> const_reference;
+
+    aabb_soa_t() = default;
+
+    explicit aabb_soa_t(size_type size)
+        : base(size)
+    {}
+
+    static aabb_soa_t from_array(const aabb_t<T>* ptr, size_type count)
+    {
+        aabb_soa_t ret;
+        ret.assign(ptr, count);
+        return ret;
+    }
+
+    T* min_x() { return this->stream(0); }
+    T* min_y() { return this->stream(1); }
+    T* min_z() { return this->stream(2); }
+    T* max_x() { return this->stream(3); }
+    T* max_y() { return this->stream(4); }
+    T* max_z() { return this->stream(5); }
+    const T* min_x() const { return this->stream(0); }
+    const T* min_y() const { return this->stream(1); }
+    const T* min_z() const { return this->stream(2); }
+    const T* max_x() const { return this->stream(3); }
+    const T* max_y() const { return this->stream(4); }
+    const T* max_z() const { return this->stream(5); }
+
+    reference at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::aabb_soa_t index overflow");
+        return reference(
+            vector3_soa_ref_t<T>(min_x()[i], min_y()[i], min_z()[i]),
+            vector3_soa_ref_t<T>(max_x()[i], max_y()[i], max_z()[i])
+        );
+    }
+
+    const_reference at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::aabb_soa_t index overflow");
+        return aabb_t<T>::from_min_max(
+            vector3_t<T>::coord(min_x()[i], min_y()[i], min_z()[i]),
+            vector3_t<T>::coord(max_x()[i], max_y()[i], max_z()[i])
+        );
+    }
+
+    reference operator[](size_type i) { return at(i); }
+    const_reference operator[](size_type i) const { return at(i); }
+
+    void push_back(const aabb_t<T>& b)
+    {
+        const size_type i = this->grow();
+        at(i) = b;
+    }
+
+    // replaces the contents with count elements from ptr
+    void assign(const aabb_t<T>* ptr, size_type count)
+    {
+        this->resize(count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            at(i) = ptr[i];
+        }
+    }
+
+    // writes size() elements to ptr
+    void copy_to(aabb_t<T>* ptr) const
+    {
+        for (size_type i = 0; i < this->size(); ++i)
+        {
+            ptr[i] = at(i);
+        }
+    }
+};
+
+namespace internal
+{
+
+template <typename T, bool Merge>
+struct soa_aabb_combine_kernel
+{
+    soa_in<T, 6> a, b;
+    soa_out<T, 6> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const P amin = P::load(a.s[c] + i), bmin = P::load(b.s[c] + i);
+            const P amax = P::load(a.s[c + 3] + i), bmax = P::load(b.s[c + 3] + i);
+            (Merge ? vmin(amin, bmin) : vmax(amin, bmin)).store(out.s[c] + i);
+            (Merge ? vmax(amax, bmax) : vmin(amax, bmax)).store(out.s[c + 3] + i);
+        }
+    }
+};
+
+template <typename T>
+struct soa_aabb_intersects_kernel
+{
+    soa_in<T, 6> a, b;
+    uint32_t* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        unsigned bits = ~0u;
+        for (size_t c = 0; c < 3; ++c)
+        {
+            bits &= ge_mask(P::load(a.s[c + 3] + i), P::load(b.s[c] + i));
+            bits &= ge_mask(P::load(b.s[c + 3] + i), P::load(a.s[c] + i));
+        }
+        store_mask(out, i, bits);
+    }
+};
+
+template <typename T>
+struct soa_aabb_contains_kernel
+{
+    soa_in<T, 6> a;
+    soa_in<T, 3> p;
+    uint32_t* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        unsigned bits = ~0u;
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const P v = P::load(p.s[c] + i);
+            bits &= ge_mask(v, P::load(a.s[c] + i));
+            bits &= ge_mask(P::load(a.s[c + 3] + i), v);
+        }
+        store_mask(out, i, bits);
+    }
+};
+
+// the matrix rows and their absolute values broadcast to packs
+template <typename T>
+struct soa_aabb_transform_kernel
+{
+    typedef pack<T> P;
+
+    P m[12];
+    P a[9];
+    soa_in<T, 6> in;
+    soa_out<T, 6> out;
+
+    soa_aabb_transform_kernel(const T* r, const aabb_soa_t<T>& in_, aabb_soa_t<T>& out_)
+        : in(in_)
+        , out(out_, in_.size())
+    {
+        for (size_t i = 0; i < 12; ++i)
+        {
+            m[i] = P::uniform(r[i]);
+        }
+        for (size_t row = 0; row < 3; ++row)
+        {
+            for (size_t col = 0; col < 3; ++col)
+            {
+                a[row * 3 + col] = P::uniform(std::abs(r[row * 4 + col]));
+            }
+        }
+    }
+
+    template <typename>
+    void run(size_t i) const
+    {
+        const P half = P::uniform(T(0.5));
+        const P x0 = P::load(in.s[0] + i), y0 = P::load(in.s[1] + i), z0 = P::load(in.s[2] + i);
+        const P x1 = P::load(in.s[3] + i), y1 = P::load(in.s[4] + i), z1 = P::load(in.s[5] + i);
+        const P cx = (x0 + x1) * half, cy = (y0 + y1) * half, cz = (z0 + z1) * half;
+        const P ex = (x1 - x0) * half, ey = (y1 - y0) * half, ez = (z1 - z0) * half;
+
+        for (size_t row = 0; row < 3; ++row)
+        {
+            const P* r = m + row * 4;
+            const P* ar = a + row * 3;
+            const P c = madd(r[0], cx, madd(r[1], cy, madd(r[2], cz, r[3])));
+            const P e = madd(ar[0], ex, madd(ar[1], ey, ar[2] * ez));
+            (c - e).store(out.s[row] + i);
+            (c + e).store(out.s[row + 3] + i);
+        }
+    }
+};
+
+}
+
+// The functions below are element-wise. As in soa.hpp the output container
+// is resized to the size of the inputs and may be one of them, and bitmask
+// outputs must have room for (size + 31) / 32 words.
+
+template <typename T>
+void merge(const aabb_soa_t<T>& a, const aabb_soa_t<T>& b, aabb_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const internal::soa_aabb_combine_kernel<T, true> k = { internal::soa_in<T, 6>(a), internal::soa_in<T, 6>(b), internal::soa_out<T, 6>(out, a.size()) };
+    internal::run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+template <typename T>
+void intersection(const aabb_soa_t<T>& a, const aabb_soa_t<T>& b, aabb_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const internal::soa_aabb_combine_kernel<T, false> k = { internal::soa_in<T, 6>(a), internal::soa_in<T, 6>(b), internal::soa_out<T, 6>(out, a.size()) };
+    internal::run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+template <typename T>
+void intersects(const aabb_soa_t<T>& a, const aabb_soa_t<T>& b, uint32_t* out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const internal::soa_aabb_intersects_kernel<T> k = { internal::soa_in<T, 6>(a), internal::soa_in<T, 6>(b), out };
+    internal::run_mask_kernel<T>(k, a.size(), a.padded_size(), out);
+}
+
+// box i contains point i
+template <typename T>
+void contains(const aabb_soa_t<T>& a, const vector3_soa_t<T>& points, uint32_t* out)
+{
+    YAMA_ASSERT_CRIT(a.size() == points.size(), "yama soa containers of different size");
+    const internal::soa_aabb_contains_kernel<T> k = { internal::soa_in<T, 6>(a), internal::soa_in<T, 3>(points), out };
+    internal::run_mask_kernel<T>(k, a.size(), a.padded_size(), out);
+}
+
+// the boxes must not be empty
+template <typename T>
+void transform_aabbs(const matrix3x4_t<T>& m, const aabb_soa_t<T>& in, aabb_soa_t<T>& out)
+{
+    T r[12];
+    internal::rows3x4(m, r);
+    const internal::soa_aabb_transform_kernel<T> k(r, in, out);
+    internal::run_padded_soa_kernel<T>(k, in.padded_size());
+}
+
+template <typename T>
+void transform_aabbs(const matrix4x4_t<T>& m, const aabb_soa_t<T>& in, aabb_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1, "yama::transform_aabbs with a non-affine matrix");
+    T r[12];
+    internal::rows3x4(m, r);
+    const internal::soa_aabb_transform_kernel<T> k(r, in, out);
+    internal::run_padded_soa_kernel<T>(k, in.padded_size());
+}
+
+// reductions: the box containing all elements
+
+namespace internal
+{
+
+// the elements [first, first + count) of a container
+template <typename T>
+aabb_t<T> soa_bounds(const vector3_soa_t<T>& points, size_t first, size_t count)
+{
+    typedef pack<T> P;
+    const size_t packed = count - count % P::width;
+
+    const T* s[3] = { points.x() + first, points.y() + first, points.z() + first };
+    auto ret = aabb_t<T>::empty();
+    if (packed)
+    {
+        P lo[3], hi[3];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            lo[c] = hi[c] = P::load(s[c]);
+        }
+        for (size_t i = P::width; i < packed; i += P::width)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                const P v = P::load(s[c] + i);
+                lo[c] = vmin(lo[c], v);
+                hi[c] = vmax(hi[c], v);
+            }
+        }
+
+        T l[P::width], h[P::width];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            lo[c].store(l);
+            hi[c].store(h);
+            for (size_t j = 0; j < P::width; ++j)
+            {
+                ret.min.at(c) = l[j] < ret.min.at(c) ? l[j] : ret.min.at(c);
+                ret.max.at(c) = h[j] > ret.max.at(c) ? h[j] : ret.max.at(c);
+            }
+        }
+    }
+
+    for (size_t i = packed; i < count; ++i)
+    {
+        ret.merge(points[first + i]);
+    }
+    return ret;
+}
+
+template <typename T>
+aabb_t<T> soa_bounds(const aabb_soa_t<T>& boxes, size_t first, size_t count)
+{
+    typedef pack<T> P;
+    const size_t packed = count - count % P::width;
+
+    const T* smin[3] = { boxes.min_x() + first, boxes.min_y() + first, boxes.min_z() + first };
+    const T* smax[3] = { boxes.max_x() + first, boxes.max_y() + first, boxes.max_z() + first };
+    auto ret = aabb_t<T>::empty();
+    if (packed)
+    {
+        P lo[3], hi[3];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            lo[c] = P::load(smin[c]);
+            hi[c] = P::load(smax[c]);
+        }
+        for (size_t i = P::width; i < packed; i += P::width)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                lo[c] = vmin(lo[c], P::load(smin[c] + i));
+                hi[c] = vmax(hi[c], P::load(smax[c] + i));
+            }
+        }
+
+        T l[P::width], h[P::width];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            lo[c].store(l);
+            hi[c].store(h);
+            for (size_t j = 0; j < P::width; ++j)
+            {
+                ret.min.at(c) = l[j] < ret.min.at(c) ? l[j] : ret.min.at(c);
+                ret.max.at(c) = h[j] > ret.max.at(c) ? h[j] : ret.max.at(c);
+            }
+        }
+    }
+
+    for (size_t i = packed; i < count; ++i)
+    {
+        ret.merge(boxes[first + i]);
+    }
+    return ret;
+}
+
+}
+
+template <typename T>
+aabb_t<T> bounds(const vector3_soa_t<T>& points)
+{
+    return internal::soa_bounds(points, 0, points.size());
+}
+
+template <typename T>
+aabb_t<T> bounds(const aabb_soa_t<T>& boxes)
+{
+    return internal::soa_bounds(boxes, 0, boxes.size());
+}
+
+#if YAMA_THREADS
+
+///////////////////////////////////////////////////////////////////////////////
+// parallel overloads
+// Reductions over blocks of a fixed size, merged in order. The result is the
+// same as the one of the functions above.
+
+namespace internal
+{
+
+// elements per block of the parallel reductions
+const size_t bounds_block_size = 16384;
+
+template <typename T, typename Map>
+aabb_t<T> parallel_bounds(parallel::thread_pool& pool, size_t count, const Map& map)
+{
+    return parallel::reduce(pool, count, bounds_block_size, aabb_t<T>::empty(), map, [](const aabb_t<T>& a, const aabb_t<T>& b) {
+        return merge(a, b);
+    });
+}
+
+}
+
+template <typename T>
+aabb_t<T> bounds(parallel::thread_pool& pool, const vector3_t<T>* points, size_t count)
+{
+    return internal::parallel_bounds<T>(pool, count, [points](size_t first, size_t n) {
+        return bounds(points + first, n);
+    });
+}
+
+template <typename T>
+aabb_t<T> bounds(parallel::thread_pool& pool, const strided_span<const vector3_t<T>>& points)
+{
+    return internal::parallel_bounds<T>(pool, points.size(), [&points](size_t first, size_t n) {
+        return bounds(points.subspan(first, n));
+    });
+}
+
+template <typename T>
+aabb_t<T> bounds(parallel::thread_pool& pool, const strided_span<vector3_t<T>>& points)
+{
+    return bounds(pool, strided_span<const vector3_t<T>>(points));
+}
+
+template <typename T>
+aabb_t<T> bounds(parallel::thread_pool& pool, const vector3_soa_t<T>& points)
+{
+    return internal::parallel_bounds<T>(pool, points.size(), [&points](size_t first, size_t n) {
+        return internal::soa_bounds(points, first, n);
+    });
+}
+
+template <typename T>
+aabb_t<T> bounds(parallel::thread_pool& pool, const aabb_soa_t<T>& boxes)
+{
+    return internal::parallel_bounds<T>(pool, boxes.size(), [&boxes](size_t first, size_t n) {
+        return internal::soa_bounds(boxes, first, n);
+    });
+}
+
+template <typename T>
+void transform_aabbs(parallel::thread_pool& pool, const matrix3x4_t<T>& m, const aabb_soa_t<T>& in, aabb_soa_t<T>& out)
+{
+    T r[12];
+    internal::rows3x4(m, r);
+    const internal::soa_aabb_transform_kernel<T> k(r, in, out);
+    internal::run_padded_soa_kernel<T>(pool, k, in.padded_size());
+}
+
+template <typename T>
+void transform_aabbs(parallel::thread_pool& pool, const matrix4x4_t<T>& m, const aabb_soa_t<T>& in, aabb_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1, "yama::transform_aabbs with a non-affine matrix");
+    T r[12];
+    internal::rows3x4(m, r);
+    const internal::soa_aabb_transform_kernel<T> k(r, in, out);
+    internal::run_padded_soa_kernel<T>(pool, k, in.padded_size());
+}
+
+#endif
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef aabb_t<preferred_type> aabb;
+typedef aabb_soa_t<preferred_type> aabb_soa;
+
+#endif
+
+}
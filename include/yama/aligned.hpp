@@ -0,0 +1,200 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Aligned storage variants
+// vector3a_t, vector4a_t and quaterniona_t are aligned to a SIMD register of
+// four components (16 bytes for float), and vector3a_t is padded to it, so a
+// single aligned load reads a whole element and arrays of them never
+// straddle registers. matrix4x4a_t is aligned to a cache line.
+//
+// Each one derives from its yama type and only adds the alignment: it has the
+// same API and converts to and from it implicitly, by copying. Named
+// constructors and operators return the unaligned type. The contents of the
+// padding of vector3a_t are unspecified and the batch functions for arrays of
+// vector3a_t may overwrite them.
+//
+// The aligned types allocate single objects and arrays with new at their
+// alignment, which C++11 doesn't do on its own. Standard containers of them
+// need aligned_allocator.
+
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "quaternion.hpp"
+#include "matrix4x4.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace yama
+{
+
+namespace internal
+{
+
+inline void* allocate_aligned(size_t bytes, size_t alignment)
+{
+    // store the pointer returned by malloc right before the aligned block
+    void* raw = std::malloc(bytes + alignment + sizeof(void*));
+    if (!raw) throw std::bad_alloc();
+    const size_t addr = reinterpret_cast<size_t>(raw) + sizeof(void*);
+    void* ret = reinterpret_cast<void*>((addr + alignment - 1) & ~(alignment - 1));
+    reinterpret_cast<void**>(ret)[-1] = raw;
+    return ret;
+}
+
+inline void free_aligned(void* ptr)
+{
+    if (ptr) std::free(reinterpret_cast<void**>(ptr)[-1]);
+}
+
+// the alignment of allocate_aligned, which must be a power of two with room for the pointer before the block
+constexpr size_t allocation_alignment(size_t alignment)
+{
+    return alignment < alignof(void*) ? alignof(void*) : alignment;
+}
+
+// new and delete for types with a larger alignment than the one of operator new
+template <size_t Alignment>
+struct aligned_new
+{
+    static void* operator new(size_t bytes) { return allocate_aligned(bytes, allocation_alignment(Alignment)); }
+    static void* operator new[](size_t bytes) { return allocate_aligned(bytes, allocation_alignment(Alignment)); }
+    static void* operator new(size_t, void* ptr) { return ptr; }
+    static void* operator new[](size_t, void* ptr) { return ptr; }
+    static void operator delete(void* ptr) { free_aligned(ptr); }
+    static void operator delete[](void* ptr) { free_aligned(ptr); }
+    static void operator delete(void*, void*) {}
+    static void operator delete[](void*, void*) {}
+};
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// allocator
+
+// a standard allocator returning memory aligned to Alignment, by default the alignment of T
+template <typename T, size_t Alignment = alignof(T)>
+class aligned_allocator
+{
+public:
+    static_assert((Alignment & (Alignment - 1)) == 0, "yama::aligned_allocator alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "yama::aligned_allocator alignment must be at least the one of the type");
+
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    static constexpr size_t alignment = Alignment;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef aligned_allocator<U, (Alignment < alignof(U) ? alignof(U) : Alignment)> other;
+    };
+
+    aligned_allocator() = default;
+
+    template <typename U, size_t A>
+    aligned_allocator(const aligned_allocator<U, A>&) {}
+
+    size_t max_size() const
+    {
+        // room for the alignment and the pointer which allocate_aligned adds
+        return (size_t(-1) - internal::allocation_alignment(Alignment) - sizeof(void*)) / sizeof(T);
+    }
+
+    T* allocate(size_t n)
+    {
+        if (n > max_size()) throw std::bad_array_new_length();
+        return static_cast<T*>(internal::allocate_aligned(n * sizeof(T), internal::allocation_alignment(Alignment)));
+    }
+
+    void deallocate(T* ptr, size_t)
+    {
+        internal::free_aligned(ptr);
+    }
+};
+
+template <typename T, size_t Alignment> constexpr size_t aligned_allocator<T, Alignment>::alignment;
+
+template <typename T, size_t A, typename U, size_t B>
+bool operator==(const aligned_allocator<T, A>&, const aligned_allocator<U, B>&)
+{
+    return true;
+}
+
+template <typename T, size_t A, typename U, size_t B>
+bool operator!=(const aligned_allocator<T, A>&, const aligned_allocator<U, B>&)
+{
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// types
+
+template <typename T>
+class alignas(4 * sizeof(T)) vector3a_t : public vector3_t<T>, public internal::aligned_new<4 * sizeof(T)>
+{
+public:
+    vector3a_t() = default;
+    vector3a_t(const vector3_t<T>& v) : vector3_t<T>(v) {}
+};
+
+template <typename T>
+class alignas(4 * sizeof(T)) vector4a_t : public vector4_t<T>, public internal::aligned_new<4 * sizeof(T)>
+{
+public:
+    vector4a_t() = default;
+    vector4a_t(const vector4_t<T>& v) : vector4_t<T>(v) {}
+};
+
+template <typename T>
+class alignas(4 * sizeof(T)) quaterniona_t : public quaternion_t<T>, public internal::aligned_new<4 * sizeof(T)>
+{
+public:
+    quaterniona_t() = default;
+    quaterniona_t(const quaternion_t<T>& q) : quaternion_t<T>(q) {}
+};
+
+template <typename T>
+class alignas(64) matrix4x4a_t : public matrix4x4_t<T>, public internal::aligned_new<64>
+{
+public:
+    matrix4x4a_t() = default;
+    matrix4x4a_t(const matrix4x4_t<T>& m) : matrix4x4_t<T>(m) {}
+};
+
+template <typename T>
+struct is_yama<vector3a_t<T>> : public std::true_type {};
+
+template <typename T>
+struct is_yama<vector4a_t<T>> : public std::true_type {};
+
+template <typename T>
+struct is_yama<quaterniona_t<T>> : public std::true_type {};
+
+template <typename T>
+struct is_yama<matrix4x4a_t<T>> : public std::true_type {};
+
+template <typename T>
+struct is_matrix<matrix4x4a_t<T>> : public std::true_type {};
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+typedef vector3a_t<preferred_type> vector3a;
+typedef vector4a_t<preferred_type> vector4a;
+typedef quaterniona_t<preferred_type> quaterniona;
+typedef matrix4x4a_t<preferred_type> matrix4x4a;
+#endif
+
+}
@@ -0,0 +1,1622 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Batch operations over arrays of yama types
+// Each function is equivalent to calling its single-element counterpart for
+// every element, but the constant arguments are loaded only once and the
+// elements are processed in SIMD packs when YAMA_SIMD is enabled. When the
+// compiler may contract multiply-adds into FMA instructions (for example GCC
+// with -mfma) the results can differ from it, and between the serial and the
+// thread_pool overloads, in the last bit.
+// Unless stated otherwise `in` and `out` may be the same array, but must not
+// overlap partially.
+// Strided overloads take the distance in bytes between consecutive elements,
+// so they work directly on interleaved vertex buffers. The same functions
+// take strided_span-s of the elements, of the same size.
+// With YAMA_THREADS the overloads which take a parallel::thread_pool first
+// split the elements between its threads.
+
+#include "matrix2x3.hpp"
+#include "matrix3x3.hpp"
+#include "matrix3x4.hpp"
+#include "matrix4x4.hpp"
+#include "quaternion.hpp"
+#include "transform.hpp"
+#include "aligned.hpp"
+#include "simd.hpp"
+#include "strided.hpp"
+#include "parallel.hpp"
+
+namespace yama
+{
+
+namespace internal
+{
+
+template <typename T>
+const T* byte_offset(const T* ptr, size_t bytes)
+{
+    return reinterpret_cast<const T*>(reinterpret_cast<const char*>(ptr) + bytes);
+}
+
+template <typename T>
+T* byte_offset(T* ptr, size_t bytes)
+{
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(ptr) + bytes);
+}
+
+template <typename P>
+void load2(const vector2_t<typename P::value_type>* ptr, size_t stride, P& x, P& y)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector2_t<T>))
+    {
+        P::load2(ptr->data(), x, y);
+        return;
+    }
+
+    T buf[2 * P::width];
+    for (size_t i = 0; i < P::width; ++i)
+    {
+        const auto& v = *byte_offset(ptr, i * stride);
+        buf[2 * i] = v.x;
+        buf[2 * i + 1] = v.y;
+    }
+    P::load2(buf, x, y);
+}
+
+template <typename P>
+void store2(vector2_t<typename P::value_type>* ptr, size_t stride, P x, P y)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector2_t<T>))
+    {
+        P::store2(ptr->data(), x, y);
+        return;
+    }
+
+    T buf[2 * P::width];
+    P::store2(buf, x, y);
+    for (size_t i = 0; i < P::width; ++i)
+    {
+        auto& v = *byte_offset(ptr, i * stride);
+        v.x = buf[2 * i];
+        v.y = buf[2 * i + 1];
+    }
+}
+
+template <typename P>
+void load3(const vector3_t<typename P::value_type>* ptr, size_t stride, P& x, P& y, P& z)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector3_t<T>))
+    {
+        P::load3(ptr->data(), x, y, z);
+        return;
+    }
+
+    T buf[3 * P::width];
+    for (size_t i = 0; i < P::width; ++i)
+    {
+        const auto& v = *byte_offset(ptr, i * stride);
+        buf[3 * i] = v.x;
+        buf[3 * i + 1] = v.y;
+        buf[3 * i + 2] = v.z;
+    }
+    P::load3(buf, x, y, z);
+}
+
+template <typename P>
+void store3(vector3_t<typename P::value_type>* ptr, size_t stride, P x, P y, P z)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector3_t<T>))
+    {
+        P::store3(ptr->data(), x, y, z);
+        return;
+    }
+
+    T buf[3 * P::width];
+    P::store3(buf, x, y, z);
+    for (size_t i = 0; i < P::width; ++i)
+    {
+        auto& v = *byte_offset(ptr, i * stride);
+        v.x = buf[3 * i];
+        v.y = buf[3 * i + 1];
+        v.z = buf[3 * i + 2];
+    }
+}
+
+// Padded arrays load and store whole elements, which gets rid of the shuffles
+// of the packed ones. The padding is overwritten with zeros.
+template <typename P>
+void load3(const vector3a_t<typename P::value_type>* ptr, size_t stride, P& x, P& y, P& z)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector3a_t<T>))
+    {
+        P w;
+        P::load4(ptr->data(), x, y, z, w);
+        return;
+    }
+    load3(static_cast<const vector3_t<T>*>(ptr), stride, x, y, z);
+}
+
+template <typename P>
+void store3(vector3a_t<typename P::value_type>* ptr, size_t stride, P x, P y, P z)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector3a_t<T>))
+    {
+        P::store4(ptr->data(), x, y, z, P::uniform(0));
+        return;
+    }
+    store3(static_cast<vector3_t<T>*>(ptr), stride, x, y, z);
+}
+
+// Calls k.run<P>(i) for packs of elements in [0, count) and scalar_pack for the rest.
+template <typename T, typename Kernel>
+void run_kernel(const Kernel& k, size_t count)
+{
+    typedef pack<T> P;
+    const size_t packed = count - count % P::width;
+    size_t i = 0;
+    for (; i < packed; i += P::width)
+    {
+        k.template run<P>(i);
+    }
+    for (; i < count; ++i)
+    {
+        k.template run<scalar_pack<T>>(i);
+    }
+}
+
+// Runs Kernel over count vector3_t-s (or vector3a_t-s), widest packs first, then the rest one by one.
+// Kernel<P, T> is constructed from `arg` and transforms a pack of vectors in place.
+template <template <typename, typename> class Kernel, typename V, typename Arg>
+void run_vector3_loop(const Arg& arg, const V* in, size_t in_stride, V* out, size_t out_stride, size_t count)
+{
+    typedef typename V::value_type T;
+    typedef pack<T> P;
+    const Kernel<P, T> k(arg);
+
+    for (; count >= P::width; count -= P::width)
+    {
+        P x, y, z;
+        load3(in, in_stride, x, y, z);
+        k(x, y, z);
+        store3(out, out_stride, x, y, z);
+        in = byte_offset(in, P::width * in_stride);
+        out = byte_offset(out, P::width * out_stride);
+    }
+
+    typedef scalar_pack<T> S;
+    const Kernel<S, T> ks(arg);
+
+    for (; count > 0; --count)
+    {
+        S x, y, z;
+        load3(in, in_stride, x, y, z);
+        ks(x, y, z);
+        store3(out, out_stride, x, y, z);
+        in = byte_offset(in, in_stride);
+        out = byte_offset(out, out_stride);
+    }
+}
+
+// With the strides of arrays as constants the checks in load3 and store3 fold
+// away, so contiguous arrays get a loop with no per-pack branches.
+template <template <typename, typename> class Kernel, typename V, typename Arg>
+void run_vector3_kernel(const Arg& arg, const V* in, size_t in_stride, V* out, size_t out_stride, size_t count)
+{
+    const size_t size = sizeof(V);
+    if (in_stride == size && out_stride == size)
+    {
+        run_vector3_loop<Kernel>(arg, in, size, out, size, count);
+    }
+    else
+    {
+        run_vector3_loop<Kernel>(arg, in, in_stride, out, out_stride, count);
+    }
+}
+
+// the same for vector2_t-s, Kernel<P, T> transforms a pack of x and y in place
+template <template <typename, typename> class Kernel, typename T, typename Arg>
+void run_vector2_loop(const Arg& arg, const vector2_t<T>* in, size_t in_stride, vector2_t<T>* out, size_t out_stride, size_t count)
+{
+    typedef pack<T> P;
+    const Kernel<P, T> k(arg);
+
+    for (; count >= P::width; count -= P::width)
+    {
+        P x, y;
+        load2(in, in_stride, x, y);
+        k(x, y);
+        store2(out, out_stride, x, y);
+        in = byte_offset(in, P::width * in_stride);
+        out = byte_offset(out, P::width * out_stride);
+    }
+
+    typedef scalar_pack<T> S;
+    const Kernel<S, T> ks(arg);
+
+    for (; count > 0; --count)
+    {
+        S x, y;
+        load2(in, in_stride, x, y);
+        ks(x, y);
+        store2(out, out_stride, x, y);
+        in = byte_offset(in, in_stride);
+        out = byte_offset(out, out_stride);
+    }
+}
+
+template <template <typename, typename> class Kernel, typename T, typename Arg>
+void run_vector2_kernel(const Arg& arg, const vector2_t<T>* in, size_t in_stride, vector2_t<T>* out, size_t out_stride, size_t count)
+{
+    const size_t size = sizeof(vector2_t<T>);
+    if (in_stride == size && out_stride == size)
+    {
+        run_vector2_loop<Kernel>(arg, in, size, out, size, count);
+    }
+    else
+    {
+        run_vector2_loop<Kernel>(arg, in, in_stride, out, out_stride, count);
+    }
+}
+
+// the kernels take their matrices as row-major arrays of coefficients
+// and accumulate in the same order as transform_coord
+
+template <typename P, typename T>
+struct linear3_kernel
+{
+    P m[9];
+
+    explicit linear3_kernel(const T* r)
+    {
+        for (size_t i = 0; i < 9; ++i) m[i] = P::uniform(r[i]);
+    }
+
+    void operator()(P& x, P& y, P& z) const
+    {
+        P ox = madd(m[2], z, madd(m[1], y, m[0] * x));
+        P oy = madd(m[5], z, madd(m[4], y, m[3] * x));
+        P oz = madd(m[8], z, madd(m[7], y, m[6] * x));
+        x = ox;
+        y = oy;
+        z = oz;
+    }
+};
+
+template <typename P, typename T>
+struct affine2_kernel
+{
+    P m[6];
+
+    explicit affine2_kernel(const T* r)
+    {
+        for (size_t i = 0; i < 6; ++i) m[i] = P::uniform(r[i]);
+    }
+
+    void operator()(P& x, P& y) const
+    {
+        P ox = madd(m[1], y, m[0] * x) + m[2];
+        P oy = madd(m[4], y, m[3] * x) + m[5];
+        x = ox;
+        y = oy;
+    }
+};
+
+template <typename P, typename T>
+struct affine3_kernel
+{
+    P m[12];
+
+    explicit affine3_kernel(const T* r)
+    {
+        for (size_t i = 0; i < 12; ++i) m[i] = P::uniform(r[i]);
+    }
+
+    void operator()(P& x, P& y, P& z) const
+    {
+        P ox = madd(m[2], z, madd(m[1], y, m[0] * x)) + m[3];
+        P oy = madd(m[6], z, madd(m[5], y, m[4] * x)) + m[7];
+        P oz = madd(m[10], z, madd(m[9], y, m[8] * x)) + m[11];
+        x = ox;
+        y = oy;
+        z = oz;
+    }
+};
+
+template <typename P, typename T>
+struct projective3_kernel
+{
+    P m[16];
+
+    explicit projective3_kernel(const T* r)
+    {
+        for (size_t i = 0; i < 16; ++i) m[i] = P::uniform(r[i]);
+    }
+
+    void operator()(P& x, P& y, P& z) const
+    {
+        P w = madd(m[14], z, madd(m[13], y, m[12] * x)) + m[15];
+        P ox = madd(m[2], z, madd(m[1], y, m[0] * x)) + m[3];
+        P oy = madd(m[6], z, madd(m[5], y, m[4] * x)) + m[7];
+        P oz = madd(m[10], z, madd(m[9], y, m[8] * x)) + m[11];
+        x = ox / w;
+        y = oy / w;
+        z = oz / w;
+    }
+};
+
+template <typename T>
+void rows2x3(const matrix2x3_t<T>& m, T* r)
+{
+    r[0] = m.m00; r[1] = m.m01; r[2] = m.m02;
+    r[3] = m.m10; r[4] = m.m11; r[5] = m.m12;
+}
+
+template <typename M>
+void rows3x3(const M& m, typename M::value_type* r)
+{
+    r[0] = m.m00; r[1] = m.m01; r[2] = m.m02;
+    r[3] = m.m10; r[4] = m.m11; r[5] = m.m12;
+    r[6] = m.m20; r[7] = m.m21; r[8] = m.m22;
+}
+
+template <typename M>
+void rows3x4(const M& m, typename M::value_type* r)
+{
+    r[0] = m.m00; r[1] = m.m01; r[2] = m.m02; r[3] = m.m03;
+    r[4] = m.m10; r[5] = m.m11; r[6] = m.m12; r[7] = m.m13;
+    r[8] = m.m20; r[9] = m.m21; r[10] = m.m22; r[11] = m.m23;
+}
+
+template <typename T>
+void rows4x4(const matrix4x4_t<T>& m, T* r)
+{
+    rows3x4(m, r);
+    r[12] = m.m30; r[13] = m.m31; r[14] = m.m32; r[15] = m.m33;
+}
+
+// inverse transpose of the upper 3x3 of m
+template <typename M>
+void normal_rows3x3(const M& m, typename M::value_type* r)
+{
+    typedef typename M::value_type T;
+
+    const T c00 = m.m11 * m.m22 - m.m12 * m.m21;
+    const T c01 = m.m12 * m.m20 - m.m10 * m.m22;
+    const T c02 = m.m10 * m.m21 - m.m11 * m.m20;
+
+    const T det = m.m00 * c00 + m.m01 * c01 + m.m02 * c02;
+    YAMA_ASSERT_WARN(det != 0, "Transforming normals with a singular yama matrix");
+    const T inv_det = T(1) / det;
+
+    r[0] = c00 * inv_det;
+    r[1] = c01 * inv_det;
+    r[2] = c02 * inv_det;
+    r[3] = (m.m02 * m.m21 - m.m01 * m.m22) * inv_det;
+    r[4] = (m.m00 * m.m22 - m.m02 * m.m20) * inv_det;
+    r[5] = (m.m01 * m.m20 - m.m00 * m.m21) * inv_det;
+    r[6] = (m.m01 * m.m12 - m.m02 * m.m11) * inv_det;
+    r[7] = (m.m02 * m.m10 - m.m00 * m.m12) * inv_det;
+    r[8] = (m.m00 * m.m11 - m.m01 * m.m10) * inv_det;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// quaternions in packs
+// q[0], q[1], q[2], q[3] are the x, y, z and w components of P::width
+// quaternions (or vector4_t-s for load4, store4 and dot4)
+
+template <typename P, typename V>
+void load4(const V* ptr, P* q)
+{
+    P::load4(ptr->data(), q[0], q[1], q[2], q[3]);
+}
+
+template <typename P, typename V>
+void store4(V* ptr, const P* q)
+{
+    P::store4(ptr->data(), q[0], q[1], q[2], q[3]);
+}
+
+template <typename P>
+P dot4(const P* a, const P* b)
+{
+    return madd(a[3], b[3], madd(a[2], b[2], madd(a[1], b[1], a[0] * b[0])));
+}
+
+// the same as operator*
+template <typename P>
+void quaternion_multiply(const P* a, const P* b, P* out)
+{
+    const P x = madd(a[3], b[0], a[0] * b[3]) + (a[1] * b[2] - a[2] * b[1]);
+    const P y = madd(a[3], b[1], a[1] * b[3]) + (a[2] * b[0] - a[0] * b[2]);
+    const P z = madd(a[3], b[2], a[2] * b[3]) + (a[0] * b[1] - a[1] * b[0]);
+    const P w = a[3] * b[3] - madd(a[2], b[2], madd(a[1], b[1], a[0] * b[0]));
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+    out[3] = w;
+}
+
+template <typename P>
+void quaternion_normalize(P* q)
+{
+    const P l = sqrt(dot4(q, q));
+    for (size_t c = 0; c < 4; ++c) q[c] = q[c] / l;
+}
+
+// v + w*t + q x t, where t = 2 * q x v
+template <typename P>
+void quaternion_rotate(const P* q, P& x, P& y, P& z)
+{
+    const P two = P::uniform(2);
+    const P tx = (q[1] * z - q[2] * y) * two;
+    const P ty = (q[2] * x - q[0] * z) * two;
+    const P tz = (q[0] * y - q[1] * x) * two;
+    x = madd(q[3], tx, x) + (q[1] * tz - q[2] * ty);
+    y = madd(q[3], ty, y) + (q[2] * tx - q[0] * tz);
+    z = madd(q[3], tz, z) + (q[0] * ty - q[1] * tx);
+}
+
+// a vector3 kernel for a single quaternion, given as x, y, z, w
+template <typename P, typename T>
+struct rotate3_kernel
+{
+    P q[4];
+
+    explicit rotate3_kernel(const T* r)
+    {
+        for (size_t i = 0; i < 4; ++i) q[i] = P::uniform(r[i]);
+    }
+
+    void operator()(P& x, P& y, P& z) const
+    {
+        quaternion_rotate(q, x, y, z);
+    }
+};
+
+// a vector3 kernel for a transform_t, given by its data: scale, rotate, translate
+template <typename P, typename T>
+struct trs3_kernel
+{
+    P t[3], q[4], s[3];
+
+    explicit trs3_kernel(const T* r)
+    {
+        for (size_t i = 0; i < 3; ++i) t[i] = P::uniform(r[i]);
+        for (size_t i = 0; i < 4; ++i) q[i] = P::uniform(r[3 + i]);
+        for (size_t i = 0; i < 3; ++i) s[i] = P::uniform(r[7 + i]);
+    }
+
+    void operator()(P& x, P& y, P& z) const
+    {
+        x = x * s[0];
+        y = y * s[1];
+        z = z * s[2];
+        quaternion_rotate(q, x, y, z);
+        x = x + t[0];
+        y = y + t[1];
+        z = z + t[2];
+    }
+};
+
+// The transforms are gathered into packs, the upper 3x4 of the matrices is
+// computed like in transform_t::to_matrix3x4 and scattered back.
+// M is matrix3x4_t or matrix4x4_t.
+template <typename M>
+struct transform_to_matrix_kernel
+{
+    typedef typename M::value_type T;
+    const transform_t<T>* in;
+    M* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        const size_t w = P::width;
+        const size_t n = transform_t<T>::value_count;
+
+        T buf[n * w];
+        for (size_t k = 0; k < w; ++k)
+        {
+            const T* d = in[i + k].data();
+            for (size_t c = 0; c < n; ++c) buf[c * w + k] = d[c];
+        }
+
+        P q[4], s[3];
+        for (size_t c = 0; c < 4; ++c) q[c] = P::load(buf + (3 + c) * w);
+        for (size_t c = 0; c < 3; ++c) s[c] = P::load(buf + (7 + c) * w);
+
+        const P two = P::uniform(2);
+        const P x2 = q[0] * q[0];
+        const P y2 = q[1] * q[1];
+        const P z2 = q[2] * q[2];
+        const P w2 = q[3] * q[3];
+        const P xy = two * q[0] * q[1];
+        const P xz = two * q[0] * q[2];
+        const P xw = two * q[0] * q[3];
+        const P yz = two * q[1] * q[2];
+        const P yw = two * q[1] * q[3];
+        const P zw = two * q[2] * q[3];
+
+        // the upper 3x3, column by column, over the translation in buf
+        ((w2 + x2 - y2 - z2) * s[0]).store(buf + 3 * w);
+        ((xy + zw) * s[0]).store(buf + 4 * w);
+        ((xz - yw) * s[0]).store(buf + 5 * w);
+        ((xy - zw) * s[1]).store(buf + 6 * w);
+        ((w2 - x2 + y2 - z2) * s[1]).store(buf + 7 * w);
+        ((yz + xw) * s[1]).store(buf + 8 * w);
+        T tail[3 * w];
+        ((xz + yw) * s[2]).store(tail);
+        ((yz - xw) * s[2]).store(tail + w);
+        ((w2 - x2 - y2 + z2) * s[2]).store(tail + 2 * w);
+
+        const size_t rows = M::rows_count;
+        for (size_t k = 0; k < w; ++k)
+        {
+            T* d = out[i + k].data();
+            for (size_t r = 0; r < 3; ++r)
+            {
+                d[r] = buf[(3 + r) * w + k];
+                d[rows + r] = buf[(6 + r) * w + k];
+                d[2 * rows + r] = tail[r * w + k];
+                d[3 * rows + r] = buf[r * w + k];
+            }
+            if (rows == 4)
+            {
+                d[3] = d[7] = d[11] = 0;
+                d[15] = 1;
+            }
+        }
+    }
+};
+
+// the same as internal::quaternion_from_rotation followed by normalize
+// m is a rotation matrix given by rows. All four branches of Shepperd's method
+// are computed and selected per lane. Their results are proportional to the
+// quaternion, so normalizing them needs no other division.
+template <typename P>
+void quaternion_from_rotation(const P* m, P* q)
+{
+    const P one = P::uniform(1);
+    const P d0 = m[7] - m[5];
+    const P d1 = m[2] - m[6];
+    const P d2 = m[3] - m[1];
+    const P p01 = m[1] + m[3];
+    const P p02 = m[2] + m[6];
+    const P p12 = m[5] + m[7];
+
+    // in the reverse order of the scalar branches, so that the first matching one wins
+    q[0] = p02;
+    q[1] = p12;
+    q[2] = one - m[0] - m[4] + m[8];
+    q[3] = d2;
+
+    const P c2 = m[8] - m[4];
+    q[0] = select(q[0], p01, c2);
+    q[1] = select(q[1], one - m[0] + m[4] - m[8], c2);
+    q[2] = select(q[2], p12, c2);
+    q[3] = select(q[3], d1, c2);
+
+    const P c1 = vmax(m[4] - m[0], m[8] - m[0]);
+    q[0] = select(q[0], one + m[0] - m[4] - m[8], c1);
+    q[1] = select(q[1], p01, c1);
+    q[2] = select(q[2], p02, c1);
+    q[3] = select(q[3], d0, c1);
+
+    const P c0 = -(m[0] + m[4] + m[8]);
+    q[0] = select(q[0], d0, c0);
+    q[1] = select(q[1], d1, c0);
+    q[2] = select(q[2], d2, c0);
+    q[3] = select(q[3], one - c0, c0);
+
+    quaternion_normalize(q);
+}
+
+template <typename P>
+void quaternion_nlerp(const P* from, const P* to, P ratio, P* out)
+{
+    const P d = dot4(from, to);
+    for (size_t c = 0; c < 4; ++c)
+    {
+        out[c] = madd(ratio, flip_sign(to[c], d) - from[c], from[c]);
+    }
+    quaternion_normalize(out);
+}
+
+// slerp_series::eval for packs, with xm1 = x - 1
+template <typename P>
+P slerp_weight(P t, P xm1)
+{
+    typedef slerp_series<typename P::value_type> series;
+    const P t2 = t * t;
+    P r = P::uniform(0);
+    for (size_t i = series::terms; i > 0; --i)
+    {
+        const P a = madd(P::uniform(series::u(i)), t2, P::uniform(-series::v(i))) * xm1;
+        r = madd(a, r, a);
+    }
+    return madd(t, r, t);
+}
+
+template <typename P>
+void quaternion_fast_slerp(const P* from, const P* to, P ratio, P* out)
+{
+    const P d = dot4(from, to);
+    const P xm1 = abs(d) - P::uniform(1);
+    const P w0 = slerp_weight(P::uniform(1) - ratio, xm1);
+    const P w1 = flip_sign(slerp_weight(ratio, xm1), d);
+    for (size_t c = 0; c < 4; ++c)
+    {
+        out[c] = madd(to[c], w1, from[c] * w0);
+    }
+}
+
+template <typename T>
+struct quaternion_multiply_kernel
+{
+    const quaternion_t<T>* a;
+    const quaternion_t<T>* b;
+    quaternion_t<T>* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P qa[4], qb[4];
+        load4(a + i, qa);
+        load4(b + i, qb);
+        quaternion_multiply(qa, qb, qa);
+        store4(out + i, qa);
+    }
+};
+
+template <typename T>
+struct quaternion_rotate_kernel
+{
+    const vector3_t<T>* in;
+    const quaternion_t<T>* q;
+    vector3_t<T>* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P pq[4], x, y, z;
+        load4(q + i, pq);
+        P::load3(in[i].data(), x, y, z);
+        quaternion_rotate(pq, x, y, z);
+        P::store3(out[i].data(), x, y, z);
+    }
+};
+
+template <typename T>
+struct quaternion_normalize_kernel
+{
+    const quaternion_t<T>* in;
+    quaternion_t<T>* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P q[4];
+        load4(in + i, q);
+        quaternion_normalize(q);
+        store4(out + i, q);
+    }
+};
+
+template <typename P, typename T>
+struct fast_normalize3_kernel
+{
+    explicit fast_normalize3_kernel(const T*) {}
+
+    void operator()(P& x, P& y, P& z) const
+    {
+        const P r = rsqrt(madd(z, z, madd(y, y, x * x)));
+        x = x * r;
+        y = y * r;
+        z = z * r;
+    }
+};
+
+template <typename T>
+struct rsqrt_length3_kernel
+{
+    const vector3_t<T>* in;
+    T* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P x, y, z;
+        P::load3(in[i].data(), x, y, z);
+        rsqrt(madd(z, z, madd(y, y, x * x))).store(out + i);
+    }
+};
+
+// V is vector4_t or quaternion_t
+template <typename V>
+struct fast_normalize4_kernel
+{
+    const V* in;
+    V* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P v[4];
+        load4(in + i, v);
+        const P r = rsqrt(dot4(v, v));
+        for (size_t c = 0; c < 4; ++c) v[c] = v[c] * r;
+        store4(out + i, v);
+    }
+};
+
+template <typename V>
+struct rsqrt_length4_kernel
+{
+    const V* in;
+    typename V::value_type* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P v[4];
+        load4(in + i, v);
+        rsqrt(dot4(v, v)).store(out + i);
+    }
+};
+
+template <typename V>
+void fast_normalize4(const V* in, V* out, size_t count)
+{
+    const fast_normalize4_kernel<V> k = { in, out };
+    run_kernel<typename V::value_type>(k, count);
+}
+
+template <typename V>
+void rsqrt_length4(const V* in, typename V::value_type* out, size_t count)
+{
+    const rsqrt_length4_kernel<V> k = { in, out };
+    run_kernel<typename V::value_type>(k, count);
+}
+
+// Fast selects quaternion_fast_slerp over quaternion_nlerp
+template <typename T, bool Fast>
+struct quaternion_interpolate_kernel
+{
+    const quaternion_t<T>* from;
+    const quaternion_t<T>* to;
+    T ratio;
+    quaternion_t<T>* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P a[4], b[4];
+        load4(from + i, a);
+        load4(to + i, b);
+        if (Fast) quaternion_fast_slerp(a, b, P::uniform(ratio), a);
+        else quaternion_nlerp(a, b, P::uniform(ratio), a);
+        store4(out + i, a);
+    }
+};
+
+
+// Decomposes matrices without shear in packs, like the orthogonal branch of
+// internal::decompose_linear. Lanes with shear or singular matrices are
+// redone with the scalar decompose.
+// M is matrix3x4_t or matrix4x4_t.
+template <typename M>
+struct decompose_kernel
+{
+    typedef typename M::value_type T;
+    const M* in;
+    transform_t<T>* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        const size_t w = P::width;
+        const size_t rows = M::rows_count;
+
+        // the upper 3x4 of the matrices, column by column
+        T buf[12 * w];
+        for (size_t k = 0; k < w; ++k)
+        {
+            const T* d = in[i + k].data();
+            for (size_t c = 0; c < 4; ++c)
+            {
+                for (size_t r = 0; r < 3; ++r) buf[(3 * c + r) * w + k] = d[c * rows + r];
+            }
+        }
+
+        P c[12];
+        for (size_t e = 0; e < 12; ++e) c[e] = P::load(buf + e * w);
+
+        const P l0 = sqrt(madd(c[2], c[2], madd(c[1], c[1], c[0] * c[0])));
+        const P l1 = sqrt(madd(c[5], c[5], madd(c[4], c[4], c[3] * c[3])));
+        const P l2 = sqrt(madd(c[8], c[8], madd(c[7], c[7], c[6] * c[6])));
+        const P d01 = madd(c[2], c[5], madd(c[1], c[4], c[0] * c[3]));
+        const P d02 = madd(c[2], c[8], madd(c[1], c[7], c[0] * c[6]));
+        const P d12 = madd(c[5], c[8], madd(c[4], c[7], c[3] * c[6]));
+        const P det =
+            c[0] * (c[4] * c[8] - c[5] * c[7]) +
+            c[1] * (c[5] * c[6] - c[3] * c[8]) +
+            c[2] * (c[3] * c[7] - c[4] * c[6]);
+
+        // non-negative in the lanes which the packs handle
+        const P tol = P::uniform(decompose_tolerance<T>());
+        const P volume = l0 * l1 * l2;
+        P ok = vmin(tol * l0 * l1 - abs(d01), tol * l0 * l2 - abs(d02));
+        ok = vmin(ok, tol * l1 * l2 - abs(d12));
+        ok = vmin(ok, abs(det) - tol * volume);
+        ok = vmin(ok, abs(det) - P::uniform(std::numeric_limits<T>::min()));
+        const unsigned packed = ge_mask(ok, P::uniform(0));
+
+        // reflections become a rotation with negative scale
+        const P s0 = flip_sign(l0, det);
+        const P s1 = flip_sign(l1, det);
+        const P s2 = flip_sign(l2, det);
+        const P i0 = P::uniform(1) / s0;
+        const P i1 = P::uniform(1) / s1;
+        const P i2 = P::uniform(1) / s2;
+
+        // the rotation by rows
+        const P r[9] = {
+            c[0] * i0, c[3] * i1, c[6] * i2,
+            c[1] * i0, c[4] * i1, c[7] * i2,
+            c[2] * i0, c[5] * i1, c[8] * i2,
+        };
+        P q[4];
+        quaternion_from_rotation(r, q);
+
+        // in the order of transform_t
+        T tbuf[10 * w];
+        for (size_t e = 0; e < 3; ++e) c[9 + e].store(tbuf + e * w);
+        for (size_t e = 0; e < 4; ++e) q[e].store(tbuf + (3 + e) * w);
+        s0.store(tbuf + 7 * w);
+        s1.store(tbuf + 8 * w);
+        s2.store(tbuf + 9 * w);
+
+        for (size_t k = 0; k < w; ++k)
+        {
+            if (packed & (1u << k))
+            {
+                T* d = out[i + k].data();
+                for (size_t e = 0; e < 10; ++e) d[e] = tbuf[e * w + k];
+            }
+            else
+            {
+                out[i + k] = decompose(in[i + k]);
+            }
+        }
+    }
+};
+
+// Op selects the function: 0 sincos, 1 sin, 2 cos, 3 acos
+template <typename T, int Op>
+struct trig_kernel
+{
+    const T* in;
+    T* out;
+    T* out_cos;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        const P x = P::load(in + i);
+        if (Op == 0)
+        {
+            P s, c;
+            sincos(x, s, c);
+            s.store(out + i);
+            c.store(out_cos + i);
+        }
+        else if (Op == 1) sin(x).store(out + i);
+        else if (Op == 2) cos(x).store(out + i);
+        else acos(x).store(out + i);
+    }
+};
+
+// Axis is 0, 1 or 2 for rotation_x, rotation_y and rotation_z and 3 for rotation_naxis
+template <typename T, int Axis>
+struct quaternion_rotation_kernel
+{
+    const T* radians;
+    vector3_t<T> axis;
+    quaternion_t<T>* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P q[4];
+        sincos(P::load(radians + i) * P::uniform(T(0.5)), q[0], q[3]);
+        if (Axis == 3)
+        {
+            q[2] = q[0] * P::uniform(axis.z);
+            q[1] = q[0] * P::uniform(axis.y);
+            q[0] = q[0] * P::uniform(axis.x);
+        }
+        else
+        {
+            q[Axis] = q[0];
+            for (int c = 0; c < 3; ++c) if (c != Axis) q[c] = P::uniform(0);
+        }
+        store4(out + i, q);
+    }
+};
+
+// The sines and cosines are computed in packs and the matrices are built
+// from them one by one with the *_sincos builders.
+template <typename M, int Axis>
+struct matrix_rotation_kernel
+{
+    typedef typename M::value_type T;
+    const T* radians;
+    vector3_t<T> axis;
+    M* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P s, c;
+        sincos(P::load(radians + i), s, c);
+        T sb[P::width], cb[P::width];
+        s.store(sb);
+        c.store(cb);
+        for (size_t k = 0; k < P::width; ++k)
+        {
+            switch (Axis)
+            {
+            case 0: out[i + k] = M::rotation_x_sincos(sb[k], cb[k]); break;
+            case 1: out[i + k] = M::rotation_y_sincos(sb[k], cb[k]); break;
+            case 2: out[i + k] = M::rotation_z_sincos(sb[k], cb[k]); break;
+            default: out[i + k] = M::rotation_naxis_sincos(axis, sb[k], cb[k]);
+            }
+        }
+    }
+};
+
+template <int Axis, typename T>
+void rotations(const vector3_t<T>& axis, const T* radians, quaternion_t<T>* out, size_t count)
+{
+    const quaternion_rotation_kernel<T, Axis> k = { radians, axis, out };
+    run_kernel<T>(k, count);
+}
+
+template <int Axis, typename M>
+void rotations(const vector3_t<typename M::value_type>& axis, const typename M::value_type* radians, M* out, size_t count)
+{
+    const matrix_rotation_kernel<M, Axis> k = { radians, axis, out };
+    run_kernel<typename M::value_type>(k, count);
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// points
+// same as transform_coord for every element
+
+template <typename T>
+void transform_coords(const matrix3x4_t<T>& m, const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    T r[12];
+    internal::rows3x4(m, r);
+    internal::run_vector3_kernel<internal::affine3_kernel>(r, in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void transform_coords(const matrix3x4_t<T>& m, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    transform_coords(m, in, sizeof(vector3_t<T>), out, sizeof(vector3_t<T>), count);
+}
+
+template <typename T>
+void transform_coords(const matrix3x3_t<T>& m, const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    T r[9];
+    internal::rows3x3(m, r);
+    internal::run_vector3_kernel<internal::linear3_kernel>(r, in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void transform_coords(const matrix3x3_t<T>& m, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    transform_coords(m, in, sizeof(vector3_t<T>), out, sizeof(vector3_t<T>), count);
+}
+
+namespace internal
+{
+
+template <typename V>
+void transform_coords4x4(const matrix4x4_t<typename V::value_type>& m, const V* in, size_t in_stride, V* out, size_t out_stride, size_t count)
+{
+    typedef typename V::value_type T;
+    T r[16];
+    rows4x4(m, r);
+
+    if (m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1)
+    {
+        // affine: w is always 1, so skip the divide
+        run_vector3_kernel<affine3_kernel>(r, in, in_stride, out, out_stride, count);
+    }
+    else
+    {
+        run_vector3_kernel<projective3_kernel>(r, in, in_stride, out, out_stride, count);
+    }
+}
+
+}
+
+template <typename T>
+void transform_coords(const matrix4x4_t<T>& m, const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    internal::transform_coords4x4(m, in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void transform_coords(const matrix4x4_t<T>& m, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    transform_coords(m, in, sizeof(vector3_t<T>), out, sizeof(vector3_t<T>), count);
+}
+
+// 2D points, for example the corners of sprites
+template <typename T>
+void transform_coords(const matrix2x3_t<T>& m, const vector2_t<T>* in, size_t in_stride, vector2_t<T>* out, size_t out_stride, size_t count)
+{
+    T r[6];
+    internal::rows2x3(m, r);
+    internal::run_vector2_kernel<internal::affine2_kernel>(r, in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void transform_coords(const matrix2x3_t<T>& m, const vector2_t<T>* in, vector2_t<T>* out, size_t count)
+{
+    transform_coords(m, in, sizeof(vector2_t<T>), out, sizeof(vector2_t<T>), count);
+}
+
+// the same as transform_coord(v, tr): scale, rotation and translation without building a matrix
+template <typename T>
+void transform_coords(const transform_t<T>& tr, const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    YAMA_ASSERT_BAD(tr.orientation.is_normalized(), "rotation with a non-normalized quaternion");
+    internal::run_vector3_kernel<internal::trs3_kernel>(tr.data(), in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void transform_coords(const transform_t<T>& tr, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    transform_coords(tr, in, sizeof(vector3_t<T>), out, sizeof(vector3_t<T>), count);
+}
+
+// arrays of padded vectors, see aligned.hpp
+template <typename T>
+void transform_coords(const matrix3x4_t<T>& m, const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    T r[12];
+    internal::rows3x4(m, r);
+    internal::run_vector3_kernel<internal::affine3_kernel>(r, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename T>
+void transform_coords(const matrix3x3_t<T>& m, const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    T r[9];
+    internal::rows3x3(m, r);
+    internal::run_vector3_kernel<internal::linear3_kernel>(r, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename T>
+void transform_coords(const matrix4x4_t<T>& m, const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    internal::transform_coords4x4(m, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename T>
+void transform_coords(const transform_t<T>& tr, const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    YAMA_ASSERT_BAD(tr.orientation.is_normalized(), "rotation with a non-normalized quaternion");
+    internal::run_vector3_kernel<internal::trs3_kernel>(tr.data(), in, sizeof(*in), out, sizeof(*out), count);
+}
+
+// any of the above with views, for example the positions of interleaved vertices
+template <typename M, typename In, typename Out>
+void transform_coords(const M& m, const strided_span<In>& in, const strided_span<Out>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::transform_coords of spans with different sizes");
+    transform_coords(m, in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// directions
+// only the upper 3x3 of the matrix is applied: no translation and no projection
+
+template <typename M>
+void transform_directions(const M& m, const vector3_t<typename M::value_type>* in, size_t in_stride, vector3_t<typename M::value_type>* out, size_t out_stride, size_t count)
+{
+    static_assert(is_matrix<M>::value, "yama::transform_directions needs a yama matrix");
+    typename M::value_type r[9];
+    internal::rows3x3(m, r);
+    internal::run_vector3_kernel<internal::linear3_kernel>(r, in, in_stride, out, out_stride, count);
+}
+
+template <typename M>
+void transform_directions(const M& m, const vector3_t<typename M::value_type>* in, vector3_t<typename M::value_type>* out, size_t count)
+{
+    transform_directions(m, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename M>
+void transform_directions(const M& m, const vector3a_t<typename M::value_type>* in, vector3a_t<typename M::value_type>* out, size_t count)
+{
+    static_assert(is_matrix<M>::value, "yama::transform_directions needs a yama matrix");
+    typename M::value_type r[9];
+    internal::rows3x3(m, r);
+    internal::run_vector3_kernel<internal::linear3_kernel>(r, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename M, typename In, typename Out>
+void transform_directions(const M& m, const strided_span<In>& in, const strided_span<Out>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::transform_directions of spans with different sizes");
+    transform_directions(m, in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// normals
+// The inverse transpose of the upper 3x3 of the matrix is computed once and
+// applied to every element, so normals stay perpendicular to their surfaces
+// under non-uniform scaling. The results are not renormalized.
+
+template <typename M>
+void transform_normals(const M& m, const vector3_t<typename M::value_type>* in, size_t in_stride, vector3_t<typename M::value_type>* out, size_t out_stride, size_t count)
+{
+    static_assert(is_matrix<M>::value, "yama::transform_normals needs a yama matrix");
+    typename M::value_type r[9];
+    internal::normal_rows3x3(m, r);
+    internal::run_vector3_kernel<internal::linear3_kernel>(r, in, in_stride, out, out_stride, count);
+}
+
+template <typename M>
+void transform_normals(const M& m, const vector3_t<typename M::value_type>* in, vector3_t<typename M::value_type>* out, size_t count)
+{
+    transform_normals(m, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename M>
+void transform_normals(const M& m, const vector3a_t<typename M::value_type>* in, vector3a_t<typename M::value_type>* out, size_t count)
+{
+    static_assert(is_matrix<M>::value, "yama::transform_normals needs a yama matrix");
+    typename M::value_type r[9];
+    internal::normal_rows3x3(m, r);
+    internal::run_vector3_kernel<internal::linear3_kernel>(r, in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename M, typename In, typename Out>
+void transform_normals(const M& m, const strided_span<In>& in, const strided_span<Out>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::transform_normals of spans with different sizes");
+    transform_normals(m, in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// reciprocal lengths
+// the same as rsqrt_length and fast_normalize for every element
+// See internal::rsqrt for the precision and for zero-length elements.
+
+template <typename T>
+void rsqrt_length(const vector3_t<T>* in, T* out, size_t count)
+{
+    const internal::rsqrt_length3_kernel<T> k = { in, out };
+    internal::run_kernel<T>(k, count);
+}
+
+template <typename T>
+void rsqrt_length(const vector4_t<T>* in, T* out, size_t count)
+{
+    internal::rsqrt_length4(in, out, count);
+}
+
+template <typename T>
+void rsqrt_length(const quaternion_t<T>* in, T* out, size_t count)
+{
+    internal::rsqrt_length4(in, out, count);
+}
+
+template <typename T>
+void fast_normalize(const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    internal::run_vector3_kernel<internal::fast_normalize3_kernel>(static_cast<const T*>(nullptr), in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void fast_normalize(const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    fast_normalize(in, sizeof(vector3_t<T>), out, sizeof(vector3_t<T>), count);
+}
+
+template <typename T>
+void fast_normalize(const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    internal::run_vector3_kernel<internal::fast_normalize3_kernel>(static_cast<const T*>(nullptr), in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename In, typename Out>
+void fast_normalize(const strided_span<In>& in, const strided_span<Out>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::fast_normalize of spans with different sizes");
+    fast_normalize(in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+template <typename T>
+void fast_normalize(const vector4_t<T>* in, vector4_t<T>* out, size_t count)
+{
+    internal::fast_normalize4(in, out, count);
+}
+
+template <typename T>
+void fast_normalize(const quaternion_t<T>* in, quaternion_t<T>* out, size_t count)
+{
+    internal::fast_normalize4(in, out, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// trigonometry
+// For float these are the polynomials from simd.hpp. See there for the error
+// bounds. For double they are the same as the functions from <cmath>.
+
+template <typename T>
+void fast_sincos(const T* radians, T* out_sin, T* out_cos, size_t count)
+{
+    const internal::trig_kernel<T, 0> k = { radians, out_sin, out_cos };
+    internal::run_kernel<T>(k, count);
+}
+
+template <typename T>
+void fast_sin(const T* radians, T* out, size_t count)
+{
+    const internal::trig_kernel<T, 1> k = { radians, out, nullptr };
+    internal::run_kernel<T>(k, count);
+}
+
+template <typename T>
+void fast_cos(const T* radians, T* out, size_t count)
+{
+    const internal::trig_kernel<T, 2> k = { radians, out, nullptr };
+    internal::run_kernel<T>(k, count);
+}
+
+// the input is clamped to [-1, 1]
+template <typename T>
+void fast_acos(const T* in, T* out, size_t count)
+{
+    const internal::trig_kernel<T, 3> k = { in, out, nullptr };
+    internal::run_kernel<T>(k, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// rotations from angles
+// out[i] = R::rotation_x(radians[i]) and so on, where R is quaternion_t,
+// matrix3x4_t or matrix4x4_t. The sines and cosines come from fast_sincos.
+
+template <typename R>
+void rotation_x(const typename R::value_type* radians, R* out, size_t count)
+{
+    internal::rotations<0>(vector3_t<typename R::value_type>::zero(), radians, out, count);
+}
+
+template <typename R>
+void rotation_y(const typename R::value_type* radians, R* out, size_t count)
+{
+    internal::rotations<1>(vector3_t<typename R::value_type>::zero(), radians, out, count);
+}
+
+template <typename R>
+void rotation_z(const typename R::value_type* radians, R* out, size_t count)
+{
+    internal::rotations<2>(vector3_t<typename R::value_type>::zero(), radians, out, count);
+}
+
+// for when you're sure that the axis is normalized
+template <typename R>
+void rotation_naxis(const vector3_t<typename R::value_type>& axis, const typename R::value_type* radians, R* out, size_t count)
+{
+    YAMA_ASSERT_BAD(axis.is_normalized(), "rotation axis should be normalized");
+    internal::rotations<3>(axis, radians, out, count);
+}
+
+template <typename R>
+void rotation_axis(const vector3_t<typename R::value_type>& axis, const typename R::value_type* radians, R* out, size_t count)
+{
+    rotation_naxis(normalize(axis), radians, out, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// quaternions
+// The quaternions are expected to be normalized. The results may differ from
+// the single-element functions in the last bits, as the packs accumulate in a
+// different order.
+
+// the same as rotate(v, q) for every element
+template <typename T>
+void rotate(const quaternion_t<T>& q, const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+    internal::run_vector3_kernel<internal::rotate3_kernel>(q.data(), in, in_stride, out, out_stride, count);
+}
+
+template <typename T>
+void rotate(const quaternion_t<T>& q, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    rotate(q, in, sizeof(vector3_t<T>), out, sizeof(vector3_t<T>), count);
+}
+
+template <typename T>
+void rotate(const quaternion_t<T>& q, const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+    internal::run_vector3_kernel<internal::rotate3_kernel>(q.data(), in, sizeof(*in), out, sizeof(*out), count);
+}
+
+template <typename T, typename In>
+void rotate(const quaternion_t<T>& q, const strided_span<In>& in, const strided_span<vector3_t<T>>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::rotate of spans with different sizes");
+    rotate(q, in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+// out[i] = rotate(in[i], q[i])
+template <typename T>
+void rotate(const quaternion_t<T>* q, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    const internal::quaternion_rotate_kernel<T> k = { in, q, out };
+    internal::run_kernel<T>(k, count);
+}
+
+// out[i] = a[i] * b[i]
+// out may be a or b
+template <typename T>
+void multiply(const quaternion_t<T>* a, const quaternion_t<T>* b, quaternion_t<T>* out, size_t count)
+{
+    const internal::quaternion_multiply_kernel<T> k = { a, b, out };
+    internal::run_kernel<T>(k, count);
+}
+
+// zero-length quaternions produce non-finite values
+template <typename T>
+void normalize(const quaternion_t<T>* in, quaternion_t<T>* out, size_t count)
+{
+    const internal::quaternion_normalize_kernel<T> k = { in, out };
+    internal::run_kernel<T>(k, count);
+}
+
+// out[i] = nlerp(from[i], to[i], ratio)
+template <typename T>
+void nlerp(const quaternion_t<T>* from, const quaternion_t<T>* to, const T& ratio, quaternion_t<T>* out, size_t count)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    const internal::quaternion_interpolate_kernel<T, false> k = { from, to, ratio, out };
+    internal::run_kernel<T>(k, count);
+}
+
+// out[i] = fast_slerp(from[i], to[i], ratio)
+template <typename T>
+void fast_slerp(const quaternion_t<T>* from, const quaternion_t<T>* to, const T& ratio, quaternion_t<T>* out, size_t count)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    const internal::quaternion_interpolate_kernel<T, true> k = { from, to, ratio, out };
+    internal::run_kernel<T>(k, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// transforms
+// out[i] = in[i].to_matrix3x4() and in[i].to_matrix4x4()
+
+template <typename T>
+void to_matrix3x4(const transform_t<T>* in, matrix3x4_t<T>* out, size_t count)
+{
+    const internal::transform_to_matrix_kernel<matrix3x4_t<T>> k = { in, out };
+    internal::run_kernel<T>(k, count);
+}
+
+template <typename T>
+void to_matrix4x4(const transform_t<T>* in, matrix4x4_t<T>* out, size_t count)
+{
+    const internal::transform_to_matrix_kernel<matrix4x4_t<T>> k = { in, out };
+    internal::run_kernel<T>(k, count);
+}
+
+// out[i] = decompose(in[i]), where in is matrix3x4_t or matrix4x4_t
+// out must not overlap in
+template <typename M>
+void decompose(const M* in, transform_t<typename M::value_type>* out, size_t count)
+{
+    const internal::decompose_kernel<M> k = { in, out };
+    internal::run_kernel<typename M::value_type>(k, count);
+}
+
+
+#if YAMA_THREADS
+
+///////////////////////////////////////////////////////////////////////////////
+// parallel overloads
+// The same as the functions above with the elements split between the
+// threads of pool. M and the element types are the ones of the overloads
+// above.
+
+namespace internal
+{
+
+// elements per chunk boundary, smaller arrays are transformed by one thread
+const size_t batch_granularity = 1024;
+
+template <typename F>
+void parallel_batch(parallel::thread_pool& pool, size_t count, const F& f)
+{
+    parallel::for_each_chunk(pool, count, batch_granularity, f);
+}
+
+}
+
+#define YAMA_PARALLEL_TRANSFORM(name) \
+    template <typename M, typename V> \
+    void name(parallel::thread_pool& pool, const M& m, const V* in, size_t in_stride, V* out, size_t out_stride, size_t count) \
+    { \
+        internal::parallel_batch(pool, count, [&](size_t first, size_t n) { \
+            name(m, internal::byte_offset(in, first * in_stride), in_stride, internal::byte_offset(out, first * out_stride), out_stride, n); \
+        }); \
+    } \
+    template <typename M, typename V> \
+    void name(parallel::thread_pool& pool, const M& m, const V* in, V* out, size_t count) \
+    { \
+        internal::parallel_batch(pool, count, [&](size_t first, size_t n) { \
+            name(m, in + first, out + first, n); \
+        }); \
+    } \
+    template <typename M, typename In, typename Out> \
+    void name(parallel::thread_pool& pool, const M& m, const strided_span<In>& in, const strided_span<Out>& out) \
+    { \
+        YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::" #name " of spans with different sizes"); \
+        name(pool, m, in.data(), in.stride(), out.data(), out.stride(), in.size()); \
+    }
+
+YAMA_PARALLEL_TRANSFORM(transform_coords)
+YAMA_PARALLEL_TRANSFORM(transform_directions)
+YAMA_PARALLEL_TRANSFORM(transform_normals)
+
+#undef YAMA_PARALLEL_TRANSFORM
+
+template <typename V>
+void fast_normalize(parallel::thread_pool& pool, const V* in, size_t in_stride, V* out, size_t out_stride, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        fast_normalize(internal::byte_offset(in, first * in_stride), in_stride, internal::byte_offset(out, first * out_stride), out_stride, n);
+    });
+}
+
+template <typename V>
+void fast_normalize(parallel::thread_pool& pool, const V* in, V* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        fast_normalize(in + first, out + first, n);
+    });
+}
+
+template <typename In, typename Out>
+void fast_normalize(parallel::thread_pool& pool, const strided_span<In>& in, const strided_span<Out>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::fast_normalize of spans with different sizes");
+    fast_normalize(pool, in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+template <typename T>
+void rotate(parallel::thread_pool& pool, const quaternion_t<T>& q, const vector3_t<T>* in, size_t in_stride, vector3_t<T>* out, size_t out_stride, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        rotate(q, internal::byte_offset(in, first * in_stride), in_stride, internal::byte_offset(out, first * out_stride), out_stride, n);
+    });
+}
+
+template <typename T>
+void rotate(parallel::thread_pool& pool, const quaternion_t<T>& q, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        rotate(q, in + first, out + first, n);
+    });
+}
+
+template <typename T>
+void rotate(parallel::thread_pool& pool, const quaternion_t<T>& q, const vector3a_t<T>* in, vector3a_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        rotate(q, in + first, out + first, n);
+    });
+}
+
+template <typename T, typename In>
+void rotate(parallel::thread_pool& pool, const quaternion_t<T>& q, const strided_span<In>& in, const strided_span<vector3_t<T>>& out)
+{
+    YAMA_ASSERT_CRIT(in.size() == out.size(), "yama::rotate of spans with different sizes");
+    rotate(pool, q, in.data(), in.stride(), out.data(), out.stride(), in.size());
+}
+
+template <typename T>
+void rotate(parallel::thread_pool& pool, const quaternion_t<T>* q, const vector3_t<T>* in, vector3_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        rotate(q + first, in + first, out + first, n);
+    });
+}
+
+template <typename T>
+void multiply(parallel::thread_pool& pool, const quaternion_t<T>* a, const quaternion_t<T>* b, quaternion_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        multiply(a + first, b + first, out + first, n);
+    });
+}
+
+template <typename T>
+void normalize(parallel::thread_pool& pool, const quaternion_t<T>* in, quaternion_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        normalize(in + first, out + first, n);
+    });
+}
+
+template <typename T>
+void nlerp(parallel::thread_pool& pool, const quaternion_t<T>* from, const quaternion_t<T>* to, const T& ratio, quaternion_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        nlerp(from + first, to + first, ratio, out + first, n);
+    });
+}
+
+template <typename T>
+void fast_slerp(parallel::thread_pool& pool, const quaternion_t<T>* from, const quaternion_t<T>* to, const T& ratio, quaternion_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        fast_slerp(from + first, to + first, ratio, out + first, n);
+    });
+}
+
+template <typename T>
+void to_matrix3x4(parallel::thread_pool& pool, const transform_t<T>* in, matrix3x4_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        to_matrix3x4(in + first, out + first, n);
+    });
+}
+
+template <typename T>
+void to_matrix4x4(parallel::thread_pool& pool, const transform_t<T>* in, matrix4x4_t<T>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        to_matrix4x4(in + first, out + first, n);
+    });
+}
+
+template <typename M>
+void decompose(parallel::thread_pool& pool, const M* in, transform_t<typename M::value_type>* out, size_t count)
+{
+    internal::parallel_batch(pool, count, [&](size_t first, size_t n) {
+        decompose(in + first, out + first, n);
+    });
+}
+
+#endif
+
+}
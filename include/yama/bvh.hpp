@@ -0,0 +1,1043 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Bounding volume hierarchies
+// bvh_t is built from the bounding boxes of primitives (triangles, points or
+// anything else with bounds). Primitives are identified by their index in
+// the array of boxes given to build.
+//
+// The nodes are 4-wide: every node holds the boxes of up to four children as
+// six streams, so a query tests all of them at once with SIMD. A child is an
+// inner node, a leaf with up to four primitives, or empty. The nodes are in a
+// single flat array with every node after its parent, and the primitives of
+// every leaf are contiguous in primitives().
+//
+// The build uses the surface area heuristic, evaluated on binned centroids.
+// The ranges of up to 4096 primitives are built as independent subtrees. With
+// YAMA_THREADS the build and refit overloads which take a parallel::thread_pool
+// split the subtrees between the threads of the pool. All builds give the same
+// tree.
+//
+// refit recomputes the boxes for moved primitives, keeping the structure.
+// Its cost is linear, and the quality of the tree slowly degrades as the
+// primitives move away from their initial positions.
+//
+// The queries call a function for the primitives of the leaves they reach.
+// The ray and nearest point queries visit the children closest first and skip
+// the ones farther than the best hit so far. The sphere and frustum queries
+// are broad: they report the primitives in the leaves whose boxes overlap the
+// volume, which are a superset of the primitives overlapping it.
+
+#include "vector3.hpp"
+#include "aabb.hpp"
+#include "frustum.hpp"
+#include "ray.hpp"
+#include "simd.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace yama
+{
+
+template <typename T>
+struct bvh_node_t
+{
+    typedef T value_type;
+
+    static constexpr size_t width = 4;
+
+    // the boxes of the children: min x, y, z, max x, y, z
+    value_type bounds[6][width];
+
+    // inner children: child is the index of the node and count is 0
+    // leaves: the primitives are [child, child + count) of bvh_t::primitives()
+    // empty slots: child and count are 0 and the box is empty
+    uint32_t child[width];
+    uint32_t count[width];
+
+    static bvh_node_t empty()
+    {
+        bvh_node_t ret;
+        for (size_t s = 0; s < width; ++s)
+        {
+            ret.set(s, aabb_t<value_type>::empty(), 0, 0);
+        }
+        return ret;
+    }
+
+    bool is_leaf(size_t s) const { return count[s] != 0; }
+    bool is_inner(size_t s) const { return count[s] == 0 && child[s] != 0; }
+
+    // a bitmask of the non-empty slots
+    unsigned occupied() const
+    {
+        unsigned bits = 0;
+        for (size_t s = 0; s < width; ++s)
+        {
+            if (child[s] | count[s]) bits |= 1u << s;
+        }
+        return bits;
+    }
+
+    aabb_t<value_type> box(size_t s) const
+    {
+        return aabb_t<value_type>::from_min_max(
+            vector3_t<value_type>::coord(bounds[0][s], bounds[1][s], bounds[2][s]),
+            vector3_t<value_type>::coord(bounds[3][s], bounds[4][s], bounds[5][s])
+        );
+    }
+
+    void set_box(size_t s, const aabb_t<value_type>& b)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            bounds[c][s] = b.min.at(c);
+            bounds[c + 3][s] = b.max.at(c);
+        }
+    }
+
+    void set(size_t s, const aabb_t<value_type>& b, uint32_t ch, uint32_t cnt)
+    {
+        set_box(s, b);
+        child[s] = ch;
+        count[s] = cnt;
+    }
+
+    // the box of all children
+    aabb_t<value_type> union_box() const
+    {
+        auto ret = aabb_t<value_type>::empty();
+        for (size_t s = 0; s < width; ++s)
+        {
+            ret.merge(box(s));
+        }
+        return ret;
+    }
+};
+
+template <typename T>
+constexpr size_t bvh_node_t<T>::width;
+
+namespace internal
+{
+
+// the pack for the four children of a node
+template <typename T>
+struct bvh_pack
+{
+    typedef scalar_pack<T> type;
+};
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+template <>
+struct bvh_pack<float>
+{
+    typedef float4_sse type;
+};
+#endif
+
+// smaller ranges are leaves, larger ones have a bin per primitive up to bvh_bin_count
+constexpr size_t bvh_bin_count = 16;
+constexpr size_t bvh_max_leaf_size = 4;
+
+// deeper ranges are split at the median, which bounds the depth of the tree
+// and the size of the traversal stacks: three siblings left per level, and
+// room for the four children of the deepest node
+constexpr size_t bvh_max_sah_depth = 48;
+constexpr size_t bvh_stack_size = 3 * (bvh_max_sah_depth + 32) + 4;
+
+// smaller ranges are built as independent subtrees
+constexpr size_t bvh_task_size = 4096;
+
+// larger ranges are binned in parallel by build_parallel
+constexpr size_t bvh_parallel_bin_size = 65536;
+
+template <typename T>
+struct bvh_ref
+{
+    aabb_t<T> box;
+    uint32_t id;
+
+    // twice the centroid, the scale doesn't matter for binning
+    T centroid(size_t c) const { return box.min.at(c) + box.max.at(c); }
+};
+
+template <typename T>
+struct bvh_range
+{
+    size_t begin, end;
+    aabb_t<T> box;
+    aabb_t<T> centroids;
+    size_t depth;
+
+    size_t size() const { return end - begin; }
+};
+
+// a subtree built separately, to be linked to slot of node
+template <typename T>
+struct bvh_task
+{
+    bvh_range<T> range;
+    uint32_t node;
+    uint32_t slot;
+};
+
+template <typename T>
+struct bvh_bins
+{
+    aabb_t<T> box[3][bvh_bin_count];
+    size_t count[3][bvh_bin_count];
+
+    void clear(size_t bin_count)
+    {
+        for (size_t a = 0; a < 3; ++a)
+        {
+            for (size_t k = 0; k < bin_count; ++k)
+            {
+                box[a][k] = aabb_t<T>::empty();
+                count[a][k] = 0;
+            }
+        }
+    }
+
+    void merge(const bvh_bins& b, size_t bin_count)
+    {
+        for (size_t a = 0; a < 3; ++a)
+        {
+            for (size_t k = 0; k < bin_count; ++k)
+            {
+                box[a][k].merge(b.box[a][k]);
+                count[a][k] += b.count[a][k];
+            }
+        }
+    }
+};
+
+// maps centroids to bins, the same way for binning and partitioning
+template <typename T>
+struct bvh_binning
+{
+    T offset[3], scale[3];
+    size_t count;
+
+    bvh_binning(const aabb_t<T>& centroids, size_t size)
+        : count(size < bvh_bin_count ? size : bvh_bin_count)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const T extent = centroids.max.at(c) - centroids.min.at(c);
+            offset[c] = centroids.min.at(c);
+            scale[c] = extent > 0 ? T(count) * (T(1) - 4 * std::numeric_limits<T>::epsilon()) / extent : T(0);
+        }
+    }
+
+    size_t bin(const bvh_ref<T>& r, size_t c) const
+    {
+        const size_t k = size_t((r.centroid(c) - offset[c]) * scale[c]);
+        return k < count ? k : count - 1;
+    }
+};
+
+template <typename T>
+class bvh_builder
+{
+public:
+    typedef bvh_node_t<T> node;
+
+    // with a pool, large ranges are binned on its threads
+    bvh_builder(bvh_ref<T>* refs, parallel::thread_pool* pool)
+        : m_refs(refs)
+        , m_pool(pool)
+    {}
+
+    // the bounds of [begin, end)
+    void range_bounds(bvh_range<T>& r) const
+    {
+        r.box = r.centroids = aabb_t<T>::empty();
+        for (size_t i = r.begin; i < r.end; ++i)
+        {
+            const auto& ref = m_refs[i];
+            r.box.merge(ref.box);
+            r.centroids.merge(vector3_t<T>::coord(ref.centroid(0), ref.centroid(1), ref.centroid(2)));
+        }
+    }
+
+    // builds the subtree of the range, with its root at the end of nodes
+    // If tasks isn't null, the inner children with up to bvh_task_size
+    // primitives are left for separate builds: the slots linking to them
+    // have their boxes set, and child and count 0.
+    void build(const bvh_range<T>& root, std::vector<node>& nodes, std::vector<bvh_task<T>>* tasks) const
+    {
+        std::vector<std::pair<uint32_t, bvh_range<T>>> stack;
+        stack.push_back(std::make_pair(uint32_t(nodes.size()), root));
+        nodes.push_back(node::empty());
+
+        while (!stack.empty())
+        {
+            const auto item = stack.back();
+            stack.pop_back();
+
+            bvh_range<T> children[node::width];
+            bool leaves[node::width];
+            const size_t n = split_node(item.second, children, leaves);
+            for (size_t s = 0; s < n; ++s)
+            {
+                const auto& c = children[s];
+                if (leaves[s])
+                {
+                    nodes[item.first].set(s, c.box, uint32_t(c.begin), uint32_t(c.size()));
+                }
+                else if (tasks && c.size() <= bvh_task_size)
+                {
+                    nodes[item.first].set(s, c.box, 0, 0);
+                    const bvh_task<T> task = { c, item.first, uint32_t(s) };
+                    tasks->push_back(task);
+                }
+                else
+                {
+                    const uint32_t index = uint32_t(nodes.size());
+                    nodes.push_back(node::empty());
+                    nodes[item.first].set(s, c.box, index, 0);
+                    stack.push_back(std::make_pair(index, c));
+                }
+            }
+        }
+    }
+
+private:
+    // Splits the range into up to four children, always splitting the one with
+    // the largest area. Returns the number of children.
+    size_t split_node(const bvh_range<T>& r, bvh_range<T>* children, bool* leaves) const
+    {
+        bool tried[node::width] = {};
+        children[0] = r;
+        leaves[0] = false;
+        size_t n = 1;
+        while (n < node::width)
+        {
+            size_t best = n;
+            T best_area = -1;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const T area = children[i].box.surface_area();
+                if (!tried[i] && area > best_area)
+                {
+                    best = i;
+                    best_area = area;
+                }
+            }
+            if (best == n) break;
+
+            bvh_range<T> left, right;
+            tried[best] = true;
+            if (!split(children[best], left, right))
+            {
+                leaves[best] = true;
+                continue;
+            }
+
+            // keep the children in the order of their primitives
+            for (size_t i = n; i > best + 1; --i)
+            {
+                children[i] = children[i - 1];
+                tried[i] = tried[i - 1];
+                leaves[i] = leaves[i - 1];
+            }
+            children[best] = left;
+            children[best + 1] = right;
+            tried[best] = tried[best + 1] = false;
+            leaves[best] = leaves[best + 1] = false;
+            ++n;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (children[i].size() <= bvh_max_leaf_size) leaves[i] = true;
+        }
+        return n;
+    }
+
+    // partitions the range, returns false if it should be a leaf
+    bool split(const bvh_range<T>& r, bvh_range<T>& left, bvh_range<T>& right) const
+    {
+        const size_t n = r.size();
+        if (n <= bvh_max_leaf_size) return false;
+
+        const bool degenerate = r.centroids.min == r.centroids.max;
+        if (degenerate || r.depth >= bvh_max_sah_depth)
+        {
+            median_split(r, left, right);
+            return true;
+        }
+
+        const bvh_binning<T> binning(r.centroids, n);
+        bvh_bins<T> bins;
+        bin(r, binning, bins);
+        const size_t bin_count = binning.count;
+
+        // sweep from both sides: the cost of splitting before bin k
+        T best_cost = std::numeric_limits<T>::max();
+        size_t best_axis = 0, best_k = 0;
+        for (size_t a = 0; a < 3; ++a)
+        {
+            T right_cost[bvh_bin_count];
+            auto box = aabb_t<T>::empty();
+            size_t count = 0;
+            for (size_t k = bin_count - 1; k > 0; --k)
+            {
+                box.merge(bins.box[a][k]);
+                count += bins.count[a][k];
+                right_cost[k] = count ? box.surface_area() * T(count) : std::numeric_limits<T>::max();
+            }
+
+            box = aabb_t<T>::empty();
+            count = 0;
+            for (size_t k = 1; k < bin_count; ++k)
+            {
+                box.merge(bins.box[a][k - 1]);
+                count += bins.count[a][k - 1];
+                if (!count || count == n) continue;
+                const T cost = box.surface_area() * T(count) + right_cost[k];
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = a;
+                    best_k = k;
+                }
+            }
+        }
+
+        if (best_k == 0)
+        {
+            // no bin boundary separates the centroids
+            median_split(r, left, right);
+            return true;
+        }
+
+        // partition, collecting the centroid bounds of both sides on the way
+        left.box = left.centroids = right.box = right.centroids = aabb_t<T>::empty();
+        size_t mid = r.begin, end = r.end;
+        while (mid < end)
+        {
+            auto& ref = m_refs[mid];
+            const auto c = vector3_t<T>::coord(ref.centroid(0), ref.centroid(1), ref.centroid(2));
+            if (binning.bin(ref, best_axis) < best_k)
+            {
+                left.centroids.merge(c);
+                ++mid;
+            }
+            else
+            {
+                right.centroids.merge(c);
+                std::swap(ref, m_refs[--end]);
+            }
+        }
+
+        left.begin = r.begin;
+        left.end = right.begin = mid;
+        right.end = r.end;
+        left.depth = right.depth = r.depth + 1;
+        for (size_t k = 0; k < bin_count; ++k)
+        {
+            (k < best_k ? left : right).box.merge(bins.box[best_axis][k]);
+        }
+        YAMA_ASSERT_BAD(left.size() && right.size(), "yama::bvh_t empty split");
+        return true;
+    }
+
+    // halves the range along the longest axis of its centroids
+    void median_split(const bvh_range<T>& r, bvh_range<T>& left, bvh_range<T>& right) const
+    {
+        const auto extent = r.centroids.size();
+        const size_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+        const size_t mid = r.begin + r.size() / 2;
+        std::nth_element(m_refs + r.begin, m_refs + mid, m_refs + r.end, [axis](const bvh_ref<T>& a, const bvh_ref<T>& b) {
+            return a.centroid(axis) < b.centroid(axis);
+        });
+
+        left.begin = r.begin;
+        left.end = right.begin = mid;
+        right.end = r.end;
+        left.depth = right.depth = r.depth + 1;
+        range_bounds(left);
+        range_bounds(right);
+    }
+
+    void bin(const bvh_range<T>& r, const bvh_binning<T>& binning, bvh_bins<T>& bins) const
+    {
+#if YAMA_THREADS
+        if (m_pool && r.size() >= bvh_parallel_bin_size)
+        {
+            // the bins of every piece of the range, merged in order
+            const size_t piece = bvh_parallel_bin_size / 4;
+            std::vector<bvh_bins<T>> partial((r.size() + piece - 1) / piece);
+            parallel::for_each_chunk(*m_pool, r.size(), piece, [&](size_t first, size_t count) {
+                for (size_t p = first; p < first + count; p += piece)
+                {
+                    auto& b = partial[p / piece];
+                    b.clear(binning.count);
+                    const size_t begin = r.begin + p;
+                    bin_range(begin, std::min(begin + piece, r.end), binning, b);
+                }
+            });
+
+            bins.clear(binning.count);
+            for (const auto& b : partial)
+            {
+                bins.merge(b, binning.count);
+            }
+            return;
+        }
+#endif
+        bins.clear(binning.count);
+        bin_range(r.begin, r.end, binning, bins);
+    }
+
+    void bin_range(size_t begin, size_t end, const bvh_binning<T>& binning, bvh_bins<T>& bins) const
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto& ref = m_refs[i];
+            for (size_t a = 0; a < 3; ++a)
+            {
+                const size_t k = binning.bin(ref, a);
+                bins.box[a][k].merge(ref.box);
+                ++bins.count[a][k];
+            }
+        }
+    }
+
+    bvh_ref<T>* m_refs;
+    parallel::thread_pool* m_pool;
+};
+
+// a child to visit and its distance
+template <typename T>
+struct bvh_entry
+{
+    uint32_t child;
+    uint32_t count;
+    T key;
+};
+
+// pushes the children in bits, with the smallest key on top
+template <typename T>
+size_t bvh_push_sorted(bvh_entry<T>* stack, size_t top, const bvh_node_t<T>& node, unsigned bits, const T* keys)
+{
+    YAMA_ASSERT_CRIT(top + bvh_node_t<T>::width <= bvh_stack_size, "yama::bvh_t traversal stack overflow");
+    const size_t first = top;
+    for (size_t s = 0; s < bvh_node_t<T>::width; ++s)
+    {
+        if (!((bits >> s) & 1)) continue;
+        const bvh_entry<T> e = { node.child[s], node.count[s], keys[s] };
+        size_t i = top++;
+        for (; i > first && stack[i - 1].key < e.key; --i)
+        {
+            stack[i] = stack[i - 1];
+        }
+        stack[i] = e;
+    }
+    return top;
+}
+
+// a ray broadcast to packs, with the near and far planes chosen by its direction
+template <typename T>
+struct bvh_ray
+{
+    typedef typename bvh_pack<T>::type Q;
+
+    Q o[3], inv[3];
+    size_t near_planes[3], far_planes[3];
+
+    explicit bvh_ray(const ray_t<T>& r)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const bool negative = r.inv_direction.at(c) < 0;
+            near_planes[c] = negative ? c + 3 : c;
+            far_planes[c] = negative ? c : c + 3;
+            o[c] = Q::uniform(r.origin.at(c));
+            inv[c] = Q::uniform(r.inv_direction.at(c));
+        }
+    }
+
+    // the slab test of ray.hpp for the children, with their entry distances in t
+    unsigned test(const bvh_node_t<T>& node, const T& t_max, T* t) const
+    {
+        unsigned bits = 0;
+        for (size_t l = 0; l < bvh_node_t<T>::width; l += Q::width)
+        {
+            Q t0 = Q::uniform(0), t1 = Q::uniform(t_max);
+            for (size_t c = 0; c < 3; ++c)
+            {
+                t0 = vmax((Q::load(node.bounds[near_planes[c]] + l) - o[c]) * inv[c], t0);
+                t1 = vmin((Q::load(node.bounds[far_planes[c]] + l) - o[c]) * inv[c], t1);
+            }
+            t0.store(t + l);
+            bits |= ge_mask(t1, t0) << l;
+        }
+        return bits & node.occupied();
+    }
+};
+
+// the squared distances from a point to the boxes of the children
+template <typename T>
+void bvh_distances_sq(const bvh_node_t<T>& node, const vector3_t<T>& p, T* out)
+{
+    typedef typename bvh_pack<T>::type Q;
+    const Q zero = Q::uniform(0);
+    for (size_t l = 0; l < bvh_node_t<T>::width; l += Q::width)
+    {
+        Q d = zero;
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const Q v = Q::uniform(p.at(c));
+            const Q e = vmax(vmax(Q::load(node.bounds[c] + l) - v, v - Q::load(node.bounds[c + 3] + l)), zero);
+            d = madd(e, e, d);
+        }
+        d.store(out + l);
+    }
+}
+
+}
+
+template <typename T>
+class bvh_t
+{
+public:
+    typedef T value_type;
+    typedef bvh_node_t<T> node_type;
+    typedef size_t size_type;
+
+    static constexpr size_type no_primitive = size_type(-1);
+
+    bvh_t()
+        : m_top_node_count(0)
+    {}
+
+    bvh_t(const aabb_t<value_type>* bounds, size_type count)
+        : m_top_node_count(0)
+    {
+        build(bounds, count);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // build
+    void build(const aabb_t<value_type>* bounds, size_type count)
+    {
+        build_impl(bounds, count, nullptr);
+    }
+
+#if YAMA_THREADS
+    // the subtrees and the binning of large ranges split between the threads of pool
+    void build(parallel::thread_pool& pool, const aabb_t<value_type>* bounds, size_type count)
+    {
+        build_impl(bounds, count, &pool);
+    }
+
+    // the same on a pool of thread_count threads, started for the call
+    // thread_count 0 means one thread per hardware thread
+    void build_parallel(const aabb_t<value_type>* bounds, size_type count, size_type thread_count = 0)
+    {
+        parallel::thread_pool pool(thread_count);
+        build(pool, bounds, count);
+    }
+#endif
+
+    // bounds has the new boxes of all primitives, in the order given to build
+    void refit(const aabb_t<value_type>* bounds)
+    {
+        refit_nodes(bounds, 0, m_nodes.size());
+    }
+
+#if YAMA_THREADS
+    // the subtrees are refit on the threads of pool, then the nodes above them
+    void refit(parallel::thread_pool& pool, const aabb_t<value_type>* bounds)
+    {
+        parallel::for_each_chunk(pool, m_subtrees.size(), 1, [this, bounds](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i)
+            {
+                refit_nodes(bounds, m_subtrees[i].first, m_subtrees[i].second);
+            }
+        });
+        refit_nodes(bounds, 0, m_top_node_count);
+    }
+
+    // the same on a pool of thread_count threads, started for the call
+    // thread_count 0 means one thread per hardware thread
+    void refit_parallel(const aabb_t<value_type>* bounds, size_type thread_count = 0)
+    {
+        parallel::thread_pool pool(thread_count);
+        refit(pool, bounds);
+    }
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    // structure
+    size_type size() const { return m_primitives.size(); }
+    bool empty() const { return m_primitives.empty(); }
+
+    // the root is the first node
+    size_type node_count() const { return m_nodes.size(); }
+    const node_type* nodes() const { return m_nodes.data(); }
+
+    // the primitive indices in the order of the leaves
+    const uint32_t* primitives() const { return m_primitives.data(); }
+
+    aabb_t<value_type> bounds() const
+    {
+        return m_nodes.empty() ? aabb_t<value_type>::empty() : m_nodes[0].union_box();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // queries
+
+    // f(primitive, t_max) tests the primitive against the ray and returns
+    // true if it hits closer than t_max, updating t_max to the distance
+    // returns whether f has returned true for any primitive
+    template <typename F>
+    bool raycast(const ray_t<value_type>& r, value_type& t_max, const F& f) const
+    {
+        if (m_nodes.empty()) return false;
+
+        const internal::bvh_ray<value_type> rp(r);
+        internal::bvh_entry<value_type> stack[internal::bvh_stack_size];
+        size_t top = 0;
+        stack[top++] = internal::bvh_entry<value_type>{ 0, 0, value_type(0) };
+
+        bool hit = false;
+        while (top)
+        {
+            const auto e = stack[--top];
+            if (e.key > t_max) continue;
+            if (e.count)
+            {
+                for (uint32_t i = e.child; i < e.child + e.count; ++i)
+                {
+                    if (f(size_type(m_primitives[i]), t_max)) hit = true;
+                }
+                continue;
+            }
+
+            const auto& nd = m_nodes[e.child];
+            value_type t[node_type::width];
+            const unsigned bits = rp.test(nd, t_max, t);
+            top = internal::bvh_push_sorted(stack, top, nd, bits, t);
+        }
+        return hit;
+    }
+
+    // f(primitive) returns the squared distance from p to the primitive
+    // distance_sq is the squared search radius on input and the squared
+    // distance to the nearest primitive on output
+    // returns the nearest primitive, or no_primitive if none is within the radius
+    template <typename F>
+    size_type nearest(const vector3_t<value_type>& p, value_type& distance_sq, const F& f) const
+    {
+        size_type ret = no_primitive;
+        if (m_nodes.empty()) return ret;
+
+        internal::bvh_entry<value_type> stack[internal::bvh_stack_size];
+        size_t top = 0;
+        stack[top++] = internal::bvh_entry<value_type>{ 0, 0, value_type(0) };
+
+        while (top)
+        {
+            const auto e = stack[--top];
+            if (e.key > distance_sq) continue;
+            if (e.count)
+            {
+                for (uint32_t i = e.child; i < e.child + e.count; ++i)
+                {
+                    const value_type d = f(size_type(m_primitives[i]));
+                    if (d < distance_sq)
+                    {
+                        distance_sq = d;
+                        ret = m_primitives[i];
+                    }
+                }
+                continue;
+            }
+
+            const auto& nd = m_nodes[e.child];
+            value_type d[node_type::width];
+            internal::bvh_distances_sq(nd, p, d);
+            unsigned bits = 0;
+            for (size_t s = 0; s < node_type::width; ++s)
+            {
+                bits |= unsigned(d[s] <= distance_sq) << s;
+            }
+            top = internal::bvh_push_sorted(stack, top, nd, bits & nd.occupied(), d);
+        }
+        return ret;
+    }
+
+    // calls f(primitive) for the primitives of the leaves overlapping the sphere
+    template <typename F>
+    void overlap_sphere(const vector3_t<value_type>& center, const value_type& radius, const F& f) const
+    {
+        if (m_nodes.empty()) return;
+
+        const value_type r2 = radius * radius;
+        uint32_t stack[internal::bvh_stack_size];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top)
+        {
+            const auto& nd = m_nodes[stack[--top]];
+            YAMA_ASSERT_CRIT(top + node_type::width <= internal::bvh_stack_size, "yama::bvh_t traversal stack overflow");
+            value_type d[node_type::width];
+            internal::bvh_distances_sq(nd, center, d);
+            for (size_t s = 0; s < node_type::width; ++s)
+            {
+                if (d[s] > r2 || !(nd.child[s] | nd.count[s])) continue;
+                if (nd.count[s]) report(nd.child[s], nd.count[s], f);
+                else stack[top++] = nd.child[s];
+            }
+        }
+    }
+
+    // calls f(primitive) for the primitives of the leaves visible in the frustum
+    // Subtrees entirely inside of the frustum are reported without tests.
+    template <typename F>
+    void overlap_frustum(const frustum_t<value_type>& fr, const F& f) const
+    {
+        if (m_nodes.empty()) return;
+
+        typedef typename internal::bvh_pack<value_type>::type Q;
+        const internal::frustum_packs<Q> planes(fr);
+        const Q half = Q::uniform(value_type(0.5)), zero = Q::uniform(0);
+
+        uint32_t stack[internal::bvh_stack_size];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top)
+        {
+            const auto& nd = m_nodes[stack[--top]];
+            YAMA_ASSERT_CRIT(top + node_type::width <= internal::bvh_stack_size, "yama::bvh_t traversal stack overflow");
+
+            // the smallest distances of the boxes from the planes: of their
+            // farthest corners for visibility, of their nearest for containment
+            unsigned visible = 0, inside = 0;
+            for (size_t l = 0; l < node_type::width; l += Q::width)
+            {
+                const Q x0 = Q::load(nd.bounds[0] + l), y0 = Q::load(nd.bounds[1] + l), z0 = Q::load(nd.bounds[2] + l);
+                const Q x1 = Q::load(nd.bounds[3] + l), y1 = Q::load(nd.bounds[4] + l), z1 = Q::load(nd.bounds[5] + l);
+                const Q cx = (x0 + x1) * half, cy = (y0 + y1) * half, cz = (z0 + z1) * half;
+                const Q ex = (x1 - x0) * half, ey = (y1 - y0) * half, ez = (z1 - z0) * half;
+
+                Q far_d = zero, near_d = zero;
+                for (size_t p = 0; p < frustum_t<value_type>::plane_count; ++p)
+                {
+                    const Q r = madd(planes.ax[p], ex, madd(planes.ay[p], ey, planes.az[p] * ez));
+                    const Q d = planes.distance(p, cx, cy, cz);
+                    far_d = p ? vmin(far_d, d + r) : d + r;
+                    near_d = p ? vmin(near_d, d - r) : d - r;
+                }
+                visible |= ge_mask(far_d, zero) << l;
+                inside |= ge_mask(near_d, zero) << l;
+            }
+
+            visible &= nd.occupied();
+            for (size_t s = 0; s < node_type::width; ++s)
+            {
+                if (!((visible >> s) & 1)) continue;
+                if ((inside >> s) & 1) report_subtree(nd.child[s], nd.count[s], f);
+                else if (nd.count[s]) report(nd.child[s], nd.count[s], f);
+                else stack[top++] = nd.child[s];
+            }
+        }
+    }
+
+private:
+    // pool is null for the serial build
+    void build_impl(const aabb_t<value_type>* bounds, size_type count, parallel::thread_pool* pool)
+    {
+        YAMA_ASSERT_CRIT(count < size_type(std::numeric_limits<uint32_t>::max()), "yama::bvh_t too many primitives");
+        m_nodes.clear();
+        m_subtrees.clear();
+        m_primitives.resize(count);
+        m_top_node_count = 0;
+        if (!count) return;
+
+        std::vector<internal::bvh_ref<value_type>> refs(count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            refs[i].box = bounds[i];
+            refs[i].id = uint32_t(i);
+        }
+
+        const internal::bvh_builder<value_type> builder(refs.data(), pool);
+        internal::bvh_range<value_type> root;
+        root.begin = 0;
+        root.end = count;
+        root.depth = 0;
+        builder.range_bounds(root);
+
+        // the top of the tree, then the subtrees, then link them
+        std::vector<internal::bvh_task<value_type>> tasks;
+        builder.build(root, m_nodes, &tasks);
+        m_top_node_count = m_nodes.size();
+
+        std::vector<std::vector<node_type>> subtrees(tasks.size());
+        auto build_tasks = [&](size_t first, size_t n) {
+            for (size_t i = first; i < first + n; ++i)
+            {
+                builder.build(tasks[i].range, subtrees[i], nullptr);
+            }
+        };
+#if YAMA_THREADS
+        if (pool)
+        {
+            parallel::for_each_chunk(*pool, tasks.size(), 1, build_tasks);
+        }
+        else
+#endif
+        {
+            build_tasks(0, tasks.size());
+        }
+
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            const uint32_t offset = uint32_t(m_nodes.size());
+            m_nodes[tasks[i].node].child[tasks[i].slot] = offset;
+            for (auto nd : subtrees[i])
+            {
+                for (size_t s = 0; s < node_type::width; ++s)
+                {
+                    if (nd.is_inner(s)) nd.child[s] += offset;
+                }
+                m_nodes.push_back(nd);
+            }
+            m_subtrees.push_back(std::make_pair(size_type(offset), m_nodes.size()));
+        }
+
+        for (size_type i = 0; i < count; ++i)
+        {
+            m_primitives[i] = refs[i].id;
+        }
+    }
+
+    // the children come after their parents, so the nodes are refit backwards
+    void refit_nodes(const aabb_t<value_type>* bounds, size_type begin, size_type end)
+    {
+        for (size_type i = end; i-- > begin; )
+        {
+            auto& nd = m_nodes[i];
+            for (size_t s = 0; s < node_type::width; ++s)
+            {
+                if (nd.is_leaf(s))
+                {
+                    auto b = aabb_t<value_type>::empty();
+                    for (uint32_t p = nd.child[s]; p < nd.child[s] + nd.count[s]; ++p)
+                    {
+                        b.merge(bounds[m_primitives[p]]);
+                    }
+                    nd.set_box(s, b);
+                }
+                else if (nd.is_inner(s))
+                {
+                    nd.set_box(s, m_nodes[nd.child[s]].union_box());
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    void report(uint32_t first, uint32_t count, const F& f) const
+    {
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            f(size_type(m_primitives[i]));
+        }
+    }
+
+    // all primitives under a child
+    template <typename F>
+    void report_subtree(uint32_t child, uint32_t count, const F& f) const
+    {
+        if (count)
+        {
+            report(child, count, f);
+            return;
+        }
+
+        uint32_t stack[internal::bvh_stack_size];
+        size_t top = 0;
+        stack[top++] = child;
+        while (top)
+        {
+            const auto& nd = m_nodes[stack[--top]];
+            YAMA_ASSERT_CRIT(top + node_type::width <= internal::bvh_stack_size, "yama::bvh_t traversal stack overflow");
+            for (size_t s = 0; s < node_type::width; ++s)
+            {
+                if (nd.is_leaf(s)) report(nd.child[s], nd.count[s], f);
+                else if (nd.is_inner(s)) stack[top++] = nd.child[s];
+            }
+        }
+    }
+
+    std::vector<node_type> m_nodes;
+    std::vector<uint32_t> m_primitives;
+
+    // the nodes [0, m_top_node_count) are above the subtrees built separately
+    // which are the node ranges in m_subtrees
+    size_type m_top_node_count;
+    std::vector<std::pair<size_type, size_type>> m_subtrees;
+};
+
+template <typename T>
+constexpr typename bvh_t<T>::size_type bvh_t<T>::no_primitive;
+
+// the boxes of the triangles of an indexed mesh, for building or refitting a bvh_t
+template <typename T, typename Index>
+void triangle_bounds(const vector3_t<T>* vertices, const Index* indices, size_t triangle_count, aabb_t<T>* out)
+{
+    for (size_t i = 0; i < triangle_count; ++i)
+    {
+        auto b = aabb_t<T>::from_point(vertices[indices[i * 3]]);
+        b.merge(vertices[indices[i * 3 + 1]]);
+        b.merge(vertices[indices[i * 3 + 2]]);
+        out[i] = b;
+    }
+}
+
+// the nearest hit of the ray with a mesh whose triangles were given to the bvh
+template <typename T, typename Index>
+ray_hit_t<T> intersect(const ray_t<T>& r, const bvh_t<T>& bvh, const vector3_t<T>* vertices, const Index* indices,
+    const T& t_max = std::numeric_limits<T>::max())
+{
+    auto hit = ray_hit_t<T>::none(t_max);
+    bvh.raycast(r, hit.t, [&](size_t tri, T& t) {
+        T ht, u, v;
+        if (!intersect(r, vertices[indices[tri * 3]], vertices[indices[tri * 3 + 1]], vertices[indices[tri * 3 + 2]], ht, u, v, t)) return false;
+        t = ht;
+        hit.u = u;
+        hit.v = v;
+        hit.triangle = tri;
+        return true;
+    });
+    return hit;
+}
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef bvh_t<preferred_type> bvh;
+
+#endif
+
+}
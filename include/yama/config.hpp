@@ -13,3 +13,29 @@
 #   define YAMA_HAS_CXX14 0
 #endif
 
+
+// SIMD backend
+// Opt-in. Define YAMA_SIMD to one of the levels below before including yama
+// (and make sure the compiler is allowed to emit the instructions, for
+// example with -msse2, -mavx, -mavx2 -mfma, or
+// -mavx512f -mavx512vl -mavx512dq -mavx512bw -mavx2 -mfma). The level must be
+// the same in all translation units (dispatch.hpp describes the exception).
+// Only float instantiations are affected. The scalar templates are always
+// available and stay the reference implementation.
+#define YAMA_SIMD_NONE 0
+#define YAMA_SIMD_SSE2 1
+#define YAMA_SIMD_AVX 2
+#define YAMA_SIMD_AVX2 3 // AVX2 and FMA3
+#define YAMA_SIMD_AVX512 4 // AVX-512 F, VL, DQ and BW (Skylake-X and later), AVX2 and FMA3
+
+#if !defined(YAMA_SIMD)
+#   define YAMA_SIMD YAMA_SIMD_NONE
+#endif
+
+// Multithreading
+// Opt-in. Define YAMA_THREADS to 1 to enable the functions which split their
+// work between threads (and link with the platform's thread library, for
+// example with -pthread). They use std::thread.
+#if !defined(YAMA_THREADS)
+#   define YAMA_THREADS 0
+#endif
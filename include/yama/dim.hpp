@@ -10,12 +10,22 @@
 #include "vector2.hpp"
 #include "vector3.hpp"
 #include "vector4.hpp"
+#include "vector.hpp"
 
 namespace yama
 {
 
+// dimensions without a named vector type fall back to the generic vector_t
 template <size_t D>
-struct dim {};
+struct dim
+{
+    template <typename T>
+    using vector_t = yama::vector_t<T, D>;
+
+#if !defined(YAMA_NO_SHORTHAND)
+    typedef vectorn<D> vector;
+#endif
+};
 
 template <>
 struct dim<2>
@@ -0,0 +1,150 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Runtime dispatch of float batch kernels
+// The rest of yama is header-only and its SIMD level is fixed at compile time
+// by YAMA_SIMD. The functions here are the optional compiled part of the
+// library, in src/: the same kernels are built once for each instruction set
+// (each with its own YAMA_SIMD and compiler flags), and every call goes through
+// the table of the instruction set selected at startup: the best one which
+// the CPU supports, unless forced by force_isa or by the environment variable
+// YAMA_DISPATCH_ISA (with the name of an instruction set, as from isa_name).
+//
+// The kernels are the batch functions of the same name in batch.hpp and
+// frustum.hpp, and give the same results as they do when compiled with the
+// YAMA_SIMD level of the active instruction set.
+//
+// Build src/CMakeLists.txt (the target yama-dispatch), or compile
+// src/dispatch.cpp and src/dispatch_scalar.cpp with the flags of the
+// application, and on x86 src/dispatch_sse2.cpp, src/dispatch_avx2.cpp and
+// src/dispatch_avx512.cpp with the flags enabling their instruction sets.
+// Each of them renames the yama namespace, so their different YAMA_SIMD
+// levels don't violate the one definition rule.
+//
+// The application itself can include this header with any YAMA_SIMD level.
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yama
+{
+
+template <typename T>
+class vector3_t;
+
+template <typename T>
+class vector4_t;
+
+template <typename T>
+class quaternion_t;
+
+template <typename T>
+class matrix3x4_t;
+
+template <typename T>
+class matrix4x4_t;
+
+template <typename T>
+class frustum_t;
+
+template <typename T>
+class vector3_soa_t;
+
+template <typename T>
+class vector4_soa_t;
+
+namespace dispatch
+{
+
+// instruction sets, from the slowest
+enum isa_t
+{
+    isa_scalar,
+    isa_sse2,
+    isa_avx2, // AVX2 and FMA3
+    isa_avx512, // AVX-512 F, VL, DQ and BW, AVX2 and FMA3
+    isa_count,
+};
+
+// "scalar", "sse2", "avx2" or "avx512"
+const char* isa_name(isa_t isa);
+
+// true if the kernels for the instruction set are compiled and the CPU supports it
+bool is_supported(isa_t isa);
+
+// the best supported instruction set
+isa_t detected_isa();
+
+// the instruction set of the kernels in use
+isa_t active_isa();
+
+// Uses the kernels of isa from now on. Returns false and keeps the active
+// ones if it isn't supported. Meant for testing and benchmarks: calls running
+// in other threads at the same time may use either.
+bool force_isa(isa_t isa);
+
+// back to the detected instruction set, ignoring YAMA_DISPATCH_ISA
+void reset_isa();
+
+// transforms
+void transform_coords(const matrix4x4_t<float>& m, const vector3_t<float>* in, vector3_t<float>* out, size_t count);
+void transform_coords(const matrix3x4_t<float>& m, const vector3_t<float>* in, vector3_t<float>* out, size_t count);
+void transform_directions(const matrix4x4_t<float>& m, const vector3_t<float>* in, vector3_t<float>* out, size_t count);
+
+// normalization
+void fast_normalize(const vector3_t<float>* in, vector3_t<float>* out, size_t count);
+void normalize(const quaternion_t<float>* in, quaternion_t<float>* out, size_t count);
+
+// quaternions
+void multiply(const quaternion_t<float>* a, const quaternion_t<float>* b, quaternion_t<float>* out, size_t count);
+void rotate(const quaternion_t<float>& q, const vector3_t<float>* in, vector3_t<float>* out, size_t count);
+void nlerp(const quaternion_t<float>* from, const quaternion_t<float>* to, float ratio, quaternion_t<float>* out, size_t count);
+
+// culling
+void cull_spheres(const frustum_t<float>& f, const vector4_soa_t<float>& spheres, uint32_t* out);
+void cull_aabbs(const frustum_t<float>& f, const vector3_soa_t<float>& mins, const vector3_soa_t<float>& maxs, uint32_t* out);
+
+}
+
+namespace internal
+{
+
+// The kernels of one instruction set. The objects are passed as pointers to
+// their components: the kernels see them as the types of their own renamed
+// namespace, which have the same layout.
+struct dispatch_kernels
+{
+    dispatch::isa_t isa;
+
+    void (*transform_coords_4x4)(const float* m, const float* in, float* out, size_t count);
+    void (*transform_coords_3x4)(const float* m, const float* in, float* out, size_t count);
+    void (*transform_directions_4x4)(const float* m, const float* in, float* out, size_t count);
+
+    void (*fast_normalize3)(const float* in, float* out, size_t count);
+    void (*normalize_quaternions)(const float* in, float* out, size_t count);
+
+    void (*multiply_quaternions)(const float* a, const float* b, float* out, size_t count);
+    void (*rotate)(const float* q, const float* in, float* out, size_t count);
+    void (*nlerp)(const float* from, const float* to, float ratio, float* out, size_t count);
+
+    void (*cull_spheres)(const float* planes, const void* spheres, uint32_t* out);
+    void (*cull_aabbs)(const float* planes, const void* mins, const void* maxs, uint32_t* out);
+};
+
+// defined by src/dispatch_<isa>.cpp
+const dispatch_kernels& dispatch_kernels_scalar();
+const dispatch_kernels& dispatch_kernels_sse2();
+const dispatch_kernels& dispatch_kernels_avx2();
+const dispatch_kernels& dispatch_kernels_avx512();
+
+}
+
+}
@@ -0,0 +1,288 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Dual quaternions
+// A unit dual quaternion real + e*dual is a rigid transformation: the
+// rotation real followed by the translation t, where dual = (t, 0) * real / 2.
+// Like with matrices a*b applies b first and then a.
+
+#include "quaternion.hpp"
+#include "matrix3x4.hpp"
+
+namespace yama
+{
+
+template <typename T>
+class dual_quaternion_t
+{
+public:
+    quaternion_t<T> real, dual;
+
+    typedef T value_type;
+    typedef size_t size_type;
+
+    static constexpr size_type value_count = 8;
+
+    constexpr size_type max_size() const { return value_count; }
+    constexpr size_type size() const { return max_size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // named constructors
+    static constexpr dual_quaternion_t real_dual(const quaternion_t<value_type>& real, const quaternion_t<value_type>& dual)
+    {
+        return{ real, dual };
+    }
+
+    static constexpr dual_quaternion_t identity()
+    {
+        return real_dual(quaternion_t<value_type>::identity(), quaternion_t<value_type>::zero());
+    }
+
+    static constexpr dual_quaternion_t zero()
+    {
+        return real_dual(quaternion_t<value_type>::zero(), quaternion_t<value_type>::zero());
+    }
+
+    static dual_quaternion_t from_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_CRIT(ptr, "Constructing yama::dual_quaternion_t from nullptr");
+        return real_dual(quaternion_t<value_type>::from_ptr(ptr), quaternion_t<value_type>::from_ptr(ptr + 4));
+    }
+
+    static dual_quaternion_t rotation(const quaternion_t<value_type>& q)
+    {
+        YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+        return real_dual(q, quaternion_t<value_type>::zero());
+    }
+
+    static constexpr dual_quaternion_t translation(const vector3_t<value_type>& t)
+    {
+        return real_dual(quaternion_t<value_type>::identity(), quaternion_t<value_type>::xyzw(t.x / 2, t.y / 2, t.z / 2, 0));
+    }
+
+    static dual_quaternion_t translation(const value_type& x, const value_type& y, const value_type& z)
+    {
+        return translation(vector3_t<value_type>::coord(x, y, z));
+    }
+
+    // rotation, followed by translation
+    static dual_quaternion_t rotation_translation(const quaternion_t<value_type>& q, const vector3_t<value_type>& t)
+    {
+        YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+        const auto tq = quaternion_t<value_type>::xyzw(t.x, t.y, t.z, 0);
+        return real_dual(q, tq * q * value_type(0.5));
+    }
+
+    // the matrix should be a rotation and a translation only
+    static dual_quaternion_t from_matrix(const matrix3x4_t<value_type>& m)
+    {
+        YAMA_ASSERT_WARN(close(m.m00*m.m00 + m.m10*m.m10 + m.m20*m.m20, value_type(1), value_type(0.001)), "yama::dual_quaternion_t from a matrix with scaling");
+        YAMA_ASSERT_WARN(close(m.m01*m.m01 + m.m11*m.m11 + m.m21*m.m21, value_type(1), value_type(0.001)), "yama::dual_quaternion_t from a matrix with scaling");
+        YAMA_ASSERT_WARN(close(m.m02*m.m02 + m.m12*m.m12 + m.m22*m.m22, value_type(1), value_type(0.001)), "yama::dual_quaternion_t from a matrix with scaling");
+
+        auto q = internal::quaternion_from_rotation(
+            m.m00, m.m01, m.m02,
+            m.m10, m.m11, m.m12,
+            m.m20, m.m21, m.m22
+        );
+        q.normalize();
+        return rotation_translation(q, vector3_t<value_type>::coord(m.m03, m.m13, m.m23));
+    }
+
+    ///////////////////////////
+    // attach
+    static dual_quaternion_t* attach_to_array(value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::dual_quaternion_t to nullptr");
+        return reinterpret_cast<dual_quaternion_t*>(ptr);
+    }
+
+    static const dual_quaternion_t* attach_to_array(const value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::dual_quaternion_t to nullptr");
+        return reinterpret_cast<const dual_quaternion_t*>(ptr);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // access
+    value_type* data()
+    {
+        return reinterpret_cast<value_type*>(this);
+    }
+
+    constexpr const value_type* data() const
+    {
+        return reinterpret_cast<const value_type*>(this);
+    }
+
+    vector3_t<value_type> translation_vector() const
+    {
+        // the vector part of 2 * dual * conjugate(real)
+        return value_type(2) * vector3_t<value_type>::coord(
+            real.w*dual.x - dual.w*real.x + real.y*dual.z - real.z*dual.y,
+            real.w*dual.y - dual.w*real.y + real.z*dual.x - real.x*dual.z,
+            real.w*dual.z - dual.w*real.z + real.x*dual.y - real.y*dual.x
+        );
+    }
+
+    matrix3x4_t<value_type> to_matrix3x4() const
+    {
+        auto m = matrix3x4_t<value_type>::rotation_quaternion(real);
+        const auto t = translation_vector();
+        m.m03 = t.x;
+        m.m13 = t.y;
+        m.m23 = t.z;
+        return m;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // arithmetic
+    dual_quaternion_t& operator+=(const dual_quaternion_t& b)
+    {
+        real += b.real;
+        dual += b.dual;
+        return *this;
+    }
+
+    dual_quaternion_t& operator-=(const dual_quaternion_t& b)
+    {
+        real -= b.real;
+        dual -= b.dual;
+        return *this;
+    }
+
+    dual_quaternion_t& operator*=(const value_type& s)
+    {
+        real *= s;
+        dual *= s;
+        return *this;
+    }
+
+    // the same code as operator*, so both give the same result
+    dual_quaternion_t& operator*=(const dual_quaternion_t& b)
+    {
+        return *this = *this * b;
+    }
+
+    // the inverse of a unit dual quaternion
+    dual_quaternion_t& conjugate()
+    {
+        real.conjugate();
+        dual.conjugate();
+        return *this;
+    }
+
+    // makes the real part a unit quaternion and the dual part orthogonal to it
+    value_type normalize()
+    {
+        auto l = real.length();
+        YAMA_ASSERT_WARN(l, "Normalizing yama::dual_quaternion_t with a zero-length real part");
+        real /= l;
+        dual /= l;
+        dual -= real * dot(real, dual);
+        return l;
+    }
+
+    bool is_normalized() const
+    {
+        return real.is_normalized() && close(dot(real, dual), value_type(0));
+    }
+};
+
+template <typename T>
+constexpr typename dual_quaternion_t<T>::size_type dual_quaternion_t<T>::value_count;
+
+template <typename T>
+dual_quaternion_t<T> operator+(const dual_quaternion_t<T>& a, const dual_quaternion_t<T>& b)
+{
+    return dual_quaternion_t<T>::real_dual(a.real + b.real, a.dual + b.dual);
+}
+
+template <typename T>
+dual_quaternion_t<T> operator-(const dual_quaternion_t<T>& a, const dual_quaternion_t<T>& b)
+{
+    return dual_quaternion_t<T>::real_dual(a.real - b.real, a.dual - b.dual);
+}
+
+template <typename T>
+dual_quaternion_t<T> operator*(const dual_quaternion_t<T>& a, const T& s)
+{
+    return dual_quaternion_t<T>::real_dual(a.real * s, a.dual * s);
+}
+
+template <typename T>
+dual_quaternion_t<T> operator*(const T& s, const dual_quaternion_t<T>& b)
+{
+    return dual_quaternion_t<T>::real_dual(s * b.real, s * b.dual);
+}
+
+template <typename T>
+dual_quaternion_t<T> operator*(const dual_quaternion_t<T>& a, const dual_quaternion_t<T>& b)
+{
+    return dual_quaternion_t<T>::real_dual(a.real * b.real, a.real * b.dual + a.dual * b.real);
+}
+
+template <typename T>
+bool operator==(const dual_quaternion_t<T>& a, const dual_quaternion_t<T>& b)
+{
+    return a.real == b.real && a.dual == b.dual;
+}
+
+template <typename T>
+bool operator!=(const dual_quaternion_t<T>& a, const dual_quaternion_t<T>& b)
+{
+    return a.real != b.real || a.dual != b.dual;
+}
+
+template <typename T>
+bool close(const dual_quaternion_t<T>& a, const dual_quaternion_t<T>& b, const T& epsilon = constants_t<T>::EPSILON())
+{
+    return close(a.real, b.real, epsilon) && close(a.dual, b.dual, epsilon);
+}
+
+template <typename T>
+dual_quaternion_t<T> normalize(const dual_quaternion_t<T>& a)
+{
+    auto r = a;
+    r.normalize();
+    return r;
+}
+
+template <typename T>
+dual_quaternion_t<T> conjugate(const dual_quaternion_t<T>& a)
+{
+    return dual_quaternion_t<T>::real_dual(conjugate(a.real), conjugate(a.dual));
+}
+
+// the rotated and translated point, for a unit dual quaternion
+template <typename T>
+vector3_t<T> transform_coord(const vector3_t<T>& v, const dual_quaternion_t<T>& dq)
+{
+    return rotate(v, dq.real) + dq.translation_vector();
+}
+
+// the rotated direction, for a unit dual quaternion
+template <typename T>
+vector3_t<T> rotate(const vector3_t<T>& v, const dual_quaternion_t<T>& dq)
+{
+    return rotate(v, dq.real);
+}
+
+// type traits
+template <typename T>
+struct is_yama<dual_quaternion_t<T>> : public std::true_type {};
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef dual_quaternion_t<preferred_type> dual_quaternion;
+
+#endif
+
+}
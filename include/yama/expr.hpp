@@ -0,0 +1,617 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Expression templates over arrays
+// Arithmetic on the operands returned by expr::ref builds a lazy expression
+// and expr::assign evaluates it in a single loop over SIMD packs, so
+// `p + v * dt` reads every input once and creates no temporary arrays, where
+// the batch functions would make a pass over memory per operator.
+//
+//  vector3_soa positions, velocities;
+//  expr::assign(positions, expr::ref(positions) + expr::ref(velocities) * dt);
+//
+// The operands are vectors (vector3_soa_t or vector4_soa_t containers,
+// arrays or strided views of vector3_t or vector4_t, and single vectors,
+// which are the same for every element) or scalars (arrays of T, one per
+// element, and single values). Vectors in an expression have the same
+// dimension and scalars apply to all of their components. + - * / are
+// component-wise and a * b + c is computed with madd.
+//
+// All arrays in an expression must have the same size. The destination may
+// be one of them, but must not overlap the others. Only expressions made with
+// expr::ref have these operators, so the header changes nothing else.
+
+#include "batch.hpp"
+#include "soa.hpp"
+#include "strided.hpp"
+
+#include <type_traits>
+
+namespace yama
+{
+
+namespace internal
+{
+
+// one pack for scalars, one per component for vectors
+constexpr size_t expr_slots(size_t dim)
+{
+    return dim ? dim : 1;
+}
+
+// component k of an operand of dimension D, scalars are the same for all
+template <size_t D, typename P>
+P expr_component(const P* c, size_t k)
+{
+    return c[D ? k : 0];
+}
+
+template <typename P>
+void expr_load(const vector3_t<typename P::value_type>* ptr, size_t stride, P* c)
+{
+    load3(ptr, stride, c[0], c[1], c[2]);
+}
+
+template <typename P>
+void expr_store(vector3_t<typename P::value_type>* ptr, size_t stride, const P* c)
+{
+    store3(ptr, stride, c[0], c[1], c[2]);
+}
+
+template <typename P>
+void expr_load(const vector4_t<typename P::value_type>* ptr, size_t stride, P* c)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector4_t<T>))
+    {
+        load4(ptr, c);
+        return;
+    }
+
+    T buf[4 * P::width];
+    for (size_t i = 0; i < P::width; ++i)
+    {
+        const T* v = byte_offset(ptr, i * stride)->data();
+        for (size_t k = 0; k < 4; ++k) buf[4 * i + k] = v[k];
+    }
+    P::load4(buf, c[0], c[1], c[2], c[3]);
+}
+
+template <typename P>
+void expr_store(vector4_t<typename P::value_type>* ptr, size_t stride, const P* c)
+{
+    typedef typename P::value_type T;
+    if (stride == sizeof(vector4_t<T>))
+    {
+        store4(ptr, c);
+        return;
+    }
+
+    T buf[4 * P::width];
+    P::store4(buf, c[0], c[1], c[2], c[3]);
+    for (size_t i = 0; i < P::width; ++i)
+    {
+        T* v = byte_offset(ptr, i * stride)->data();
+        for (size_t k = 0; k < 4; ++k) v[k] = buf[4 * i + k];
+    }
+}
+
+template <typename T, size_t D>
+struct expr_soa_destination
+{
+    soa_out<T, D> out;
+
+    template <typename P>
+    void store(size_t i, const P* c) const
+    {
+        for (size_t k = 0; k < D; ++k) c[k].store(out.s[k] + i);
+    }
+};
+
+template <typename V, bool Contiguous>
+struct expr_array_destination
+{
+    V* data;
+    size_t stride;
+
+    template <typename P>
+    void store(size_t i, const P* c) const
+    {
+        const size_t s = Contiguous ? sizeof(V) : stride;
+        expr_store(byte_offset(data, i * s), s, c);
+    }
+};
+
+template <typename T>
+struct expr_scalar_destination
+{
+    T* data;
+
+    template <typename P>
+    void store(size_t i, const P* c) const
+    {
+        c[0].store(data + i);
+    }
+};
+
+template <typename E, typename Destination>
+struct expr_assign_kernel
+{
+    const E& e;
+    Destination out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P c[expr_slots(E::dim)];
+        e.template load<P>(i, c);
+        out.store(i, c);
+    }
+};
+
+template <typename E, typename Destination>
+void run_expr_assign(const E& e, const Destination& out, size_t count)
+{
+    const expr_assign_kernel<E, Destination> k = { e, out };
+    run_kernel<typename E::value_type>(k, count);
+}
+
+}
+
+namespace expr
+{
+
+// The base of all expressions. An expression E has
+//  E::value_type and E::dim, the number of components or 0 for scalars
+//  size(), the number of elements or 0 for single values
+//  load<P>(i, c), which computes elements [i, i + P::width) into
+//      internal::expr_slots(dim) packs
+template <typename E>
+struct expression
+{
+    const E& derived() const { return static_cast<const E&>(*this); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// operands
+
+// a single value, the same for every element
+template <typename T>
+class scalar_value : public expression<scalar_value<T>>
+{
+public:
+    typedef T value_type;
+    static constexpr size_t dim = 0;
+
+    explicit scalar_value(const T& s) : m_s(s) {}
+
+    size_t size() const { return 0; }
+
+    template <typename P>
+    void load(size_t, P* c) const
+    {
+        c[0] = P::uniform(m_s);
+    }
+
+private:
+    T m_s;
+};
+
+// a single vector, the same for every element
+template <typename T, size_t D>
+class vector_value : public expression<vector_value<T, D>>
+{
+public:
+    typedef T value_type;
+    static constexpr size_t dim = D;
+
+    explicit vector_value(const T* v)
+    {
+        for (size_t k = 0; k < D; ++k) m_v[k] = v[k];
+    }
+
+    size_t size() const { return 0; }
+
+    template <typename P>
+    void load(size_t, P* c) const
+    {
+        for (size_t k = 0; k < D; ++k) c[k] = P::uniform(m_v[k]);
+    }
+
+private:
+    T m_v[D];
+};
+
+// a scalar per element
+template <typename T>
+class scalar_array : public expression<scalar_array<T>>
+{
+public:
+    typedef T value_type;
+    static constexpr size_t dim = 0;
+
+    scalar_array(const T* ptr, size_t size) : m_ptr(ptr), m_size(size) {}
+
+    size_t size() const { return m_size; }
+
+    template <typename P>
+    void load(size_t i, P* c) const
+    {
+        c[0] = P::load(m_ptr + i);
+    }
+
+private:
+    const T* m_ptr;
+    size_t m_size;
+};
+
+// vectors in the streams of a SoA container
+template <typename T, size_t D>
+class soa_array : public expression<soa_array<T, D>>
+{
+public:
+    typedef T value_type;
+    static constexpr size_t dim = D;
+
+    explicit soa_array(const internal::soa_streams<T, D>& c)
+        : m_streams(c)
+        , m_size(c.size())
+    {}
+
+    size_t size() const { return m_size; }
+
+    template <typename P>
+    void load(size_t i, P* c) const
+    {
+        for (size_t k = 0; k < D; ++k) c[k] = P::load(m_streams.s[k] + i);
+    }
+
+private:
+    internal::soa_in<T, D> m_streams;
+    size_t m_size;
+};
+
+// vectors in a strided view, Contiguous if it's known to be an array
+template <typename V, bool Contiguous>
+class vector_array : public expression<vector_array<V, Contiguous>>
+{
+public:
+    typedef typename V::value_type value_type;
+    static constexpr size_t dim = V::value_count;
+
+    explicit vector_array(const strided_span<const V>& s) : m_span(s) {}
+
+    size_t size() const { return m_span.size(); }
+
+    template <typename P>
+    void load(size_t i, P* c) const
+    {
+        const size_t stride = Contiguous ? sizeof(V) : m_span.stride();
+        internal::expr_load(internal::byte_offset(m_span.data(), i * stride), stride, c);
+    }
+
+private:
+    strided_span<const V> m_span;
+};
+
+template <typename T>
+scalar_array<T> ref(const T* ptr, size_t count)
+{
+    return scalar_array<T>(ptr, count);
+}
+
+template <typename T>
+soa_array<T, 3> ref(const vector3_soa_t<T>& c)
+{
+    return soa_array<T, 3>(c);
+}
+
+template <typename T>
+soa_array<T, 4> ref(const vector4_soa_t<T>& c)
+{
+    return soa_array<T, 4>(c);
+}
+
+template <typename T>
+vector_array<vector3_t<T>, true> ref(const vector3_t<T>* ptr, size_t count)
+{
+    return vector_array<vector3_t<T>, true>(strided_span<const vector3_t<T>>::from_array(ptr, count));
+}
+
+template <typename T>
+vector_array<vector4_t<T>, true> ref(const vector4_t<T>* ptr, size_t count)
+{
+    return vector_array<vector4_t<T>, true>(strided_span<const vector4_t<T>>::from_array(ptr, count));
+}
+
+template <typename V>
+vector_array<typename std::remove_const<V>::type, false> ref(const strided_span<V>& s)
+{
+    return vector_array<typename std::remove_const<V>::type, false>(s);
+}
+
+// the other operands of the operators: single values and vectors
+template <typename X, typename T, typename = void>
+struct operand
+{
+};
+
+template <typename X, typename T>
+struct operand<X, T, typename std::enable_if<std::is_arithmetic<X>::value>::type>
+{
+    typedef scalar_value<T> type;
+    static type make(const X& s) { return type(T(s)); }
+};
+
+template <typename T>
+struct operand<vector3_t<T>, T>
+{
+    typedef vector_value<T, 3> type;
+    static type make(const vector3_t<T>& v) { return type(v.data()); }
+};
+
+template <typename T>
+struct operand<vector4_t<T>, T>
+{
+    typedef vector_value<T, 4> type;
+    static type make(const vector4_t<T>& v) { return type(v.data()); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// operations
+
+struct op_add { template <typename P> static P apply(P a, P b) { return a + b; } };
+struct op_sub { template <typename P> static P apply(P a, P b) { return a - b; } };
+struct op_mul { template <typename P> static P apply(P a, P b) { return a * b; } };
+struct op_div { template <typename P> static P apply(P a, P b) { return a / b; } };
+
+template <typename L, typename R>
+struct common_dim
+{
+    static_assert(std::is_same<typename L::value_type, typename R::value_type>::value, "yama::expr operands of different types");
+    static_assert(L::dim == R::dim || L::dim == 0 || R::dim == 0, "yama::expr vectors of different dimensions");
+    static constexpr size_t value = L::dim ? L::dim : R::dim;
+};
+
+// the size of the arrays in two operands, single values fit any
+inline size_t common_size(size_t a, size_t b)
+{
+    YAMA_ASSERT_CRIT(!a || !b || a == b, "yama::expr arrays of different size");
+    return a ? a : b;
+}
+
+template <typename Op, typename L, typename R>
+class binary : public expression<binary<Op, L, R>>
+{
+public:
+    typedef typename L::value_type value_type;
+    static constexpr size_t dim = common_dim<L, R>::value;
+
+    binary(const L& l, const R& r)
+        : m_left(l)
+        , m_right(r)
+        , m_size(common_size(l.size(), r.size()))
+    {}
+
+    const L& left() const { return m_left; }
+    const R& right() const { return m_right; }
+    size_t size() const { return m_size; }
+
+    template <typename P>
+    void load(size_t i, P* c) const
+    {
+        P l[internal::expr_slots(L::dim)], r[internal::expr_slots(R::dim)];
+        m_left.load(i, l);
+        m_right.load(i, r);
+        for (size_t k = 0; k < internal::expr_slots(dim); ++k)
+        {
+            c[k] = Op::apply(internal::expr_component<L::dim>(l, k), internal::expr_component<R::dim>(r, k));
+        }
+    }
+
+private:
+    L m_left;
+    R m_right;
+    size_t m_size;
+};
+
+// a * b + c
+template <typename A, typename B, typename C>
+class multiply_add : public expression<multiply_add<A, B, C>>
+{
+public:
+    typedef typename A::value_type value_type;
+    static constexpr size_t dim = common_dim<binary<op_mul, A, B>, C>::value;
+
+    multiply_add(const binary<op_mul, A, B>& ab, const C& c)
+        : m_a(ab.left())
+        , m_b(ab.right())
+        , m_c(c)
+        , m_size(common_size(ab.size(), c.size()))
+    {}
+
+    size_t size() const { return m_size; }
+
+    template <typename P>
+    void load(size_t i, P* out) const
+    {
+        P a[internal::expr_slots(A::dim)], b[internal::expr_slots(B::dim)], c[internal::expr_slots(C::dim)];
+        m_a.load(i, a);
+        m_b.load(i, b);
+        m_c.load(i, c);
+        for (size_t k = 0; k < internal::expr_slots(dim); ++k)
+        {
+            out[k] = madd(internal::expr_component<A::dim>(a, k), internal::expr_component<B::dim>(b, k), internal::expr_component<C::dim>(c, k));
+        }
+    }
+
+private:
+    A m_a;
+    B m_b;
+    C m_c;
+    size_t m_size;
+};
+
+template <typename E>
+class negate : public expression<negate<E>>
+{
+public:
+    typedef typename E::value_type value_type;
+    static constexpr size_t dim = E::dim;
+
+    explicit negate(const E& e) : m_e(e) {}
+
+    size_t size() const { return m_e.size(); }
+
+    template <typename P>
+    void load(size_t i, P* c) const
+    {
+        m_e.load(i, c);
+        for (size_t k = 0; k < internal::expr_slots(dim); ++k) c[k] = -c[k];
+    }
+
+private:
+    E m_e;
+};
+
+template <typename T> constexpr size_t scalar_value<T>::dim;
+template <typename T, size_t D> constexpr size_t vector_value<T, D>::dim;
+template <typename T> constexpr size_t scalar_array<T>::dim;
+template <typename T, size_t D> constexpr size_t soa_array<T, D>::dim;
+template <typename V, bool Contiguous> constexpr size_t vector_array<V, Contiguous>::dim;
+template <typename Op, typename L, typename R> constexpr size_t binary<Op, L, R>::dim;
+template <typename A, typename B, typename C> constexpr size_t multiply_add<A, B, C>::dim;
+template <typename E> constexpr size_t negate<E>::dim;
+
+// The operators take an expression and either an expression or a value of
+// its type. Sums with a product on either side are fused.
+
+#define YAMA_EXPR_OPERATOR(op, Op) \
+    template <typename L, typename R> \
+    binary<Op, L, typename operand<R, typename L::value_type>::type> operator op(const expression<L>& l, const R& r) \
+    { \
+        return { l.derived(), operand<R, typename L::value_type>::make(r) }; \
+    } \
+    template <typename L, typename R> \
+    binary<Op, typename operand<L, typename R::value_type>::type, R> operator op(const L& l, const expression<R>& r) \
+    { \
+        return { operand<L, typename R::value_type>::make(l), r.derived() }; \
+    } \
+    template <typename L, typename R> \
+    binary<Op, L, R> operator op(const expression<L>& l, const expression<R>& r) \
+    { \
+        return { l.derived(), r.derived() }; \
+    }
+
+YAMA_EXPR_OPERATOR(+, op_add)
+YAMA_EXPR_OPERATOR(-, op_sub)
+YAMA_EXPR_OPERATOR(*, op_mul)
+YAMA_EXPR_OPERATOR(/, op_div)
+
+#undef YAMA_EXPR_OPERATOR
+
+template <typename A, typename B, typename C>
+multiply_add<A, B, C> operator+(const binary<op_mul, A, B>& ab, const expression<C>& c)
+{
+    return { ab, c.derived() };
+}
+
+template <typename A, typename B, typename C>
+multiply_add<A, B, C> operator+(const expression<C>& c, const binary<op_mul, A, B>& ab)
+{
+    return { ab, c.derived() };
+}
+
+template <typename A, typename B, typename C, typename D>
+multiply_add<A, B, binary<op_mul, C, D>> operator+(const binary<op_mul, A, B>& ab, const binary<op_mul, C, D>& cd)
+{
+    return { ab, cd };
+}
+
+template <typename A, typename B, typename R>
+multiply_add<A, B, typename operand<R, typename A::value_type>::type> operator+(const binary<op_mul, A, B>& ab, const R& r)
+{
+    return { ab, operand<R, typename A::value_type>::make(r) };
+}
+
+template <typename A, typename B, typename L>
+multiply_add<A, B, typename operand<L, typename A::value_type>::type> operator+(const L& l, const binary<op_mul, A, B>& ab)
+{
+    return { ab, operand<L, typename A::value_type>::make(l) };
+}
+
+template <typename E>
+negate<E> operator-(const expression<E>& e)
+{
+    return negate<E>(e.derived());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// evaluation
+
+// resizes out to the size of the expression
+template <typename T, typename E>
+void assign(vector3_soa_t<T>& out, const expression<E>& e)
+{
+    static_assert(E::dim == 3, "yama::expr::assign of a vector3_soa_t needs 3 components");
+    const size_t size = e.derived().size();
+    const internal::expr_soa_destination<T, 3> d = { internal::soa_out<T, 3>(out, size) };
+    internal::run_expr_assign(e.derived(), d, size);
+}
+
+template <typename T, typename E>
+void assign(vector4_soa_t<T>& out, const expression<E>& e)
+{
+    static_assert(E::dim == 4, "yama::expr::assign of a vector4_soa_t needs 4 components");
+    const size_t size = e.derived().size();
+    const internal::expr_soa_destination<T, 4> d = { internal::soa_out<T, 4>(out, size) };
+    internal::run_expr_assign(e.derived(), d, size);
+}
+
+template <typename V, typename E>
+void assign(const strided_span<V>& out, const expression<E>& e)
+{
+    static_assert(E::dim == V::value_count, "yama::expr::assign of vectors with a different dimension");
+    YAMA_ASSERT_CRIT(out.size() == e.derived().size(), "yama::expr::assign to a view of a different size");
+    if (out.contiguous())
+    {
+        const internal::expr_array_destination<V, true> d = { out.data(), out.stride() };
+        internal::run_expr_assign(e.derived(), d, out.size());
+    }
+    else
+    {
+        const internal::expr_array_destination<V, false> d = { out.data(), out.stride() };
+        internal::run_expr_assign(e.derived(), d, out.size());
+    }
+}
+
+// out must have room for the elements of the expression
+template <typename T, typename E>
+void assign(vector3_t<T>* out, const expression<E>& e)
+{
+    assign(strided_span<vector3_t<T>>::from_array(out, e.derived().size()), e);
+}
+
+template <typename T, typename E>
+void assign(vector4_t<T>* out, const expression<E>& e)
+{
+    assign(strided_span<vector4_t<T>>::from_array(out, e.derived().size()), e);
+}
+
+template <typename T, typename E>
+void assign(T* out, const expression<E>& e)
+{
+    static_assert(E::dim == 0, "yama::expr::assign of scalars needs a scalar expression");
+    const internal::expr_scalar_destination<T> d = { out };
+    internal::run_expr_assign(e.derived(), d, e.derived().size());
+}
+
+}
+
+}
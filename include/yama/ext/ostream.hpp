@@ -12,7 +12,12 @@
 #include "../vector3.hpp"
 #include "../vector4.hpp"
 #include "../quaternion.hpp"
+#include "../matrix2x3.hpp"
+#include "../matrix3x3.hpp"
 #include "../matrix4x4.hpp"
+#include "../vector.hpp"
+#include "../matrix.hpp"
+#include "../transform.hpp"
 
 namespace yama
 {
@@ -45,6 +50,13 @@ template <typename T>
     return o;
 }
 
+template <typename T>
+::std::ostream& operator<<(::std::ostream& o, const transform_t<T>& t)
+{
+    o << '(' << t.position << ", " << t.orientation << ", " << t.scale << ')';
+    return o;
+}
+
 template <typename T>
 ::std::ostream& operator<<(::std::ostream& o, const matrix4x4_t<T>& m)
 {
@@ -66,4 +78,31 @@ template <typename T>
     return o;
 }
 
+template <typename T, size_t N>
+::std::ostream& operator<<(::std::ostream& o, const vector_t<T, N>& v)
+{
+    o << '(';
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (i) o << ", ";
+        o << v.values[i];
+    }
+    o << ')';
+    return o;
+}
+
+// row by row like the named matrices
+template <typename T, size_t R, size_t C>
+::std::ostream& operator<<(::std::ostream& o, const matrix_t<T, R, C>& m)
+{
+    o << '(';
+    for (size_t r = 0; r < R; ++r)
+    {
+        if (r) o << ", ";
+        o << m.row_vector(r);
+    }
+    o << ')';
+    return o;
+}
+
 }
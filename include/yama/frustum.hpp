@@ -0,0 +1,347 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// View frustum culling
+// frustum_t holds the six planes of a view-projection matrix. Each plane is a
+// vector4_t (normal.x, normal.y, normal.z, d) with a unit normal pointing
+// inside, so that the signed distance of a point p is dot(normal, p) + d.
+//
+// The volume tests are conservative: a volume outside of the frustum, but
+// not entirely behind any single plane (near its corners) is reported as
+// visible.
+//
+// The batch functions test structure-of-arrays bounds and write a bitmask
+// (see soa.hpp) with the bits of the visible volumes set. With YAMA_THREADS
+// they have overloads which take a parallel::thread_pool.
+
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "quaternion.hpp"
+#include "matrix4x4.hpp"
+#include "soa.hpp"
+
+#include <cstdint>
+
+namespace yama
+{
+
+template <typename T>
+class frustum_t
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    enum plane_index
+    {
+        left_plane,
+        right_plane,
+        bottom_plane,
+        top_plane,
+        near_plane,
+        far_plane,
+    };
+
+    static constexpr size_type plane_count = 6;
+
+    vector4_t<value_type> planes[plane_count];
+
+    ////////////////////////////////////////////////////////
+    // named constructors
+
+    // from a view-projection matrix with a [0, 1] depth range, like perspective_lh
+    static frustum_t from_view_projection(const matrix4x4_t<value_type>& m)
+    {
+        const auto r2 = m.row_vector(2);
+        const auto r3 = m.row_vector(3);
+        return from_rows(m, r2, r3 - r2);
+    }
+
+    // from a view-projection matrix with a [-1, 1] depth range, like perspective_lh_cube
+    static frustum_t from_view_projection_cube(const matrix4x4_t<value_type>& m)
+    {
+        const auto r2 = m.row_vector(2);
+        const auto r3 = m.row_vector(3);
+        return from_rows(m, r3 + r2, r3 - r2);
+    }
+
+    ////////////////////////////////////////////////////////
+    // tests
+
+    value_type distance(plane_index i, const vector3_t<value_type>& p) const
+    {
+        const auto& pl = planes[i];
+        return pl.x*p.x + pl.y*p.y + pl.z*p.z + pl.w;
+    }
+
+    bool contains(const vector3_t<value_type>& p) const
+    {
+        return intersects_sphere(p, value_type(0));
+    }
+
+    bool intersects_sphere(const vector3_t<value_type>& center, const value_type& radius) const
+    {
+        for (size_type i = 0; i < plane_count; ++i)
+        {
+            if (distance(plane_index(i), center) < -radius) return false;
+        }
+        return true;
+    }
+
+    bool intersects_aabb(const vector3_t<value_type>& min, const vector3_t<value_type>& max) const
+    {
+        const auto center = (min + max) * value_type(0.5);
+        const auto half_extents = (max - min) * value_type(0.5);
+        for (size_type i = 0; i < plane_count; ++i)
+        {
+            const auto& pl = planes[i];
+            const auto r = std::abs(pl.x)*half_extents.x + std::abs(pl.y)*half_extents.y + std::abs(pl.z)*half_extents.z;
+            if (distance(plane_index(i), center) < -r) return false;
+        }
+        return true;
+    }
+
+    // an oriented box is an axis-aligned box around the origin, rotated by orientation and moved to center
+    bool intersects_obb(const vector3_t<value_type>& center, const vector3_t<value_type>& half_extents, const quaternion_t<value_type>& orientation) const
+    {
+        const auto u = rotate(vector3_t<value_type>::coord(half_extents.x, 0, 0), orientation);
+        const auto v = rotate(vector3_t<value_type>::coord(0, half_extents.y, 0), orientation);
+        const auto w = rotate(vector3_t<value_type>::coord(0, 0, half_extents.z), orientation);
+        for (size_type i = 0; i < plane_count; ++i)
+        {
+            const auto& pl = planes[i];
+            const auto n = vector3_t<value_type>::coord(pl.x, pl.y, pl.z);
+            const auto r = std::abs(dot(n, u)) + std::abs(dot(n, v)) + std::abs(dot(n, w));
+            if (distance(plane_index(i), center) < -r) return false;
+        }
+        return true;
+    }
+
+private:
+    static frustum_t from_rows(const matrix4x4_t<value_type>& m, const vector4_t<value_type>& near_p, const vector4_t<value_type>& far_p)
+    {
+        const auto r0 = m.row_vector(0);
+        const auto r1 = m.row_vector(1);
+        const auto r3 = m.row_vector(3);
+
+        frustum_t ret;
+        ret.planes[left_plane] = r3 + r0;
+        ret.planes[right_plane] = r3 - r0;
+        ret.planes[bottom_plane] = r3 + r1;
+        ret.planes[top_plane] = r3 - r1;
+        ret.planes[near_plane] = near_p;
+        ret.planes[far_plane] = far_p;
+
+        for (auto& p : ret.planes)
+        {
+            const auto l = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+            YAMA_ASSERT_WARN(l, "yama::frustum_t from a degenerate matrix");
+            p /= l;
+        }
+        return ret;
+    }
+};
+
+template <typename T>
+constexpr typename frustum_t<T>::size_type frustum_t<T>::plane_count;
+
+///////////////////////////////////////////////////////////////////////////////
+// batch culling
+
+namespace internal
+{
+
+// the planes broadcast to packs, built once per batch
+template <typename P>
+struct frustum_packs
+{
+    P nx[6], ny[6], nz[6], d[6];
+    P ax[6], ay[6], az[6]; // absolute values of the normals, for boxes
+
+    template <typename T>
+    explicit frustum_packs(const frustum_t<T>& f)
+    {
+        for (size_t i = 0; i < 6; ++i)
+        {
+            const auto& p = f.planes[i];
+            nx[i] = P::uniform(p.x);
+            ny[i] = P::uniform(p.y);
+            nz[i] = P::uniform(p.z);
+            d[i] = P::uniform(p.w);
+            ax[i] = P::uniform(std::abs(p.x));
+            ay[i] = P::uniform(std::abs(p.y));
+            az[i] = P::uniform(std::abs(p.z));
+        }
+    }
+
+    // the signed distance of the center from plane i
+    P distance(size_t i, P cx, P cy, P cz) const
+    {
+        return madd(nx[i], cx, madd(ny[i], cy, madd(nz[i], cz, d[i])));
+    }
+};
+
+template <typename T>
+struct cull_spheres_kernel
+{
+    typedef pack<T> P;
+
+    frustum_packs<P> f;
+    soa_in<T, 4> spheres;
+    uint32_t* out;
+
+    template <typename>
+    void run(size_t i) const
+    {
+        const P cx = P::load(spheres.s[0] + i), cy = P::load(spheres.s[1] + i), cz = P::load(spheres.s[2] + i);
+        const P r = P::load(spheres.s[3] + i);
+
+        // the smallest distance to any plane, plus the radius
+        P m = f.distance(0, cx, cy, cz);
+        for (size_t p = 1; p < 6; ++p)
+        {
+            m = vmin(m, f.distance(p, cx, cy, cz));
+        }
+        store_mask(out, i, ge_mask(m + r, P::uniform(0)));
+    }
+};
+
+template <typename T>
+struct cull_aabbs_kernel
+{
+    typedef pack<T> P;
+
+    frustum_packs<P> f;
+    soa_in<T, 3> mins, maxs;
+    uint32_t* out;
+
+    template <typename>
+    void run(size_t i) const
+    {
+        const P half = P::uniform(T(0.5));
+        const P x0 = P::load(mins.s[0] + i), y0 = P::load(mins.s[1] + i), z0 = P::load(mins.s[2] + i);
+        const P x1 = P::load(maxs.s[0] + i), y1 = P::load(maxs.s[1] + i), z1 = P::load(maxs.s[2] + i);
+        const P cx = (x0 + x1) * half, cy = (y0 + y1) * half, cz = (z0 + z1) * half;
+        const P ex = (x1 - x0) * half, ey = (y1 - y0) * half, ez = (z1 - z0) * half;
+
+        P m = P::uniform(0);
+        for (size_t p = 0; p < 6; ++p)
+        {
+            const P r = madd(f.ax[p], ex, madd(f.ay[p], ey, f.az[p] * ez));
+            const P d = f.distance(p, cx, cy, cz) + r;
+            m = p ? vmin(m, d) : d;
+        }
+        store_mask(out, i, ge_mask(m, P::uniform(0)));
+    }
+};
+
+template <typename T>
+struct cull_obbs_kernel
+{
+    typedef pack<T> P;
+
+    frustum_packs<P> f;
+    soa_in<T, 3> centers, half_extents;
+    soa_in<T, 4> orientations;
+    uint32_t* out;
+
+    template <typename>
+    void run(size_t i) const
+    {
+        const P cx = P::load(centers.s[0] + i), cy = P::load(centers.s[1] + i), cz = P::load(centers.s[2] + i);
+        const P ex = P::load(half_extents.s[0] + i), ey = P::load(half_extents.s[1] + i), ez = P::load(half_extents.s[2] + i);
+        const P qx = P::load(orientations.s[0] + i), qy = P::load(orientations.s[1] + i);
+        const P qz = P::load(orientations.s[2] + i), qw = P::load(orientations.s[3] + i);
+
+        // the box axes scaled by the half extents: the columns of matrix3x4_t::rotation_quaternion
+        const P two = P::uniform(T(2));
+        const P x2 = qx * qx, y2 = qy * qy, z2 = qz * qz, w2 = qw * qw;
+        const P xy = two * qx * qy, xz = two * qx * qz, xw = two * qx * qw;
+        const P yz = two * qy * qz, yw = two * qy * qw, zw = two * qz * qw;
+        const P ux = (w2 + x2 - y2 - z2) * ex, uy = (xy + zw) * ex, uz = (xz - yw) * ex;
+        const P vx = (xy - zw) * ey, vy = (w2 - x2 + y2 - z2) * ey, vz = (yz + xw) * ey;
+        const P wx = (xz + yw) * ez, wy = (yz - xw) * ez, wz = (w2 - x2 - y2 + z2) * ez;
+
+        P m = P::uniform(0);
+        for (size_t p = 0; p < 6; ++p)
+        {
+            const P ru = abs(madd(f.nx[p], ux, madd(f.ny[p], uy, f.nz[p] * uz)));
+            const P rv = abs(madd(f.nx[p], vx, madd(f.ny[p], vy, f.nz[p] * vz)));
+            const P rw = abs(madd(f.nx[p], wx, madd(f.ny[p], wy, f.nz[p] * wz)));
+            const P d = f.distance(p, cx, cy, cz) + ru + rv + rw;
+            m = p ? vmin(m, d) : d;
+        }
+        store_mask(out, i, ge_mask(m, P::uniform(0)));
+    }
+};
+
+}
+
+// spheres are center x, y, z and radius in w
+template <typename T>
+void cull_spheres(const frustum_t<T>& f, const vector4_soa_t<T>& spheres, uint32_t* out)
+{
+    const internal::cull_spheres_kernel<T> k = { internal::frustum_packs<internal::pack<T>>(f), internal::soa_in<T, 4>(spheres), out };
+    internal::run_mask_kernel<T>(k, spheres.size(), spheres.padded_size(), out);
+}
+
+template <typename T>
+void cull_aabbs(const frustum_t<T>& f, const vector3_soa_t<T>& mins, const vector3_soa_t<T>& maxs, uint32_t* out)
+{
+    YAMA_ASSERT_CRIT(mins.size() == maxs.size(), "yama soa containers of different size");
+    const internal::cull_aabbs_kernel<T> k = { internal::frustum_packs<internal::pack<T>>(f), internal::soa_in<T, 3>(mins), internal::soa_in<T, 3>(maxs), out };
+    internal::run_mask_kernel<T>(k, mins.size(), mins.padded_size(), out);
+}
+
+template <typename T>
+void cull_obbs(const frustum_t<T>& f, const vector3_soa_t<T>& centers, const vector3_soa_t<T>& half_extents, const quaternion_soa_t<T>& orientations, uint32_t* out)
+{
+    YAMA_ASSERT_CRIT(centers.size() == half_extents.size(), "yama soa containers of different size");
+    YAMA_ASSERT_CRIT(centers.size() == orientations.size(), "yama soa containers of different size");
+    const internal::cull_obbs_kernel<T> k = { internal::frustum_packs<internal::pack<T>>(f), internal::soa_in<T, 3>(centers), internal::soa_in<T, 3>(half_extents), internal::soa_in<T, 4>(orientations), out };
+    internal::run_mask_kernel<T>(k, centers.size(), centers.padded_size(), out);
+}
+
+#if YAMA_THREADS
+
+// the same with the volumes split between the threads of pool
+template <typename T>
+void cull_spheres(parallel::thread_pool& pool, const frustum_t<T>& f, const vector4_soa_t<T>& spheres, uint32_t* out)
+{
+    const internal::cull_spheres_kernel<T> k = { internal::frustum_packs<internal::pack<T>>(f), internal::soa_in<T, 4>(spheres), out };
+    internal::run_mask_kernel<T>(pool, k, spheres.size(), spheres.padded_size(), out);
+}
+
+template <typename T>
+void cull_aabbs(parallel::thread_pool& pool, const frustum_t<T>& f, const vector3_soa_t<T>& mins, const vector3_soa_t<T>& maxs, uint32_t* out)
+{
+    YAMA_ASSERT_CRIT(mins.size() == maxs.size(), "yama soa containers of different size");
+    const internal::cull_aabbs_kernel<T> k = { internal::frustum_packs<internal::pack<T>>(f), internal::soa_in<T, 3>(mins), internal::soa_in<T, 3>(maxs), out };
+    internal::run_mask_kernel<T>(pool, k, mins.size(), mins.padded_size(), out);
+}
+
+template <typename T>
+void cull_obbs(parallel::thread_pool& pool, const frustum_t<T>& f, const vector3_soa_t<T>& centers, const vector3_soa_t<T>& half_extents, const quaternion_soa_t<T>& orientations, uint32_t* out)
+{
+    YAMA_ASSERT_CRIT(centers.size() == half_extents.size(), "yama soa containers of different size");
+    YAMA_ASSERT_CRIT(centers.size() == orientations.size(), "yama soa containers of different size");
+    const internal::cull_obbs_kernel<T> k = { internal::frustum_packs<internal::pack<T>>(f), internal::soa_in<T, 3>(centers), internal::soa_in<T, 3>(half_extents), internal::soa_in<T, 4>(orientations), out };
+    internal::run_mask_kernel<T>(pool, k, centers.size(), centers.padded_size(), out);
+}
+
+#endif
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef frustum_t<preferred_type> frustum;
+
+#endif
+
+}
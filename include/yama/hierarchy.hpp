@@ -0,0 +1,376 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Transform hierarchies (scene graphs) as flat arrays
+// hierarchy_t keeps the nodes sorted by depth: all roots first, then all of
+// their children, then the grandchildren and so on. A node's parent is always
+// in the previous depth level, so the world transformations are computed in a
+// single linear pass over the arrays, with no recursion. Within a level the
+// nodes are in the order of their parents (breadth-first), so the children of
+// consecutive nodes are consecutive too.
+//
+// Nodes are identified by their index in the arrays given to the constructor
+// (their id). The storage order is available too, for code which wants to
+// walk the flat arrays.
+//
+// Changing a local transformation marks its node as dirty. Every level keeps
+// the range of slots which may need recomputing: its dirty nodes and the
+// children of the range of the level above. update only visits these ranges,
+// so the cost of a small edit is proportional to the size of the changed
+// subtrees, not of the hierarchy. Dirty nodes far apart in a level share one
+// range, which includes the nodes between them.
+//
+// With YAMA_THREADS the update overload which takes a parallel::thread_pool
+// splits every level between the threads of the pool. The levels are still
+// processed one after the other.
+
+#include "matrix3x4.hpp"
+#include "transform.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace yama
+{
+
+namespace internal
+{
+
+template <typename T>
+const matrix3x4_t<T>& local_matrix(const matrix3x4_t<T>& m)
+{
+    return m;
+}
+
+template <typename T>
+matrix3x4_t<T> local_matrix(const transform_t<T>& t)
+{
+    return t.to_matrix3x4();
+}
+
+// levels smaller than this are not split between threads, and the chunks of
+// larger ones are multiples of it
+constexpr size_t hierarchy_granularity = 1024;
+
+}
+
+// Local is matrix3x4_t or transform_t
+// The world transformations are always matrix3x4_t, as a product of
+// non-uniformly scaled TRS transformations may have shear.
+template <typename Local>
+class hierarchy_t
+{
+public:
+    typedef Local local_type;
+    typedef typename Local::value_type value_type;
+    typedef matrix3x4_t<value_type> world_type;
+    typedef size_t size_type;
+
+    static constexpr size_type no_parent = size_type(-1);
+
+    hierarchy_t()
+        : m_first_dirty_level(0)
+    {}
+
+    // parents[i] is the id of the parent of node i, or no_parent for roots
+    // Parents must come before their children: parents[i] < i.
+    // All nodes start dirty.
+    hierarchy_t(const size_type* parents, const Local* locals, size_type count)
+        : m_parents(count)
+        , m_locals(count)
+        , m_worlds(count)
+        , m_dirty(count, 1)
+        , m_ids(count)
+        , m_first_children(count + 1, count)
+        , m_slots(count)
+        , m_first_dirty_level(0)
+    {
+        // depth of every node and the sizes of the levels
+        std::vector<size_type> depths(count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            const size_type p = parents[i];
+            YAMA_ASSERT_CRIT(p == no_parent || p < i, "yama::hierarchy_t parents must come before their children");
+            depths[i] = p == no_parent ? 0 : depths[p] + 1;
+            if (depths[i] + 2 > m_levels.size()) m_levels.resize(depths[i] + 2, 0);
+            ++m_levels[depths[i] + 1];
+        }
+        for (size_type d = 1; d < m_levels.size(); ++d)
+        {
+            m_levels[d] += m_levels[d - 1];
+        }
+
+        // the children of every node in id order, as ranges of one array
+        std::vector<size_type> child_offsets(count + 1, 0);
+        for (size_type i = 0; i < count; ++i)
+        {
+            if (parents[i] != no_parent) ++child_offsets[parents[i] + 1];
+        }
+        for (size_type i = 1; i <= count; ++i)
+        {
+            child_offsets[i] += child_offsets[i - 1];
+        }
+        std::vector<size_type> children(count);
+        std::vector<size_type> next(child_offsets.begin(), child_offsets.end() - 1);
+        for (size_type i = 0; i < count; ++i)
+        {
+            if (parents[i] != no_parent) children[next[parents[i]]++] = i;
+        }
+
+        // breadth-first: the roots, then the children of every slot in order
+        size_type end = 0;
+        for (size_type i = 0; i < count; ++i)
+        {
+            if (parents[i] == no_parent) m_ids[end++] = i;
+        }
+        for (size_type s = 0; s < count; ++s)
+        {
+            const size_type id = m_ids[s];
+            m_first_children[s] = end;
+            for (size_type c = child_offsets[id]; c < child_offsets[id + 1]; ++c)
+            {
+                m_ids[end++] = children[c];
+            }
+        }
+
+        for (size_type s = 0; s < count; ++s)
+        {
+            m_slots[m_ids[s]] = s;
+        }
+        for (size_type s = 0; s < count; ++s)
+        {
+            const size_type id = m_ids[s];
+            m_locals[s] = locals[id];
+            m_parents[s] = parents[id] == no_parent ? no_parent : m_slots[parents[id]];
+        }
+
+        m_dirty_ranges.resize(level_count());
+        for (size_type d = 0; d < level_count(); ++d)
+        {
+            m_dirty_ranges[d] = range(level_begin(d), level_end(d));
+        }
+    }
+
+    size_type size() const { return m_ids.size(); }
+    bool empty() const { return m_ids.empty(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // nodes by id
+    size_type parent(size_type id) const
+    {
+        const size_type p = m_parents[slot(id)];
+        return p == no_parent ? no_parent : m_ids[p];
+    }
+
+    size_type depth(size_type id) const
+    {
+        return level_of(slot(id));
+    }
+
+    const Local& local(size_type id) const
+    {
+        return m_locals[slot(id)];
+    }
+
+    void set_local(size_type id, const Local& l)
+    {
+        const size_type s = slot(id);
+        m_locals[s] = l;
+        mark_slot_dirty(s);
+    }
+
+    // the world transformation as of the last update
+    const world_type& world(size_type id) const
+    {
+        return m_worlds[slot(id)];
+    }
+
+    // recompute the node and its descendants on the next update
+    void mark_dirty(size_type id)
+    {
+        mark_slot_dirty(slot(id));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // storage order
+    size_type slot(size_type id) const
+    {
+        YAMA_ASSERT_CRIT(id < size(), "yama::hierarchy_t node id overflow");
+        return m_slots[id];
+    }
+
+    size_type id(size_type s) const
+    {
+        YAMA_ASSERT_CRIT(s < size(), "yama::hierarchy_t slot overflow");
+        return m_ids[s];
+    }
+
+    // the nodes at depth d are the slots [level_begin(d), level_end(d))
+    size_type level_count() const { return m_levels.empty() ? 0 : m_levels.size() - 1; }
+    size_type level_begin(size_type d) const { return m_levels[d]; }
+    size_type level_end(size_type d) const { return m_levels[d + 1]; }
+
+    // the slot of the parent of every slot
+    const size_type* parent_slots() const { return m_parents.data(); }
+    const Local* locals() const { return m_locals.data(); }
+    const world_type* worlds() const { return m_worlds.data(); }
+
+    // the children of slot s are the slots [first_child_slots()[s], first_child_slots()[s + 1])
+    const size_type* first_child_slots() const { return m_first_children.data(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // update
+    // returns the number of recomputed nodes
+    size_type update()
+    {
+        size_type recomputed = 0;
+        for (size_type d = m_first_dirty_level; d < level_count(); ++d)
+        {
+            const range r = spread_dirty_range(d);
+            recomputed += update_range(r.first, r.second);
+        }
+        clear_dirty();
+        return recomputed;
+    }
+
+#if YAMA_THREADS
+    // the same with every level split between the threads of pool
+    size_type update(parallel::thread_pool& pool)
+    {
+        std::atomic<size_type> recomputed(0);
+        for (size_type d = m_first_dirty_level; d < level_count(); ++d)
+        {
+            const range r = spread_dirty_range(d);
+            const size_type first = r.first;
+            parallel::for_each_chunk(pool, r.second - first, internal::hierarchy_granularity, [this, first, &recomputed](size_t begin, size_t n) {
+                recomputed += update_range(first + begin, first + begin + n);
+            });
+        }
+        clear_dirty();
+        return recomputed;
+    }
+
+    // the same on a pool of thread_count threads, started for the call
+    // thread_count 0 means one thread per hardware thread
+    void update_parallel(size_type thread_count = 0)
+    {
+        parallel::thread_pool pool(thread_count);
+        update(pool);
+    }
+#endif
+
+private:
+    // a range of slots [first, second), empty if first == second
+    typedef std::pair<size_type, size_type> range;
+
+    static range merge(const range& a, const range& b)
+    {
+        if (a.first == a.second) return b;
+        if (b.first == b.second) return a;
+        return range(std::min(a.first, b.first), std::max(a.second, b.second));
+    }
+
+    size_type level_of(size_type s) const
+    {
+        return size_type(std::upper_bound(m_levels.begin(), m_levels.end(), s) - m_levels.begin()) - 1;
+    }
+
+    void mark_slot_dirty(size_type s)
+    {
+        m_dirty[s] = 1;
+        const size_type d = level_of(s);
+        m_dirty_ranges[d] = merge(m_dirty_ranges[d], range(s, s + 1));
+        if (d < m_first_dirty_level) m_first_dirty_level = d;
+    }
+
+    // adds the children of the range of the level above to the range of level d
+    // and returns it
+    range spread_dirty_range(size_type d)
+    {
+        range& r = m_dirty_ranges[d];
+        if (d > 0)
+        {
+            const range& above = m_dirty_ranges[d - 1];
+            r = merge(r, range(m_first_children[above.first], m_first_children[above.second]));
+        }
+        return r;
+    }
+
+    // the parents of [begin, end) must be up to date
+    size_type update_range(size_type begin, size_type end)
+    {
+        size_type recomputed = 0;
+        for (size_type s = begin; s < end; ++s)
+        {
+            const size_type p = m_parents[s];
+            if (p == no_parent)
+            {
+                if (!m_dirty[s]) continue;
+                m_worlds[s] = internal::local_matrix(m_locals[s]);
+            }
+            else
+            {
+                if (!m_dirty[s] && !m_dirty[p]) continue;
+                m_dirty[s] = 1;
+                m_worlds[s] = m_worlds[p] * internal::local_matrix(m_locals[s]);
+            }
+            ++recomputed;
+        }
+        return recomputed;
+    }
+
+    void clear_dirty()
+    {
+        for (size_type d = m_first_dirty_level; d < level_count(); ++d)
+        {
+            range& r = m_dirty_ranges[d];
+            if (r.second > r.first) std::memset(m_dirty.data() + r.first, 0, r.second - r.first);
+            r = range(0, 0);
+        }
+        m_first_dirty_level = level_count();
+    }
+
+    // by slot
+    std::vector<size_type> m_parents;
+    std::vector<Local> m_locals;
+    std::vector<world_type> m_worlds;
+    std::vector<uint8_t> m_dirty;
+    std::vector<size_type> m_ids;
+    std::vector<size_type> m_first_children; // and size() at the end
+
+    // by id
+    std::vector<size_type> m_slots;
+
+    // m_levels[d] is the first slot at depth d, the last element is size()
+    std::vector<size_type> m_levels;
+
+    // by level, the slots which may need recomputing
+    std::vector<range> m_dirty_ranges;
+
+    // the levels before it have no dirty nodes
+    size_type m_first_dirty_level;
+};
+
+template <typename Local>
+constexpr typename hierarchy_t<Local>::size_type hierarchy_t<Local>::no_parent;
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef hierarchy_t<matrix3x4_t<preferred_type>> hierarchy;
+typedef hierarchy_t<transform_t<preferred_type>> transform_hierarchy;
+
+#endif
+
+}
@@ -0,0 +1,697 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Generic compile-time-sized matrices
+// matrix_t<T, R, C> has R rows and C columns stored column by column, the same
+// layout as matrix3x4_t (R = 3, C = 4) and matrix4x4_t, so it converts to and
+// from them with from() and as(). Like vector_t every operation is unrolled
+// at compile time.
+// operator* is the plain product of an R x K and a K x C matrix. Note that
+// matrix3x4_t multiplies as an affine transform with an implied last row of
+// 0 0 0 1 instead.
+//
+// A shape can have a named specialisation with mNN members instead of the
+// values array. The operators and kernels here only read the elements with
+// at() and operator() and build matrices with columns(), so they work on the
+// specialisations too, and stay constexpr if their element access is.
+// The 2x2 and 3x3 matrices also have determinant() and inverse().
+
+#include "vector.hpp"
+
+namespace yama
+{
+
+template <typename T, size_t R, size_t C>
+class matrix_t;
+
+namespace internal
+{
+
+// the element at flat index I is at row I % R and column I / R
+
+template <typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_uniform(const T& s, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(repeat<I>(s)...);
+}
+
+template <typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_identity(index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(T(I % R == I / R ? 1 : 0)...);
+}
+
+template <typename T, size_t R, size_t C, size_t... I>
+matrix_t<T, R, C> matrix_from_ptr(const T* ptr, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(ptr[I]...);
+}
+
+// the transposed C x R matrix has the element at row I % R and column I / R at I / R + (I % R) * C
+template <typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, C, R> matrix_transpose(const matrix_t<T, R, C>& a, index_list<I...>)
+{
+    return matrix_t<T, C, R>::columns(a.at((I % C) * R + I / C)...);
+}
+
+template <typename Op, typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_map(const matrix_t<T, R, C>& a, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(Op::apply(a.at(I))...);
+}
+
+template <typename Op, typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_zip(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(Op::apply(a.at(I), b.at(I))...);
+}
+
+template <typename Op, typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_zip(const matrix_t<T, R, C>& a, const T& s, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(Op::apply(a.at(I), s)...);
+}
+
+template <typename Op, typename T, size_t R, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_zip(const T& s, const matrix_t<T, R, C>& b, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(Op::apply(s, b.at(I))...);
+}
+
+// a(row, k) * b(k, column)
+template <typename A, typename B>
+struct product_terms
+{
+    const A& a;
+    const B& b;
+    size_t row;
+    size_t column;
+
+    constexpr typename A::value_type operator()(size_t k) const
+    {
+        return a.at(k * A::rows_count + row) * b.at(column * B::rows_count + k);
+    }
+};
+
+// row I % R of a times column I / R of b
+template <typename T, size_t R, size_t K, size_t C, size_t... I>
+constexpr matrix_t<T, R, C> matrix_product(const matrix_t<T, R, K>& a, const matrix_t<T, K, C>& b, index_list<I...>)
+{
+    return matrix_t<T, R, C>::columns(unroll<K>::sum(product_terms<matrix_t<T, R, K>, matrix_t<T, K, C>>{ a, b, I % R, I / R })...);
+}
+
+// m(row, k) * v[k]
+template <typename T, size_t R, size_t C>
+struct vector_product_terms
+{
+    const matrix_t<T, R, C>& m;
+    const vector_t<T, C>& v;
+    size_t row;
+
+    constexpr T operator()(size_t k) const
+    {
+        return m.at(k * R + row) * v.values[k];
+    }
+};
+
+template <typename T, size_t R, size_t C, size_t... I>
+constexpr vector_t<T, R> matrix_vector_product(const matrix_t<T, R, C>& m, const vector_t<T, C>& v, index_list<I...>)
+{
+    return{ { unroll<C>::sum(vector_product_terms<T, R, C>{ m, v, I })... } };
+}
+
+template <typename T, size_t R, size_t C, size_t... I>
+constexpr vector_t<T, C> matrix_row(const matrix_t<T, R, C>& m, size_t row, index_list<I...>)
+{
+    return{ { m.at(I * R + row)... } };
+}
+
+template <typename M>
+struct equal_elements
+{
+    const M& a;
+    const M& b;
+
+    constexpr bool operator()(size_t i) const
+    {
+        return a.at(i) == b.at(i);
+    }
+};
+
+template <typename M>
+struct close_elements
+{
+    const M& a;
+    const M& b;
+    typename M::value_type epsilon;
+
+    bool operator()(size_t i) const
+    {
+        return close(a.at(i), b.at(i), epsilon);
+    }
+};
+
+template <typename M>
+struct finite_elements
+{
+    const M& a;
+
+    bool operator()(size_t i) const
+    {
+        return std::isfinite(a.at(i));
+    }
+};
+
+// the determinant and the inverse of the upper left N x N of any matrix with
+// operator()(row, column)
+template <size_t N>
+struct square_matrix;
+
+template <>
+struct square_matrix<2>
+{
+    template <typename M>
+    static constexpr typename M::value_type determinant(const M& a)
+    {
+        return a(0, 0)*a(1, 1) - a(0, 1)*a(1, 0);
+    }
+
+    template <typename Ret, typename M>
+    static Ret inverse(const M& a, typename M::value_type& out_determinant)
+    {
+        typedef typename M::value_type T;
+        out_determinant = determinant(a);
+        const T inv_det = T(1) / out_determinant;
+        return Ret::columns(
+            a(1, 1) * inv_det, -a(1, 0) * inv_det,
+            -a(0, 1) * inv_det, a(0, 0) * inv_det
+        );
+    }
+};
+
+template <>
+struct square_matrix<3>
+{
+    template <typename M>
+    static constexpr typename M::value_type determinant(const M& a)
+    {
+        return
+            -a(0, 2)*a(1, 1)*a(2, 0) + a(0, 1)*a(1, 2)*a(2, 0) + a(0, 2)*a(1, 0)*a(2, 1) -
+            a(0, 0)*a(1, 2)*a(2, 1) - a(0, 1)*a(1, 0)*a(2, 2) + a(0, 0)*a(1, 1)*a(2, 2);
+    }
+
+    template <typename Ret, typename M>
+    static Ret inverse(const M& a, typename M::value_type& out_determinant)
+    {
+        typedef typename M::value_type T;
+        const T c00 = - a(1, 2)*a(2, 1) + a(1, 1)*a(2, 2);
+        const T c10 = + a(1, 2)*a(2, 0) - a(1, 0)*a(2, 2);
+        const T c20 = - a(1, 1)*a(2, 0) + a(1, 0)*a(2, 1);
+
+        out_determinant = a(0, 0)*c00 + a(0, 1)*c10 + a(0, 2)*c20;
+        const T inv_det = T(1) / out_determinant;
+
+        const T c01 = + a(0, 2)*a(2, 1) - a(0, 1)*a(2, 2);
+        const T c11 = - a(0, 2)*a(2, 0) + a(0, 0)*a(2, 2);
+        const T c21 = + a(0, 1)*a(2, 0) - a(0, 0)*a(2, 1);
+
+        const T c02 = - a(0, 2)*a(1, 1) + a(0, 1)*a(1, 2);
+        const T c12 = + a(0, 2)*a(1, 0) - a(0, 0)*a(1, 2);
+        const T c22 = - a(0, 1)*a(1, 0) + a(0, 0)*a(1, 1);
+
+        return Ret::columns(
+            c00 * inv_det, c10 * inv_det, c20 * inv_det,
+            c01 * inv_det, c11 * inv_det, c21 * inv_det,
+            c02 * inv_det, c12 * inv_det, c22 * inv_det
+        );
+    }
+};
+
+}
+
+template <typename T, size_t R, size_t C>
+class matrix_t
+{
+    static_assert(R > 0 && C > 0, "yama::matrix_t needs at least one row and column");
+    typedef typename internal::make_index_list<R * C>::type indices;
+
+public:
+    T values[R * C];
+
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef typename std::reverse_iterator<iterator> reverse_iterator;
+    typedef typename std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type rows_count = R;
+    static constexpr size_type columns_count = C;
+    static constexpr size_type value_count = R * C;
+
+    constexpr size_type max_size() const { return value_count; }
+    constexpr size_type size() const { return max_size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // named constructors
+
+    // the values of column 0, then column 1 and so on
+    template <typename... Args>
+    static constexpr matrix_t columns(const Args&... args)
+    {
+        static_assert(sizeof...(Args) == R * C, "yama::matrix_t::columns needs a value for each element");
+        return{ { value_type(args)... } };
+    }
+
+    // the values of row 0, then row 1 and so on
+    template <typename... Args>
+    static constexpr matrix_t rows(const Args&... args)
+    {
+        static_assert(sizeof...(Args) == R * C, "yama::matrix_t::rows needs a value for each element");
+        return transpose(matrix_t<T, C, R>::columns(args...));
+    }
+
+    static constexpr matrix_t uniform(const value_type& s)
+    {
+        return internal::matrix_uniform<T, R, C>(s, indices());
+    }
+
+    static constexpr matrix_t zero()
+    {
+        return uniform(value_type(0));
+    }
+
+    // ones on the main diagonal and zeroes elsewhere, also for non-square matrices
+    static constexpr matrix_t identity()
+    {
+        return internal::matrix_identity<T, R, C>(indices());
+    }
+
+    static matrix_t from_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_CRIT(ptr, "Constructing yama::matrix_t from nullptr");
+        return internal::matrix_from_ptr<T, R, C>(ptr, indices());
+    }
+
+    // from a type with the same rows and columns, like matrix3x4_t for 3 x 4
+    template <typename M>
+    static matrix_t from(const M& m)
+    {
+        static_assert(M::rows_count == R && M::columns_count == C, "yama::matrix_t::from a type of a different size");
+        return from_ptr(m.data());
+    }
+
+    ///////////////////////////
+    // attach
+    static matrix_t& attach_to_ptr(value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::matrix_t to nullptr");
+        return *reinterpret_cast<matrix_t*>(ptr);
+    }
+
+    static const matrix_t& attach_to_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::matrix_t to nullptr");
+        return *reinterpret_cast<const matrix_t*>(ptr);
+    }
+
+    static matrix_t* attach_to_array(value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::matrix_t to nullptr");
+        return reinterpret_cast<matrix_t*>(ptr);
+    }
+
+    static const matrix_t* attach_to_array(const value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::matrix_t to nullptr");
+        return reinterpret_cast<const matrix_t*>(ptr);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // access
+    value_type* data()
+    {
+        return values;
+    }
+
+    constexpr const value_type* data() const
+    {
+        return values;
+    }
+
+    value_type& at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < value_count, "yama::matrix_t index overflow");
+        return values[i];
+    }
+
+    constexpr const value_type& at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT14(i < value_count, "yama::matrix_t index overflow");
+        return values[i];
+    }
+
+    value_type& operator()(size_type row, size_type column)
+    {
+        YAMA_ASSERT_CRIT(row < R && column < C, "yama::matrix_t index overflow");
+        return values[column * R + row];
+    }
+
+    constexpr const value_type& operator()(size_type row, size_type column) const
+    {
+        YAMA_ASSERT_CRIT14(row < R && column < C, "yama::matrix_t index overflow");
+        return values[column * R + row];
+    }
+
+    value_type* column(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < C, "yama::matrix_t column index overflow");
+        return values + i * R;
+    }
+
+    const value_type* column(size_type i) const
+    {
+        YAMA_ASSERT_CRIT(i < C, "yama::matrix_t column index overflow");
+        return values + i * R;
+    }
+
+    vector_t<value_type, R>& column_vector(size_type i)
+    {
+        return vector_t<value_type, R>::attach_to_ptr(column(i));
+    }
+
+    const vector_t<value_type, R>& column_vector(size_type i) const
+    {
+        return vector_t<value_type, R>::attach_to_ptr(column(i));
+    }
+
+    constexpr vector_t<value_type, C> row_vector(size_type i) const
+    {
+        YAMA_ASSERT_CRIT14(i < R, "yama::matrix_t row index overflow");
+        return internal::matrix_row(*this, i, typename internal::make_index_list<C>::type());
+    }
+
+    ///////////////////////////
+    // cast
+
+    value_type* as_ptr()
+    {
+        return data();
+    }
+
+    const value_type* as_ptr() const
+    {
+        return data();
+    }
+
+    template <typename S>
+    matrix_t<S, R, C> as_matrix_t() const
+    {
+        matrix_t<S, R, C> ret;
+        std::copy(begin(), end(), ret.begin());
+        return ret;
+    }
+
+    // to a type with the same rows and columns, like matrix3x4_t for 3 x 4
+    template <typename M>
+    M as() const
+    {
+        static_assert(M::rows_count == R && M::columns_count == C, "yama::matrix_t::as a type of a different size");
+        return M::from_ptr(data());
+    }
+
+    ///////////////////////////
+    // std
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + value_count;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + value_count;
+    }
+
+    value_type& front()
+    {
+        return at(0);
+    }
+
+    value_type& back()
+    {
+        return at(value_count - 1);
+    }
+
+    constexpr const value_type& front() const
+    {
+        return at(0);
+    }
+
+    constexpr const value_type& back() const
+    {
+        return at(value_count - 1);
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // arithmetic
+
+    constexpr const matrix_t& operator+() const
+    {
+        return *this;
+    }
+
+    constexpr matrix_t operator-() const
+    {
+        return internal::matrix_map<internal::neg_op>(*this, indices());
+    }
+
+    matrix_t& operator+=(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::add_op>(*this, b, indices());
+    }
+
+    matrix_t& operator-=(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::sub_op>(*this, b, indices());
+    }
+
+    matrix_t& operator*=(const value_type& s)
+    {
+        return *this = internal::matrix_zip<internal::mul_op>(*this, s, indices());
+    }
+
+    matrix_t& operator/=(const value_type& s)
+    {
+        YAMA_ASSERT_WARN(s != 0, "yama::matrix_t division by zero");
+        return *this = internal::matrix_zip<internal::div_op>(*this, s, indices());
+    }
+
+    // *this = *this * b
+    matrix_t& operator*=(const matrix_t<T, C, C>& b)
+    {
+        return *this = internal::matrix_product(*this, b, indices());
+    }
+
+    matrix_t& mul(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::mul_op>(*this, b, indices());
+    }
+
+    matrix_t& div(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::div_op>(*this, b, indices());
+    }
+
+    // 2x2 and 3x3 only
+    constexpr value_type determinant() const
+    {
+        static_assert(R == C && (R == 2 || R == 3), "yama::matrix_t::determinant needs a 2x2 or a 3x3 matrix");
+        return internal::square_matrix<R>::determinant(*this);
+    }
+
+    // 2x2 and 3x3 only
+    // returns determinant
+    value_type inverse()
+    {
+        static_assert(R == C && (R == 2 || R == 3), "yama::matrix_t::inverse needs a 2x2 or a 3x3 matrix");
+        value_type det;
+        *this = internal::square_matrix<R>::template inverse<matrix_t>(*this, det);
+        return det;
+    }
+};
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, C, R> transpose(const matrix_t<T, R, C>& a)
+{
+    return internal::matrix_transpose(a, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr bool operator==(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b)
+{
+    return internal::unroll<R * C>::all(internal::equal_elements<matrix_t<T, R, C>>{ a, b });
+}
+
+template <typename T, size_t R, size_t C>
+constexpr bool operator!=(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b)
+{
+    return !(a == b);
+}
+
+template <typename T, size_t R, size_t C>
+bool close(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b, const T& epsilon = constants_t<T>::EPSILON())
+{
+    return internal::unroll<R * C>::all(internal::close_elements<matrix_t<T, R, C>>{ a, b, epsilon });
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> operator+(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b)
+{
+    return internal::matrix_zip<internal::add_op>(a, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> operator-(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b)
+{
+    return internal::matrix_zip<internal::sub_op>(a, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> operator*(const matrix_t<T, R, C>& a, const T& s)
+{
+    return internal::matrix_zip<internal::mul_op>(a, s, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> operator*(const T& s, const matrix_t<T, R, C>& b)
+{
+    return internal::matrix_zip<internal::mul_op>(s, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+matrix_t<T, R, C> operator/(const matrix_t<T, R, C>& a, const T& s)
+{
+    YAMA_ASSERT_WARN(s != 0, "yama::matrix_t division by zero");
+    return internal::matrix_zip<internal::div_op>(a, s, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> operator/(const T& s, const matrix_t<T, R, C>& b)
+{
+    return internal::matrix_zip<internal::div_op>(s, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t K, size_t C>
+constexpr matrix_t<T, R, C> operator*(const matrix_t<T, R, K>& a, const matrix_t<T, K, C>& b)
+{
+    return internal::matrix_product(a, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr vector_t<T, R> operator*(const matrix_t<T, R, C>& m, const vector_t<T, C>& v)
+{
+    return internal::matrix_vector_product(m, v, typename internal::make_index_list<R>::type());
+}
+
+template <typename T, size_t R, size_t C>
+matrix_t<T, R, C> abs(const matrix_t<T, R, C>& a)
+{
+    return internal::matrix_map<internal::abs_op>(a, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> mul(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b)
+{
+    return internal::matrix_zip<internal::mul_op>(a, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+constexpr matrix_t<T, R, C> div(const matrix_t<T, R, C>& a, const matrix_t<T, R, C>& b)
+{
+    return internal::matrix_zip<internal::div_op>(a, b, typename internal::make_index_list<R * C>::type());
+}
+
+template <typename T, size_t R, size_t C>
+bool isfinite(const matrix_t<T, R, C>& a)
+{
+    return internal::unroll<R * C>::all(internal::finite_elements<matrix_t<T, R, C>>{ a });
+}
+
+// for the matrices which have inverse(), like the 2x2 and 3x3 ones
+template <typename T, size_t R, size_t C>
+matrix_t<T, R, C> inverse(const matrix_t<T, R, C>& a, T& out_determinant)
+{
+    auto ret = a;
+    out_determinant = ret.inverse();
+    return ret;
+}
+
+template <typename T, size_t R, size_t C>
+matrix_t<T, R, C> inverse(const matrix_t<T, R, C>& a)
+{
+    T det;
+    return inverse(a, det);
+}
+
+// type traits
+template <typename T, size_t R, size_t C>
+struct is_yama<matrix_t<T, R, C>> : public std::true_type {};
+
+template <typename T, size_t R, size_t C>
+struct is_matrix<matrix_t<T, R, C>> : public std::true_type {};
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+template <size_t R, size_t C>
+using matrixn = matrix_t<preferred_type, R, C>;
+
+#endif
+
+}
+
+// the named specialisations, which must be visible wherever matrix_t is used
+#include "matrix2x3.hpp"
+#include "matrix3x3.hpp"
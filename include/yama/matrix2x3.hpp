@@ -0,0 +1,537 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// 2D affine transforms
+// matrix2x3_t is the specialisation of matrix_t for 2x3, with named members.
+// Like matrix3x4_t in 3D, it multiplies as if it had an implied last row of
+// 0 0 1. The other arithmetic and the comparisons are the ones of matrix_t.
+
+#include "dim.hpp"
+#include "matrix4x4.hpp"
+#include "matrix.hpp"
+
+namespace yama
+{
+
+template <typename T>
+class matrix_t<T, 2, 3>
+{
+    typedef typename internal::make_index_list<6>::type indices;
+
+public:
+    T m00, m10;
+    T m01, m11;
+    T m02, m12;
+
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef typename std::reverse_iterator<iterator> reverse_iterator;
+    typedef typename std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type rows_count = 2;
+    static constexpr size_type columns_count = 3;
+    static constexpr size_type value_count = 6;
+
+    constexpr size_type max_size() const { return value_count; }
+    constexpr size_type size() const { return max_size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // named constructors
+
+    static constexpr matrix_t columns(
+        const T& cr00, const T& cr01, //column 0
+        const T& cr10, const T& cr11, //column 1
+        const T& cr20, const T& cr21  //column 2
+    )
+    {
+        return{
+            cr00, cr01,
+            cr10, cr11,
+            cr20, cr21
+        };
+    }
+
+    static constexpr matrix_t rows(
+        const T& rc00, const T& rc01, const T& rc02, //row 0
+        const T& rc10, const T& rc11, const T& rc12  //row 1
+    )
+    {
+        return{
+            rc00, rc10,
+            rc01, rc11,
+            rc02, rc12
+        };
+    }
+
+    static constexpr matrix_t uniform(const value_type& s)
+    {
+        return internal::matrix_uniform<T, 2, 3>(s, indices());
+    }
+
+    static constexpr matrix_t zero()
+    {
+        return uniform(value_type(0));
+    }
+
+    static matrix_t from_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_CRIT(ptr, "Constructing yama::matrix2x3_t from nullptr");
+        return internal::matrix_from_ptr<T, 2, 3>(ptr, indices());
+    }
+
+    static constexpr matrix_t identity()
+    {
+        return internal::matrix_identity<T, 2, 3>(indices());
+    }
+
+    // from a type with the same rows and columns
+    template <typename M>
+    static matrix_t from(const M& m)
+    {
+        static_assert(M::rows_count == 2 && M::columns_count == 3, "yama::matrix2x3_t::from a type of a different size");
+        return from_ptr(m.data());
+    }
+
+    ////////////////////////////////////////////////////////
+    // transforms
+
+    static constexpr matrix_t translation(const value_type& x, const value_type& y)
+    {
+        return rows(
+            1, 0, x,
+            0, 1, y
+        );
+    }
+
+    static constexpr matrix_t translation(const vector2_t<T>& pos)
+    {
+        return translation(pos.x, pos.y);
+    }
+
+    static constexpr matrix_t scaling_uniform(const value_type& s)
+    {
+        YAMA_ASSERT_WARN14(!close(s, value_type(0)), "scale shouldn't be zero");
+        return columns(
+            s, 0,
+            0, s,
+            0, 0
+        );
+    }
+
+    static constexpr matrix_t scaling(const value_type& x, const value_type& y)
+    {
+        YAMA_ASSERT_WARN14(!close(x, value_type(0)), "scale shouldn't be zero");
+        YAMA_ASSERT_WARN14(!close(y, value_type(0)), "scale shouldn't be zero");
+        return columns(
+            x, 0,
+            0, y,
+            0, 0
+        );
+    }
+
+    static constexpr matrix_t scaling(const vector2_t<T>& s)
+    {
+        return scaling(s.x, s.y);
+    }
+
+    // counter-clockwise for a y-up coordinate system
+    static matrix_t rotation(const value_type& radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_sincos(s, c);
+    }
+
+    static constexpr matrix_t rotation_sincos(value_type s, value_type c)
+    {
+        return rows(
+            c, -s, 0,
+            s,  c, 0
+        );
+    }
+
+    // x is moved by tan(x_radians) * y and y by tan(y_radians) * x
+    static matrix_t skew(const value_type& x_radians, const value_type& y_radians)
+    {
+        return skew_factors(std::tan(x_radians), std::tan(y_radians));
+    }
+
+    // skew with the tangents of the angles
+    static constexpr matrix_t skew_factors(const value_type& x, const value_type& y)
+    {
+        return rows(
+            1, x, 0,
+            y, 1, 0
+        );
+    }
+
+    ///////////////////////////
+    // attach
+    static matrix_t& attach_to_ptr(value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::matrix2x3_t to nullptr");
+        return *reinterpret_cast<matrix_t*>(ptr);
+    }
+
+    static const matrix_t& attach_to_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::matrix2x3_t to nullptr");
+        return *reinterpret_cast<const matrix_t*>(ptr);
+    }
+
+    static matrix_t* attach_to_array(value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::matrix2x3_t to nullptr");
+        return reinterpret_cast<matrix_t*>(ptr);
+    }
+
+    static const matrix_t* attach_to_array(const value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::matrix2x3_t to nullptr");
+        return reinterpret_cast<const matrix_t*>(ptr);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // access
+    value_type* data()
+    {
+        return reinterpret_cast<value_type*>(this);
+    }
+
+    constexpr const value_type* data() const
+    {
+        return reinterpret_cast<const value_type*>(this);
+    }
+
+    value_type& at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < value_count, "yama::matrix2x3_t index overflow");
+        return data()[i];
+    }
+
+    // through the members, so it is constexpr
+    constexpr const value_type& at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT14(i < value_count, "yama::matrix2x3_t index overflow");
+        return this->*member(i);
+    }
+
+    value_type& operator[](size_type i)
+    {
+        return at(i);
+    }
+
+    constexpr const value_type& operator[](size_type i) const
+    {
+        return at(i);
+    }
+
+    value_type* column(size_t i)
+    {
+        YAMA_ASSERT_CRIT(i < columns_count, "yama::matrix2x3_t column index overflow");
+        return data() + rows_count * i;
+    }
+
+    constexpr const value_type* column(size_t i) const
+    {
+        YAMA_ASSERT_CRIT14(i < columns_count, "yama::matrix2x3_t column index overflow");
+        return data() + rows_count * i;
+    }
+
+    value_type& m(size_t row, size_t col)
+    {
+        return column(col)[row];
+    }
+
+    constexpr const value_type& m(size_t row, size_t col) const
+    {
+        return at(col * rows_count + row);
+    }
+
+    value_type& operator()(size_t row, size_t col)
+    {
+        return m(row, col);
+    }
+
+    constexpr const value_type& operator()(size_t row, size_t col) const
+    {
+        return m(row, col);
+    }
+
+    vector2_t<value_type>& column_vector(size_t col)
+    {
+        return vector2_t<value_type>::attach_to_ptr(column(col));
+    }
+
+    const vector2_t<value_type>& column_vector(size_t col) const
+    {
+        return vector2_t<value_type>::attach_to_ptr(column(col));
+    }
+
+    vector3_t<value_type> row_vector(size_t row) const
+    {
+        return vector3_t<value_type>::coord(m(row, 0), m(row, 1), m(row, 2));
+    }
+
+    ///////////////////////////
+    // cast
+
+    value_type* as_ptr()
+    {
+        return data();
+    }
+
+    const value_type* as_ptr() const
+    {
+        return data();
+    }
+
+    template <typename S>
+    matrix_t<S, 2, 3> as_matrix2x3_t() const
+    {
+        return matrix_t<S, 2, 3>::columns(
+            S(m00), S(m10),
+            S(m01), S(m11),
+            S(m02), S(m12)
+        );
+    }
+
+    // to a type with the same rows and columns
+    template <typename M>
+    M as() const
+    {
+        static_assert(M::rows_count == 2 && M::columns_count == 3, "yama::matrix2x3_t::as a type of a different size");
+        return M::from_ptr(data());
+    }
+
+    // the same transform in the xy plane, for example for a vertex shader
+    constexpr matrix4x4_t<value_type> to_matrix4x4() const
+    {
+        return matrix4x4_t<value_type>::rows(
+            m00, m01, 0, m02,
+            m10, m11, 0, m12,
+            0, 0, 1, 0,
+            0, 0, 0, 1
+        );
+    }
+
+    ///////////////////////////
+    // std
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + value_count;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + value_count;
+    }
+
+    value_type& front()
+    {
+        return at(0);
+    }
+
+    value_type& back()
+    {
+        return at(value_count - 1);
+    }
+
+    constexpr const value_type& front() const
+    {
+        return at(0);
+    }
+
+    constexpr const value_type& back() const
+    {
+        return at(value_count - 1);
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // arithmetic
+
+    constexpr const matrix_t& operator+() const
+    {
+        return *this;
+    }
+
+    constexpr matrix_t operator-() const
+    {
+        return internal::matrix_map<internal::neg_op>(*this, indices());
+    }
+
+    matrix_t& operator+=(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::add_op>(*this, b, indices());
+    }
+
+    matrix_t& operator-=(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::sub_op>(*this, b, indices());
+    }
+
+    matrix_t& operator*=(const value_type& s)
+    {
+        return *this = internal::matrix_zip<internal::mul_op>(*this, s, indices());
+    }
+
+    matrix_t& operator/=(const value_type& s)
+    {
+        YAMA_ASSERT_WARN(s != 0, "yama::matrix2x3_t division by zero");
+        return *this = internal::matrix_zip<internal::div_op>(*this, s, indices());
+    }
+
+    // the affine product, as operator* below
+    matrix_t& operator*=(const matrix_t& b)
+    {
+        auto c00 = m00 * b.m00 + m01 * b.m10;
+        auto c10 = m10 * b.m00 + m11 * b.m10;
+        auto c01 = m00 * b.m01 + m01 * b.m11;
+        auto c11 = m10 * b.m01 + m11 * b.m11;
+        auto c02 = m00 * b.m02 + m01 * b.m12 + m02;
+        auto c12 = m10 * b.m02 + m11 * b.m12 + m12;
+
+        m00 = c00; m10 = c10;
+        m01 = c01; m11 = c11;
+        m02 = c02; m12 = c12;
+
+        return *this;
+    }
+
+    matrix_t& mul(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::mul_op>(*this, b, indices());
+    }
+
+    matrix_t& div(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::div_op>(*this, b, indices());
+    }
+
+    // of the linear part
+    constexpr value_type determinant() const
+    {
+        return internal::square_matrix<2>::determinant(*this);
+    }
+
+    // returns determinant
+    value_type inverse()
+    {
+        value_type det;
+        const auto l = internal::square_matrix<2>::inverse<matrix_t<T, 2, 2>>(*this, det);
+
+        auto c02 = -(l(0, 0)*m02 + l(0, 1)*m12);
+        auto c12 = -(l(1, 0)*m02 + l(1, 1)*m12);
+
+        *this = columns(
+            l(0, 0), l(1, 0),
+            l(0, 1), l(1, 1),
+            c02, c12
+        );
+
+        return det;
+    }
+
+private:
+    static constexpr value_type matrix_t::* member(size_type i)
+    {
+        return
+            i == 0 ? &matrix_t::m00 : i == 1 ? &matrix_t::m10 :
+            i == 2 ? &matrix_t::m01 : i == 3 ? &matrix_t::m11 :
+            i == 4 ? &matrix_t::m02 : &matrix_t::m12;
+    }
+};
+
+template <typename T>
+using matrix2x3_t = matrix_t<T, 2, 3>;
+
+// the affine product: a after b
+// The generic product of matrix_t doesn't apply, as 2x3 times 2x3 isn't defined.
+template <typename T>
+matrix2x3_t<T> operator*(const matrix2x3_t<T>& a, const matrix2x3_t<T>& b)
+{
+    return matrix2x3_t<T>::columns(
+        a.m00 * b.m00 + a.m01 * b.m10,
+        a.m10 * b.m00 + a.m11 * b.m10,
+        a.m00 * b.m01 + a.m01 * b.m11,
+        a.m10 * b.m01 + a.m11 * b.m11,
+        a.m00 * b.m02 + a.m01 * b.m12 + a.m02,
+        a.m10 * b.m02 + a.m11 * b.m12 + a.m12
+    );
+}
+
+// for rotation and translation only: the inverse rotation is the transpose
+template <typename T>
+matrix2x3_t<T> inverse_rigid(const matrix2x3_t<T>& a)
+{
+    return matrix2x3_t<T>::columns(
+        a.m00, a.m01,
+        a.m10, a.m11,
+        -(a.m00*a.m02 + a.m10*a.m12),
+        -(a.m01*a.m02 + a.m11*a.m12)
+    );
+}
+
+template <typename T>
+vector2_t<T> transform_coord(const vector2_t<T>& v, const matrix2x3_t<T>& m)
+{
+    vector2_t<T> out;
+
+    out.x = m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2);
+    out.y = m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2);
+
+    return out;
+}
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef matrix2x3_t<preferred_type> matrix2x3;
+
+#endif
+
+}
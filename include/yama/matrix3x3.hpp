@@ -0,0 +1,816 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Linear 3x3 matrices
+// For rotations, scaling, inertia tensors and normal matrices, where the
+// translation column of matrix3x4_t would be unused.
+// matrix3x3_t is the specialisation of matrix_t for 3x3, with named members.
+// The arithmetic, the comparisons, transpose, determinant and inverse are the
+// ones of matrix_t.
+// padded_matrix3x3_t stores the same matrix with each column padded to four
+// values, so with YAMA_SIMD the columns are loaded as whole SIMD registers.
+
+#include "dim.hpp"
+#include "quaternion.hpp"
+#include "matrix3x4.hpp"
+#include "matrix4x4.hpp"
+#include "matrix.hpp"
+#include "simd.hpp"
+
+namespace yama
+{
+
+template <typename T>
+class matrix_t<T, 3, 3>
+{
+    typedef typename internal::make_index_list<9>::type indices;
+
+public:
+    T m00, m10, m20;
+    T m01, m11, m21;
+    T m02, m12, m22;
+
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef typename std::reverse_iterator<iterator> reverse_iterator;
+    typedef typename std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type rows_count = 3;
+    static constexpr size_type columns_count = 3;
+    static constexpr size_type value_count = 9;
+
+    constexpr size_type max_size() const { return value_count; }
+    constexpr size_type size() const { return max_size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // named constructors
+
+    static constexpr matrix_t columns(
+        const T& cr00, const T& cr01, const T& cr02, //column 0
+        const T& cr10, const T& cr11, const T& cr12, //column 1
+        const T& cr20, const T& cr21, const T& cr22  //column 2
+    )
+    {
+        return{
+            cr00, cr01, cr02,
+            cr10, cr11, cr12,
+            cr20, cr21, cr22
+        };
+    }
+
+    static constexpr matrix_t rows(
+        const T& rc00, const T& rc01, const T& rc02, //row 0
+        const T& rc10, const T& rc11, const T& rc12, //row 1
+        const T& rc20, const T& rc21, const T& rc22  //row 2
+    )
+    {
+        return{
+            rc00, rc10, rc20,
+            rc01, rc11, rc21,
+            rc02, rc12, rc22
+        };
+    }
+
+    static constexpr matrix_t uniform(const value_type& s)
+    {
+        return internal::matrix_uniform<T, 3, 3>(s, indices());
+    }
+
+    static constexpr matrix_t zero()
+    {
+        return uniform(value_type(0));
+    }
+
+    static matrix_t from_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_CRIT(ptr, "Constructing yama::matrix3x3_t from nullptr");
+        return internal::matrix_from_ptr<T, 3, 3>(ptr, indices());
+    }
+
+    static constexpr matrix_t identity()
+    {
+        return internal::matrix_identity<T, 3, 3>(indices());
+    }
+
+    // from a type with the same rows and columns
+    template <typename M>
+    static matrix_t from(const M& m)
+    {
+        static_assert(M::rows_count == 3 && M::columns_count == 3, "yama::matrix3x3_t::from a type of a different size");
+        return from_ptr(m.data());
+    }
+
+    // the upper 3x3 of a matrix3x4_t or a matrix4x4_t
+    template <typename M>
+    static constexpr matrix_t from_matrix(const M& m)
+    {
+        return columns(
+            m.m00, m.m10, m.m20,
+            m.m01, m.m11, m.m21,
+            m.m02, m.m12, m.m22
+        );
+    }
+
+    ////////////////////////////////////////////////////////
+    // transforms
+
+    static constexpr matrix_t scaling_uniform(const value_type& s)
+    {
+        YAMA_ASSERT_WARN14(!close(s, value_type(0)), "scale shouldn't be zero");
+        return columns(
+            s, 0, 0,
+            0, s, 0,
+            0, 0, s
+        );
+    }
+
+    static constexpr matrix_t scaling(const value_type& x, const value_type& y, const value_type& z)
+    {
+        YAMA_ASSERT_WARN14(!close(x, value_type(0)), "scale shouldn't be zero");
+        YAMA_ASSERT_WARN14(!close(y, value_type(0)), "scale shouldn't be zero");
+        YAMA_ASSERT_WARN14(!close(z, value_type(0)), "scale shouldn't be zero");
+        return columns(
+            x, 0, 0,
+            0, y, 0,
+            0, 0, z
+        );
+    }
+
+    static constexpr matrix_t scaling(const vector3_t<T>& s)
+    {
+        return scaling(s.x, s.y, s.z);
+    }
+
+    // for when you're sure that the axis is normalized
+    static matrix_t rotation_naxis(const vector3_t<value_type>& axis, value_type radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_naxis_sincos(axis, s, c);
+    }
+
+    // rotation_naxis from the sine and the cosine of the angle
+    static matrix_t rotation_naxis_sincos(const vector3_t<value_type>& axis, value_type s, value_type c)
+    {
+        YAMA_ASSERT_BAD(axis.is_normalized(), "rotation axis should be normalized");
+
+        const value_type c1 = 1 - c;
+        const value_type& x = axis.x;
+        const value_type& y = axis.y;
+        const value_type& z = axis.z;
+
+        return rows(
+            c + c1*sq(x), c1*y*x - s*z, c1*z*x + s*y,
+            c1*x*y + s*z, c + c1*sq(y), c1*z*y - s*x,
+            c1*x*z - s*y, c1*y*z + s*x, c + c1*sq(z)
+        );
+    }
+
+    static matrix_t rotation_axis(const vector3_t<value_type>& axis, value_type radians)
+    {
+        auto naxis = yama::normalize(axis);
+        return rotation_naxis(naxis, radians);
+    }
+
+    static matrix_t rotation_x(const value_type& radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_x_sincos(s, c);
+    }
+
+    static matrix_t rotation_x_sincos(value_type s, value_type c)
+    {
+        return rows(
+            1, 0,  0,
+            0, c, -s,
+            0, s,  c
+        );
+    }
+
+    static matrix_t rotation_y(const value_type& radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_y_sincos(s, c);
+    }
+
+    static matrix_t rotation_y_sincos(value_type s, value_type c)
+    {
+        return rows(
+            c, 0, s,
+            0, 1, 0,
+           -s, 0, c
+        );
+    }
+
+    static matrix_t rotation_z(const value_type& radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_z_sincos(s, c);
+    }
+
+    static matrix_t rotation_z_sincos(value_type s, value_type c)
+    {
+        return rows(
+            c, -s, 0,
+            s,  c, 0,
+            0,  0, 1
+        );
+    }
+
+    static matrix_t rotation_vectors(const vector3_t<value_type>& src, const vector3_t<value_type>& target)
+    {
+        YAMA_ASSERT_BAD(src.is_normalized(), "source vector should be normalized");
+        YAMA_ASSERT_BAD(target.is_normalized(), "target vector should be normalized");
+        YAMA_ASSERT_WARN(!close(src, vector3_t<value_type>::zero()), "source vector shouldn't be zero");
+        YAMA_ASSERT_WARN(!close(target, vector3_t<value_type>::zero()), "target vector shouldn't be zero");
+
+        auto axis = cross(src, target);
+        auto axis_length = axis.normalize();
+
+        if (axis_length > constants_t<value_type>::EPSILON()) // not collinear
+        {
+            auto angle = acos(dot(src, target));
+            return rotation_naxis(axis, angle);
+        }
+        else
+        {
+            // collinear
+            return identity();
+        }
+    }
+
+    static matrix_t rotation_quaternion(const quaternion_t<T>& q)
+    {
+        YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+        YAMA_ASSERT_WARN(!close(q.length_sq(), value_type(0)), "rotating with a broken quaternion");
+
+        const value_type x2 = sq(q.x);
+        const value_type y2 = sq(q.y);
+        const value_type z2 = sq(q.z);
+        const value_type w2 = sq(q.w);
+        const value_type xy = 2 * q.x * q.y;
+        const value_type xz = 2 * q.x * q.z;
+        const value_type xw = 2 * q.x * q.w;
+        const value_type yz = 2 * q.y * q.z;
+        const value_type yw = 2 * q.y * q.w;
+        const value_type zw = 2 * q.z * q.w;
+
+        return rows(
+            w2 + x2 - y2 - z2, xy - zw,           xz + yw,
+            xy + zw,           w2 - x2 + y2 - z2, yz - xw,
+            xz - yw,           yz + xw,           w2 - x2 - y2 + z2
+        );
+    }
+
+    // the inverse transpose of the upper 3x3 of m
+    // Transforms the normals of surfaces transformed by m, so they stay
+    // perpendicular to them under non-uniform scaling.
+    template <typename M>
+    static matrix_t normal_matrix(const M& m)
+    {
+        value_type det;
+        auto ret = yama::inverse(from_matrix(m), det);
+        YAMA_ASSERT_WARN(det != 0, "yama::matrix3x3_t::normal_matrix of a singular matrix");
+        return ret.transpose();
+    }
+
+    ///////////////////////////
+    // attach
+    static matrix_t& attach_to_ptr(value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::matrix3x3_t to nullptr");
+        return *reinterpret_cast<matrix_t*>(ptr);
+    }
+
+    static const matrix_t& attach_to_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::matrix3x3_t to nullptr");
+        return *reinterpret_cast<const matrix_t*>(ptr);
+    }
+
+    static matrix_t* attach_to_array(value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::matrix3x3_t to nullptr");
+        return reinterpret_cast<matrix_t*>(ptr);
+    }
+
+    static const matrix_t* attach_to_array(const value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::matrix3x3_t to nullptr");
+        return reinterpret_cast<const matrix_t*>(ptr);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // access
+    value_type* data()
+    {
+        return reinterpret_cast<value_type*>(this);
+    }
+
+    constexpr const value_type* data() const
+    {
+        return reinterpret_cast<const value_type*>(this);
+    }
+
+    value_type& at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < value_count, "yama::matrix3x3_t index overflow");
+        return data()[i];
+    }
+
+    // through the members, so it is constexpr
+    constexpr const value_type& at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT14(i < value_count, "yama::matrix3x3_t index overflow");
+        return this->*member(i);
+    }
+
+    value_type& operator[](size_type i)
+    {
+        return at(i);
+    }
+
+    constexpr const value_type& operator[](size_type i) const
+    {
+        return at(i);
+    }
+
+    value_type* column(size_t i)
+    {
+        YAMA_ASSERT_CRIT(i < columns_count, "yama::matrix3x3_t column index overflow");
+        return data() + rows_count * i;
+    }
+
+    constexpr const value_type* column(size_t i) const
+    {
+        YAMA_ASSERT_CRIT14(i < columns_count, "yama::matrix3x3_t column index overflow");
+        return data() + rows_count * i;
+    }
+
+    value_type& m(size_t row, size_t col)
+    {
+        return column(col)[row];
+    }
+
+    constexpr const value_type& m(size_t row, size_t col) const
+    {
+        return at(col * rows_count + row);
+    }
+
+    value_type& operator()(size_t row, size_t col)
+    {
+        return m(row, col);
+    }
+
+    constexpr const value_type& operator()(size_t row, size_t col) const
+    {
+        return m(row, col);
+    }
+
+    vector3_t<value_type>& column_vector(size_t col)
+    {
+        return vector3_t<value_type>::attach_to_ptr(column(col));
+    }
+
+    const vector3_t<value_type>& column_vector(size_t col) const
+    {
+        return vector3_t<value_type>::attach_to_ptr(column(col));
+    }
+
+    vector3_t<value_type> row_vector(size_t row) const
+    {
+        return vector3_t<value_type>::coord(m(row, 0), m(row, 1), m(row, 2));
+    }
+
+    vector3_t<value_type> main_diagonal() const
+    {
+        return vector3_t<value_type>::coord(m00, m11, m22);
+    }
+
+    constexpr value_type trace() const
+    {
+        return m00 + m11 + m22;
+    }
+
+    ///////////////////////////
+    // cast
+
+    value_type* as_ptr()
+    {
+        return data();
+    }
+
+    const value_type* as_ptr() const
+    {
+        return data();
+    }
+
+    template <typename S>
+    matrix_t<S, 3, 3> as_matrix3x3_t() const
+    {
+        return matrix_t<S, 3, 3>::columns(
+            S(m00), S(m10), S(m20),
+            S(m01), S(m11), S(m21),
+            S(m02), S(m12), S(m22)
+        );
+    }
+
+    // to a type with the same rows and columns
+    template <typename M>
+    M as() const
+    {
+        static_assert(M::rows_count == 3 && M::columns_count == 3, "yama::matrix3x3_t::as a type of a different size");
+        return M::from_ptr(data());
+    }
+
+    // with a zero translation
+    constexpr matrix3x4_t<value_type> to_matrix3x4() const
+    {
+        return matrix3x4_t<value_type>::columns(
+            m00, m10, m20,
+            m01, m11, m21,
+            m02, m12, m22,
+            0, 0, 0
+        );
+    }
+
+    constexpr matrix4x4_t<value_type> to_matrix4x4() const
+    {
+        return matrix4x4_t<value_type>::columns(
+            m00, m10, m20, 0,
+            m01, m11, m21, 0,
+            m02, m12, m22, 0,
+            0, 0, 0, 1
+        );
+    }
+
+    // the matrix should be a rotation
+    quaternion_t<value_type> to_quaternion() const
+    {
+        auto q = internal::quaternion_from_rotation(
+            m00, m01, m02,
+            m10, m11, m12,
+            m20, m21, m22
+        );
+        q.normalize();
+        return q;
+    }
+
+    ///////////////////////////
+    // std
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + value_count;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + value_count;
+    }
+
+    value_type& front()
+    {
+        return at(0);
+    }
+
+    value_type& back()
+    {
+        return at(value_count - 1);
+    }
+
+    constexpr const value_type& front() const
+    {
+        return at(0);
+    }
+
+    constexpr const value_type& back() const
+    {
+        return at(value_count - 1);
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // arithmetic
+
+    constexpr const matrix_t& operator+() const
+    {
+        return *this;
+    }
+
+    constexpr matrix_t operator-() const
+    {
+        return internal::matrix_map<internal::neg_op>(*this, indices());
+    }
+
+    matrix_t& operator+=(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::add_op>(*this, b, indices());
+    }
+
+    matrix_t& operator-=(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::sub_op>(*this, b, indices());
+    }
+
+    matrix_t& operator*=(const value_type& s)
+    {
+        return *this = internal::matrix_zip<internal::mul_op>(*this, s, indices());
+    }
+
+    matrix_t& operator/=(const value_type& s)
+    {
+        YAMA_ASSERT_WARN(s != 0, "yama::matrix3x3_t division by zero");
+        return *this = internal::matrix_zip<internal::div_op>(*this, s, indices());
+    }
+
+    matrix_t& operator*=(const matrix_t& b)
+    {
+        return *this = internal::matrix_product(*this, b, indices());
+    }
+
+    matrix_t& mul(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::mul_op>(*this, b, indices());
+    }
+
+    matrix_t& div(const matrix_t& b)
+    {
+        return *this = internal::matrix_zip<internal::div_op>(*this, b, indices());
+    }
+
+    matrix_t& transpose()
+    {
+        std::swap(m10, m01);
+        std::swap(m20, m02);
+        std::swap(m21, m12);
+        return *this;
+    }
+
+    constexpr value_type determinant() const
+    {
+        return internal::square_matrix<3>::determinant(*this);
+    }
+
+    // returns determinant
+    value_type inverse()
+    {
+        value_type det;
+        *this = internal::square_matrix<3>::inverse<matrix_t>(*this, det);
+        return det;
+    }
+
+private:
+    static constexpr value_type matrix_t::* member(size_type i)
+    {
+        return
+            i == 0 ? &matrix_t::m00 : i == 1 ? &matrix_t::m10 : i == 2 ? &matrix_t::m20 :
+            i == 3 ? &matrix_t::m01 : i == 4 ? &matrix_t::m11 : i == 5 ? &matrix_t::m21 :
+            i == 6 ? &matrix_t::m02 : i == 7 ? &matrix_t::m12 : &matrix_t::m22;
+    }
+};
+
+template <typename T>
+using matrix3x3_t = matrix_t<T, 3, 3>;
+
+// for rotations only: the inverse is the transpose
+template <typename T>
+matrix3x3_t<T> inverse_rigid(const matrix3x3_t<T>& a)
+{
+    return transpose(a);
+}
+
+namespace internal
+{
+
+template <typename T>
+T frobenius_sq(const matrix3x3_t<T>& a)
+{
+    T ret = 0;
+    for (auto e : a) ret += e * e;
+    return ret;
+}
+
+}
+
+// The orthogonal factor of the polar decomposition a = rotation * stretch,
+// where stretch is symmetric positive semi-definite. This is the closest
+// orthogonal matrix to a. Its determinant has the sign of a's, so for
+// reflections it is a rotation times -1.
+// Computed with the scaled Newton iteration x = (g*x + transpose(inverse(x))/g) / 2
+// from N. Higham, "Computing the Polar Decomposition - with Applications",
+// which converges in a handful of steps. a must not be singular.
+template <typename T>
+matrix3x3_t<T> polar_decomposition(const matrix3x3_t<T>& a)
+{
+    T det;
+    auto x = a;
+    for (int i = 0; i < 32; ++i)
+    {
+        const auto xi = inverse(x, det);
+        YAMA_ASSERT_WARN(det != 0, "yama::polar_decomposition of a singular matrix");
+        const T g = std::sqrt(std::sqrt(internal::frobenius_sq(xi) / internal::frobenius_sq(x)));
+        const auto next = (x * g + transpose(xi) / g) * T(0.5);
+        const T change = internal::frobenius_sq(next - x);
+        x = next;
+        // quadratic convergence: the next step would be below the precision of T
+        if (change <= sq(16 * std::numeric_limits<T>::epsilon())) break;
+    }
+    return x;
+}
+
+// also computes stretch = transpose(rotation) * a
+template <typename T>
+matrix3x3_t<T> polar_decomposition(const matrix3x3_t<T>& a, matrix3x3_t<T>& out_stretch)
+{
+    const auto r = polar_decomposition(a);
+    out_stretch = transpose(r) * a;
+    return r;
+}
+
+template <typename T>
+vector3_t<T> transform_coord(const vector3_t<T>& v, const matrix3x3_t<T>& m)
+{
+    vector3_t<T> out;
+
+    out.x = m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2) * v.z;
+    out.y = m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2) * v.z;
+    out.z = m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z;
+
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// padded storage
+// The columns of a matrix3x3_t at four values each, the fourth always zero,
+// aligned to 16 bytes. For float with YAMA_SIMD products and transforms work
+// on whole columns.
+
+template <typename T>
+class alignas(16) padded_matrix3x3_t
+{
+public:
+    T m00, m10, m20, p0;
+    T m01, m11, m21, p1;
+    T m02, m12, m22, p2;
+
+    typedef T value_type;
+    typedef size_t size_type;
+
+    static constexpr size_type rows_count = 3;
+    static constexpr size_type columns_count = 3;
+    static constexpr size_type column_stride = 4;
+
+    static constexpr padded_matrix3x3_t from(const matrix3x3_t<T>& m)
+    {
+        return{
+            m.m00, m.m10, m.m20, 0,
+            m.m01, m.m11, m.m21, 0,
+            m.m02, m.m12, m.m22, 0
+        };
+    }
+
+    constexpr matrix3x3_t<T> to_matrix3x3() const
+    {
+        return matrix3x3_t<T>::columns(
+            m00, m10, m20,
+            m01, m11, m21,
+            m02, m12, m22
+        );
+    }
+
+    value_type* data()
+    {
+        return reinterpret_cast<value_type*>(this);
+    }
+
+    constexpr const value_type* data() const
+    {
+        return reinterpret_cast<const value_type*>(this);
+    }
+
+    value_type* column(size_t i)
+    {
+        YAMA_ASSERT_CRIT(i < columns_count, "yama::padded_matrix3x3_t column index overflow");
+        return data() + column_stride * i;
+    }
+
+    constexpr const value_type* column(size_t i) const
+    {
+        YAMA_ASSERT_CRIT14(i < columns_count, "yama::padded_matrix3x3_t column index overflow");
+        return data() + column_stride * i;
+    }
+
+    value_type& operator()(size_t row, size_t col)
+    {
+        return column(col)[row];
+    }
+
+    constexpr const value_type& operator()(size_t row, size_t col) const
+    {
+        return column(col)[row];
+    }
+};
+
+template <typename T>
+padded_matrix3x3_t<T> operator*(const padded_matrix3x3_t<T>& a, const padded_matrix3x3_t<T>& b)
+{
+    return padded_matrix3x3_t<T>::from(a.to_matrix3x3() * b.to_matrix3x3());
+}
+
+template <typename T>
+vector3_t<T> transform_coord(const vector3_t<T>& v, const padded_matrix3x3_t<T>& m)
+{
+    return transform_coord(v, m.to_matrix3x3());
+}
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+namespace internal
+{
+
+// a * column, accumulated in the same order as the scalar code
+inline __m128 mul_padded_column3(const float* a, float x, float y, float z)
+{
+    __m128 r = _mm_mul_ps(_mm_load_ps(a), _mm_set1_ps(x));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(a + 4), _mm_set1_ps(y)));
+    return _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(a + 8), _mm_set1_ps(z)));
+}
+
+}
+
+// the generic templates above are still reachable as operator*<float> and transform_coord<float>
+inline padded_matrix3x3_t<float> operator*(const padded_matrix3x3_t<float>& a, const padded_matrix3x3_t<float>& b)
+{
+    padded_matrix3x3_t<float> ret;
+    for (int i = 0; i < 3; ++i)
+    {
+        const float* bc = b.column(i);
+        _mm_store_ps(ret.column(i), internal::mul_padded_column3(a.data(), bc[0], bc[1], bc[2]));
+    }
+    return ret;
+}
+
+inline vector3_t<float> transform_coord(const vector3_t<float>& v, const padded_matrix3x3_t<float>& m)
+{
+    alignas(16) float r[4];
+    _mm_store_ps(r, internal::mul_padded_column3(m.data(), v.x, v.y, v.z));
+    return vector3_t<float>::coord(r[0], r[1], r[2]);
+}
+
+#endif
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef matrix3x3_t<preferred_type> matrix3x3;
+typedef padded_matrix3x3_t<preferred_type> padded_matrix3x3;
+
+#endif
+
+}
@@ -151,11 +151,17 @@ public:
 
     // for when you're sure that the axis is normalized
     static matrix3x4_t rotation_naxis(const vector3_t<value_type>& axis, value_type radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_naxis_sincos(axis, s, c);
+    }
+
+    // rotation_naxis from the sine and the cosine of the angle
+    static matrix3x4_t rotation_naxis_sincos(const vector3_t<value_type>& axis, value_type s, value_type c)
     {
         YAMA_ASSERT_BAD(axis.is_normalized(), "rotation axis should be normalized");
 
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
         const value_type c1 = 1 - c;
         const value_type& x = axis.x;
         const value_type& y = axis.y;
@@ -176,9 +182,13 @@ public:
 
     static matrix3x4_t rotation_x(const value_type& radians)
     {
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_x_sincos(s, c);
+    }
 
+    static matrix3x4_t rotation_x_sincos(value_type s, value_type c)
+    {
         return rows(
             1, 0,  0, 0,
             0, c, -s, 0,
@@ -188,9 +198,13 @@ public:
 
     static matrix3x4_t rotation_y(const value_type& radians)
     {
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_y_sincos(s, c);
+    }
 
+    static matrix3x4_t rotation_y_sincos(value_type s, value_type c)
+    {
         return rows(
             c, 0, s, 0,
             0, 1, 0, 0,
@@ -200,9 +214,13 @@ public:
 
     static matrix3x4_t rotation_z(const value_type& radians)
     {
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_z_sincos(s, c);
+    }
 
+    static matrix3x4_t rotation_z_sincos(value_type s, value_type c)
+    {
         return rows(
             c, -s, 0, 0,
             s,  c, 0, 0,
@@ -433,6 +451,19 @@ public:
         );
     }
 
+    // the upper 3x3 should be a rotation
+    // Use decompose from transform.hpp for matrices with scaling.
+    quaternion_t<value_type> to_quaternion() const
+    {
+        auto q = internal::quaternion_from_rotation(
+            m00, m01, m02,
+            m10, m11, m12,
+            m20, m21, m22
+        );
+        q.normalize();
+        return q;
+    }
+
     ///////////////////////////
     // std
 
@@ -567,13 +598,14 @@ public:
         auto c02 = m00 * b.m02 + m01 * b.m12 + m02 * b.m22;
         auto c12 = m10 * b.m02 + m11 * b.m12 + m12 * b.m22;
         auto c22 = m20 * b.m02 + m21 * b.m12 + m22 * b.m22;
-        m03 = m00 * b.m03 + m01 * b.m13 + m02 * b.m23 + m03;
-        m13 = m10 * b.m03 + m11 * b.m13 + m12 * b.m23 + m13;
-        m23 = m20 * b.m03 + m21 * b.m13 + m22 * b.m23 + m23;
+        auto c03 = m00 * b.m03 + m01 * b.m13 + m02 * b.m23 + m03;
+        auto c13 = m10 * b.m03 + m11 * b.m13 + m12 * b.m23 + m13;
+        auto c23 = m20 * b.m03 + m21 * b.m13 + m22 * b.m23 + m23;
 
         m00 = c00; m10 = c10; m20 = c20;
         m01 = c01; m11 = c11; m21 = c21;
         m02 = c02; m12 = c12; m22 = c22;
+        m03 = c03; m13 = c13; m23 = c23;
 
         return *this;
     }
@@ -610,19 +642,20 @@ public:
     value_type determinant() const
     {
         return
-            m02*m11*m20 + m01*m12*m20 + m02*m10*m21 -
+            -m02*m11*m20 + m01*m12*m20 + m02*m10*m21 -
             m00*m12*m21 - m01*m10*m22 + m00*m11*m22;
     }
 
     // returns determinant
     value_type inverse()
     {
-        auto det = determinant();
-
         auto c00 = - m12*m21 + m11*m22;
         auto c10 = + m12*m20 - m10*m22;
         auto c20 = - m11*m20 + m10*m21;
 
+        auto det = m00*c00 + m01*c10 + m02*c20;
+        auto inv_det = value_type(1) / det;
+
         auto c01 = + m02*m21 - m01*m22;
         auto c11 = - m02*m20 + m00*m22;
         auto c21 = + m01*m20 - m00*m21;
@@ -631,14 +664,14 @@ public:
         auto c12 = + m02*m10 - m00*m12;
         auto c22 = - m01*m10 + m00*m11;
 
-        auto c03 = m03*m12*m21 - m02*m13*m21 - m03*m11*m22 + m01*m13*m22 + m02*m11*m23 - m01*m12*m23;
-        auto c13 = -(m03*m12*m20) + m02*m13*m20 + m03*m10*m22 - m00*m13*m22 - m02*m10*m23 + m00*m12*m23;
-        auto c23 = m03*m11*m20 - m01*m13*m20 - m03*m10*m21 + m00*m13*m21 + m01*m10*m23 - m00*m11*m23;
+        auto c03 = -(c00*m03 + c01*m13 + c02*m23);
+        auto c13 = -(c10*m03 + c11*m13 + c12*m23);
+        auto c23 = -(c20*m03 + c21*m13 + c22*m23);
 
-        m00 = c00 / det; m10 = c10 / det; m20 = c20 / det;
-        m01 = c01 / det; m11 = c11 / det; m21 = c21 / det;
-        m02 = c02 / det; m12 = c12 / det; m22 = c22 / det;
-        m03 = c03 / det; m13 = c13 / det; m23 = c23 / det;
+        m00 = c00 * inv_det; m10 = c10 * inv_det; m20 = c20 * inv_det;
+        m01 = c01 * inv_det; m11 = c11 * inv_det; m21 = c21 * inv_det;
+        m02 = c02 * inv_det; m12 = c12 * inv_det; m22 = c22 * inv_det;
+        m03 = c03 * inv_det; m13 = c13 * inv_det; m23 = c23 * inv_det;
 
         return det;
     }
@@ -802,6 +835,42 @@ bool isfinite(const matrix3x4_t<T>& a)
 }
 
 
+template <typename T>
+matrix3x4_t<T> inverse(const matrix3x4_t<T>& a, T& out_determinant)
+{
+    auto ret = a;
+    out_determinant = ret.inverse();
+    return ret;
+}
+
+template <typename T>
+matrix3x4_t<T> inverse(const matrix3x4_t<T>& a)
+{
+    T det;
+    return inverse(a, det);
+}
+
+// every matrix3x4_t is affine, this is the same as inverse and exists for symmetry with matrix4x4_t
+template <typename T>
+matrix3x4_t<T> inverse_affine(const matrix3x4_t<T>& a)
+{
+    return inverse(a);
+}
+
+// for rotation and translation only: the inverse rotation is the transpose
+template <typename T>
+matrix3x4_t<T> inverse_rigid(const matrix3x4_t<T>& a)
+{
+    return matrix3x4_t<T>::columns(
+        a.m00, a.m01, a.m02,
+        a.m10, a.m11, a.m12,
+        a.m20, a.m21, a.m22,
+        -(a.m00*a.m03 + a.m10*a.m13 + a.m20*a.m23),
+        -(a.m01*a.m03 + a.m11*a.m13 + a.m21*a.m23),
+        -(a.m02*a.m03 + a.m12*a.m13 + a.m22*a.m23)
+    );
+}
+
 template <typename T>
 vector3_t<T> transform_coord(const vector3_t<T>& v, const matrix3x4_t<T>& m)
 {
@@ -9,6 +9,7 @@
 
 #include "dim.hpp"
 #include "quaternion.hpp"
+#include "simd.hpp"
 
 namespace yama
 {
@@ -154,11 +155,17 @@ public:
 
     // for when you're sure that the axis is normalized
     static matrix4x4_t rotation_naxis(const vector3_t<value_type>& axis, value_type radians)
+    {
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_naxis_sincos(axis, s, c);
+    }
+
+    // rotation_naxis from the sine and the cosine of the angle
+    static matrix4x4_t rotation_naxis_sincos(const vector3_t<value_type>& axis, value_type s, value_type c)
     {
         YAMA_ASSERT_BAD(axis.is_normalized(), "rotation axis should be normalized");
 
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
         const value_type c1 = 1 - c;
         const value_type& x = axis.x;
         const value_type& y = axis.y;
@@ -180,9 +187,13 @@ public:
 
     static matrix4x4_t rotation_x(const value_type& radians)
     {
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_x_sincos(s, c);
+    }
 
+    static matrix4x4_t rotation_x_sincos(value_type s, value_type c)
+    {
         return rows(
             1, 0,  0, 0,
             0, c, -s, 0,
@@ -193,9 +204,13 @@ public:
 
     static matrix4x4_t rotation_y(const value_type& radians)
     {
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_y_sincos(s, c);
+    }
 
+    static matrix4x4_t rotation_y_sincos(value_type s, value_type c)
+    {
         return rows(
             c, 0, s, 0,
             0, 1, 0, 0,
@@ -206,9 +221,13 @@ public:
 
     static matrix4x4_t rotation_z(const value_type& radians)
     {
-        const value_type c = std::cos(radians);
-        const value_type s = std::sin(radians);
+        value_type s, c;
+        sincos(radians, s, c);
+        return rotation_z_sincos(s, c);
+    }
 
+    static matrix4x4_t rotation_z_sincos(value_type s, value_type c)
+    {
         return rows(
             c, -s, 0, 0,
             s,  c, 0, 0,
@@ -785,6 +804,19 @@ public:
         );
     }
 
+    // the upper 3x3 should be a rotation
+    // Use decompose from transform.hpp for matrices with scaling.
+    quaternion_t<value_type> to_quaternion() const
+    {
+        auto q = internal::quaternion_from_rotation(
+            m00, m01, m02,
+            m10, m11, m12,
+            m20, m21, m22
+        );
+        q.normalize();
+        return q;
+    }
+
     ///////////////////////////
     // std
 
@@ -922,14 +954,15 @@ public:
         auto c12 = m10 * b.m02 + m11 * b.m12 + m12 * b.m22 + m13 * b.m32;
         auto c22 = m20 * b.m02 + m21 * b.m12 + m22 * b.m22 + m23 * b.m32;
         auto c32 = m30 * b.m02 + m31 * b.m12 + m32 * b.m22 + m33 * b.m32;
-             m03 = m00 * b.m03 + m01 * b.m13 + m02 * b.m23 + m03 * b.m33;
-             m13 = m10 * b.m03 + m11 * b.m13 + m12 * b.m23 + m13 * b.m33;
-             m23 = m20 * b.m03 + m21 * b.m13 + m22 * b.m23 + m23 * b.m33;
-             m33 = m30 * b.m03 + m31 * b.m13 + m32 * b.m23 + m33 * b.m33;
+        auto c03 = m00 * b.m03 + m01 * b.m13 + m02 * b.m23 + m03 * b.m33;
+        auto c13 = m10 * b.m03 + m11 * b.m13 + m12 * b.m23 + m13 * b.m33;
+        auto c23 = m20 * b.m03 + m21 * b.m13 + m22 * b.m23 + m23 * b.m33;
+        auto c33 = m30 * b.m03 + m31 * b.m13 + m32 * b.m23 + m33 * b.m33;
 
         m00 = c00; m10 = c10; m20 = c20; m30 = c30;
         m01 = c01; m11 = c11; m21 = c21; m31 = c31;
         m02 = c02; m12 = c12; m22 = c22; m32 = c32;
+        m03 = c03; m13 = c13; m23 = c23; m33 = c33;
 
         return *this;
     }
@@ -977,31 +1010,51 @@ public:
     }
 
     // returns determinant
+    // Uses the 2x2 minors of the top two and bottom two rows (Laplace expansion)
+    // and divides once.
     value_type inverse()
     {
-        auto det = determinant();
-
-        auto c00 = -(m13*m22*m31) + m12*m23*m31 + m13*m21*m32 - m11*m23*m32 - m12*m21*m33 + m11*m22*m33;
-        auto c10 = m13*m22*m30 - m12*m23*m30 - m13*m20*m32 + m10*m23*m32 + m12*m20*m33 - m10*m22*m33;
-        auto c20 = -(m13*m21*m30) + m11*m23*m30 + m13*m20*m31 - m10*m23*m31 - m11*m20*m33 + m10*m21*m33;
-        auto c30 = m12*m21*m30 - m11*m22*m30 - m12*m20*m31 + m10*m22*m31 + m11*m20*m32 - m10*m21*m32;
-        auto c01 = m03*m22*m31 - m02*m23*m31 - m03*m21*m32 + m01*m23*m32 + m02*m21*m33 - m01*m22*m33;
-        auto c11 = -(m03*m22*m30) + m02*m23*m30 + m03*m20*m32 - m00*m23*m32 - m02*m20*m33 + m00*m22*m33;
-        auto c21 = m03*m21*m30 - m01*m23*m30 - m03*m20*m31 + m00*m23*m31 + m01*m20*m33 - m00*m21*m33;
-        auto c31 = -(m02*m21*m30) + m01*m22*m30 + m02*m20*m31 - m00*m22*m31 - m01*m20*m32 + m00*m21*m32;
-        auto c02 = -(m03*m12*m31) + m02*m13*m31 + m03*m11*m32 - m01*m13*m32 - m02*m11*m33 + m01*m12*m33;
-        auto c12 = m03*m12*m30 - m02*m13*m30 - m03*m10*m32 + m00*m13*m32 + m02*m10*m33 - m00*m12*m33;
-        auto c22 = -(m03*m11*m30) + m01*m13*m30 + m03*m10*m31 - m00*m13*m31 - m01*m10*m33 + m00*m11*m33;
-        auto c32 = m02*m11*m30 - m01*m12*m30 - m02*m10*m31 + m00*m12*m31 + m01*m10*m32 - m00*m11*m32;
-        auto c03 = m03*m12*m21 - m02*m13*m21 - m03*m11*m22 + m01*m13*m22 + m02*m11*m23 - m01*m12*m23;
-        auto c13 = -(m03*m12*m20) + m02*m13*m20 + m03*m10*m22 - m00*m13*m22 - m02*m10*m23 + m00*m12*m23;
-        auto c23 = m03*m11*m20 - m01*m13*m20 - m03*m10*m21 + m00*m13*m21 + m01*m10*m23 - m00*m11*m23;
-        auto c33 = -(m02*m11*m20) + m01*m12*m20 + m02*m10*m21 - m00*m12*m21 - m01*m10*m22 + m00*m11*m22;
-
-        m00 = c00 / det; m10 = c10 / det; m20 = c20 / det; m30 = c30 / det;
-        m01 = c01 / det; m11 = c11 / det; m21 = c21 / det; m31 = c31 / det;
-        m02 = c02 / det; m12 = c12 / det; m22 = c22 / det; m32 = c32 / det;
-        m03 = c03 / det; m13 = c13 / det; m23 = c23 / det; m33 = c33 / det;
+        auto s0 = m00*m11 - m10*m01;
+        auto s1 = m00*m12 - m10*m02;
+        auto s2 = m00*m13 - m10*m03;
+        auto s3 = m01*m12 - m11*m02;
+        auto s4 = m01*m13 - m11*m03;
+        auto s5 = m02*m13 - m12*m03;
+
+        auto c5 = m22*m33 - m32*m23;
+        auto c4 = m21*m33 - m31*m23;
+        auto c3 = m21*m32 - m31*m22;
+        auto c2 = m20*m33 - m30*m23;
+        auto c1 = m20*m32 - m30*m22;
+        auto c0 = m20*m31 - m30*m21;
+
+        auto det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+        auto inv_det = value_type(1) / det;
+
+        auto i00 = (m11*c5 - m12*c4 + m13*c3) * inv_det;
+        auto i01 = (-m01*c5 + m02*c4 - m03*c3) * inv_det;
+        auto i02 = (m31*s5 - m32*s4 + m33*s3) * inv_det;
+        auto i03 = (-m21*s5 + m22*s4 - m23*s3) * inv_det;
+
+        auto i10 = (-m10*c5 + m12*c2 - m13*c1) * inv_det;
+        auto i11 = (m00*c5 - m02*c2 + m03*c1) * inv_det;
+        auto i12 = (-m30*s5 + m32*s2 - m33*s1) * inv_det;
+        auto i13 = (m20*s5 - m22*s2 + m23*s1) * inv_det;
+
+        auto i20 = (m10*c4 - m11*c2 + m13*c0) * inv_det;
+        auto i21 = (-m00*c4 + m01*c2 - m03*c0) * inv_det;
+        auto i22 = (m30*s4 - m31*s2 + m33*s0) * inv_det;
+        auto i23 = (-m20*s4 + m21*s2 - m23*s0) * inv_det;
+
+        auto i30 = (-m10*c3 + m11*c1 - m12*c0) * inv_det;
+        auto i31 = (m00*c3 - m01*c1 + m02*c0) * inv_det;
+        auto i32 = (-m30*s3 + m31*s1 - m32*s0) * inv_det;
+        auto i33 = (m20*s3 - m21*s1 + m22*s0) * inv_det;
+
+        m00 = i00; m10 = i10; m20 = i20; m30 = i30;
+        m01 = i01; m11 = i11; m21 = i21; m31 = i31;
+        m02 = i02; m12 = i12; m22 = i22; m32 = i32;
+        m03 = i03; m13 = i13; m23 = i23; m33 = i33;
 
         return det;
     }
@@ -1126,6 +1179,160 @@ matrix4x4_t<T> operator*(const matrix4x4_t<T>& a, const matrix4x4_t<T>& b)
     );
 }
 
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+namespace internal
+{
+
+// c = a * b for column-major float matrices
+// Every column of the result is a linear combination of the columns of a,
+// accumulated in the same order as the scalar code.
+// c may alias a or b.
+inline void mul_matrix4x4(const float* a, const float* b, float* c)
+{
+#if YAMA_SIMD >= YAMA_SIMD_AVX
+    // two columns of the result per iteration
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a));
+    const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+    const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+    const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+
+    for (int i = 0; i < 16; i += 8)
+    {
+        const __m256 bc = _mm256_loadu_ps(b + i);
+        __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = madd(a1, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = madd(a2, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = madd(a3, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm256_storeu_ps(c + i, r);
+    }
+#else
+    const __m128 a0 = _mm_loadu_ps(a);
+    const __m128 a1 = _mm_loadu_ps(a + 4);
+    const __m128 a2 = _mm_loadu_ps(a + 8);
+    const __m128 a3 = _mm_loadu_ps(a + 12);
+
+    for (int i = 0; i < 16; i += 4)
+    {
+        const __m128 bc = _mm_loadu_ps(b + i);
+        __m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = madd(a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = madd(a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = madd(a3, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm_storeu_ps(c + i, r);
+    }
+#endif
+}
+
+}
+
+// the generic template above is still reachable as operator*<float>
+inline matrix4x4_t<float> operator*(const matrix4x4_t<float>& a, const matrix4x4_t<float>& b)
+{
+    matrix4x4_t<float> ret;
+    internal::mul_matrix4x4(a.data(), b.data(), ret.data());
+    return ret;
+}
+
+template <>
+inline matrix4x4_t<float>& matrix4x4_t<float>::operator*=(const matrix4x4_t<float>& b)
+{
+    internal::mul_matrix4x4(data(), b.data(), data());
+    return *this;
+}
+
+namespace internal
+{
+
+// a[x] a[y] b[z] b[w]
+#define _YAMA_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+
+// The matrix is split into 2x2 blocks, each stored in a vector as (_00, _01, _10, _11).
+// Since inv(transpose(M)) = transpose(inv(M)) the code works on columns as if they were rows.
+
+// a * b
+inline __m128 mul_2x2(__m128 a, __m128 b)
+{
+    return madd(a, _YAMA_SHUFFLE(b, b, 0, 3, 0, 3), _mm_mul_ps(_YAMA_SHUFFLE(a, a, 1, 0, 3, 2), _YAMA_SHUFFLE(b, b, 2, 1, 2, 1)));
+}
+
+// adjugate(a) * b
+inline __m128 adj_mul_2x2(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(_YAMA_SHUFFLE(a, a, 3, 3, 0, 0), b), _mm_mul_ps(_YAMA_SHUFFLE(a, a, 1, 1, 2, 2), _YAMA_SHUFFLE(b, b, 2, 3, 0, 1)));
+}
+
+// a * adjugate(b)
+inline __m128 mul_adj_2x2(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, _YAMA_SHUFFLE(b, b, 3, 0, 3, 0)), _mm_mul_ps(_YAMA_SHUFFLE(a, a, 1, 0, 3, 2), _YAMA_SHUFFLE(b, b, 2, 1, 2, 1)));
+}
+
+// blockwise inversion of a column-major float matrix with a single division
+// returns the determinant, out may alias a
+inline float inverse_matrix4x4(const float* a, float* out)
+{
+    const __m128 c0 = _mm_loadu_ps(a);
+    const __m128 c1 = _mm_loadu_ps(a + 4);
+    const __m128 c2 = _mm_loadu_ps(a + 8);
+    const __m128 c3 = _mm_loadu_ps(a + 12);
+
+    const __m128 A = _mm_movelh_ps(c0, c1);
+    const __m128 B = _mm_movehl_ps(c1, c0);
+    const __m128 C = _mm_movelh_ps(c2, c3);
+    const __m128 D = _mm_movehl_ps(c3, c2);
+
+    // |A| |B| |C| |D|
+    const __m128 det_sub = _mm_sub_ps(
+        _mm_mul_ps(_YAMA_SHUFFLE(c0, c2, 0, 2, 0, 2), _YAMA_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+        _mm_mul_ps(_YAMA_SHUFFLE(c0, c2, 1, 3, 1, 3), _YAMA_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+    const __m128 det_a = _YAMA_SHUFFLE(det_sub, det_sub, 0, 0, 0, 0);
+    const __m128 det_b = _YAMA_SHUFFLE(det_sub, det_sub, 1, 1, 1, 1);
+    const __m128 det_c = _YAMA_SHUFFLE(det_sub, det_sub, 2, 2, 2, 2);
+    const __m128 det_d = _YAMA_SHUFFLE(det_sub, det_sub, 3, 3, 3, 3);
+
+    const __m128 d_c = adj_mul_2x2(D, C);
+    const __m128 a_b = adj_mul_2x2(A, B);
+
+    // adjugates of the blocks of the result
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, A), mul_2x2(B, d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, D), mul_2x2(C, a_b));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, C), mul_adj_2x2(D, a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, B), mul_adj_2x2(A, d_c));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 tr = _mm_mul_ps(a_b, _YAMA_SHUFFLE(d_c, d_c, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, _YAMA_SHUFFLE(tr, tr, 2, 3, 0, 1));
+    tr = _mm_add_ps(tr, _YAMA_SHUFFLE(tr, tr, 1, 0, 3, 2));
+    const __m128 det = _mm_sub_ps(madd(det_b, det_c, _mm_mul_ps(det_a, det_d)), tr);
+
+    const __m128 r_det = _mm_div_ps(_mm_setr_ps(1, -1, -1, 1), det);
+    x = _mm_mul_ps(x, r_det);
+    y = _mm_mul_ps(y, r_det);
+    z = _mm_mul_ps(z, r_det);
+    w = _mm_mul_ps(w, r_det);
+
+    // the final adjugate and transposition are in the shuffles
+    _mm_storeu_ps(out, _YAMA_SHUFFLE(x, y, 3, 1, 3, 1));
+    _mm_storeu_ps(out + 4, _YAMA_SHUFFLE(x, y, 2, 0, 2, 0));
+    _mm_storeu_ps(out + 8, _YAMA_SHUFFLE(z, w, 3, 1, 3, 1));
+    _mm_storeu_ps(out + 12, _YAMA_SHUFFLE(z, w, 2, 0, 2, 0));
+
+    return _mm_cvtss_f32(det);
+}
+
+#undef _YAMA_SHUFFLE
+
+}
+
+template <>
+inline float matrix4x4_t<float>::inverse()
+{
+    return internal::inverse_matrix4x4(data(), data());
+}
+
+#endif
+
 template <typename T>
 matrix4x4_t<T> abs(const matrix4x4_t<T>& a)
 {
@@ -1171,33 +1378,69 @@ bool isfinite(const matrix4x4_t<T>& a)
 template <typename T>
 matrix4x4_t<T> inverse(const matrix4x4_t<T>& a, T& out_determinant)
 {
-    out_determinant = a.determinant();
+    auto ret = a;
+    out_determinant = ret.inverse();
+    return ret;
+}
+
+template <typename T>
+matrix4x4_t<T> inverse(const matrix4x4_t<T>& a)
+{
+    T det;
+    return inverse(a, det);
+}
+
+// for matrices whose last row is 0 0 0 1
+// inverts the upper 3x3 and transforms the negated translation with it
+template <typename T>
+matrix4x4_t<T> inverse_affine(const matrix4x4_t<T>& a)
+{
+    YAMA_ASSERT_WARN(a.m30 == 0 && a.m31 == 0 && a.m32 == 0 && a.m33 == 1, "yama::inverse_affine of a non-affine matrix");
+
+    const T c00 = a.m11*a.m22 - a.m12*a.m21;
+    const T c10 = a.m12*a.m20 - a.m10*a.m22;
+    const T c20 = a.m10*a.m21 - a.m11*a.m20;
+
+    const T det = a.m00*c00 + a.m01*c10 + a.m02*c20;
+    YAMA_ASSERT_WARN(det != 0, "yama::inverse_affine of a singular matrix");
+    const T inv_det = T(1) / det;
+
+    const T i00 = c00 * inv_det;
+    const T i10 = c10 * inv_det;
+    const T i20 = c20 * inv_det;
+    const T i01 = (a.m02*a.m21 - a.m01*a.m22) * inv_det;
+    const T i11 = (a.m00*a.m22 - a.m02*a.m20) * inv_det;
+    const T i21 = (a.m01*a.m20 - a.m00*a.m21) * inv_det;
+    const T i02 = (a.m01*a.m12 - a.m02*a.m11) * inv_det;
+    const T i12 = (a.m02*a.m10 - a.m00*a.m12) * inv_det;
+    const T i22 = (a.m00*a.m11 - a.m01*a.m10) * inv_det;
 
     return matrix4x4_t<T>::columns(
-        (-(a.m13*a.m22*a.m31) + a.m12*a.m23*a.m31 + a.m13*a.m21*a.m32 - a.m11*a.m23*a.m32 - a.m12*a.m21*a.m33 + a.m11*a.m22*a.m33) / out_determinant,
-        (a.m13*a.m22*a.m30 - a.m12*a.m23*a.m30 - a.m13*a.m20*a.m32 + a.m10*a.m23*a.m32 + a.m12*a.m20*a.m33 - a.m10*a.m22*a.m33) / out_determinant,
-        (-(a.m13*a.m21*a.m30) + a.m11*a.m23*a.m30 + a.m13*a.m20*a.m31 - a.m10*a.m23*a.m31 - a.m11*a.m20*a.m33 + a.m10*a.m21*a.m33) / out_determinant,
-        (a.m12*a.m21*a.m30 - a.m11*a.m22*a.m30 - a.m12*a.m20*a.m31 + a.m10*a.m22*a.m31 + a.m11*a.m20*a.m32 - a.m10*a.m21*a.m32) / out_determinant,
-        (a.m03*a.m22*a.m31 - a.m02*a.m23*a.m31 - a.m03*a.m21*a.m32 + a.m01*a.m23*a.m32 + a.m02*a.m21*a.m33 - a.m01*a.m22*a.m33) / out_determinant,
-        (-(a.m03*a.m22*a.m30) + a.m02*a.m23*a.m30 + a.m03*a.m20*a.m32 - a.m00*a.m23*a.m32 - a.m02*a.m20*a.m33 + a.m00*a.m22*a.m33) / out_determinant,
-        (a.m03*a.m21*a.m30 - a.m01*a.m23*a.m30 - a.m03*a.m20*a.m31 + a.m00*a.m23*a.m31 + a.m01*a.m20*a.m33 - a.m00*a.m21*a.m33) / out_determinant,
-        (-(a.m02*a.m21*a.m30) + a.m01*a.m22*a.m30 + a.m02*a.m20*a.m31 - a.m00*a.m22*a.m31 - a.m01*a.m20*a.m32 + a.m00*a.m21*a.m32) / out_determinant,
-        (-(a.m03*a.m12*a.m31) + a.m02*a.m13*a.m31 + a.m03*a.m11*a.m32 - a.m01*a.m13*a.m32 - a.m02*a.m11*a.m33 + a.m01*a.m12*a.m33) / out_determinant,
-        (a.m03*a.m12*a.m30 - a.m02*a.m13*a.m30 - a.m03*a.m10*a.m32 + a.m00*a.m13*a.m32 + a.m02*a.m10*a.m33 - a.m00*a.m12*a.m33) / out_determinant,
-        (-(a.m03*a.m11*a.m30) + a.m01*a.m13*a.m30 + a.m03*a.m10*a.m31 - a.m00*a.m13*a.m31 - a.m01*a.m10*a.m33 + a.m00*a.m11*a.m33) / out_determinant,
-        (a.m02*a.m11*a.m30 - a.m01*a.m12*a.m30 - a.m02*a.m10*a.m31 + a.m00*a.m12*a.m31 + a.m01*a.m10*a.m32 - a.m00*a.m11*a.m32) / out_determinant,
-        (a.m03*a.m12*a.m21 - a.m02*a.m13*a.m21 - a.m03*a.m11*a.m22 + a.m01*a.m13*a.m22 + a.m02*a.m11*a.m23 - a.m01*a.m12*a.m23) / out_determinant,
-        (-(a.m03*a.m12*a.m20) + a.m02*a.m13*a.m20 + a.m03*a.m10*a.m22 - a.m00*a.m13*a.m22 - a.m02*a.m10*a.m23 + a.m00*a.m12*a.m23) / out_determinant,
-        (a.m03*a.m11*a.m20 - a.m01*a.m13*a.m20 - a.m03*a.m10*a.m21 + a.m00*a.m13*a.m21 + a.m01*a.m10*a.m23 - a.m00*a.m11*a.m23) / out_determinant,
-        (-(a.m02*a.m11*a.m20) + a.m01*a.m12*a.m20 + a.m02*a.m10*a.m21 - a.m00*a.m12*a.m21 - a.m01*a.m10*a.m22 + a.m00*a.m11*a.m22) / out_determinant
+        i00, i10, i20, 0,
+        i01, i11, i21, 0,
+        i02, i12, i22, 0,
+        -(i00*a.m03 + i01*a.m13 + i02*a.m23),
+        -(i10*a.m03 + i11*a.m13 + i12*a.m23),
+        -(i20*a.m03 + i21*a.m13 + i22*a.m23),
+        1
     );
 }
 
+// for rotation and translation only: the inverse rotation is the transpose
 template <typename T>
-matrix4x4_t<T> inverse(const matrix4x4_t<T>& a)
+matrix4x4_t<T> inverse_rigid(const matrix4x4_t<T>& a)
 {
-    T det;
-    return intverse(a, det);
+    YAMA_ASSERT_WARN(a.m30 == 0 && a.m31 == 0 && a.m32 == 0 && a.m33 == 1, "yama::inverse_rigid of a non-affine matrix");
+
+    return matrix4x4_t<T>::columns(
+        a.m00, a.m01, a.m02, 0,
+        a.m10, a.m11, a.m12, 0,
+        a.m20, a.m21, a.m22, 0,
+        -(a.m00*a.m03 + a.m10*a.m13 + a.m20*a.m23),
+        -(a.m01*a.m03 + a.m11*a.m13 + a.m21*a.m23),
+        -(a.m02*a.m03 + a.m12*a.m13 + a.m22*a.m23),
+        1
+    );
 }
 
 
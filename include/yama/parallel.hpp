@@ -0,0 +1,277 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Splitting batch work between threads
+// Only available with YAMA_THREADS (see config.hpp).
+//
+// parallel::thread_pool is the executor taken by the parallel overloads of
+// the batch functions. Its threads are started once and every call is split
+// into a few chunks per thread. Each thread has its own queue of chunks and
+// steals from the others when it runs out, so threads which finish early
+// help the slow ones. The calling thread works on chunks too, so a pool can
+// be shared between threads, and the overloads can be called from the
+// chunks of another call.
+//
+// The functions which take a thread count instead of a pool (skin_parallel,
+// hierarchy_t::update_parallel, bvh_t::build_parallel and refit_parallel)
+// start a pool for the call and stop it before returning.
+//
+// The chunks of reductions don't depend on the number of threads and their
+// results are combined in order, so reductions give the same result on any
+// pool, even for sums of floating point values.
+
+#include "config.hpp"
+
+namespace yama
+{
+namespace parallel
+{
+// declared without YAMA_THREADS too, for the classes which keep a pointer to one
+class thread_pool;
+}
+}
+
+#if YAMA_THREADS
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace yama
+{
+namespace parallel
+{
+
+class thread_pool
+{
+public:
+    // thread_count is the number of threads working on a call, including the
+    // calling one. 0 means one per hardware thread.
+    explicit thread_pool(size_t thread_count = 0)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::thread::hardware_concurrency();
+        }
+        m_worker_count = thread_count > 1 ? thread_count - 1 : 0;
+        m_queues.reset(new queue[m_worker_count ? m_worker_count : 1]);
+        m_threads.reserve(m_worker_count);
+        for (size_t i = 0; i < m_worker_count; ++i)
+        {
+            m_threads.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads)
+        {
+            t.join();
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    size_t thread_count() const { return m_worker_count + 1; }
+
+    // Calls f(first, n) for consecutive chunks of [0, count) of chunk_size
+    // elements (the last one may be shorter) and returns when all of them
+    // have returned. f must not throw.
+    template <typename F>
+    void run(size_t count, size_t chunk_size, const F& f)
+    {
+        const size_t chunks = (count + chunk_size - 1) / chunk_size;
+        if (chunks <= 1 || m_worker_count == 0)
+        {
+            for (size_t first = 0; first < count; first += chunk_size)
+            {
+                f(first, count - first < chunk_size ? count - first : chunk_size);
+            }
+            return;
+        }
+
+        job j(f, chunks);
+        for (size_t q = 0; q < m_worker_count && q < chunks; ++q)
+        {
+            std::lock_guard<std::mutex> lock(m_queues[q].mutex);
+            for (size_t c = q; c < chunks; c += m_worker_count)
+            {
+                const size_t first = c * chunk_size;
+                const task t = { &j, first, count - first < chunk_size ? count - first : chunk_size };
+                m_queues[q].tasks.push_back(t);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_pending += ptrdiff_t(chunks);
+        }
+        m_wake.notify_all();
+
+        // help until there is nothing left to take, then wait for the chunks taken by the workers
+        task t;
+        while (j.remaining.load() && take(0, t))
+        {
+            execute(t);
+        }
+
+        std::unique_lock<std::mutex> lock(j.mutex);
+        j.finished.wait(lock, [&j]() { return j.done; });
+    }
+
+private:
+    struct job
+    {
+        template <typename F>
+        job(const F& f, size_t chunks)
+            : func(&f)
+            , call([](const void* func, size_t first, size_t n) { (*static_cast<const F*>(func))(first, n); })
+            , remaining(chunks)
+        {}
+
+        const void* func;
+        void (*call)(const void*, size_t, size_t);
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+    };
+
+    struct task
+    {
+        job* j;
+        size_t first;
+        size_t count;
+    };
+
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    // the own queue of a worker from the front, then the others from the back
+    bool take(size_t own, task& t)
+    {
+        for (size_t i = 0; i < m_worker_count; ++i)
+        {
+            queue& q = m_queues[(own + i) % m_worker_count];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            if (i == 0)
+            {
+                t = q.tasks.front();
+                q.tasks.pop_front();
+            }
+            else
+            {
+                t = q.tasks.back();
+                q.tasks.pop_back();
+            }
+            --m_pending;
+            return true;
+        }
+        return false;
+    }
+
+    static void execute(const task& t)
+    {
+        job& j = *t.j;
+        j.call(j.func, t.first, t.count);
+        if (j.remaining.fetch_sub(1) == 1)
+        {
+            // notify under the lock, as the job is gone once its caller wakes up
+            std::lock_guard<std::mutex> lock(j.mutex);
+            j.done = true;
+            j.finished.notify_all();
+        }
+    }
+
+    void work(size_t index)
+    {
+        for (;;)
+        {
+            task t;
+            if (take(index, t))
+            {
+                execute(t);
+                continue;
+            }
+
+            // m_pending can be briefly below zero when a task is taken before it's counted
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_wake.wait(lock, [this]() { return m_stop || m_pending > 0; });
+            if (m_stop) return;
+        }
+    }
+
+    size_t m_worker_count;
+    std::unique_ptr<queue[]> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<ptrdiff_t> m_pending{0};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+};
+
+// a few chunks per thread, so that the idle threads have something to steal
+const size_t chunks_per_thread = 4;
+
+// Calls f(first, n) for chunks of [0, count) split between the threads of
+// pool and returns when all of them have returned. Chunk boundaries are
+// multiples of granularity, so that chunks don't share SIMD packs, mask words
+// or cache lines.
+template <typename F>
+void for_each_chunk(thread_pool& pool, size_t count, size_t granularity, const F& f)
+{
+    const size_t units = (count + granularity - 1) / granularity;
+    const size_t chunks = pool.thread_count() * chunks_per_thread;
+    const size_t chunk_size = (units + chunks - 1) / chunks * granularity;
+    if (chunk_size) pool.run(count, chunk_size, f);
+}
+
+// Reduces [0, count) in blocks of block_size elements. map(first, n) returns
+// the value of a block and combine(a, b) merges two values. The values are
+// combined from the first block to the last, starting with identity.
+template <typename R, typename Map, typename Combine>
+R reduce(thread_pool& pool, size_t count, size_t block_size, const R& identity, const Map& map, const Combine& combine)
+{
+    const size_t blocks = (count + block_size - 1) / block_size;
+    std::vector<R> values(blocks, identity);
+    for_each_chunk(pool, blocks, 1, [&](size_t first, size_t n) {
+        for (size_t b = first; b < first + n; ++b)
+        {
+            const size_t begin = b * block_size;
+            values[b] = map(begin, count - begin < block_size ? count - begin : block_size);
+        }
+    });
+
+    R ret = identity;
+    for (const auto& v : values)
+    {
+        ret = combine(ret, v);
+    }
+    return ret;
+}
+
+}
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include <algorithm>
 
 #include "util.hpp"
+#include "simd.hpp"
 #include "shorthand.hpp"
 #include "type_traits.hpp"
 
@@ -77,13 +78,9 @@ public:
     static quaternion_t rotation_naxis(const vector3_t<value_type>& axis, value_type radians)
     {
         YAMA_ASSERT_BAD(axis.is_normalized(), "rotation axis should be normalized");
-        const value_type s = std::sin(radians / 2);
-        return xyzw(
-            axis.x * s,
-            axis.y * s,
-            axis.z * s,
-            std::cos(radians / 2)
-        );
+        value_type s, c;
+        sincos(radians / 2, s, c);
+        return xyzw(axis.x * s, axis.y * s, axis.z * s, c);
     }
 
     static quaternion_t rotation_axis(const vector3_t<value_type>& axis, value_type radians)
@@ -94,32 +91,23 @@ public:
 
     static quaternion_t rotation_x(value_type radians)
     {
-        return xyzw(
-            std::sin(radians / 2),
-            0,
-            0,
-            std::cos(radians / 2)
-        );
+        value_type s, c;
+        sincos(radians / 2, s, c);
+        return xyzw(s, 0, 0, c);
     }
 
     static quaternion_t rotation_y(value_type radians)
     {
-        return xyzw(
-            0,
-            std::sin(radians / 2),
-            0,
-            std::cos(radians / 2)
-        );
+        value_type s, c;
+        sincos(radians / 2, s, c);
+        return xyzw(0, s, 0, c);
     }
 
     static quaternion_t rotation_z(value_type radians)
     {
-        return xyzw(
-            0,
-            0,
-            std::sin(radians / 2),
-            std::cos(radians / 2)
-        );
+        value_type s, c;
+        sincos(radians / 2, s, c);
+        return xyzw(0, 0, s, c);
     }
 
     static quaternion_t rotation_vectors(const vector3_t<value_type>& src, const vector3_t<value_type>& target)
@@ -429,6 +417,26 @@ public:
         return l;
     }
 
+    // 1/length(), see internal::rsqrt for the precision
+    // Zero-length quaternions give a large finite value.
+    value_type rsqrt_length() const
+    {
+        return internal::rsqrt(length_sq());
+    }
+
+    // normalize() with a reciprocal square root instead of a square root and a division
+    // Zero-length quaternions stay zero. Returns the length.
+    value_type fast_normalize()
+    {
+        const auto l_sq = length_sq();
+        const auto r = internal::rsqrt(l_sq);
+        x *= r;
+        y *= r;
+        z *= r;
+        w *= r;
+        return l_sq * r;
+    }
+
     bool is_normalized() const
     {
         return close(length(), value_type(1));
@@ -653,6 +661,19 @@ quaternion_t<T> normalize(const quaternion_t<T>& a)
     return quaternion_t<T>::xyzw(a.x / l, a.y / l, a.z / l, a.w / l);
 }
 
+template <typename T>
+T rsqrt_length(const quaternion_t<T>& a)
+{
+    return a.rsqrt_length();
+}
+
+template <typename T>
+quaternion_t<T> fast_normalize(const quaternion_t<T>& a)
+{
+    const auto r = a.rsqrt_length();
+    return quaternion_t<T>::xyzw(a.x * r, a.y * r, a.z * r, a.w * r);
+}
+
 template <typename T>
 quaternion_t<T> lerp(const quaternion_t<T>& from, const quaternion_t<T>& to, const T& ratio)
 {
@@ -677,6 +698,61 @@ quaternion_t<T> slerp(const quaternion_t<T>& from, const quaternion_t<T>& to, T
     return (from*std::sin((1 - ratio)*angle) + to*std::sin(angle*ratio)) / std::sin(angle);
 }
 
+// lerp along the shortest path: to or -to, whichever is closer to from
+template <typename T>
+quaternion_t<T> nlerp(const quaternion_t<T>& from, const quaternion_t<T>& to, const T& ratio)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    const auto target = dot(from, to) < 0 ? -to : to;
+    return normalize(from + ratio * (target - from));
+}
+
+namespace internal
+{
+
+// sin(t*angle)/sin(angle) as a polynomial of x = cos(angle), for x in [0, 1]
+// From D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP": the
+// first terms of the series sum(a_i(t) * (x - 1)^i), where a_0 = t and
+// a_i = a_(i-1) * (u_i*t^2 - v_i). The last term is scaled to compensate for
+// the truncation, which keeps the error of the weights under 2e-5.
+template <typename T>
+struct slerp_series
+{
+    static constexpr size_t terms = 8;
+
+    static T correction(size_t i) { return i == terms ? T(1.854) : T(1); }
+    static T u(size_t i) { return correction(i) / T(i * (2 * i + 1)); }
+    static T v(size_t i) { return correction(i) * T(i) / T(2 * i + 1); }
+
+    static T eval(const T& t, const T& x)
+    {
+        const T t2 = t * t;
+        const T xm1 = x - 1;
+        T r = 0;
+        for (size_t i = terms; i > 0; --i)
+        {
+            r = (u(i) * t2 - v(i)) * xm1 * (1 + r);
+        }
+        return t * (1 + r);
+    }
+};
+
+}
+
+// slerp along the shortest path, with no trigonometric functions
+// See internal::slerp_series for the approximation.
+template <typename T>
+quaternion_t<T> fast_slerp(const quaternion_t<T>& from, const quaternion_t<T>& to, const T& ratio)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    const T d = dot(from, to);
+    const T sign = d < 0 ? T(-1) : T(1);
+    const T x = d * sign;
+    return from * internal::slerp_series<T>::eval(1 - ratio, x) + to * (internal::slerp_series<T>::eval(ratio, x) * sign);
+}
+
 template <typename T>
 quaternion_t<T> conjugate(const quaternion_t<T>& a)
 {
@@ -710,6 +786,42 @@ vector3_t<T> rotate(const vector3_t<T>& v, const quaternion_t<T>& q)
     return v + ((c1 * q.w) + c2) * T(2);
 }
 
+namespace internal
+{
+
+// the rotation of an orthonormal 3x3 matrix, given by rows
+// (Shepperd's method: divide by the largest of the four components)
+template <typename T>
+quaternion_t<T> quaternion_from_rotation(
+    const T& m00, const T& m01, const T& m02,
+    const T& m10, const T& m11, const T& m12,
+    const T& m20, const T& m21, const T& m22)
+{
+    const T trace = m00 + m11 + m22;
+    if (trace > 0)
+    {
+        const T s = std::sqrt(trace + 1) * 2;
+        return quaternion_t<T>::xyzw((m21 - m12) / s, (m02 - m20) / s, (m10 - m01) / s, s / 4);
+    }
+    else if (m00 > m11 && m00 > m22)
+    {
+        const T s = std::sqrt(1 + m00 - m11 - m22) * 2;
+        return quaternion_t<T>::xyzw(s / 4, (m01 + m10) / s, (m02 + m20) / s, (m21 - m12) / s);
+    }
+    else if (m11 > m22)
+    {
+        const T s = std::sqrt(1 + m11 - m00 - m22) * 2;
+        return quaternion_t<T>::xyzw((m01 + m10) / s, s / 4, (m12 + m21) / s, (m02 - m20) / s);
+    }
+    else
+    {
+        const T s = std::sqrt(1 + m22 - m00 - m11) * 2;
+        return quaternion_t<T>::xyzw((m02 + m20) / s, (m12 + m21) / s, s / 4, (m10 - m01) / s);
+    }
+}
+
+}
+
 // type traits
 template <typename T>
 struct is_yama<quaternion_t<T>> : public std::true_type {};
@@ -0,0 +1,387 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Rays and ray intersections
+// ray_t holds an origin, a direction (not necessarily normalized) and the
+// reciprocal of the direction for the slab tests against boxes. The points of
+// the ray are origin + t*direction for t >= 0, and the intersection functions
+// report distances in units of t.
+//
+// Box tests use slabs. A ray parallel to a slab with its origin exactly on
+// one of the slab's planes counts as inside of the slab. Triangle tests use
+// the Moller-Trumbore algorithm, are two-sided, and report the barycentric
+// coordinates (u, v) of the hit: hit = (1-u-v)*v0 + u*v1 + v*v2.
+//
+// The batch functions test a ray against a pack of boxes or triangles at a
+// time (see batch.hpp). Boxes come in an aabb_soa_t and the results are a
+// bitmask (see soa.hpp). Triangles come from an indexed mesh: three indices
+// per triangle into an array of vertices. They are gathered in blocks, which
+// are shared by all rays of a call. With YAMA_THREADS the batch functions have
+// overloads which take a parallel::thread_pool.
+
+#include "vector3.hpp"
+#include "aabb.hpp"
+#include "soa.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace yama
+{
+
+template <typename T>
+class ray_t
+{
+public:
+    typedef T value_type;
+
+    vector3_t<value_type> origin;
+    vector3_t<value_type> direction;
+    vector3_t<value_type> inv_direction; // infinite in the components where the direction is zero
+
+    ////////////////////////////////////////////////////////
+    // named constructors
+
+    static ray_t from_origin_direction(const vector3_t<value_type>& origin, const vector3_t<value_type>& direction)
+    {
+        return { origin, direction, reciprocal(direction) };
+    }
+
+    // t = 1 at to
+    static ray_t from_points(const vector3_t<value_type>& from, const vector3_t<value_type>& to)
+    {
+        return from_origin_direction(from, to - from);
+    }
+
+    ////////////////////////////////////////////////////////
+    // modification
+
+    void set_direction(const vector3_t<value_type>& d)
+    {
+        direction = d;
+        inv_direction = reciprocal(d);
+    }
+
+    ////////////////////////////////////////////////////////
+    // operations
+
+    vector3_t<value_type> point_at(const value_type& t) const
+    {
+        return origin + direction * t;
+    }
+
+private:
+    static vector3_t<value_type> reciprocal(const vector3_t<value_type>& d)
+    {
+        return vector3_t<value_type>::coord(value_type(1) / d.x, value_type(1) / d.y, value_type(1) / d.z);
+    }
+};
+
+// the nearest hit of a ray with a triangle mesh
+template <typename T>
+struct ray_hit_t
+{
+    typedef T value_type;
+
+    static constexpr size_t no_triangle = size_t(-1);
+
+    value_type t;
+    value_type u, v;
+    size_t triangle; // no_triangle if nothing was hit
+
+    static ray_hit_t none(const value_type& t_max = std::numeric_limits<value_type>::max())
+    {
+        return { t_max, value_type(0), value_type(0), no_triangle };
+    }
+
+    bool hit() const
+    {
+        return triangle != no_triangle;
+    }
+
+    // the weights of the triangle's vertices
+    vector3_t<value_type> barycentric() const
+    {
+        return vector3_t<value_type>::coord(value_type(1) - u - v, u, v);
+    }
+};
+
+template <typename T>
+constexpr size_t ray_hit_t<T>::no_triangle;
+
+///////////////////////////////////////////////////////////////////////////////
+// intersections
+
+// the ray hits the box at a distance in [0, t_max]
+// t is the distance at which the ray enters the box, or 0 if its origin is inside
+template <typename T>
+bool intersect(const ray_t<T>& r, const aabb_t<T>& b, T& t, const T& t_max = std::numeric_limits<T>::max())
+{
+    T t0 = 0, t1 = t_max;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        const T inv = r.inv_direction.at(c);
+        const T near_plane = inv < 0 ? b.max.at(c) : b.min.at(c);
+        const T far_plane = inv < 0 ? b.min.at(c) : b.max.at(c);
+        const T n = (near_plane - r.origin.at(c)) * inv;
+        const T f = (far_plane - r.origin.at(c)) * inv;
+
+        // comparisons with a NaN (0 * infinity) are false and keep the slab open
+        t0 = n > t0 ? n : t0;
+        t1 = f < t1 ? f : t1;
+    }
+    t = t0;
+    return t0 <= t1;
+}
+
+template <typename T>
+bool intersects(const ray_t<T>& r, const aabb_t<T>& b, const T& t_max = std::numeric_limits<T>::max())
+{
+    T t;
+    return intersect(r, b, t, t_max);
+}
+
+// the ray hits the triangle at a distance t in [0, t_max)
+// Degenerate triangles and rays in the plane of the triangle never hit.
+template <typename T>
+bool intersect(const ray_t<T>& r, const vector3_t<T>& v0, const vector3_t<T>& v1, const vector3_t<T>& v2,
+    T& t, T& u, T& v, const T& t_max = std::numeric_limits<T>::max())
+{
+    const auto e1 = v1 - v0;
+    const auto e2 = v2 - v0;
+    const auto p = cross(r.direction, e2);
+    const T det = dot(e1, p);
+    if (std::abs(det) < std::numeric_limits<T>::min()) return false;
+
+    const T inv = T(1) / det;
+    const auto s = r.origin - v0;
+    const T hu = dot(s, p) * inv;
+    const auto q = cross(s, e1);
+    const T hv = dot(r.direction, q) * inv;
+    const T ht = dot(e2, q) * inv;
+    if (!(hu >= 0 && hv >= 0 && hu + hv <= 1 && ht >= 0 && ht < t_max)) return false;
+
+    t = ht;
+    u = hu;
+    v = hv;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// batch intersections
+
+namespace internal
+{
+
+// the near and far planes of the boxes are chosen once per ray, by the signs of its direction
+template <typename T>
+struct ray_aabbs_kernel
+{
+    typedef pack<T> P;
+
+    const T* near_planes[3];
+    const T* far_planes[3];
+    P o[3], inv[3];
+    P t_max;
+    uint32_t* out;
+
+    ray_aabbs_kernel(const ray_t<T>& r, const aabb_soa_t<T>& boxes, const T& t_max_, uint32_t* out_)
+        : t_max(P::uniform(t_max_))
+        , out(out_)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const bool negative = r.inv_direction.at(c) < 0;
+            near_planes[c] = boxes.stream(negative ? c + 3 : c);
+            far_planes[c] = boxes.stream(negative ? c : c + 3);
+            o[c] = P::uniform(r.origin.at(c));
+            inv[c] = P::uniform(r.inv_direction.at(c));
+        }
+    }
+
+    template <typename>
+    void run(size_t i) const
+    {
+        // vmin and vmax return their second argument for NaN lanes, like the scalar test
+        P t0 = P::uniform(0), t1 = t_max;
+        for (size_t c = 0; c < 3; ++c)
+        {
+            t0 = vmax((P::load(near_planes[c] + i) - o[c]) * inv[c], t0);
+            t1 = vmin((P::load(far_planes[c] + i) - o[c]) * inv[c], t1);
+        }
+        store_mask(out, i, ge_mask(t1, t0));
+    }
+};
+
+// a block of triangles as nine streams: v0, e1 = v1 - v0 and e2 = v2 - v0
+template <typename T>
+struct triangle_block
+{
+    static constexpr size_t capacity = 64;
+
+    T s[9][capacity];
+    size_t padded_count;
+
+    // the padding up to a whole number of packs is degenerate and never hits
+    template <typename Index>
+    void gather(const vector3_t<T>* vertices, const Index* indices, size_t count)
+    {
+        YAMA_ASSERT_CRIT(count <= capacity, "yama triangle block overflow");
+        const size_t w = pack<T>::width;
+        padded_count = (count + w - 1) / w * w;
+        for (size_t k = 0; k < count; ++k)
+        {
+            const auto& v0 = vertices[indices[k * 3]];
+            const auto e1 = vertices[indices[k * 3 + 1]] - v0;
+            const auto e2 = vertices[indices[k * 3 + 2]] - v0;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                s[c][k] = v0.at(c);
+                s[c + 3][k] = e1.at(c);
+                s[c + 6][k] = e2.at(c);
+            }
+        }
+        for (size_t k = count; k < padded_count; ++k)
+        {
+            for (size_t c = 0; c < 9; ++c)
+            {
+                s[c][k] = 0;
+            }
+        }
+    }
+
+    // updates the hit if the ray hits a triangle of the block closer than it
+    // first is the index of the block's first triangle in the mesh
+    void intersect(const ray_t<T>& r, size_t first, ray_hit_t<T>& hit) const
+    {
+        typedef pack<T> P;
+        const P ox = P::uniform(r.origin.x), oy = P::uniform(r.origin.y), oz = P::uniform(r.origin.z);
+        const P dx = P::uniform(r.direction.x), dy = P::uniform(r.direction.y), dz = P::uniform(r.direction.z);
+        const P zero = P::uniform(0), one = P::uniform(1);
+        const P tiny = P::uniform(std::numeric_limits<T>::min());
+
+        for (size_t i = 0; i < padded_count; i += P::width)
+        {
+            const P e1x = P::load(s[3] + i), e1y = P::load(s[4] + i), e1z = P::load(s[5] + i);
+            const P e2x = P::load(s[6] + i), e2y = P::load(s[7] + i), e2z = P::load(s[8] + i);
+
+            const P px = dy * e2z - dz * e2y, py = dz * e2x - dx * e2z, pz = dx * e2y - dy * e2x;
+            const P det = madd(e1x, px, madd(e1y, py, e1z * pz));
+            const P inv = one / det;
+
+            const P sx = ox - P::load(s[0] + i), sy = oy - P::load(s[1] + i), sz = oz - P::load(s[2] + i);
+            const P u = madd(sx, px, madd(sy, py, sz * pz)) * inv;
+            const P qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+            const P v = madd(dx, qx, madd(dy, qy, dz * qz)) * inv;
+            const P t = madd(e2x, qx, madd(e2y, qy, e2z * qz)) * inv;
+
+            unsigned bits = ge_mask(abs(det), tiny) & ge_mask(u, zero) & ge_mask(v, zero) & ge_mask(one, u + v);
+            bits &= ge_mask(t, zero) & ge_mask(P::uniform(hit.t), t);
+            if (!bits) continue;
+
+            // hits are rare, the lanes which have one are picked in order
+            T ts[P::width], us[P::width], vs[P::width];
+            t.store(ts);
+            u.store(us);
+            v.store(vs);
+            for (size_t l = 0; l < P::width; ++l)
+            {
+                if (((bits >> l) & 1) && ts[l] < hit.t)
+                {
+                    hit.t = ts[l];
+                    hit.u = us[l];
+                    hit.v = vs[l];
+                    hit.triangle = first + i + l;
+                }
+            }
+        }
+    }
+};
+
+template <typename T>
+constexpr size_t triangle_block<T>::capacity;
+
+// rays per chunk boundary when splitting between threads
+const size_t ray_granularity = 16;
+
+}
+
+// bit i of out is set if the ray hits box i at a distance in [0, t_max]
+// out must have room for (boxes.size() + 31) / 32 words
+template <typename T>
+void intersects(const ray_t<T>& r, const aabb_soa_t<T>& boxes, uint32_t* out, const T& t_max = std::numeric_limits<T>::max())
+{
+    const internal::ray_aabbs_kernel<T> k(r, boxes, t_max, out);
+    internal::run_mask_kernel<T>(k, boxes.size(), boxes.padded_size(), out);
+}
+
+// the nearest hits of every ray with the triangles of a mesh at a distance in [0, t_max)
+// indices has three elements per triangle. On ties the first triangle wins.
+template <typename T, typename Index>
+void intersect(const ray_t<T>* rays, size_t ray_count, const vector3_t<T>* vertices, const Index* indices, size_t triangle_count,
+    ray_hit_t<T>* hits, const T& t_max = std::numeric_limits<T>::max())
+{
+    for (size_t i = 0; i < ray_count; ++i)
+    {
+        hits[i] = ray_hit_t<T>::none(t_max);
+    }
+
+    internal::triangle_block<T> block;
+    const size_t capacity = internal::triangle_block<T>::capacity;
+    for (size_t first = 0; first < triangle_count; first += capacity)
+    {
+        const size_t n = triangle_count - first < capacity ? triangle_count - first : capacity;
+        block.gather(vertices, indices + first * 3, n);
+        for (size_t i = 0; i < ray_count; ++i)
+        {
+            block.intersect(rays[i], first, hits[i]);
+        }
+    }
+}
+
+template <typename T, typename Index>
+ray_hit_t<T> intersect(const ray_t<T>& r, const vector3_t<T>* vertices, const Index* indices, size_t triangle_count,
+    const T& t_max = std::numeric_limits<T>::max())
+{
+    ray_hit_t<T> hit;
+    intersect(&r, 1, vertices, indices, triangle_count, &hit, t_max);
+    return hit;
+}
+
+#if YAMA_THREADS
+
+// the same with the boxes split between the threads of pool
+template <typename T>
+void intersects(parallel::thread_pool& pool, const ray_t<T>& r, const aabb_soa_t<T>& boxes, uint32_t* out, const T& t_max = std::numeric_limits<T>::max())
+{
+    const internal::ray_aabbs_kernel<T> k(r, boxes, t_max, out);
+    internal::run_mask_kernel<T>(pool, k, boxes.size(), boxes.padded_size(), out);
+}
+
+// the same with the rays split between the threads of pool, each thread gathers its own triangle blocks
+template <typename T, typename Index>
+void intersect(parallel::thread_pool& pool, const ray_t<T>* rays, size_t ray_count, const vector3_t<T>* vertices, const Index* indices, size_t triangle_count,
+    ray_hit_t<T>* hits, const T& t_max = std::numeric_limits<T>::max())
+{
+    parallel::for_each_chunk(pool, ray_count, internal::ray_granularity, [&](size_t first, size_t n) {
+        intersect(rays + first, n, vertices, indices, triangle_count, hits + first, t_max);
+    });
+}
+
+#endif
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef ray_t<preferred_type> ray;
+typedef ray_hit_t<preferred_type> ray_hit;
+
+#endif
+
+}
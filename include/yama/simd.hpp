@@ -0,0 +1,691 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+#include "config.hpp"
+
+#if YAMA_SIMD < YAMA_SIMD_NONE || YAMA_SIMD > YAMA_SIMD_AVX512
+#   error "Yama: Invalid SIMD level."
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+#   if !defined(__SSE2__) && !defined(_M_X64) && !(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       error "Yama: YAMA_SIMD requires SSE2 to be enabled in the compiler."
+#   endif
+#   include <emmintrin.h>
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX
+#   if !defined(__AVX__)
+#       error "Yama: YAMA_SIMD_AVX requires AVX to be enabled in the compiler."
+#   endif
+#   include <immintrin.h>
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX2
+#   if !defined(__AVX2__) || (!defined(__FMA__) && !defined(_MSC_VER))
+#       error "Yama: YAMA_SIMD_AVX2 requires AVX2 and FMA to be enabled in the compiler."
+#   endif
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX512
+#   if !defined(__AVX512F__) || !defined(__AVX512VL__) || !defined(__AVX512DQ__) || !defined(__AVX512BW__)
+#       error "Yama: YAMA_SIMD_AVX512 requires AVX-512 F, VL, DQ and BW to be enabled in the compiler."
+#   endif
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace yama
+{
+namespace internal
+{
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+// a*b + c
+inline __m128 madd(__m128 a, __m128 b, __m128 c)
+{
+#if YAMA_SIMD >= YAMA_SIMD_AVX2
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX
+
+inline __m256 madd(__m256 a, __m256 b, __m256 c)
+{
+#if YAMA_SIMD >= YAMA_SIMD_AVX2
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX512
+
+inline __m512 madd(__m512 a, __m512 b, __m512 c)
+{
+    return _mm512_fmadd_ps(a, b, c);
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// reciprocal square root
+// 1/sqrt(x), with x clamped to the smallest normal value of T, so zero gives
+// a large finite number instead of infinity and a zero vector scaled by it
+// stays zero.
+// With YAMA_SIMD, for float, this is the hardware estimate refined with one
+// Newton-Raphson step, which has a relative error under 3e-7. The estimate
+// is the 14-bit one of AVX-512 with YAMA_SIMD_AVX512, for every pack width.
+// Otherwise it is 1 / std::sqrt(x).
+
+template <typename T>
+T rsqrt(T x)
+{
+    return T(1) / std::sqrt(std::max(x, std::numeric_limits<T>::min()));
+}
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+// x must be clamped already
+inline __m128 rsqrt_newton(__m128 x)
+{
+#if YAMA_SIMD >= YAMA_SIMD_AVX512
+    const __m128 y = _mm_rsqrt14_ps(x);
+#else
+    const __m128 y = _mm_rsqrt_ps(x);
+#endif
+    const __m128 hy = _mm_mul_ps(_mm_mul_ps(x, _mm_set1_ps(-0.5f)), y); // -x*y/2
+    return _mm_mul_ps(y, madd(hy, y, _mm_set1_ps(1.5f)));
+}
+
+inline float rsqrt(float x)
+{
+    const __m128 c = _mm_max_ps(_mm_set1_ps(x), _mm_set1_ps(std::numeric_limits<float>::min()));
+    return _mm_cvtss_f32(rsqrt_newton(c));
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// packs
+// Batch kernels are written once against a "pack" of values and instantiated
+// with the widest pack available for the type. The same kernels instantiated
+// with scalar_pack process the tails of the arrays, so every element goes
+// through the same sequence of operations.
+//
+// Every pack type P provides:
+//  P::width, P::value_type
+//  P::load(ptr), P::uniform(s), p.store(ptr) (unaligned)
+//  P::load2(ptr, x, y), P::store2(ptr, x, y)
+//      width interleaved xy pairs to and from two packs
+//  P::load3(ptr, x, y, z), P::store3(ptr, x, y, z)
+//      width interleaved xyz triplets to and from three packs
+//  P::load4(ptr, x, y, z, w), P::store4(ptr, x, y, z, w)
+//      width interleaved xyzw quadruplets to and from four packs
+//  + - * / and unary -, madd(a, b, c) = a*b + c, vmin, vmax, sqrt, abs
+//  rsqrt(a) the same as the scalar rsqrt above for every lane
+//  round(a) to the nearest integer, ties to even, for |a| < 2^31
+//  flip_sign(a, s) -a in the lanes where s < 0 and a elsewhere
+//  select(a, b, s) b in the lanes where s < 0 and a elsewhere
+//  ge_mask(a, b) a bitmask of the lanes where a >= b, lane 0 in bit 0
+
+template <typename T>
+struct scalar_pack
+{
+    typedef T value_type;
+    static constexpr size_t width = 1;
+
+    T v;
+
+    static scalar_pack uniform(T s) { scalar_pack r = { s }; return r; }
+    static scalar_pack load(const T* ptr) { return uniform(*ptr); }
+    void store(T* ptr) const { *ptr = v; }
+
+    static void load2(const T* ptr, scalar_pack& x, scalar_pack& y)
+    {
+        x.v = ptr[0];
+        y.v = ptr[1];
+    }
+
+    static void store2(T* ptr, scalar_pack x, scalar_pack y)
+    {
+        ptr[0] = x.v;
+        ptr[1] = y.v;
+    }
+
+    static void load3(const T* ptr, scalar_pack& x, scalar_pack& y, scalar_pack& z)
+    {
+        x.v = ptr[0];
+        y.v = ptr[1];
+        z.v = ptr[2];
+    }
+
+    static void store3(T* ptr, scalar_pack x, scalar_pack y, scalar_pack z)
+    {
+        ptr[0] = x.v;
+        ptr[1] = y.v;
+        ptr[2] = z.v;
+    }
+
+    static void load4(const T* ptr, scalar_pack& x, scalar_pack& y, scalar_pack& z, scalar_pack& w)
+    {
+        x.v = ptr[0];
+        y.v = ptr[1];
+        z.v = ptr[2];
+        w.v = ptr[3];
+    }
+
+    static void store4(T* ptr, scalar_pack x, scalar_pack y, scalar_pack z, scalar_pack w)
+    {
+        ptr[0] = x.v;
+        ptr[1] = y.v;
+        ptr[2] = z.v;
+        ptr[3] = w.v;
+    }
+};
+
+template <typename T> scalar_pack<T> operator+(scalar_pack<T> a, scalar_pack<T> b) { return scalar_pack<T>::uniform(a.v + b.v); }
+template <typename T> scalar_pack<T> operator-(scalar_pack<T> a, scalar_pack<T> b) { return scalar_pack<T>::uniform(a.v - b.v); }
+template <typename T> scalar_pack<T> operator*(scalar_pack<T> a, scalar_pack<T> b) { return scalar_pack<T>::uniform(a.v * b.v); }
+template <typename T> scalar_pack<T> operator/(scalar_pack<T> a, scalar_pack<T> b) { return scalar_pack<T>::uniform(a.v / b.v); }
+template <typename T> scalar_pack<T> operator-(scalar_pack<T> a) { return scalar_pack<T>::uniform(-a.v); }
+template <typename T> scalar_pack<T> madd(scalar_pack<T> a, scalar_pack<T> b, scalar_pack<T> c) { return scalar_pack<T>::uniform(a.v * b.v + c.v); }
+template <typename T> scalar_pack<T> vmin(scalar_pack<T> a, scalar_pack<T> b) { return scalar_pack<T>::uniform(a.v < b.v ? a.v : b.v); }
+template <typename T> scalar_pack<T> vmax(scalar_pack<T> a, scalar_pack<T> b) { return scalar_pack<T>::uniform(a.v > b.v ? a.v : b.v); }
+template <typename T> scalar_pack<T> sqrt(scalar_pack<T> a) { return scalar_pack<T>::uniform(std::sqrt(a.v)); }
+template <typename T> scalar_pack<T> abs(scalar_pack<T> a) { return scalar_pack<T>::uniform(std::abs(a.v)); }
+template <typename T> scalar_pack<T> rsqrt(scalar_pack<T> a) { return scalar_pack<T>::uniform(rsqrt(a.v)); }
+template <typename T> scalar_pack<T> round(scalar_pack<T> a) { return scalar_pack<T>::uniform(std::nearbyint(a.v)); }
+template <typename T> scalar_pack<T> flip_sign(scalar_pack<T> a, scalar_pack<T> s) { return scalar_pack<T>::uniform(s.v < 0 ? -a.v : a.v); }
+template <typename T> scalar_pack<T> select(scalar_pack<T> a, scalar_pack<T> b, scalar_pack<T> s) { return s.v < 0 ? b : a; }
+template <typename T> unsigned ge_mask(scalar_pack<T> a, scalar_pack<T> b) { return a.v >= b.v; }
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+struct float4_sse
+{
+    typedef float value_type;
+    static constexpr size_t width = 4;
+
+    __m128 v;
+
+    static float4_sse make(__m128 m) { float4_sse r; r.v = m; return r; }
+    static float4_sse uniform(float s) { return make(_mm_set1_ps(s)); }
+    static float4_sse load(const float* ptr) { return make(_mm_loadu_ps(ptr)); }
+    void store(float* ptr) const { _mm_storeu_ps(ptr, v); }
+
+    // a = x0 y0 x1 y1, b = x2 y2 x3 y3
+    static void load2(const float* ptr, float4_sse& x, float4_sse& y)
+    {
+        const __m128 a = _mm_loadu_ps(ptr);
+        const __m128 b = _mm_loadu_ps(ptr + 4);
+        x.v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        y.v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    static void store2(float* ptr, float4_sse x, float4_sse y)
+    {
+        _mm_storeu_ps(ptr, _mm_unpacklo_ps(x.v, y.v));
+        _mm_storeu_ps(ptr + 4, _mm_unpackhi_ps(x.v, y.v));
+    }
+
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    static void load3(const float* ptr, float4_sse& x, float4_sse& y, float4_sse& z)
+    {
+        const __m128 a = _mm_loadu_ps(ptr);
+        const __m128 b = _mm_loadu_ps(ptr + 4);
+        const __m128 c = _mm_loadu_ps(ptr + 8);
+        const __m128 xy23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+        const __m128 yz01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+        x.v = _mm_shuffle_ps(a, xy23, _MM_SHUFFLE(2, 0, 3, 0));
+        y.v = _mm_shuffle_ps(yz01, xy23, _MM_SHUFFLE(3, 1, 2, 0));
+        z.v = _mm_shuffle_ps(yz01, c, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+
+    static void store3(float* ptr, float4_sse x, float4_sse y, float4_sse z)
+    {
+        const __m128 xy01 = _mm_unpacklo_ps(x.v, y.v); // x0 y0 x1 y1
+        const __m128 xy23 = _mm_unpackhi_ps(x.v, y.v); // x2 y2 x3 y3
+        const __m128 z0x1 = _mm_shuffle_ps(z.v, x.v, _MM_SHUFFLE(1, 1, 0, 0)); // z0 z0 x1 x1
+        const __m128 y1z1 = _mm_shuffle_ps(y.v, z.v, _MM_SHUFFLE(1, 1, 1, 1)); // y1 y1 z1 z1
+        const __m128 z2x3 = _mm_shuffle_ps(z.v, x.v, _MM_SHUFFLE(3, 3, 2, 2)); // z2 z2 x3 x3
+        const __m128 y3z3 = _mm_shuffle_ps(y.v, z.v, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+        _mm_storeu_ps(ptr, _mm_shuffle_ps(xy01, z0x1, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(ptr + 4, _mm_shuffle_ps(y1z1, xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+        _mm_storeu_ps(ptr + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+
+    static void load4(const float* ptr, float4_sse& x, float4_sse& y, float4_sse& z, float4_sse& w)
+    {
+        __m128 a = _mm_loadu_ps(ptr);
+        __m128 b = _mm_loadu_ps(ptr + 4);
+        __m128 c = _mm_loadu_ps(ptr + 8);
+        __m128 d = _mm_loadu_ps(ptr + 12);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        x.v = a;
+        y.v = b;
+        z.v = c;
+        w.v = d;
+    }
+
+    static void store4(float* ptr, float4_sse x, float4_sse y, float4_sse z, float4_sse w)
+    {
+        _MM_TRANSPOSE4_PS(x.v, y.v, z.v, w.v);
+        _mm_storeu_ps(ptr, x.v);
+        _mm_storeu_ps(ptr + 4, y.v);
+        _mm_storeu_ps(ptr + 8, z.v);
+        _mm_storeu_ps(ptr + 12, w.v);
+    }
+};
+
+inline float4_sse operator+(float4_sse a, float4_sse b) { return float4_sse::make(_mm_add_ps(a.v, b.v)); }
+inline float4_sse operator-(float4_sse a, float4_sse b) { return float4_sse::make(_mm_sub_ps(a.v, b.v)); }
+inline float4_sse operator*(float4_sse a, float4_sse b) { return float4_sse::make(_mm_mul_ps(a.v, b.v)); }
+inline float4_sse operator/(float4_sse a, float4_sse b) { return float4_sse::make(_mm_div_ps(a.v, b.v)); }
+inline float4_sse operator-(float4_sse a) { return float4_sse::make(_mm_xor_ps(a.v, _mm_set1_ps(-0.f))); }
+inline float4_sse madd(float4_sse a, float4_sse b, float4_sse c) { return float4_sse::make(madd(a.v, b.v, c.v)); }
+inline float4_sse vmin(float4_sse a, float4_sse b) { return float4_sse::make(_mm_min_ps(a.v, b.v)); }
+inline float4_sse vmax(float4_sse a, float4_sse b) { return float4_sse::make(_mm_max_ps(a.v, b.v)); }
+inline float4_sse sqrt(float4_sse a) { return float4_sse::make(_mm_sqrt_ps(a.v)); }
+inline float4_sse abs(float4_sse a) { return float4_sse::make(_mm_andnot_ps(_mm_set1_ps(-0.f), a.v)); }
+inline float4_sse rsqrt(float4_sse a) { return float4_sse::make(rsqrt_newton(_mm_max_ps(a.v, _mm_set1_ps(std::numeric_limits<float>::min())))); }
+inline float4_sse round(float4_sse a) { return float4_sse::make(_mm_cvtepi32_ps(_mm_cvtps_epi32(a.v))); }
+inline float4_sse flip_sign(float4_sse a, float4_sse s) { return float4_sse::make(_mm_xor_ps(a.v, _mm_and_ps(_mm_cmplt_ps(s.v, _mm_setzero_ps()), _mm_set1_ps(-0.f)))); }
+inline float4_sse select(float4_sse a, float4_sse b, float4_sse s)
+{
+    const __m128 m = _mm_cmplt_ps(s.v, _mm_setzero_ps());
+    return float4_sse::make(_mm_or_ps(_mm_andnot_ps(m, a.v), _mm_and_ps(m, b.v)));
+}
+inline unsigned ge_mask(float4_sse a, float4_sse b) { return unsigned(_mm_movemask_ps(_mm_cmpge_ps(a.v, b.v))); }
+
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX
+
+struct float8_avx
+{
+    typedef float value_type;
+    static constexpr size_t width = 8;
+
+    __m256 v;
+
+    static float8_avx make(__m256 m) { float8_avx r; r.v = m; return r; }
+    static float8_avx make(float4_sse lo, float4_sse hi) { return make(_mm256_insertf128_ps(_mm256_castps128_ps256(lo.v), hi.v, 1)); }
+    static float8_avx uniform(float s) { return make(_mm256_set1_ps(s)); }
+    static float8_avx load(const float* ptr) { return make(_mm256_loadu_ps(ptr)); }
+    void store(float* ptr) const { _mm256_storeu_ps(ptr, v); }
+
+    float4_sse lo() const { return float4_sse::make(_mm256_castps256_ps128(v)); }
+    float4_sse hi() const { return float4_sse::make(_mm256_extractf128_ps(v, 1)); }
+
+    // the same shuffles as float4_sse, done on points 0-3 and 4-7 in the two 128-bit lanes
+    static void load2(const float* ptr, float8_avx& x, float8_avx& y)
+    {
+        const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr)), _mm_loadu_ps(ptr + 8), 1);
+        const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 4)), _mm_loadu_ps(ptr + 12), 1);
+        x.v = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        y.v = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    static void store2(float* ptr, float8_avx x, float8_avx y)
+    {
+        const __m256 a = _mm256_unpacklo_ps(x.v, y.v);
+        const __m256 b = _mm256_unpackhi_ps(x.v, y.v);
+        _mm_storeu_ps(ptr, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(ptr + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(ptr + 8, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(ptr + 12, _mm256_extractf128_ps(b, 1));
+    }
+
+    static void load3(const float* ptr, float8_avx& x, float8_avx& y, float8_avx& z)
+    {
+        const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr)), _mm_loadu_ps(ptr + 12), 1);
+        const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 4)), _mm_loadu_ps(ptr + 16), 1);
+        const __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 8)), _mm_loadu_ps(ptr + 20), 1);
+        const __m256 xy23 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+        const __m256 yz01 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+        x.v = _mm256_shuffle_ps(a, xy23, _MM_SHUFFLE(2, 0, 3, 0));
+        y.v = _mm256_shuffle_ps(yz01, xy23, _MM_SHUFFLE(3, 1, 2, 0));
+        z.v = _mm256_shuffle_ps(yz01, c, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+
+    static void store3(float* ptr, float8_avx x, float8_avx y, float8_avx z)
+    {
+        const __m256 xy01 = _mm256_unpacklo_ps(x.v, y.v);
+        const __m256 xy23 = _mm256_unpackhi_ps(x.v, y.v);
+        const __m256 z0x1 = _mm256_shuffle_ps(z.v, x.v, _MM_SHUFFLE(1, 1, 0, 0));
+        const __m256 y1z1 = _mm256_shuffle_ps(y.v, z.v, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m256 z2x3 = _mm256_shuffle_ps(z.v, x.v, _MM_SHUFFLE(3, 3, 2, 2));
+        const __m256 y3z3 = _mm256_shuffle_ps(y.v, z.v, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m256 a = _mm256_shuffle_ps(xy01, z0x1, _MM_SHUFFLE(2, 0, 1, 0));
+        const __m256 b = _mm256_shuffle_ps(y1z1, xy23, _MM_SHUFFLE(1, 0, 2, 0));
+        const __m256 c = _mm256_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0));
+        _mm_storeu_ps(ptr, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(ptr + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(ptr + 8, _mm256_castps256_ps128(c));
+        _mm_storeu_ps(ptr + 12, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(ptr + 16, _mm256_extractf128_ps(b, 1));
+        _mm_storeu_ps(ptr + 20, _mm256_extractf128_ps(c, 1));
+    }
+
+    // a 4x4 transpose in each lane: points 0-3 in the low one and 4-7 in the high one
+    static void load4(const float* ptr, float8_avx& x, float8_avx& y, float8_avx& z, float8_avx& w)
+    {
+        const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr)), _mm_loadu_ps(ptr + 16), 1);
+        const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 4)), _mm_loadu_ps(ptr + 20), 1);
+        const __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 8)), _mm_loadu_ps(ptr + 24), 1);
+        const __m256 d = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 12)), _mm_loadu_ps(ptr + 28), 1);
+        const __m256 xy01 = _mm256_unpacklo_ps(a, b); // x0 x1 y0 y1
+        const __m256 xy23 = _mm256_unpacklo_ps(c, d); // x2 x3 y2 y3
+        const __m256 zw01 = _mm256_unpackhi_ps(a, b); // z0 z1 w0 w1
+        const __m256 zw23 = _mm256_unpackhi_ps(c, d); // z2 z3 w2 w3
+        x.v = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0));
+        y.v = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+        z.v = _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+        w.v = _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    static void store4(float* ptr, float8_avx x, float8_avx y, float8_avx z, float8_avx w)
+    {
+        const __m256 xy01 = _mm256_unpacklo_ps(x.v, y.v); // x0 y0 x1 y1
+        const __m256 xy23 = _mm256_unpackhi_ps(x.v, y.v); // x2 y2 x3 y3
+        const __m256 zw01 = _mm256_unpacklo_ps(z.v, w.v); // z0 w0 z1 w1
+        const __m256 zw23 = _mm256_unpackhi_ps(z.v, w.v); // z2 w2 z3 w3
+        const __m256 a = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 b = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 c = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 d = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+        _mm_storeu_ps(ptr, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(ptr + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(ptr + 8, _mm256_castps256_ps128(c));
+        _mm_storeu_ps(ptr + 12, _mm256_castps256_ps128(d));
+        _mm_storeu_ps(ptr + 16, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(ptr + 20, _mm256_extractf128_ps(b, 1));
+        _mm_storeu_ps(ptr + 24, _mm256_extractf128_ps(c, 1));
+        _mm_storeu_ps(ptr + 28, _mm256_extractf128_ps(d, 1));
+    }
+};
+
+inline float8_avx operator+(float8_avx a, float8_avx b) { return float8_avx::make(_mm256_add_ps(a.v, b.v)); }
+inline float8_avx operator-(float8_avx a, float8_avx b) { return float8_avx::make(_mm256_sub_ps(a.v, b.v)); }
+inline float8_avx operator*(float8_avx a, float8_avx b) { return float8_avx::make(_mm256_mul_ps(a.v, b.v)); }
+inline float8_avx operator/(float8_avx a, float8_avx b) { return float8_avx::make(_mm256_div_ps(a.v, b.v)); }
+inline float8_avx operator-(float8_avx a) { return float8_avx::make(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.f))); }
+inline float8_avx madd(float8_avx a, float8_avx b, float8_avx c) { return float8_avx::make(madd(a.v, b.v, c.v)); }
+inline float8_avx vmin(float8_avx a, float8_avx b) { return float8_avx::make(_mm256_min_ps(a.v, b.v)); }
+inline float8_avx vmax(float8_avx a, float8_avx b) { return float8_avx::make(_mm256_max_ps(a.v, b.v)); }
+inline float8_avx sqrt(float8_avx a) { return float8_avx::make(_mm256_sqrt_ps(a.v)); }
+inline float8_avx abs(float8_avx a) { return float8_avx::make(_mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v)); }
+inline float8_avx rsqrt(float8_avx a)
+{
+    const __m256 x = _mm256_max_ps(a.v, _mm256_set1_ps(std::numeric_limits<float>::min()));
+#if YAMA_SIMD >= YAMA_SIMD_AVX512
+    const __m256 y = _mm256_rsqrt14_ps(x);
+#else
+    const __m256 y = _mm256_rsqrt_ps(x);
+#endif
+    const __m256 hy = _mm256_mul_ps(_mm256_mul_ps(x, _mm256_set1_ps(-0.5f)), y);
+    return float8_avx::make(_mm256_mul_ps(y, madd(hy, y, _mm256_set1_ps(1.5f))));
+}
+inline float8_avx round(float8_avx a) { return float8_avx::make(_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+inline float8_avx flip_sign(float8_avx a, float8_avx s) { return float8_avx::make(_mm256_xor_ps(a.v, _mm256_and_ps(_mm256_cmp_ps(s.v, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.f)))); }
+inline float8_avx select(float8_avx a, float8_avx b, float8_avx s) { return float8_avx::make(_mm256_blendv_ps(a.v, b.v, _mm256_cmp_ps(s.v, _mm256_setzero_ps(), _CMP_LT_OQ))); }
+inline unsigned ge_mask(float8_avx a, float8_avx b) { return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ))); }
+
+#endif
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX512
+
+// The interleaved loads and stores are permutes of whole registers: every
+// lane of the result picks its value from one or two sources by index, and
+// a masked permute adds the third source of the xyz ones.
+struct float16_avx512
+{
+    typedef float value_type;
+    static constexpr size_t width = 16;
+
+    __m512 v;
+
+    static float16_avx512 make(__m512 m) { float16_avx512 r; r.v = m; return r; }
+    static float16_avx512 uniform(float s) { return make(_mm512_set1_ps(s)); }
+    static float16_avx512 load(const float* ptr) { return make(_mm512_loadu_ps(ptr)); }
+    void store(float* ptr) const { _mm512_storeu_ps(ptr, v); }
+
+    static void load2(const float* ptr, float16_avx512& x, float16_avx512& y)
+    {
+        const __m512 a = _mm512_loadu_ps(ptr);
+        const __m512 b = _mm512_loadu_ps(ptr + 16);
+        x.v = _mm512_permutex2var_ps(a, _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30), b);
+        y.v = _mm512_permutex2var_ps(a, _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31), b);
+    }
+
+    static void store2(float* ptr, float16_avx512 x, float16_avx512 y)
+    {
+        _mm512_storeu_ps(ptr, _mm512_permutex2var_ps(x.v, _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23), y.v));
+        _mm512_storeu_ps(ptr + 16, _mm512_permutex2var_ps(x.v, _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31), y.v));
+    }
+
+    // lane i of x is element 3i of a b c: in a or b up to 31 and in c (modulo 16) after that
+    static void load3(const float* ptr, float16_avx512& x, float16_avx512& y, float16_avx512& z)
+    {
+        const __m512 a = _mm512_loadu_ps(ptr);
+        const __m512 b = _mm512_loadu_ps(ptr + 16);
+        const __m512 c = _mm512_loadu_ps(ptr + 32);
+        const __m512i ix = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45);
+        const __m512i iy = _mm512_add_epi32(ix, _mm512_set1_epi32(1));
+        const __m512i iz = _mm512_add_epi32(ix, _mm512_set1_epi32(2));
+        x.v = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(a, ix, b), 0xf800, ix, c);
+        y.v = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(a, iy, b), 0xf800, iy, c);
+        z.v = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(a, iz, b), 0xfc00, iz, c);
+    }
+
+    // the inverse: x and y by a two-source permute, then z in the masked lanes
+    static void store3(float* ptr, float16_avx512 x, float16_avx512 y, float16_avx512 z)
+    {
+        const __m512i i0 = _mm512_setr_epi32(0, 16, 0, 1, 17, 1, 2, 18, 2, 3, 19, 3, 4, 20, 4, 5);
+        const __m512i i1 = _mm512_setr_epi32(21, 5, 6, 22, 6, 7, 23, 7, 8, 24, 8, 9, 25, 9, 10, 26);
+        const __m512i i2 = _mm512_setr_epi32(10, 11, 27, 11, 12, 28, 12, 13, 29, 13, 14, 30, 14, 15, 31, 15);
+        _mm512_storeu_ps(ptr, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(x.v, i0, y.v), 0x4924, i0, z.v));
+        _mm512_storeu_ps(ptr + 16, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(x.v, i1, y.v), 0x2492, i1, z.v));
+        _mm512_storeu_ps(ptr + 32, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(x.v, i2, y.v), 0x9249, i2, z.v));
+    }
+
+    // xy and zw of points 0-7 and 8-15 first, then the halves are joined
+    static void load4(const float* ptr, float16_avx512& x, float16_avx512& y, float16_avx512& z, float16_avx512& w)
+    {
+        const __m512i even = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, 1, 5, 9, 13, 17, 21, 25, 29);
+        const __m512i odd = _mm512_setr_epi32(2, 6, 10, 14, 18, 22, 26, 30, 3, 7, 11, 15, 19, 23, 27, 31);
+        const __m512i lo = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23);
+        const __m512i hi = _mm512_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31);
+        const __m512 a = _mm512_loadu_ps(ptr), b = _mm512_loadu_ps(ptr + 16);
+        const __m512 c = _mm512_loadu_ps(ptr + 32), d = _mm512_loadu_ps(ptr + 48);
+        const __m512 xy0 = _mm512_permutex2var_ps(a, even, b); // x0-7 y0-7
+        const __m512 zw0 = _mm512_permutex2var_ps(a, odd, b); // z0-7 w0-7
+        const __m512 xy1 = _mm512_permutex2var_ps(c, even, d); // x8-15 y8-15
+        const __m512 zw1 = _mm512_permutex2var_ps(c, odd, d); // z8-15 w8-15
+        x.v = _mm512_permutex2var_ps(xy0, lo, xy1);
+        y.v = _mm512_permutex2var_ps(xy0, hi, xy1);
+        z.v = _mm512_permutex2var_ps(zw0, lo, zw1);
+        w.v = _mm512_permutex2var_ps(zw0, hi, zw1);
+    }
+
+    static void store4(float* ptr, float16_avx512 x, float16_avx512 y, float16_avx512 z, float16_avx512 w)
+    {
+        const __m512i lo = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23);
+        const __m512i hi = _mm512_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31);
+        const __m512i first = _mm512_setr_epi32(0, 8, 16, 24, 1, 9, 17, 25, 2, 10, 18, 26, 3, 11, 19, 27);
+        const __m512i second = _mm512_setr_epi32(4, 12, 20, 28, 5, 13, 21, 29, 6, 14, 22, 30, 7, 15, 23, 31);
+        const __m512 xy0 = _mm512_permutex2var_ps(x.v, lo, y.v); // x0-7 y0-7
+        const __m512 xy1 = _mm512_permutex2var_ps(x.v, hi, y.v); // x8-15 y8-15
+        const __m512 zw0 = _mm512_permutex2var_ps(z.v, lo, w.v); // z0-7 w0-7
+        const __m512 zw1 = _mm512_permutex2var_ps(z.v, hi, w.v); // z8-15 w8-15
+        _mm512_storeu_ps(ptr, _mm512_permutex2var_ps(xy0, first, zw0));
+        _mm512_storeu_ps(ptr + 16, _mm512_permutex2var_ps(xy0, second, zw0));
+        _mm512_storeu_ps(ptr + 32, _mm512_permutex2var_ps(xy1, first, zw1));
+        _mm512_storeu_ps(ptr + 48, _mm512_permutex2var_ps(xy1, second, zw1));
+    }
+};
+
+inline float16_avx512 operator+(float16_avx512 a, float16_avx512 b) { return float16_avx512::make(_mm512_add_ps(a.v, b.v)); }
+inline float16_avx512 operator-(float16_avx512 a, float16_avx512 b) { return float16_avx512::make(_mm512_sub_ps(a.v, b.v)); }
+inline float16_avx512 operator*(float16_avx512 a, float16_avx512 b) { return float16_avx512::make(_mm512_mul_ps(a.v, b.v)); }
+inline float16_avx512 operator/(float16_avx512 a, float16_avx512 b) { return float16_avx512::make(_mm512_div_ps(a.v, b.v)); }
+inline float16_avx512 operator-(float16_avx512 a) { return float16_avx512::make(_mm512_xor_ps(a.v, _mm512_set1_ps(-0.f))); }
+inline float16_avx512 madd(float16_avx512 a, float16_avx512 b, float16_avx512 c) { return float16_avx512::make(madd(a.v, b.v, c.v)); }
+// The unmasked forms of min, max, sqrt, rsqrt14 and roundscale merge into an undefined
+// register, which GCC 12 reports as uninitialized once they are inlined. The zero-masked
+// forms with every lane set merge into _mm512_setzero_ps() and compile to the same code.
+const __mmask16 all_lanes16 = 0xffff;
+
+inline float16_avx512 vmin(float16_avx512 a, float16_avx512 b) { return float16_avx512::make(_mm512_maskz_min_ps(all_lanes16, a.v, b.v)); }
+inline float16_avx512 vmax(float16_avx512 a, float16_avx512 b) { return float16_avx512::make(_mm512_maskz_max_ps(all_lanes16, a.v, b.v)); }
+inline float16_avx512 sqrt(float16_avx512 a) { return float16_avx512::make(_mm512_maskz_sqrt_ps(all_lanes16, a.v)); }
+inline float16_avx512 abs(float16_avx512 a) { return float16_avx512::make(_mm512_andnot_ps(_mm512_set1_ps(-0.f), a.v)); }
+inline float16_avx512 rsqrt(float16_avx512 a)
+{
+    const __m512 x = _mm512_maskz_max_ps(all_lanes16, a.v, _mm512_set1_ps(std::numeric_limits<float>::min()));
+    const __m512 y = _mm512_maskz_rsqrt14_ps(all_lanes16, x);
+    const __m512 hy = _mm512_mul_ps(_mm512_mul_ps(x, _mm512_set1_ps(-0.5f)), y);
+    return float16_avx512::make(_mm512_mul_ps(y, madd(hy, y, _mm512_set1_ps(1.5f))));
+}
+inline float16_avx512 round(float16_avx512 a) { return float16_avx512::make(_mm512_maskz_roundscale_ps(all_lanes16, a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+inline float16_avx512 flip_sign(float16_avx512 a, float16_avx512 s) { return float16_avx512::make(_mm512_mask_xor_ps(a.v, _mm512_cmp_ps_mask(s.v, _mm512_setzero_ps(), _CMP_LT_OQ), a.v, _mm512_set1_ps(-0.f))); }
+inline float16_avx512 select(float16_avx512 a, float16_avx512 b, float16_avx512 s) { return float16_avx512::make(_mm512_mask_blend_ps(_mm512_cmp_ps_mask(s.v, _mm512_setzero_ps(), _CMP_LT_OQ), a.v, b.v)); }
+inline unsigned ge_mask(float16_avx512 a, float16_avx512 b) { return unsigned(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)); }
+
+#endif
+
+// the widest pack for a type
+template <typename T>
+struct best_pack
+{
+    typedef scalar_pack<T> type;
+};
+
+#if YAMA_SIMD >= YAMA_SIMD_AVX512
+template <>
+struct best_pack<float>
+{
+    typedef float16_avx512 type;
+};
+#elif YAMA_SIMD >= YAMA_SIMD_AVX
+template <>
+struct best_pack<float>
+{
+    typedef float8_avx type;
+};
+#elif YAMA_SIMD >= YAMA_SIMD_SSE2
+template <>
+struct best_pack<float>
+{
+    typedef float4_sse type;
+};
+#endif
+
+template <typename T>
+using pack = typename best_pack<T>::type;
+
+///////////////////////////////////////////////////////////////////////////////
+// trigonometry in packs
+// For float packs these are polynomials, the same in every lane and for
+// scalar_pack<float>, so the batch functions give the same results with and
+// without YAMA_SIMD (up to the rounding of madd). The error against the
+// exact value, checked for every float in the domain, with and without FMA:
+//  sin, cos: at most 2 ulp for |x| <= pi and at most 1e-7 for |x| <= 8192
+//  acos: at most 1.5 ulp over [-1, 1]
+// The reduction of sin and cos loses precision beyond |x| = 8192.
+// For double they call the functions from <cmath>.
+
+template <typename P, typename R = P>
+using if_float_pack = typename std::enable_if<std::is_same<typename P::value_type, float>::value, R>::type;
+
+// The argument is reduced to r in [-pi/4, pi/4] with x = r + j*pi/2, using
+// the split pi/2 from Cephes, whose first two parts multiply j exactly.
+// The minimax polynomials for r are also from Cephes (sinf, cosf).
+// The quadrant q = j mod 4 then swaps sin and cos and flips their signs.
+template <typename P>
+if_float_pack<P, void> sincos(P x, P& s, P& c)
+{
+    const P j = round(x * P::uniform(0.636619772f)); // 2/pi
+    P r = madd(j, P::uniform(-1.5703125f), x);
+    r = madd(j, P::uniform(-4.837512969970703125e-4f), r);
+    r = madd(j, P::uniform(-7.54978995489188216e-8f), r);
+
+    const P r2 = r * r;
+    const P ps = madd(madd(madd(P::uniform(-1.9515295891e-4f), r2, P::uniform(8.3321608736e-3f)), r2, P::uniform(-1.6666654611e-1f)), r * r2, r);
+    const P pc = madd(madd(madd(P::uniform(2.443315711809948e-5f), r2, P::uniform(-1.388731625493765e-3f)), r2, P::uniform(4.166664568298827e-2f)), r2 * r2, madd(r2, P::uniform(-0.5f), P::uniform(1)));
+
+    // floor(j/4) is round(j/4 - 3/8), as j/4 - 3/8 is never a tie
+    const P q = madd(round(madd(j, P::uniform(0.25f), P::uniform(-0.375f))), P::uniform(-4), j);
+    const P d = abs(q - P::uniform(2)) - P::uniform(1);
+    const P q_odd = d * d - P::uniform(0.5f); // < 0 for 1, 3
+    const P s_neg = P::uniform(1.5f) - q; // < 0 for 2, 3
+    const P c_neg = abs(q - P::uniform(1.5f)) - P::uniform(1); // < 0 for 1, 2
+    s = flip_sign(select(ps, pc, q_odd), s_neg);
+    c = flip_sign(select(pc, ps, q_odd), c_neg);
+}
+
+template <typename P>
+if_float_pack<P> sin(P x)
+{
+    P s, c;
+    sincos(x, s, c);
+    return s;
+}
+
+template <typename P>
+if_float_pack<P> cos(P x)
+{
+    P s, c;
+    sincos(x, s, c);
+    return c;
+}
+
+// acos(x) = pi/2 - asin(x) with the asin polynomial from Cephes (asinf) on
+// [0, 1/2], and acos(|x|) = 2*asin(sqrt((1 - |x|)/2)) above that
+// x is clamped to [-1, 1].
+template <typename P>
+if_float_pack<P> acos(P x)
+{
+    const P a = vmin(abs(x), P::uniform(1));
+    const P big = P::uniform(0.5f) - a; // < 0 for |x| > 1/2
+    const P z = select(a * a, (P::uniform(1) - a) * P::uniform(0.5f), big);
+    const P t = select(a, sqrt(z), big);
+    const P poly = madd(madd(madd(madd(P::uniform(4.2163199048e-2f), z, P::uniform(2.4181311049e-2f)), z, P::uniform(4.5470025998e-2f)), z, P::uniform(7.4953002686e-2f)), z, P::uniform(1.6666752422e-1f));
+    const P asin_t = madd(t * z, poly, t);
+
+    const P small_result = P::uniform(1.57079632679f) - flip_sign(asin_t, x);
+    const P big_result = select(asin_t + asin_t, P::uniform(3.14159265359f) - (asin_t + asin_t), x);
+    return select(small_result, big_result, big);
+}
+
+inline void sincos(scalar_pack<double> x, scalar_pack<double>& s, scalar_pack<double>& c)
+{
+    s.v = std::sin(x.v);
+    c.v = std::cos(x.v);
+}
+
+inline scalar_pack<double> sin(scalar_pack<double> x) { return scalar_pack<double>::uniform(std::sin(x.v)); }
+inline scalar_pack<double> cos(scalar_pack<double> x) { return scalar_pack<double>::uniform(std::cos(x.v)); }
+inline scalar_pack<double> acos(scalar_pack<double> x) { return scalar_pack<double>::uniform(std::acos(x.v)); }
+
+}
+}
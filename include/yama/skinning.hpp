@@ -0,0 +1,546 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Skinning
+// Every vertex is transformed by the sum of the palette transformations of
+// its bones, weighted by its bone weights:
+//      p' = (w0*palette[b0] + w1*palette[b1] + ...) * p
+// The weights of a vertex should add up to 1. Unused influences should have
+// weight 0 and any valid bone index.
+//
+// The type of the palette selects the method:
+// * matrix3x4_t - linear blend skinning. Normals are transformed by the same
+//   matrix and normalized, which is exact for bones with rotation,
+//   translation and uniform scaling only.
+// * dual_quaternion_t - dual quaternion linear blending. The blend is
+//   normalized, so the volume is preserved around twisting joints. The bones
+//   should be rigid (rotation and translation only).
+//
+// Influences is the number of bones per vertex, usually 4 or 8. The blended
+// transformation of a vertex is built once and used for both its position
+// and its normal. With YAMA_SIMD the float blend works on whole matrix
+// columns or quaternions.
+//
+// The output may be the same as the input. With YAMA_THREADS the skin
+// overloads which take a parallel::thread_pool split the vertices between the
+// threads of the pool. skin_parallel does the same on a pool started for the
+// call.
+
+#include "vector3.hpp"
+#include "matrix3x4.hpp"
+#include "dual_quaternion.hpp"
+#include "batch.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+namespace yama
+{
+
+// Interleaved or separate vertex arrays. Each attribute has its own distance
+// in bytes between consecutive vertices.
+template <typename T, typename Index>
+struct skinning_input_t
+{
+    const vector3_t<T>* positions;
+    size_t positions_stride;
+    const vector3_t<T>* normals; // may be null
+    size_t normals_stride;
+    const Index* bones; // Influences consecutive indices per vertex
+    size_t bones_stride;
+    const T* weights; // Influences consecutive weights per vertex
+    size_t weights_stride;
+};
+
+template <typename T>
+struct skinning_output_t
+{
+    vector3_t<T>* positions;
+    size_t positions_stride;
+    vector3_t<T>* normals; // ignored if the input has no normals
+    size_t normals_stride;
+};
+
+namespace internal
+{
+
+// the blended matrix of a vertex
+template <typename T>
+struct skin_matrix
+{
+    T m[12]; // column-major, as matrix3x4_t
+
+    template <size_t N, typename Index>
+    void blend(const matrix3x4_t<T>* palette, const Index* bones, const T* weights)
+    {
+        const T* b = palette[bones[0]].data();
+        for (size_t e = 0; e < 12; ++e)
+        {
+            m[e] = b[e] * weights[0];
+        }
+
+        for (size_t k = 1; k < N; ++k)
+        {
+            b = palette[bones[k]].data();
+            const T w = weights[k];
+            for (size_t e = 0; e < 12; ++e)
+            {
+                m[e] += b[e] * w;
+            }
+        }
+    }
+
+    void transform_coord(const vector3_t<T>& p, vector3_t<T>& out) const
+    {
+        const T x = m[0]*p.x + m[3]*p.y + m[6]*p.z + m[9];
+        const T y = m[1]*p.x + m[4]*p.y + m[7]*p.z + m[10];
+        const T z = m[2]*p.x + m[5]*p.y + m[8]*p.z + m[11];
+        out = vector3_t<T>::coord(x, y, z);
+    }
+
+    // by columns
+    void set(T e0, T e1, T e2, T e3, T e4, T e5, T e6, T e7, T e8, T e9, T e10, T e11)
+    {
+        m[0] = e0; m[1] = e1; m[2] = e2;
+        m[3] = e3; m[4] = e4; m[5] = e5;
+        m[6] = e6; m[7] = e7; m[8] = e8;
+        m[9] = e9; m[10] = e10; m[11] = e11;
+    }
+
+    void transform_direction(const vector3_t<T>& n, vector3_t<T>& out) const
+    {
+        out = vector3_t<T>::coord(
+            m[0]*n.x + m[3]*n.y + m[6]*n.z,
+            m[1]*n.x + m[4]*n.y + m[7]*n.z,
+            m[2]*n.x + m[5]*n.y + m[8]*n.z
+        );
+    }
+
+    void transform_normal(const vector3_t<T>& n, vector3_t<T>& out) const
+    {
+        transform_direction(n, out);
+        out /= out.length();
+    }
+};
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+// stores the first three lanes
+inline void skin_store(__m128 v, vector3_t<float>& out)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(out.data()), v);
+    _mm_store_ss(out.data() + 2, _mm_movehl_ps(v, v));
+}
+
+template <>
+struct skin_matrix<float>
+{
+    __m128 c0, c1, c2, c3; // columns, the last lane is unused
+
+    // The columns start at floats 0, 3, 6 and 9 of a matrix. The last one is
+    // loaded from 8, so that no load reads past the matrix, and shifted once
+    // after blending.
+    template <size_t N, typename Index>
+    void blend(const matrix3x4_t<float>* palette, const Index* bones, const float* weights)
+    {
+        const float* b = palette[bones[0]].data();
+        __m128 w = _mm_set1_ps(weights[0]);
+        __m128 a0 = _mm_mul_ps(_mm_loadu_ps(b), w);
+        __m128 a1 = _mm_mul_ps(_mm_loadu_ps(b + 3), w);
+        __m128 a2 = _mm_mul_ps(_mm_loadu_ps(b + 6), w);
+        __m128 a3 = _mm_mul_ps(_mm_loadu_ps(b + 8), w);
+
+        for (size_t k = 1; k < N; ++k)
+        {
+            b = palette[bones[k]].data();
+            w = _mm_set1_ps(weights[k]);
+            a0 = madd(_mm_loadu_ps(b), w, a0);
+            a1 = madd(_mm_loadu_ps(b + 3), w, a1);
+            a2 = madd(_mm_loadu_ps(b + 6), w, a2);
+            a3 = madd(_mm_loadu_ps(b + 8), w, a3);
+        }
+
+        c0 = a0;
+        c1 = a1;
+        c2 = a2;
+        c3 = _mm_shuffle_ps(a3, a3, _MM_SHUFFLE(3, 3, 2, 1));
+    }
+
+    void set(float e0, float e1, float e2, float e3, float e4, float e5, float e6, float e7, float e8, float e9, float e10, float e11)
+    {
+        c0 = _mm_setr_ps(e0, e1, e2, 0);
+        c1 = _mm_setr_ps(e3, e4, e5, 0);
+        c2 = _mm_setr_ps(e6, e7, e8, 0);
+        c3 = _mm_setr_ps(e9, e10, e11, 0);
+    }
+
+    void transform_coord(const vector3_t<float>& p, vector3_t<float>& out) const
+    {
+        skin_store(madd(c0, _mm_set1_ps(p.x), madd(c1, _mm_set1_ps(p.y), madd(c2, _mm_set1_ps(p.z), c3))), out);
+    }
+
+    __m128 direction(const vector3_t<float>& n) const
+    {
+        return madd(c0, _mm_set1_ps(n.x), madd(c1, _mm_set1_ps(n.y), _mm_mul_ps(c2, _mm_set1_ps(n.z))));
+    }
+
+    void transform_direction(const vector3_t<float>& n, vector3_t<float>& out) const
+    {
+        skin_store(direction(n), out);
+    }
+
+    void transform_normal(const vector3_t<float>& n, vector3_t<float>& out) const
+    {
+        const __m128 r = direction(n);
+        const __m128 sq = _mm_mul_ps(r, r);
+        __m128 l = _mm_add_ss(_mm_add_ss(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 1, 1, 1))), _mm_movehl_ps(sq, sq));
+        l = _mm_sqrt_ss(l);
+        skin_store(_mm_div_ps(r, _mm_shuffle_ps(l, l, _MM_SHUFFLE(0, 0, 0, 0))), out);
+    }
+};
+
+#endif
+
+// The weighted sum of the dual quaternions of a vertex, not normalized.
+// q and -q are the same transformation, so the bones are blended the
+// shortest way around from the first one.
+template <size_t N, typename T, typename Index>
+void skin_blend_dual_quaternions(const dual_quaternion_t<T>* palette, const Index* bones, const T* weights, T* r, T* d)
+{
+    const auto& q0 = palette[bones[0]];
+    auto br = q0.real * weights[0];
+    auto bd = q0.dual * weights[0];
+
+    for (size_t k = 1; k < N; ++k)
+    {
+        const auto& q = palette[bones[k]];
+        const T w = dot(q.real, q0.real) < 0 ? -weights[k] : weights[k];
+        br += q.real * w;
+        bd += q.dual * w;
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        r[i] = br[i];
+        d[i] = bd[i];
+    }
+}
+
+// The blended dual quaternion of a vertex, applied as a matrix. Converting
+// the blend to a matrix costs less than rotating twice by the quaternion
+// and folds the normalization into a single division.
+template <typename T>
+struct skin_dual_quaternion
+{
+    skin_matrix<T> m;
+
+    template <size_t N, typename Index>
+    void blend(const dual_quaternion_t<T>* palette, const Index* bones, const T* weights)
+    {
+        T r[4], d[4];
+        skin_blend_dual_quaternions<N>(palette, bones, weights, r, d);
+        const T x = r[0], y = r[1], z = r[2], w = r[3];
+
+        // matrix3x4_t::rotation_quaternion and dual_quaternion_t::translation_vector, divided by the squared length
+        const T s = T(1) / (x*x + y*y + z*z + w*w);
+        const T x2 = x*x*s, y2 = y*y*s, z2 = z*z*s, w2 = w*w*s;
+        const T xy = 2*x*y*s, xz = 2*x*z*s, xw = 2*x*w*s;
+        const T yz = 2*y*z*s, yw = 2*y*w*s, zw = 2*z*w*s;
+        const T s2 = 2*s;
+
+        m.set(
+            w2 + x2 - y2 - z2, xy + zw, xz - yw,
+            xy - zw, w2 - x2 + y2 - z2, yz + xw,
+            xz + yw, yz - xw, w2 - x2 - y2 + z2,
+            (w*d[0] - d[3]*x + y*d[2] - z*d[1]) * s2,
+            (w*d[1] - d[3]*y + z*d[0] - x*d[2]) * s2,
+            (w*d[2] - d[3]*z + x*d[1] - y*d[0]) * s2
+        );
+    }
+
+    void transform_coord(const vector3_t<T>& p, vector3_t<T>& out) const
+    {
+        m.transform_coord(p, out);
+    }
+
+    // rigid, no need to normalize
+    void transform_normal(const vector3_t<T>& n, vector3_t<T>& out) const
+    {
+        m.transform_direction(n, out);
+    }
+};
+
+#if YAMA_SIMD >= YAMA_SIMD_SSE2
+
+// the sum of the four lanes in all lanes
+inline __m128 skin_sum4(__m128 a)
+{
+    a = _mm_add_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+// the cross product of the first three lanes
+inline __m128 skin_cross(__m128 a, __m128 b)
+{
+    const __m128 c = _mm_sub_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), b)
+    );
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// With SIMD rotating by the quaternion is cheaper than building a matrix.
+template <>
+struct skin_dual_quaternion<float>
+{
+    __m128 r, rw, t; // rotation, its w broadcast, translation
+
+    template <size_t N, typename Index>
+    void blend(const dual_quaternion_t<float>* palette, const Index* bones, const float* weights)
+    {
+        const float* q = palette[bones[0]].data();
+        const __m128 r0 = _mm_loadu_ps(q);
+        __m128 w = _mm_set1_ps(weights[0]);
+        __m128 br = _mm_mul_ps(r0, w);
+        __m128 bd = _mm_mul_ps(_mm_loadu_ps(q + 4), w);
+
+        // negate the weight if dot(q.real, q0.real) < 0
+        const __m128 sign = _mm_set1_ps(-0.f);
+        for (size_t k = 1; k < N; ++k)
+        {
+            q = palette[bones[k]].data();
+            const __m128 rk = _mm_loadu_ps(q);
+            w = _mm_xor_ps(_mm_set1_ps(weights[k]), _mm_and_ps(skin_sum4(_mm_mul_ps(rk, r0)), sign));
+            br = madd(rk, w, br);
+            bd = madd(_mm_loadu_ps(q + 4), w, bd);
+        }
+
+        const __m128 l = _mm_sqrt_ps(skin_sum4(_mm_mul_ps(br, br)));
+        r = _mm_div_ps(br, l);
+        const __m128 d = _mm_div_ps(bd, l);
+        rw = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3));
+
+        // the vector part of 2 * d * conjugate(r)
+        const __m128 dw = _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 v = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rw, d), _mm_mul_ps(dw, r)), skin_cross(r, d));
+        t = _mm_add_ps(v, v);
+    }
+
+    // v + w*u + r x u, where u = 2 * (r x v)
+    __m128 rotate(__m128 v) const
+    {
+        __m128 u = skin_cross(r, v);
+        u = _mm_add_ps(u, u);
+        return _mm_add_ps(madd(rw, u, v), skin_cross(r, u));
+    }
+
+    void transform_coord(const vector3_t<float>& p, vector3_t<float>& out) const
+    {
+        skin_store(_mm_add_ps(rotate(_mm_setr_ps(p.x, p.y, p.z, 0)), t), out);
+    }
+
+    void transform_normal(const vector3_t<float>& n, vector3_t<float>& out) const
+    {
+        skin_store(rotate(_mm_setr_ps(n.x, n.y, n.z, 0)), out);
+    }
+};
+
+#endif
+
+// the blender for a palette type
+template <typename Bone>
+struct skin_blender;
+
+template <typename T>
+struct skin_blender<matrix3x4_t<T>>
+{
+    typedef skin_matrix<T> type;
+};
+
+template <typename T>
+struct skin_blender<dual_quaternion_t<T>>
+{
+    typedef skin_dual_quaternion<T> type;
+};
+
+template <size_t N, typename Bone, typename Index>
+void skin_range(const Bone* palette, const skinning_input_t<typename Bone::value_type, Index>& in, const skinning_output_t<typename Bone::value_type>& out, size_t first, size_t count)
+{
+    typename skin_blender<Bone>::type m;
+    for (size_t i = first; i < first + count; ++i)
+    {
+        m.template blend<N>(palette, byte_offset(in.bones, i * in.bones_stride), byte_offset(in.weights, i * in.weights_stride));
+        m.transform_coord(*byte_offset(in.positions, i * in.positions_stride), *byte_offset(out.positions, i * out.positions_stride));
+        if (in.normals)
+        {
+            m.transform_normal(*byte_offset(in.normals, i * in.normals_stride), *byte_offset(out.normals, i * out.normals_stride));
+        }
+    }
+}
+
+template <size_t N, typename Bone, typename Index>
+struct skin_soa_args
+{
+    typedef typename Bone::value_type T;
+
+    const Bone* palette;
+    const T* p[3];
+    const T* n[3]; // null without normals
+    const Index* const* bones;
+    const T* const* weights;
+    T* out_p[3];
+    T* out_n[3];
+
+    void run(size_t first, size_t count) const
+    {
+        typename skin_blender<Bone>::type m;
+        Index b[N];
+        T w[N];
+        vector3_t<T> v;
+        for (size_t i = first; i < first + count; ++i)
+        {
+            for (size_t k = 0; k < N; ++k)
+            {
+                b[k] = bones[k][i];
+                w[k] = weights[k][i];
+            }
+            m.template blend<N>(palette, b, w);
+
+            m.transform_coord(vector3_t<T>::coord(p[0][i], p[1][i], p[2][i]), v);
+            out_p[0][i] = v.x;
+            out_p[1][i] = v.y;
+            out_p[2][i] = v.z;
+
+            if (n[0])
+            {
+                m.transform_normal(vector3_t<T>::coord(n[0][i], n[1][i], n[2][i]), v);
+                out_n[0][i] = v.x;
+                out_n[1][i] = v.y;
+                out_n[2][i] = v.z;
+            }
+        }
+    }
+};
+
+// resizes the outputs
+template <size_t N, typename Bone, typename Index, typename T>
+skin_soa_args<N, Bone, Index> make_skin_soa_args(const Bone* palette,
+    const vector3_soa_t<T>& positions, const vector3_soa_t<T>* normals,
+    const Index* const* bones, const T* const* weights,
+    vector3_soa_t<T>& out_positions, vector3_soa_t<T>* out_normals)
+{
+    skin_soa_args<N, Bone, Index> a;
+    a.palette = palette;
+    a.bones = bones;
+    a.weights = weights;
+
+    out_positions.resize(positions.size());
+    if (normals)
+    {
+        YAMA_ASSERT_CRIT(normals->size() == positions.size(), "yama soa containers of different size");
+        out_normals->resize(positions.size());
+    }
+
+    for (size_t c = 0; c < 3; ++c)
+    {
+        a.p[c] = positions.stream(c);
+        a.out_p[c] = out_positions.stream(c);
+        a.n[c] = normals ? normals->stream(c) : nullptr;
+        a.out_n[c] = normals ? out_normals->stream(c) : nullptr;
+    }
+    return a;
+}
+
+// vertices per chunk boundary when splitting between threads
+const size_t skin_granularity = 64;
+
+}
+
+// the palette is matrix3x4_t or dual_quaternion_t
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin(const Bone<T>* palette, const skinning_input_t<T, Index>& in, const skinning_output_t<T>& out, size_t count)
+{
+    internal::skin_range<Influences>(palette, in, out, 0, count);
+}
+
+// bones and weights are Influences streams of positions.size() values each
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin(const Bone<T>* palette, const vector3_soa_t<T>& positions, const vector3_soa_t<T>& normals,
+    const Index* const* bones, const T* const* weights, vector3_soa_t<T>& out_positions, vector3_soa_t<T>& out_normals)
+{
+    const auto a = internal::make_skin_soa_args<Influences>(palette, positions, &normals, bones, weights, out_positions, &out_normals);
+    a.run(0, positions.size());
+}
+
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin(const Bone<T>* palette, const vector3_soa_t<T>& positions,
+    const Index* const* bones, const T* const* weights, vector3_soa_t<T>& out_positions)
+{
+    const auto a = internal::make_skin_soa_args<Influences>(palette, positions, static_cast<const vector3_soa_t<T>*>(nullptr), bones, weights, out_positions, static_cast<vector3_soa_t<T>*>(nullptr));
+    a.run(0, positions.size());
+}
+
+#if YAMA_THREADS
+
+// the vertices split between the threads of pool
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin(parallel::thread_pool& pool, const Bone<T>* palette, const skinning_input_t<T, Index>& in, const skinning_output_t<T>& out, size_t count)
+{
+    parallel::for_each_chunk(pool, count, internal::skin_granularity, [&](size_t first, size_t n) {
+        internal::skin_range<Influences>(palette, in, out, first, n);
+    });
+}
+
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin(parallel::thread_pool& pool, const Bone<T>* palette, const vector3_soa_t<T>& positions, const vector3_soa_t<T>& normals,
+    const Index* const* bones, const T* const* weights, vector3_soa_t<T>& out_positions, vector3_soa_t<T>& out_normals)
+{
+    const auto a = internal::make_skin_soa_args<Influences>(palette, positions, &normals, bones, weights, out_positions, &out_normals);
+    parallel::for_each_chunk(pool, positions.size(), internal::skin_granularity, [&a](size_t first, size_t n) {
+        a.run(first, n);
+    });
+}
+
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin(parallel::thread_pool& pool, const Bone<T>* palette, const vector3_soa_t<T>& positions,
+    const Index* const* bones, const T* const* weights, vector3_soa_t<T>& out_positions)
+{
+    const auto a = internal::make_skin_soa_args<Influences>(palette, positions, static_cast<const vector3_soa_t<T>*>(nullptr), bones, weights, out_positions, static_cast<vector3_soa_t<T>*>(nullptr));
+    parallel::for_each_chunk(pool, positions.size(), internal::skin_granularity, [&a](size_t first, size_t n) {
+        a.run(first, n);
+    });
+}
+
+// the same on a pool of thread_count threads, started for the call
+// thread_count 0 means one thread per hardware thread
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin_parallel(const Bone<T>* palette, const skinning_input_t<T, Index>& in, const skinning_output_t<T>& out, size_t count, size_t thread_count = 0)
+{
+    parallel::thread_pool pool(thread_count);
+    skin<Influences>(pool, palette, in, out, count);
+}
+
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin_parallel(const Bone<T>* palette, const vector3_soa_t<T>& positions, const vector3_soa_t<T>& normals,
+    const Index* const* bones, const T* const* weights, vector3_soa_t<T>& out_positions, vector3_soa_t<T>& out_normals, size_t thread_count = 0)
+{
+    parallel::thread_pool pool(thread_count);
+    skin<Influences>(pool, palette, positions, normals, bones, weights, out_positions, out_normals);
+}
+
+template <size_t Influences, template <typename> class Bone, typename T, typename Index>
+void skin_parallel(const Bone<T>* palette, const vector3_soa_t<T>& positions,
+    const Index* const* bones, const T* const* weights, vector3_soa_t<T>& out_positions, size_t thread_count = 0)
+{
+    parallel::thread_pool pool(thread_count);
+    skin<Influences>(pool, palette, positions, bones, weights, out_positions);
+}
+
+#endif
+
+}
@@ -0,0 +1,1332 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Structure-of-arrays containers
+// vector3_soa_t, vector4_soa_t and quaternion_soa_t keep every component in a
+// separate stream, so batch kernels load whole SIMD packs with no shuffling.
+// The streams live in a single 64-byte aligned allocation and each one is
+// padded to a multiple of 16 elements, which is a whole number of packs for
+// any supported SIMD width. Kernels over containers process the padding too
+// and never need a scalar tail. The contents of the padding are unspecified.
+//
+// Indexing a container returns a proxy which references the components of
+// the element and converts to and from the corresponding yama type.
+//
+// With YAMA_THREADS the heavier batch functions have overloads which take a
+// parallel::thread_pool. Their chunks start at multiples of the padding.
+
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "quaternion.hpp"
+#include "batch.hpp"
+#include "aligned.hpp"
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace yama
+{
+
+namespace internal
+{
+
+// N padded streams of T in one aligned buffer
+template <typename T, size_t N>
+class soa_streams
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    static constexpr size_type stream_count = N;
+    static constexpr size_type lane_padding = 16;
+    static constexpr size_type alignment = 64;
+
+    soa_streams()
+        : m_data(nullptr)
+        , m_size(0)
+        , m_capacity(0)
+    {}
+
+    explicit soa_streams(size_type size)
+        : soa_streams()
+    {
+        resize(size);
+    }
+
+    soa_streams(const soa_streams& other)
+        : soa_streams()
+    {
+        *this = other;
+    }
+
+    soa_streams(soa_streams&& other)
+        : m_data(other.m_data)
+        , m_size(other.m_size)
+        , m_capacity(other.m_capacity)
+    {
+        other.m_data = nullptr;
+        other.m_size = other.m_capacity = 0;
+    }
+
+    ~soa_streams()
+    {
+        free_aligned(m_data);
+    }
+
+    soa_streams& operator=(const soa_streams& other)
+    {
+        if (this == &other) return *this;
+        m_size = 0;
+        resize(other.m_size);
+        for (size_type s = 0; s < N; ++s)
+        {
+            std::memcpy(stream(s), other.stream(s), m_size * sizeof(T));
+        }
+        return *this;
+    }
+
+    soa_streams& operator=(soa_streams&& other)
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        return *this;
+    }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_type capacity() const { return m_capacity; }
+
+    // the number of elements processed by kernels: size rounded up to lane_padding
+    size_type padded_size() const
+    {
+        return (m_size + lane_padding - 1) & ~(lane_padding - 1);
+    }
+
+    void reserve(size_type n)
+    {
+        if (n <= m_capacity) return;
+
+        const size_type capacity = (n + lane_padding - 1) & ~(lane_padding - 1);
+        T* data = static_cast<T*>(allocate_aligned(N * capacity * sizeof(T), alignment));
+        std::memset(data, 0, N * capacity * sizeof(T));
+        for (size_type s = 0; s < N; ++s)
+        {
+            if (m_size) std::memcpy(data + s * capacity, stream(s), m_size * sizeof(T));
+        }
+
+        free_aligned(m_data);
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    // new elements are zero
+    void resize(size_type n)
+    {
+        reserve(n);
+        for (size_type s = 0; s < N && n > m_size; ++s)
+        {
+            std::memset(stream(s) + m_size, 0, (n - m_size) * sizeof(T));
+        }
+        m_size = n;
+    }
+
+    void clear()
+    {
+        m_size = 0;
+    }
+
+    T* stream(size_type s)
+    {
+        YAMA_ASSERT_CRIT(s < N, "yama soa stream index overflow");
+        return m_data + s * m_capacity;
+    }
+
+    const T* stream(size_type s) const
+    {
+        YAMA_ASSERT_CRIT(s < N, "yama soa stream index overflow");
+        return m_data + s * m_capacity;
+    }
+
+protected:
+    // makes room for one more element and returns its index
+    size_type grow()
+    {
+        if (m_size == m_capacity)
+        {
+            reserve(m_capacity ? 2 * m_capacity : lane_padding);
+        }
+        return m_size++;
+    }
+
+private:
+    T* m_data;
+    size_type m_size;
+    size_type m_capacity;
+};
+
+template <typename T, size_t N> constexpr size_t soa_streams<T, N>::stream_count;
+template <typename T, size_t N> constexpr size_t soa_streams<T, N>::lane_padding;
+template <typename T, size_t N> constexpr size_t soa_streams<T, N>::alignment;
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// element proxies
+
+template <typename T>
+class vector3_soa_ref_t
+{
+public:
+    T& x;
+    T& y;
+    T& z;
+
+    typedef T value_type;
+
+    vector3_soa_ref_t(T& x, T& y, T& z)
+        : x(x), y(y), z(z)
+    {}
+
+    vector3_soa_ref_t(const vector3_soa_ref_t&) = default;
+
+    vector3_soa_ref_t& operator=(const vector3_soa_ref_t& b)
+    {
+        return *this = b.value();
+    }
+
+    vector3_soa_ref_t& operator=(const vector3_t<T>& b)
+    {
+        x = b.x;
+        y = b.y;
+        z = b.z;
+        return *this;
+    }
+
+    vector3_t<T> value() const
+    {
+        return vector3_t<T>::coord(x, y, z);
+    }
+
+    operator vector3_t<T>() const
+    {
+        return value();
+    }
+
+    friend bool operator==(const vector3_soa_ref_t& a, const vector3_t<T>& b) { return a.value() == b; }
+    friend bool operator==(const vector3_t<T>& a, const vector3_soa_ref_t& b) { return a == b.value(); }
+    friend bool operator!=(const vector3_soa_ref_t& a, const vector3_t<T>& b) { return a.value() != b; }
+    friend bool operator!=(const vector3_t<T>& a, const vector3_soa_ref_t& b) { return a != b.value(); }
+
+    vector3_soa_ref_t& operator+=(const vector3_t<T>& b) { return *this = value() + b; }
+    vector3_soa_ref_t& operator-=(const vector3_t<T>& b) { return *this = value() - b; }
+    vector3_soa_ref_t& operator*=(const T& s) { return *this = value() * s; }
+    vector3_soa_ref_t& operator/=(const T& s) { return *this = value() / s; }
+
+    T length_sq() const { return value().length_sq(); }
+    T length() const { return value().length(); }
+
+    T normalize()
+    {
+        auto v = value();
+        auto l = v.normalize();
+        *this = v;
+        return l;
+    }
+};
+
+template <typename T>
+class vector4_soa_ref_t
+{
+public:
+    T& x;
+    T& y;
+    T& z;
+    T& w;
+
+    typedef T value_type;
+
+    vector4_soa_ref_t(T& x, T& y, T& z, T& w)
+        : x(x), y(y), z(z), w(w)
+    {}
+
+    vector4_soa_ref_t(const vector4_soa_ref_t&) = default;
+
+    vector4_soa_ref_t& operator=(const vector4_soa_ref_t& b)
+    {
+        return *this = b.value();
+    }
+
+    vector4_soa_ref_t& operator=(const vector4_t<T>& b)
+    {
+        x = b.x;
+        y = b.y;
+        z = b.z;
+        w = b.w;
+        return *this;
+    }
+
+    vector4_t<T> value() const
+    {
+        return vector4_t<T>::coord(x, y, z, w);
+    }
+
+    operator vector4_t<T>() const
+    {
+        return value();
+    }
+
+    friend bool operator==(const vector4_soa_ref_t& a, const vector4_t<T>& b) { return a.value() == b; }
+    friend bool operator==(const vector4_t<T>& a, const vector4_soa_ref_t& b) { return a == b.value(); }
+    friend bool operator!=(const vector4_soa_ref_t& a, const vector4_t<T>& b) { return a.value() != b; }
+    friend bool operator!=(const vector4_t<T>& a, const vector4_soa_ref_t& b) { return a != b.value(); }
+
+    vector4_soa_ref_t& operator+=(const vector4_t<T>& b) { return *this = value() + b; }
+    vector4_soa_ref_t& operator-=(const vector4_t<T>& b) { return *this = value() - b; }
+    vector4_soa_ref_t& operator*=(const T& s) { return *this = value() * s; }
+    vector4_soa_ref_t& operator/=(const T& s) { return *this = value() / s; }
+
+    T length_sq() const { return value().length_sq(); }
+    T length() const { return value().length(); }
+
+    T normalize()
+    {
+        auto v = value();
+        auto l = v.normalize();
+        *this = v;
+        return l;
+    }
+};
+
+template <typename T>
+class quaternion_soa_ref_t
+{
+public:
+    T& x;
+    T& y;
+    T& z;
+    T& w;
+
+    typedef T value_type;
+
+    quaternion_soa_ref_t(T& x, T& y, T& z, T& w)
+        : x(x), y(y), z(z), w(w)
+    {}
+
+    quaternion_soa_ref_t(const quaternion_soa_ref_t&) = default;
+
+    quaternion_soa_ref_t& operator=(const quaternion_soa_ref_t& b)
+    {
+        return *this = b.value();
+    }
+
+    quaternion_soa_ref_t& operator=(const quaternion_t<T>& b)
+    {
+        x = b.x;
+        y = b.y;
+        z = b.z;
+        w = b.w;
+        return *this;
+    }
+
+    quaternion_t<T> value() const
+    {
+        return quaternion_t<T>::xyzw(x, y, z, w);
+    }
+
+    operator quaternion_t<T>() const
+    {
+        return value();
+    }
+
+    friend bool operator==(const quaternion_soa_ref_t& a, const quaternion_t<T>& b) { return a.value() == b; }
+    friend bool operator==(const quaternion_t<T>& a, const quaternion_soa_ref_t& b) { return a == b.value(); }
+    friend bool operator!=(const quaternion_soa_ref_t& a, const quaternion_t<T>& b) { return a.value() != b; }
+    friend bool operator!=(const quaternion_t<T>& a, const quaternion_soa_ref_t& b) { return a != b.value(); }
+
+    quaternion_soa_ref_t& operator*=(const quaternion_t<T>& b) { return *this = value() * b; }
+
+    T length_sq() const { return value().length_sq(); }
+    T length() const { return value().length(); }
+
+    T normalize()
+    {
+        auto q = value();
+        auto l = q.normalize();
+        *this = q;
+        return l;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// containers
+
+template <typename T>
+class vector3_soa_t : public internal::soa_streams<T, 3>
+{
+    typedef internal::soa_streams<T, 3> base;
+public:
+    typedef typename base::size_type size_type;
+    typedef vector3_soa_ref_t<T> reference;
+    typedef vector3_t<T> const_reference;
+
+    vector3_soa_t() = default;
+
+    explicit vector3_soa_t(size_type size)
+        : base(size)
+    {}
+
+    static vector3_soa_t from_array(const vector3_t<T>* ptr, size_type count)
+    {
+        vector3_soa_t ret;
+        ret.assign(ptr, count);
+        return ret;
+    }
+
+    T* x() { return this->stream(0); }
+    T* y() { return this->stream(1); }
+    T* z() { return this->stream(2); }
+    const T* x() const { return this->stream(0); }
+    const T* y() const { return this->stream(1); }
+    const T* z() const { return this->stream(2); }
+
+    reference at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::vector3_soa_t index overflow");
+        return reference(x()[i], y()[i], z()[i]);
+    }
+
+    const_reference at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::vector3_soa_t index overflow");
+        return vector3_t<T>::coord(x()[i], y()[i], z()[i]);
+    }
+
+    reference operator[](size_type i) { return at(i); }
+    const_reference operator[](size_type i) const { return at(i); }
+
+    void push_back(const vector3_t<T>& v)
+    {
+        const size_type i = this->grow();
+        at(i) = v;
+    }
+
+    // replaces the contents with count elements from ptr
+    void assign(const vector3_t<T>* ptr, size_type count)
+    {
+        this->resize(count);
+        T* sx = x();
+        T* sy = y();
+        T* sz = z();
+
+        typedef internal::pack<T> P;
+        const size_type packed = count - count % P::width;
+        size_type i = 0;
+        for (; i < packed; i += P::width)
+        {
+            P px, py, pz;
+            P::load3(ptr[i].data(), px, py, pz);
+            px.store(sx + i);
+            py.store(sy + i);
+            pz.store(sz + i);
+        }
+        for (; i < count; ++i)
+        {
+            sx[i] = ptr[i].x;
+            sy[i] = ptr[i].y;
+            sz[i] = ptr[i].z;
+        }
+    }
+
+    // writes size() elements to ptr
+    void copy_to(vector3_t<T>* ptr) const
+    {
+        const size_type count = this->size();
+        const T* sx = x();
+        const T* sy = y();
+        const T* sz = z();
+
+        typedef internal::pack<T> P;
+        const size_type packed = count - count % P::width;
+        size_type i = 0;
+        for (; i < packed; i += P::width)
+        {
+            P::store3(ptr[i].data(), P::load(sx + i), P::load(sy + i), P::load(sz + i));
+        }
+        for (; i < count; ++i)
+        {
+            ptr[i] = vector3_t<T>::coord(sx[i], sy[i], sz[i]);
+        }
+    }
+};
+
+template <typename T>
+class vector4_soa_t : public internal::soa_streams<T, 4>
+{
+    typedef internal::soa_streams<T, 4> base;
+public:
+    typedef typename base::size_type size_type;
+    typedef vector4_soa_ref_t<T> reference;
+    typedef vector4_t<T> const_reference;
+
+    vector4_soa_t() = default;
+
+    explicit vector4_soa_t(size_type size)
+        : base(size)
+    {}
+
+    static vector4_soa_t from_array(const vector4_t<T>* ptr, size_type count)
+    {
+        vector4_soa_t ret;
+        ret.assign(ptr, count);
+        return ret;
+    }
+
+    T* x() { return this->stream(0); }
+    T* y() { return this->stream(1); }
+    T* z() { return this->stream(2); }
+    T* w() { return this->stream(3); }
+    const T* x() const { return this->stream(0); }
+    const T* y() const { return this->stream(1); }
+    const T* z() const { return this->stream(2); }
+    const T* w() const { return this->stream(3); }
+
+    reference at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::vector4_soa_t index overflow");
+        return reference(x()[i], y()[i], z()[i], w()[i]);
+    }
+
+    const_reference at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::vector4_soa_t index overflow");
+        return vector4_t<T>::coord(x()[i], y()[i], z()[i], w()[i]);
+    }
+
+    reference operator[](size_type i) { return at(i); }
+    const_reference operator[](size_type i) const { return at(i); }
+
+    void push_back(const vector4_t<T>& v)
+    {
+        const size_type i = this->grow();
+        at(i) = v;
+    }
+
+    void assign(const vector4_t<T>* ptr, size_type count)
+    {
+        this->resize(count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            at(i) = ptr[i];
+        }
+    }
+
+    void copy_to(vector4_t<T>* ptr) const
+    {
+        for (size_type i = 0; i < this->size(); ++i)
+        {
+            ptr[i] = at(i);
+        }
+    }
+};
+
+template <typename T>
+class quaternion_soa_t : public internal::soa_streams<T, 4>
+{
+    typedef internal::soa_streams<T, 4> base;
+public:
+    typedef typename base::size_type size_type;
+    typedef quaternion_soa_ref_t<T> reference;
+    typedef quaternion_t<T> const_reference;
+
+    quaternion_soa_t() = default;
+
+    explicit quaternion_soa_t(size_type size)
+        : base(size)
+    {}
+
+    static quaternion_soa_t from_array(const quaternion_t<T>* ptr, size_type count)
+    {
+        quaternion_soa_t ret;
+        ret.assign(ptr, count);
+        return ret;
+    }
+
+    T* x() { return this->stream(0); }
+    T* y() { return this->stream(1); }
+    T* z() { return this->stream(2); }
+    T* w() { return this->stream(3); }
+    const T* x() const { return this->stream(0); }
+    const T* y() const { return this->stream(1); }
+    const T* z() const { return this->stream(2); }
+    const T* w() const { return this->stream(3); }
+
+    reference at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::quaternion_soa_t index overflow");
+        return reference(x()[i], y()[i], z()[i], w()[i]);
+    }
+
+    const_reference at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT(i < this->size(), "yama::quaternion_soa_t index overflow");
+        return quaternion_t<T>::xyzw(x()[i], y()[i], z()[i], w()[i]);
+    }
+
+    reference operator[](size_type i) { return at(i); }
+    const_reference operator[](size_type i) const { return at(i); }
+
+    void push_back(const quaternion_t<T>& q)
+    {
+        const size_type i = this->grow();
+        at(i) = q;
+    }
+
+    void assign(const quaternion_t<T>* ptr, size_type count)
+    {
+        this->resize(count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            at(i) = ptr[i];
+        }
+    }
+
+    void copy_to(quaternion_t<T>* ptr) const
+    {
+        for (size_type i = 0; i < this->size(); ++i)
+        {
+            ptr[i] = at(i);
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// kernels
+
+namespace internal
+{
+
+// Counts of containers are padded to a whole number of packs, so they need no tail.
+template <typename T, typename Kernel>
+void run_padded_soa_kernel(const Kernel& k, size_t padded_count)
+{
+    typedef pack<T> P;
+    static_assert(soa_streams<T, 1>::lane_padding % P::width == 0, "yama soa padding must be a multiple of the pack width");
+    for (size_t i = 0; i < padded_count; i += P::width)
+    {
+        k.template run<P>(i);
+    }
+}
+
+// Bitmask results have one bit per element: bit i % 32 of word i / 32.
+// Packs never straddle mask words, as their width divides 32.
+inline void store_mask(uint32_t* out, size_t i, unsigned bits)
+{
+    out[i / 32] |= uint32_t(bits) << (i % 32);
+}
+
+// Clears the output, runs the kernel over the padded elements and clears the bits of the padding.
+// out must have room for (size + 31) / 32 words.
+template <typename T, typename Kernel>
+void run_mask_kernel(const Kernel& k, size_t size, size_t padded_size, uint32_t* out)
+{
+    const size_t words = (size + 31) / 32;
+    std::memset(out, 0, words * sizeof(uint32_t));
+    run_padded_soa_kernel<T>(k, padded_size);
+    if (size % 32)
+    {
+        out[words - 1] &= (uint32_t(1) << (size % 32)) - 1;
+    }
+}
+
+#if YAMA_THREADS
+
+// elements per chunk boundary of the parallel overloads, a multiple of the
+// padding and of the mask words
+const size_t soa_granularity = 1024;
+
+template <typename T, typename Kernel>
+void run_padded_soa_kernel(parallel::thread_pool& pool, const Kernel& k, size_t padded_count)
+{
+    parallel::for_each_chunk(pool, padded_count, soa_granularity, [&k](size_t first, size_t n) {
+        typedef pack<T> P;
+        for (size_t i = first; i < first + n; i += P::width)
+        {
+            k.template run<P>(i);
+        }
+    });
+}
+
+template <typename T, typename Kernel>
+void run_mask_kernel(parallel::thread_pool& pool, const Kernel& k, size_t size, size_t padded_size, uint32_t* out)
+{
+    const size_t words = (size + 31) / 32;
+    std::memset(out, 0, words * sizeof(uint32_t));
+    run_padded_soa_kernel<T>(pool, k, padded_size);
+    if (size % 32)
+    {
+        out[words - 1] &= (uint32_t(1) << (size % 32)) - 1;
+    }
+}
+
+#endif
+
+template <typename T, size_t N>
+struct soa_in
+{
+    const T* s[N];
+
+    explicit soa_in(const soa_streams<T, N>& c)
+    {
+        for (size_t i = 0; i < N; ++i) s[i] = c.stream(i);
+    }
+};
+
+template <typename T, size_t N>
+struct soa_out
+{
+    T* s[N];
+
+    // resizes c to size elements first
+    soa_out(soa_streams<T, N>& c, size_t size)
+    {
+        c.resize(size);
+        for (size_t i = 0; i < N; ++i) s[i] = c.stream(i);
+    }
+};
+
+template <typename T, size_t N>
+struct soa_dot_kernel
+{
+    soa_in<T, N> a, b;
+    T* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P d = P::load(a.s[0] + i) * P::load(b.s[0] + i);
+        for (size_t c = 1; c < N; ++c)
+        {
+            d = madd(P::load(a.s[c] + i), P::load(b.s[c] + i), d);
+        }
+        d.store(out + i);
+    }
+};
+
+template <typename T>
+struct soa_cross_kernel
+{
+    soa_in<T, 3> a, b;
+    soa_out<T, 3> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        const P ax = P::load(a.s[0] + i), ay = P::load(a.s[1] + i), az = P::load(a.s[2] + i);
+        const P bx = P::load(b.s[0] + i), by = P::load(b.s[1] + i), bz = P::load(b.s[2] + i);
+        (ay * bz - az * by).store(out.s[0] + i);
+        (az * bx - ax * bz).store(out.s[1] + i);
+        (ax * by - ay * bx).store(out.s[2] + i);
+    }
+};
+
+// with Fast the vectors are scaled by rsqrt of the squared length
+template <typename T, size_t N, bool Fast>
+struct soa_normalize_kernel
+{
+    soa_in<T, N> a;
+    soa_out<T, N> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P v[N];
+        for (size_t c = 0; c < N; ++c) v[c] = P::load(a.s[c] + i);
+        P l = v[0] * v[0];
+        for (size_t c = 1; c < N; ++c) l = madd(v[c], v[c], l);
+        if (Fast)
+        {
+            l = rsqrt(l);
+            for (size_t c = 0; c < N; ++c) (v[c] * l).store(out.s[c] + i);
+        }
+        else
+        {
+            l = sqrt(l);
+            for (size_t c = 0; c < N; ++c) (v[c] / l).store(out.s[c] + i);
+        }
+    }
+};
+
+template <typename T, size_t N>
+struct soa_rsqrt_length_kernel
+{
+    soa_in<T, N> a;
+    T* out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P l = P::load(a.s[0] + i) * P::load(a.s[0] + i);
+        for (size_t c = 1; c < N; ++c)
+        {
+            const P v = P::load(a.s[c] + i);
+            l = madd(v, v, l);
+        }
+        rsqrt(l).store(out + i);
+    }
+};
+
+// with Normalize the result is normalized as in lerp for quaternions
+template <typename T, size_t N, bool Normalize>
+struct soa_lerp_kernel
+{
+    soa_in<T, N> a, b;
+    T ratio;
+    soa_out<T, N> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        const P t = P::uniform(ratio);
+        P v[N];
+        for (size_t c = 0; c < N; ++c)
+        {
+            const P from = P::load(a.s[c] + i);
+            v[c] = madd(t, P::load(b.s[c] + i) - from, from);
+        }
+        if (Normalize)
+        {
+            P l = v[0] * v[0];
+            for (size_t c = 1; c < N; ++c) l = madd(v[c], v[c], l);
+            l = sqrt(l);
+            for (size_t c = 0; c < N; ++c) v[c] = v[c] / l;
+        }
+        for (size_t c = 0; c < N; ++c) v[c].store(out.s[c] + i);
+    }
+};
+
+template <typename T, size_t N, bool Max>
+struct soa_minmax_kernel
+{
+    soa_in<T, N> a, b;
+    soa_out<T, N> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        for (size_t c = 0; c < N; ++c)
+        {
+            const P pa = P::load(a.s[c] + i), pb = P::load(b.s[c] + i);
+            (Max ? vmax(pa, pb) : vmin(pa, pb)).store(out.s[c] + i);
+        }
+    }
+};
+
+// applies one of the batch.hpp vector3 kernels
+template <typename T, template <typename, typename> class Kernel>
+struct soa_vector3_kernel
+{
+    Kernel<pack<T>, T> k;
+    soa_in<T, 3> a;
+    soa_out<T, 3> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P x = P::load(a.s[0] + i), y = P::load(a.s[1] + i), z = P::load(a.s[2] + i);
+        k(x, y, z);
+        x.store(out.s[0] + i);
+        y.store(out.s[1] + i);
+        z.store(out.s[2] + i);
+    }
+};
+
+template <typename P, size_t N>
+void soa_load(const soa_in<typename P::value_type, N>& a, size_t i, P* v)
+{
+    for (size_t c = 0; c < N; ++c) v[c] = P::load(a.s[c] + i);
+}
+
+template <typename P, size_t N>
+void soa_store(const soa_out<typename P::value_type, N>& out, size_t i, const P* v)
+{
+    for (size_t c = 0; c < N; ++c) v[c].store(out.s[c] + i);
+}
+
+template <typename T>
+struct soa_quaternion_multiply_kernel
+{
+    soa_in<T, 4> a, b;
+    soa_out<T, 4> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P qa[4], qb[4];
+        soa_load(a, i, qa);
+        soa_load(b, i, qb);
+        quaternion_multiply(qa, qb, qa);
+        soa_store(out, i, qa);
+    }
+};
+
+template <typename T>
+struct soa_quaternion_rotate_kernel
+{
+    soa_in<T, 3> v;
+    soa_in<T, 4> q;
+    soa_out<T, 3> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P pv[3], pq[4];
+        soa_load(v, i, pv);
+        soa_load(q, i, pq);
+        quaternion_rotate(pq, pv[0], pv[1], pv[2]);
+        soa_store(out, i, pv);
+    }
+};
+
+// Fast selects quaternion_fast_slerp over quaternion_nlerp
+template <typename T, bool Fast>
+struct soa_quaternion_interpolate_kernel
+{
+    soa_in<T, 4> a, b;
+    T ratio;
+    soa_out<T, 4> out;
+
+    template <typename P>
+    void run(size_t i) const
+    {
+        P qa[4], qb[4];
+        soa_load(a, i, qa);
+        soa_load(b, i, qb);
+        if (Fast) quaternion_fast_slerp(qa, qb, P::uniform(ratio), qa);
+        else quaternion_nlerp(qa, qb, P::uniform(ratio), qa);
+        soa_store(out, i, qa);
+    }
+};
+
+template <typename T, size_t N>
+void soa_dot(const soa_streams<T, N>& a, const soa_streams<T, N>& b, T* out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const soa_dot_kernel<T, N> k = { soa_in<T, N>(a), soa_in<T, N>(b), out };
+    run_kernel<T>(k, a.size());
+}
+
+template <bool Fast, typename T, size_t N>
+void soa_normalize(const soa_streams<T, N>& a, soa_streams<T, N>& out)
+{
+    const soa_normalize_kernel<T, N, Fast> k = { soa_in<T, N>(a), soa_out<T, N>(out, a.size()) };
+    run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+template <typename T, size_t N>
+void soa_rsqrt_length(const soa_streams<T, N>& a, T* out)
+{
+    const soa_rsqrt_length_kernel<T, N> k = { soa_in<T, N>(a), out };
+    run_kernel<T>(k, a.size());
+}
+
+template <bool Normalize, typename T, size_t N>
+void soa_lerp(const soa_streams<T, N>& a, const soa_streams<T, N>& b, T ratio, soa_streams<T, N>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const soa_lerp_kernel<T, N, Normalize> k = { soa_in<T, N>(a), soa_in<T, N>(b), ratio, soa_out<T, N>(out, a.size()) };
+    run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+template <bool Max, typename T, size_t N>
+void soa_minmax(const soa_streams<T, N>& a, const soa_streams<T, N>& b, soa_streams<T, N>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const soa_minmax_kernel<T, N, Max> k = { soa_in<T, N>(a), soa_in<T, N>(b), soa_out<T, N>(out, a.size()) };
+    run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+template <template <typename, typename> class Kernel, typename T>
+void soa_transform(const T* m, const vector3_soa_t<T>& a, vector3_soa_t<T>& out)
+{
+    const soa_vector3_kernel<T, Kernel> k = { Kernel<pack<T>, T>(m), soa_in<T, 3>(a), soa_out<T, 3>(out, a.size()) };
+    run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+}
+
+// The functions below are the element-wise equivalents of the corresponding
+// functions for single values. The output container is resized to the size
+// of the input and may be one of the inputs.
+
+///////////////////////////////////////////////////////////////////////////////
+// vector3_soa_t
+
+// out must have room for a.size() values
+template <typename T>
+void dot(const vector3_soa_t<T>& a, const vector3_soa_t<T>& b, T* out)
+{
+    internal::soa_dot(a, b, out);
+}
+
+template <typename T>
+void cross(const vector3_soa_t<T>& a, const vector3_soa_t<T>& b, vector3_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const internal::soa_cross_kernel<T> k = { internal::soa_in<T, 3>(a), internal::soa_in<T, 3>(b), internal::soa_out<T, 3>(out, a.size()) };
+    internal::run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+// zero-length vectors produce non-finite values
+template <typename T>
+void normalize(const vector3_soa_t<T>& a, vector3_soa_t<T>& out)
+{
+    internal::soa_normalize<false>(a, out);
+}
+
+// see internal::rsqrt for the precision, zero-length vectors stay zero
+template <typename T>
+void fast_normalize(const vector3_soa_t<T>& a, vector3_soa_t<T>& out)
+{
+    internal::soa_normalize<true>(a, out);
+}
+
+// out must have room for a.size() values
+template <typename T>
+void rsqrt_length(const vector3_soa_t<T>& a, T* out)
+{
+    internal::soa_rsqrt_length(a, out);
+}
+
+template <typename T>
+void lerp(const vector3_soa_t<T>& from, const vector3_soa_t<T>& to, const T& ratio, vector3_soa_t<T>& out)
+{
+    internal::soa_lerp<false>(from, to, ratio, out);
+}
+
+#if !defined(min)
+template <typename T>
+void min(const vector3_soa_t<T>& a, const vector3_soa_t<T>& b, vector3_soa_t<T>& out)
+{
+    internal::soa_minmax<false>(a, b, out);
+}
+#endif
+
+#if !defined(max)
+template <typename T>
+void max(const vector3_soa_t<T>& a, const vector3_soa_t<T>& b, vector3_soa_t<T>& out)
+{
+    internal::soa_minmax<true>(a, b, out);
+}
+#endif
+
+template <typename T>
+void transform_coords(const matrix3x4_t<T>& m, const vector3_soa_t<T>& in, vector3_soa_t<T>& out)
+{
+    T r[12];
+    internal::rows3x4(m, r);
+    internal::soa_transform<internal::affine3_kernel>(r, in, out);
+}
+
+template <typename T>
+void transform_coords(const matrix4x4_t<T>& m, const vector3_soa_t<T>& in, vector3_soa_t<T>& out)
+{
+    T r[16];
+    internal::rows4x4(m, r);
+
+    if (m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1)
+    {
+        internal::soa_transform<internal::affine3_kernel>(r, in, out);
+    }
+    else
+    {
+        internal::soa_transform<internal::projective3_kernel>(r, in, out);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// vector4_soa_t
+
+template <typename T>
+void dot(const vector4_soa_t<T>& a, const vector4_soa_t<T>& b, T* out)
+{
+    internal::soa_dot(a, b, out);
+}
+
+template <typename T>
+void normalize(const vector4_soa_t<T>& a, vector4_soa_t<T>& out)
+{
+    internal::soa_normalize<false>(a, out);
+}
+
+// see internal::rsqrt for the precision, zero-length vectors stay zero
+template <typename T>
+void fast_normalize(const vector4_soa_t<T>& a, vector4_soa_t<T>& out)
+{
+    internal::soa_normalize<true>(a, out);
+}
+
+// out must have room for a.size() values
+template <typename T>
+void rsqrt_length(const vector4_soa_t<T>& a, T* out)
+{
+    internal::soa_rsqrt_length(a, out);
+}
+
+template <typename T>
+void lerp(const vector4_soa_t<T>& from, const vector4_soa_t<T>& to, const T& ratio, vector4_soa_t<T>& out)
+{
+    internal::soa_lerp<false>(from, to, ratio, out);
+}
+
+#if !defined(min)
+template <typename T>
+void min(const vector4_soa_t<T>& a, const vector4_soa_t<T>& b, vector4_soa_t<T>& out)
+{
+    internal::soa_minmax<false>(a, b, out);
+}
+#endif
+
+#if !defined(max)
+template <typename T>
+void max(const vector4_soa_t<T>& a, const vector4_soa_t<T>& b, vector4_soa_t<T>& out)
+{
+    internal::soa_minmax<true>(a, b, out);
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// quaternion_soa_t
+
+template <typename T>
+void dot(const quaternion_soa_t<T>& a, const quaternion_soa_t<T>& b, T* out)
+{
+    internal::soa_dot(a, b, out);
+}
+
+template <typename T>
+void normalize(const quaternion_soa_t<T>& a, quaternion_soa_t<T>& out)
+{
+    internal::soa_normalize<false>(a, out);
+}
+
+// see internal::rsqrt for the precision, zero-length quaternions stay zero
+template <typename T>
+void fast_normalize(const quaternion_soa_t<T>& a, quaternion_soa_t<T>& out)
+{
+    internal::soa_normalize<true>(a, out);
+}
+
+// out must have room for a.size() values
+template <typename T>
+void rsqrt_length(const quaternion_soa_t<T>& a, T* out)
+{
+    internal::soa_rsqrt_length(a, out);
+}
+
+// normalized, as lerp for quaternion_t
+template <typename T>
+void lerp(const quaternion_soa_t<T>& from, const quaternion_soa_t<T>& to, const T& ratio, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t lerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t lerp is defined between 0 and 1 ");
+    internal::soa_lerp<true>(from, to, ratio, out);
+}
+
+template <typename T>
+void nlerp(const quaternion_soa_t<T>& from, const quaternion_soa_t<T>& to, const T& ratio, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    YAMA_ASSERT_CRIT(from.size() == to.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_interpolate_kernel<T, false> k = { internal::soa_in<T, 4>(from), internal::soa_in<T, 4>(to), ratio, internal::soa_out<T, 4>(out, from.size()) };
+    internal::run_padded_soa_kernel<T>(k, from.padded_size());
+}
+
+template <typename T>
+void fast_slerp(const quaternion_soa_t<T>& from, const quaternion_soa_t<T>& to, const T& ratio, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    YAMA_ASSERT_CRIT(from.size() == to.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_interpolate_kernel<T, true> k = { internal::soa_in<T, 4>(from), internal::soa_in<T, 4>(to), ratio, internal::soa_out<T, 4>(out, from.size()) };
+    internal::run_padded_soa_kernel<T>(k, from.padded_size());
+}
+
+template <typename T>
+void multiply(const quaternion_soa_t<T>& a, const quaternion_soa_t<T>& b, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_multiply_kernel<T> k = { internal::soa_in<T, 4>(a), internal::soa_in<T, 4>(b), internal::soa_out<T, 4>(out, a.size()) };
+    internal::run_padded_soa_kernel<T>(k, a.padded_size());
+}
+
+// out[i] = rotate(v[i], q[i])
+template <typename T>
+void rotate(const vector3_soa_t<T>& v, const quaternion_soa_t<T>& q, vector3_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(v.size() == q.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_rotate_kernel<T> k = { internal::soa_in<T, 3>(v), internal::soa_in<T, 4>(q), internal::soa_out<T, 3>(out, v.size()) };
+    internal::run_padded_soa_kernel<T>(k, v.padded_size());
+}
+
+// the same as rotate(v, q) for every element
+template <typename T>
+void rotate(const quaternion_t<T>& q, const vector3_soa_t<T>& in, vector3_soa_t<T>& out)
+{
+    YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+    internal::soa_transform<internal::rotate3_kernel>(q.data(), in, out);
+}
+
+#if YAMA_THREADS
+
+///////////////////////////////////////////////////////////////////////////////
+// parallel overloads
+// The same as the functions above with the elements split between the
+// threads of pool. The output is resized before the threads start.
+
+namespace internal
+{
+
+template <template <typename, typename> class Kernel, typename T>
+void soa_transform(parallel::thread_pool& pool, const T* m, const vector3_soa_t<T>& a, vector3_soa_t<T>& out)
+{
+    const soa_vector3_kernel<T, Kernel> k = { Kernel<pack<T>, T>(m), soa_in<T, 3>(a), soa_out<T, 3>(out, a.size()) };
+    run_padded_soa_kernel<T>(pool, k, a.padded_size());
+}
+
+template <bool Fast, typename T, size_t N>
+void soa_normalize(parallel::thread_pool& pool, const soa_streams<T, N>& a, soa_streams<T, N>& out)
+{
+    const soa_normalize_kernel<T, N, Fast> k = { soa_in<T, N>(a), soa_out<T, N>(out, a.size()) };
+    run_padded_soa_kernel<T>(pool, k, a.padded_size());
+}
+
+}
+
+template <typename T>
+void transform_coords(parallel::thread_pool& pool, const matrix3x4_t<T>& m, const vector3_soa_t<T>& in, vector3_soa_t<T>& out)
+{
+    T r[12];
+    internal::rows3x4(m, r);
+    internal::soa_transform<internal::affine3_kernel>(pool, r, in, out);
+}
+
+template <typename T>
+void transform_coords(parallel::thread_pool& pool, const matrix4x4_t<T>& m, const vector3_soa_t<T>& in, vector3_soa_t<T>& out)
+{
+    T r[16];
+    internal::rows4x4(m, r);
+
+    if (m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1)
+    {
+        internal::soa_transform<internal::affine3_kernel>(pool, r, in, out);
+    }
+    else
+    {
+        internal::soa_transform<internal::projective3_kernel>(pool, r, in, out);
+    }
+}
+
+template <typename T>
+void rotate(parallel::thread_pool& pool, const quaternion_t<T>& q, const vector3_soa_t<T>& in, vector3_soa_t<T>& out)
+{
+    YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+    internal::soa_transform<internal::rotate3_kernel>(pool, q.data(), in, out);
+}
+
+template <typename T>
+void rotate(parallel::thread_pool& pool, const vector3_soa_t<T>& v, const quaternion_soa_t<T>& q, vector3_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(v.size() == q.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_rotate_kernel<T> k = { internal::soa_in<T, 3>(v), internal::soa_in<T, 4>(q), internal::soa_out<T, 3>(out, v.size()) };
+    internal::run_padded_soa_kernel<T>(pool, k, v.padded_size());
+}
+
+template <typename T>
+void normalize(parallel::thread_pool& pool, const vector3_soa_t<T>& a, vector3_soa_t<T>& out)
+{
+    internal::soa_normalize<false>(pool, a, out);
+}
+
+template <typename T>
+void fast_normalize(parallel::thread_pool& pool, const vector3_soa_t<T>& a, vector3_soa_t<T>& out)
+{
+    internal::soa_normalize<true>(pool, a, out);
+}
+
+template <typename T>
+void normalize(parallel::thread_pool& pool, const vector4_soa_t<T>& a, vector4_soa_t<T>& out)
+{
+    internal::soa_normalize<false>(pool, a, out);
+}
+
+template <typename T>
+void fast_normalize(parallel::thread_pool& pool, const vector4_soa_t<T>& a, vector4_soa_t<T>& out)
+{
+    internal::soa_normalize<true>(pool, a, out);
+}
+
+template <typename T>
+void normalize(parallel::thread_pool& pool, const quaternion_soa_t<T>& a, quaternion_soa_t<T>& out)
+{
+    internal::soa_normalize<false>(pool, a, out);
+}
+
+template <typename T>
+void fast_normalize(parallel::thread_pool& pool, const quaternion_soa_t<T>& a, quaternion_soa_t<T>& out)
+{
+    internal::soa_normalize<true>(pool, a, out);
+}
+
+template <typename T>
+void nlerp(parallel::thread_pool& pool, const quaternion_soa_t<T>& from, const quaternion_soa_t<T>& to, const T& ratio, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t nlerp is defined between 0 and 1 ");
+    YAMA_ASSERT_CRIT(from.size() == to.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_interpolate_kernel<T, false> k = { internal::soa_in<T, 4>(from), internal::soa_in<T, 4>(to), ratio, internal::soa_out<T, 4>(out, from.size()) };
+    internal::run_padded_soa_kernel<T>(pool, k, from.padded_size());
+}
+
+template <typename T>
+void fast_slerp(parallel::thread_pool& pool, const quaternion_soa_t<T>& from, const quaternion_soa_t<T>& to, const T& ratio, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_WARN(ratio >= 0, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    YAMA_ASSERT_WARN(ratio <= 1, "yama::quaternion_t slerp is defined between 0 and 1 ");
+    YAMA_ASSERT_CRIT(from.size() == to.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_interpolate_kernel<T, true> k = { internal::soa_in<T, 4>(from), internal::soa_in<T, 4>(to), ratio, internal::soa_out<T, 4>(out, from.size()) };
+    internal::run_padded_soa_kernel<T>(pool, k, from.padded_size());
+}
+
+template <typename T>
+void multiply(parallel::thread_pool& pool, const quaternion_soa_t<T>& a, const quaternion_soa_t<T>& b, quaternion_soa_t<T>& out)
+{
+    YAMA_ASSERT_CRIT(a.size() == b.size(), "yama soa containers of different size");
+    const internal::soa_quaternion_multiply_kernel<T> k = { internal::soa_in<T, 4>(a), internal::soa_in<T, 4>(b), internal::soa_out<T, 4>(out, a.size()) };
+    internal::run_padded_soa_kernel<T>(pool, k, a.padded_size());
+}
+
+#endif
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef vector3_soa_t<preferred_type> vector3_soa;
+typedef vector4_soa_t<preferred_type> vector4_soa;
+typedef quaternion_soa_t<preferred_type> quaternion_soa;
+
+#endif
+
+}
@@ -0,0 +1,170 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Strided views
+// strided_span<E> views count elements of type E which are stride bytes apart,
+// like the positions in an interleaved vertex buffer. It doesn't own them and
+// copying it copies only the view. strided_span<const E> is the read-only form,
+// and a strided_span<E> converts to it.
+//
+// The batch functions take views for their inputs and outputs. When the
+// stride equals sizeof(E) the elements are contiguous and they take the same
+// path as for plain arrays.
+
+#include "assert.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+
+namespace yama
+{
+
+template <typename E>
+class strided_span
+{
+public:
+    typedef E element_type;
+    typedef typename std::remove_cv<E>::type value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef E& reference;
+    typedef E* pointer;
+
+    ////////////////////////////////////////////////////////
+    // iterators
+
+    class iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename strided_span::value_type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef E* pointer;
+        typedef E& reference;
+
+        iterator() : m_ptr(nullptr), m_stride(0) {}
+        iterator(E* ptr, size_type stride) : m_ptr(ptr), m_stride(difference_type(stride)) {}
+
+        reference operator*() const { return *m_ptr; }
+        pointer operator->() const { return m_ptr; }
+        reference operator[](difference_type n) const { return *offset(n); }
+
+        iterator& operator++() { m_ptr = offset(1); return *this; }
+        iterator& operator--() { m_ptr = offset(-1); return *this; }
+        iterator operator++(int) { iterator r = *this; ++*this; return r; }
+        iterator operator--(int) { iterator r = *this; --*this; return r; }
+        iterator& operator+=(difference_type n) { m_ptr = offset(n); return *this; }
+        iterator& operator-=(difference_type n) { m_ptr = offset(-n); return *this; }
+
+        friend iterator operator+(iterator a, difference_type n) { return a += n; }
+        friend iterator operator+(difference_type n, iterator a) { return a += n; }
+        friend iterator operator-(iterator a, difference_type n) { return a -= n; }
+        // value-initialized iterators have no stride and are all equal
+        friend difference_type operator-(const iterator& a, const iterator& b)
+        {
+            if (!a.m_stride) return 0;
+            return (reinterpret_cast<const char*>(a.m_ptr) - reinterpret_cast<const char*>(b.m_ptr)) / a.m_stride;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_ptr == b.m_ptr; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return a.m_ptr != b.m_ptr; }
+        friend bool operator<(const iterator& a, const iterator& b) { return std::less<const E*>()(a.m_ptr, b.m_ptr); }
+        friend bool operator>(const iterator& a, const iterator& b) { return b < a; }
+        friend bool operator<=(const iterator& a, const iterator& b) { return !(b < a); }
+        friend bool operator>=(const iterator& a, const iterator& b) { return !(a < b); }
+
+    private:
+        E* offset(difference_type n) const { return reinterpret_cast<E*>(byte_ptr(m_ptr) + n * m_stride); }
+
+        E* m_ptr;
+        difference_type m_stride;
+    };
+
+    typedef iterator const_iterator;
+
+    ////////////////////////////////////////////////////////
+    // named constructors
+
+    // count elements, the first one at ptr and each next one stride bytes after the previous
+    static strided_span from_ptr(E* ptr, size_type stride, size_type count)
+    {
+        YAMA_ASSERT_WARN(ptr || !count, "yama::strided_span of nullptr");
+        YAMA_ASSERT_CRIT(stride != 0, "yama::strided_span with a zero stride");
+        YAMA_ASSERT_CRIT(stride % alignof(E) == 0, "yama::strided_span stride breaks the alignment of the elements");
+        return strided_span(ptr, stride, count);
+    }
+
+    // a contiguous array
+    static strided_span from_array(E* ptr, size_type count)
+    {
+        return from_ptr(ptr, sizeof(E), count);
+    }
+
+    strided_span() : m_data(nullptr), m_stride(sizeof(E)), m_size(0) {}
+
+    // strided_span<E> to strided_span<const E>
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, E*>::value && sizeof(U) == sizeof(E)>::type>
+    strided_span(const strided_span<U>& s)
+        : m_data(s.data()), m_stride(s.stride()), m_size(s.size())
+    {}
+
+    ////////////////////////////////////////////////////////
+    // access
+
+    E* data() const { return m_data; }
+    size_type stride() const { return m_stride; }
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // true if the elements are next to each other, like in an array
+    bool contiguous() const { return m_stride == sizeof(E); }
+
+    reference operator[](size_type i) const
+    {
+        YAMA_ASSERT_CRIT(i < m_size, "yama::strided_span index overflow");
+        return *reinterpret_cast<E*>(byte_ptr(m_data) + i * m_stride);
+    }
+
+    reference front() const { return (*this)[0]; }
+    reference back() const { return (*this)[m_size - 1]; }
+
+    iterator begin() const { return iterator(m_data, m_stride); }
+    iterator end() const { return begin() + difference_type(m_size); }
+
+    // count elements from first
+    strided_span subspan(size_type first, size_type count) const
+    {
+        YAMA_ASSERT_CRIT(first + count <= m_size, "yama::strided_span subspan overflow");
+        return strided_span(count ? &(*this)[first] : m_data, m_stride, count);
+    }
+
+private:
+    strided_span(E* data, size_type stride, size_type size)
+        : m_data(data), m_stride(stride), m_size(size)
+    {}
+
+    typedef typename std::conditional<std::is_const<E>::value, const char, char>::type byte;
+
+    static byte* byte_ptr(E* ptr) { return reinterpret_cast<byte*>(ptr); }
+
+    E* m_data;
+    size_type m_stride;
+    size_type m_size;
+};
+
+// the same as strided_span<E>::from_ptr
+template <typename E>
+strided_span<E> make_strided_span(E* ptr, size_t stride, size_t count)
+{
+    return strided_span<E>::from_ptr(ptr, stride, count);
+}
+
+}
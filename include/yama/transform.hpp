@@ -0,0 +1,417 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Transformations as translation, rotation and scale (TRS)
+// A point v is scaled by `scale` first, then rotated by `orientation` and
+// finally translated by `position`. This is the same as the matrix
+// translation(position) * rotation_quaternion(orientation) * scaling(scale).
+// Like with matrices a*b applies b first and then a.
+//
+// A product of TRS transformations is not always a TRS transformation:
+// composition and inversion are exact when the scale of the left (parent)
+// transformation is uniform, which is the common case for scene graphs.
+// Otherwise the shear is lost.
+//
+// decompose splits a matrix back into a transformation. When the matrix has
+// shear, which a transformation can't represent, the rotation is the closest
+// one (from the polar decomposition) and the scale is the best fit for it.
+
+#include "quaternion.hpp"
+#include "matrix3x3.hpp"
+#include "matrix3x4.hpp"
+#include "matrix4x4.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace yama
+{
+
+namespace internal
+{
+
+// rotate(v, q) for a unit quaternion as v + w*t + q x t, where t = 2 * q x v
+// fewer multiplications than rotate, which matters in composition
+template <typename T>
+vector3_t<T> rotate_unit(const vector3_t<T>& v, const quaternion_t<T>& q)
+{
+    const auto t = vector3_t<T>::coord(
+        2 * (q.y*v.z - q.z*v.y),
+        2 * (q.z*v.x - q.x*v.z),
+        2 * (q.x*v.y - q.y*v.x)
+    );
+    return vector3_t<T>::coord(
+        v.x + q.w*t.x + (q.y*t.z - q.z*t.y),
+        v.y + q.w*t.y + (q.z*t.x - q.x*t.z),
+        v.z + q.w*t.z + (q.x*t.y - q.y*t.x)
+    );
+}
+
+}
+
+template <typename T>
+class transform_t
+{
+public:
+    vector3_t<T> position;
+    quaternion_t<T> orientation;
+    vector3_t<T> scale;
+
+    typedef T value_type;
+    typedef size_t size_type;
+
+    static constexpr size_type value_count = 10;
+
+    constexpr size_type max_size() const { return value_count; }
+    constexpr size_type size() const { return max_size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // named constructors
+    static constexpr transform_t trs(const vector3_t<value_type>& t, const quaternion_t<value_type>& r, const vector3_t<value_type>& s)
+    {
+        return{ t, r, s };
+    }
+
+    static constexpr transform_t trs(const vector3_t<value_type>& t, const quaternion_t<value_type>& r, const value_type& s)
+    {
+        return trs(t, r, vector3_t<value_type>::uniform(s));
+    }
+
+    static constexpr transform_t identity()
+    {
+        return trs(vector3_t<value_type>::zero(), quaternion_t<value_type>::identity(), vector3_t<value_type>::uniform(1));
+    }
+
+    static transform_t from_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_CRIT(ptr, "Constructing yama::transform_t from nullptr");
+        return trs(vector3_t<value_type>::from_ptr(ptr), quaternion_t<value_type>::from_ptr(ptr + 3), vector3_t<value_type>::from_ptr(ptr + 7));
+    }
+
+    static constexpr transform_t translation(const vector3_t<value_type>& t)
+    {
+        return trs(t, quaternion_t<value_type>::identity(), vector3_t<value_type>::uniform(1));
+    }
+
+    static constexpr transform_t translation(const value_type& x, const value_type& y, const value_type& z)
+    {
+        return translation(vector3_t<value_type>::coord(x, y, z));
+    }
+
+    static transform_t rotation(const quaternion_t<value_type>& q)
+    {
+        YAMA_ASSERT_BAD(q.is_normalized(), "rotation with a non-normalized quaternion");
+        return trs(vector3_t<value_type>::zero(), q, vector3_t<value_type>::uniform(1));
+    }
+
+    static constexpr transform_t scaling(const vector3_t<value_type>& s)
+    {
+        return trs(vector3_t<value_type>::zero(), quaternion_t<value_type>::identity(), s);
+    }
+
+    static constexpr transform_t scaling(const value_type& x, const value_type& y, const value_type& z)
+    {
+        return scaling(vector3_t<value_type>::coord(x, y, z));
+    }
+
+    static constexpr transform_t scaling_uniform(const value_type& s)
+    {
+        return scaling(vector3_t<value_type>::uniform(s));
+    }
+
+    ///////////////////////////
+    // attach
+    static transform_t* attach_to_array(value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::transform_t to nullptr");
+        return reinterpret_cast<transform_t*>(ptr);
+    }
+
+    static const transform_t* attach_to_array(const value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::transform_t to nullptr");
+        return reinterpret_cast<const transform_t*>(ptr);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // access
+    value_type* data()
+    {
+        return reinterpret_cast<value_type*>(this);
+    }
+
+    constexpr const value_type* data() const
+    {
+        return reinterpret_cast<const value_type*>(this);
+    }
+
+    bool has_uniform_scale(const value_type& epsilon = constants_t<value_type>::EPSILON()) const
+    {
+        return close(scale.x, scale.y, epsilon) && close(scale.x, scale.z, epsilon);
+    }
+
+    // the columns of the rotation matrix, multiplied by the scale
+    matrix3x4_t<value_type> to_matrix3x4() const
+    {
+        const auto& q = orientation;
+        const auto& s = scale;
+        const value_type x2 = sq(q.x);
+        const value_type y2 = sq(q.y);
+        const value_type z2 = sq(q.z);
+        const value_type w2 = sq(q.w);
+        const value_type xy = 2 * q.x * q.y;
+        const value_type xz = 2 * q.x * q.z;
+        const value_type xw = 2 * q.x * q.w;
+        const value_type yz = 2 * q.y * q.z;
+        const value_type yw = 2 * q.y * q.w;
+        const value_type zw = 2 * q.z * q.w;
+
+        return matrix3x4_t<value_type>::columns(
+            (w2 + x2 - y2 - z2) * s.x, (xy + zw) * s.x,           (xz - yw) * s.x,
+            (xy - zw) * s.y,           (w2 - x2 + y2 - z2) * s.y, (yz + xw) * s.y,
+            (xz + yw) * s.z,           (yz - xw) * s.z,           (w2 - x2 - y2 + z2) * s.z,
+            position.x,                position.y,                position.z
+        );
+    }
+
+    matrix4x4_t<value_type> to_matrix4x4() const
+    {
+        const auto m = to_matrix3x4();
+        return matrix4x4_t<value_type>::columns(
+            m.m00, m.m10, m.m20, 0,
+            m.m01, m.m11, m.m21, 0,
+            m.m02, m.m12, m.m22, 0,
+            m.m03, m.m13, m.m23, 1
+        );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // arithmetic
+    transform_t& operator*=(const transform_t& b)
+    {
+        position += internal::rotate_unit(mul(scale, b.position), orientation);
+        orientation *= b.orientation;
+        scale = mul(scale, b.scale);
+        return *this;
+    }
+
+    // exact for uniform scale
+    transform_t& invert()
+    {
+        YAMA_ASSERT_WARN(scale.x != 0 && scale.y != 0 && scale.z != 0, "Inverting a yama::transform_t with zero scale");
+        orientation.conjugate();
+        scale = div(vector3_t<value_type>::uniform(1), scale);
+        position = mul(scale, internal::rotate_unit(-position, orientation));
+        return *this;
+    }
+};
+
+template <typename T>
+constexpr typename transform_t<T>::size_type transform_t<T>::value_count;
+
+template <typename T>
+transform_t<T> operator*(const transform_t<T>& a, const transform_t<T>& b)
+{
+    return transform_t<T>::trs(
+        a.position + internal::rotate_unit(mul(a.scale, b.position), a.orientation),
+        a.orientation * b.orientation,
+        mul(a.scale, b.scale)
+    );
+}
+
+template <typename T>
+bool operator==(const transform_t<T>& a, const transform_t<T>& b)
+{
+    return a.position == b.position && a.orientation == b.orientation && a.scale == b.scale;
+}
+
+template <typename T>
+bool operator!=(const transform_t<T>& a, const transform_t<T>& b)
+{
+    return a.position != b.position || a.orientation != b.orientation || a.scale != b.scale;
+}
+
+template <typename T>
+bool close(const transform_t<T>& a, const transform_t<T>& b, const T& epsilon = constants_t<T>::EPSILON())
+{
+    return close(a.position, b.position, epsilon) && close(a.orientation, b.orientation, epsilon) && close(a.scale, b.scale, epsilon);
+}
+
+template <typename T>
+transform_t<T> inverse(const transform_t<T>& a)
+{
+    auto r = a;
+    r.invert();
+    return r;
+}
+
+// the scaled, rotated and translated point
+template <typename T>
+vector3_t<T> transform_coord(const vector3_t<T>& v, const transform_t<T>& tr)
+{
+    return internal::rotate_unit(mul(v, tr.scale), tr.orientation) + tr.position;
+}
+
+// the scaled and rotated direction
+template <typename T>
+vector3_t<T> transform_direction(const vector3_t<T>& v, const transform_t<T>& tr)
+{
+    return internal::rotate_unit(mul(v, tr.scale), tr.orientation);
+}
+
+// linear interpolation of the translation and scale and nlerp of the rotation
+// for blending animation poses
+template <typename T>
+transform_t<T> nlerp(const transform_t<T>& from, const transform_t<T>& to, const T& ratio)
+{
+    return transform_t<T>::trs(
+        from.position + ratio * (to.position - from.position),
+        nlerp(from.orientation, to.orientation, ratio),
+        from.scale + ratio * (to.scale - from.scale)
+    );
+}
+
+namespace internal
+{
+
+// the columns of a are treated as orthogonal if the cosines of the angles between them are below this
+template <typename T>
+T decompose_tolerance()
+{
+    return std::sqrt(std::numeric_limits<T>::epsilon());
+}
+
+// any unit vector perpendicular to the unit vector v
+template <typename T>
+vector3_t<T> any_perpendicular(const vector3_t<T>& v)
+{
+    const auto axis = std::abs(v.x) < T(0.5) ? vector3_t<T>::coord(1, 0, 0) : vector3_t<T>::coord(0, 1, 0);
+    return normalize(cross(v, axis));
+}
+
+// Gram-Schmidt from the longest column, for singular matrices
+template <typename T>
+matrix3x3_t<T> singular_rotation(const vector3_t<T>* c, const T* l)
+{
+    const size_t i0 = l[0] >= l[1] ? (l[0] >= l[2] ? 0 : 2) : (l[1] >= l[2] ? 1 : 2);
+    const size_t i1 = l[(i0 + 1) % 3] >= l[(i0 + 2) % 3] ? (i0 + 1) % 3 : (i0 + 2) % 3;
+    const size_t i2 = 3 - i0 - i1;
+
+    vector3_t<T> e[3];
+    if (l[i0] <= std::numeric_limits<T>::min())
+    {
+        return matrix3x3_t<T>::identity();
+    }
+    e[i0] = c[i0] / l[i0];
+
+    const auto u = c[i1] - e[i0] * dot(c[i1], e[i0]);
+    const T ul = u.length();
+    e[i1] = ul > decompose_tolerance<T>() * l[i0] ? u / ul : any_perpendicular(e[i0]);
+
+    // right-handed: e[i2] is the cross product of the next two cyclically
+    e[i2] = cross(e[(i2 + 1) % 3], e[(i2 + 2) % 3]);
+
+    return matrix3x3_t<T>::columns(
+        e[0].x, e[0].y, e[0].z,
+        e[1].x, e[1].y, e[1].z,
+        e[2].x, e[2].y, e[2].z
+    );
+}
+
+// a = r * scaling(s) + shear, r a rotation
+template <typename T>
+void decompose_linear(const matrix3x3_t<T>& a, matrix3x3_t<T>& r, vector3_t<T>& s)
+{
+    const vector3_t<T> c[] = { a.column_vector(0), a.column_vector(1), a.column_vector(2) };
+    const T l[] = { c[0].length(), c[1].length(), c[2].length() };
+    const T tol = decompose_tolerance<T>();
+    const T det = a.determinant();
+
+    const bool orthogonal =
+        std::abs(dot(c[0], c[1])) <= tol * l[0] * l[1] &&
+        std::abs(dot(c[0], c[2])) <= tol * l[0] * l[2] &&
+        std::abs(dot(c[1], c[2])) <= tol * l[1] * l[2];
+
+    if (std::abs(det) <= tol * l[0] * l[1] * l[2] || std::abs(det) <= std::numeric_limits<T>::min())
+    {
+        r = singular_rotation(c, l);
+    }
+    else if (orthogonal)
+    {
+        // the common case: only rotation and scaling
+        r = matrix3x3_t<T>::columns(
+            c[0].x / l[0], c[0].y / l[0], c[0].z / l[0],
+            c[1].x / l[1], c[1].y / l[1], c[1].z / l[1],
+            c[2].x / l[2], c[2].y / l[2], c[2].z / l[2]
+        );
+    }
+    else
+    {
+        r = polar_decomposition(a);
+    }
+
+    // reflections become a rotation with negative scale
+    if (r.determinant() < 0) r = r * T(-1);
+
+    s = vector3_t<T>::coord(
+        dot(r.column_vector(0), c[0]),
+        dot(r.column_vector(1), c[1]),
+        dot(r.column_vector(2), c[2])
+    );
+}
+
+template <typename M>
+transform_t<typename M::value_type> decompose_affine(const M& m)
+{
+    typedef typename M::value_type T;
+    matrix3x3_t<T> r;
+    vector3_t<T> s;
+    decompose_linear(matrix3x3_t<T>::from_matrix(m), r, s);
+    return transform_t<T>::trs(vector3_t<T>::coord(m.m03, m.m13, m.m23), r.to_quaternion(), s);
+}
+
+}
+
+// the transformation with the same translation, rotation and scale as m
+// Exact if m has no shear: decompose(m).to_matrix3x4() == m.
+template <typename T>
+transform_t<T> decompose(const matrix3x4_t<T>& m)
+{
+    return internal::decompose_affine(m);
+}
+
+// m should be affine
+template <typename T>
+transform_t<T> decompose(const matrix4x4_t<T>& m)
+{
+    YAMA_ASSERT_WARN(m.m30 == 0 && m.m31 == 0 && m.m32 == 0 && m.m33 == 1, "yama::decompose of a projective matrix4x4_t");
+    return internal::decompose_affine(m);
+}
+
+template <typename T>
+transform_t<T> decompose(const matrix3x3_t<T>& m)
+{
+    matrix3x3_t<T> r;
+    vector3_t<T> s;
+    internal::decompose_linear(m, r, s);
+    return transform_t<T>::trs(vector3_t<T>::zero(), r.to_quaternion(), s);
+}
+
+// type traits
+template <typename T>
+struct is_yama<transform_t<T>> : public std::true_type {};
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+typedef transform_t<preferred_type> transform;
+
+#endif
+
+}
@@ -76,6 +76,15 @@ T lerp(const T& from, const T& to, const S& ratio)
     return from + ratio * (to - from);
 }
 
+// the sine and the cosine of the same angle
+// Compilers merge the two calls into a single sincos call where the C library has one.
+template <typename T>
+void sincos(const T& radians, T& out_sin, T& out_cos)
+{
+    out_sin = std::sin(radians);
+    out_cos = std::cos(radians);
+}
+
 template <typename T>
 T rad_to_deg(const T& radians)
 {
@@ -0,0 +1,637 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+// Generic compile-time-sized vectors
+// vector_t<T, N> is N consecutive values of T, the same layout as vector2_t,
+// vector3_t, vector4_t and quaternion_t, so it converts to and from them with
+// from() and as(). Every operation is unrolled at compile time by expanding
+// an index list, and the ones that can be constexpr in C++11 are.
+
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <cstdlib>
+#include <algorithm>
+
+#include "util.hpp"
+#include "shorthand.hpp"
+#include "type_traits.hpp"
+
+namespace yama
+{
+
+template <typename T, size_t N>
+class vector_t;
+
+namespace internal
+{
+
+// make_index_list<N>::type is index_list<0, 1, ..., N - 1>
+template <size_t... I>
+struct index_list {};
+
+template <size_t N, size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_index_list<0, I...>
+{
+    typedef index_list<I...> type;
+};
+
+// unroll<N>::sum(f) is f(0) + f(1) + ... + f(N - 1), added from left to right
+// like the hand-written types do
+template <size_t N>
+struct unroll
+{
+    template <typename F>
+    static constexpr auto sum(const F& f) -> decltype(f(0))
+    {
+        return unroll<N - 1>::sum(f) + f(N - 1);
+    }
+
+    template <typename F>
+    static constexpr bool all(const F& f)
+    {
+        return unroll<N - 1>::all(f) && f(N - 1);
+    }
+};
+
+template <>
+struct unroll<1>
+{
+    template <typename F>
+    static constexpr auto sum(const F& f) -> decltype(f(0))
+    {
+        return f(0);
+    }
+
+    template <typename F>
+    static constexpr bool all(const F& f)
+    {
+        return f(0);
+    }
+};
+
+// a[k*a_stride] * b[k*b_stride]
+template <typename T>
+struct strided_product
+{
+    const T* a;
+    size_t a_stride;
+    const T* b;
+    size_t b_stride;
+
+    constexpr T operator()(size_t k) const
+    {
+        return a[k * a_stride] * b[k * b_stride];
+    }
+};
+
+// the dot product of N strided values
+template <size_t N, typename T>
+constexpr T strided_dot(const T* a, size_t a_stride, const T* b, size_t b_stride)
+{
+    return unroll<N>::sum(strided_product<T>{ a, a_stride, b, b_stride });
+}
+
+template <typename T>
+struct equal_values
+{
+    const T* a;
+    const T* b;
+
+    constexpr bool operator()(size_t i) const
+    {
+        return a[i] == b[i];
+    }
+};
+
+template <typename T>
+struct close_values
+{
+    const T* a;
+    const T* b;
+    T epsilon;
+
+    bool operator()(size_t i) const
+    {
+        return close(a[i], b[i], epsilon);
+    }
+};
+
+template <typename T>
+struct abs_values
+{
+    const T* a;
+
+    T operator()(size_t i) const
+    {
+        return std::abs(a[i]);
+    }
+};
+
+template <typename T>
+struct finite_values
+{
+    const T* a;
+
+    bool operator()(size_t i) const
+    {
+        return std::isfinite(a[i]);
+    }
+};
+
+// element-wise operations
+struct add_op { template <typename T> static constexpr T apply(const T& a, const T& b) { return a + b; } };
+struct sub_op { template <typename T> static constexpr T apply(const T& a, const T& b) { return a - b; } };
+struct mul_op { template <typename T> static constexpr T apply(const T& a, const T& b) { return a * b; } };
+struct div_op { template <typename T> static constexpr T apply(const T& a, const T& b) { return a / b; } };
+struct min_op { template <typename T> static constexpr T apply(const T& a, const T& b) { return b < a ? b : a; } };
+struct max_op { template <typename T> static constexpr T apply(const T& a, const T& b) { return a < b ? b : a; } };
+struct neg_op { template <typename T> static constexpr T apply(const T& a) { return -a; } };
+struct abs_op { template <typename T> static T apply(const T& a) { return std::abs(a); } };
+
+template <size_t I, typename T>
+constexpr const T& repeat(const T& s)
+{
+    return s;
+}
+
+template <typename T, size_t N, size_t... I>
+constexpr vector_t<T, N> vector_uniform(const T& s, index_list<I...>)
+{
+    return{ { repeat<I>(s)... } };
+}
+
+template <typename T, size_t N, size_t... I>
+constexpr vector_t<T, N> vector_unit(size_t axis, index_list<I...>)
+{
+    return{ { T(I == axis ? 1 : 0)... } };
+}
+
+template <typename T, size_t N, size_t... I>
+vector_t<T, N> vector_from_ptr(const T* ptr, index_list<I...>)
+{
+    return{ { ptr[I]... } };
+}
+
+template <typename Op, typename T, size_t N, size_t... I>
+constexpr vector_t<T, N> vector_map(const vector_t<T, N>& a, index_list<I...>)
+{
+    return{ { Op::apply(a.values[I])... } };
+}
+
+template <typename Op, typename T, size_t N, size_t... I>
+constexpr vector_t<T, N> vector_zip(const vector_t<T, N>& a, const vector_t<T, N>& b, index_list<I...>)
+{
+    return{ { Op::apply(a.values[I], b.values[I])... } };
+}
+
+template <typename Op, typename T, size_t N, size_t... I>
+constexpr vector_t<T, N> vector_zip(const vector_t<T, N>& a, const T& s, index_list<I...>)
+{
+    return{ { Op::apply(a.values[I], s)... } };
+}
+
+template <typename Op, typename T, size_t N, size_t... I>
+constexpr vector_t<T, N> vector_zip(const T& s, const vector_t<T, N>& b, index_list<I...>)
+{
+    return{ { Op::apply(s, b.values[I])... } };
+}
+
+}
+
+template <typename T, size_t N>
+class vector_t
+{
+    static_assert(N > 0, "yama::vector_t needs at least one value");
+    typedef typename internal::make_index_list<N>::type indices;
+
+public:
+    T values[N];
+
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef typename std::reverse_iterator<iterator> reverse_iterator;
+    typedef typename std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type value_count = N;
+
+    constexpr size_type max_size() const { return value_count; }
+    constexpr size_type size() const { return max_size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // named constructors
+    template <typename... Args>
+    static constexpr vector_t coord(const Args&... args)
+    {
+        static_assert(sizeof...(Args) == N, "yama::vector_t::coord needs a value for each coordinate");
+        return{ { value_type(args)... } };
+    }
+
+    static constexpr vector_t uniform(const value_type& s)
+    {
+        return internal::vector_uniform<T, N>(s, indices());
+    }
+
+    static constexpr vector_t zero()
+    {
+        return uniform(value_type(0));
+    }
+
+    // 1 at `axis` and 0 elsewhere
+    static constexpr vector_t unit(size_type axis)
+    {
+        return internal::vector_unit<T, N>(axis, indices());
+    }
+
+    static vector_t from_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_CRIT(ptr, "Constructing yama::vector_t from nullptr");
+        return internal::vector_from_ptr<T, N>(ptr, indices());
+    }
+
+    // from a type with the same number of consecutive values, like vector3_t for N = 3
+    template <typename V>
+    static vector_t from(const V& v)
+    {
+        static_assert(V::value_count == N, "yama::vector_t::from a type of a different size");
+        return from_ptr(v.data());
+    }
+
+    ///////////////////////////
+    // attach
+    static vector_t& attach_to_ptr(value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::vector_t to nullptr");
+        return *reinterpret_cast<vector_t*>(ptr);
+    }
+
+    static const vector_t& attach_to_ptr(const value_type* ptr)
+    {
+        YAMA_ASSERT_BAD(ptr, "Attaching yama::vector_t to nullptr");
+        return *reinterpret_cast<const vector_t*>(ptr);
+    }
+
+    static vector_t* attach_to_array(value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::vector_t to nullptr");
+        return reinterpret_cast<vector_t*>(ptr);
+    }
+
+    static const vector_t* attach_to_array(const value_type* ptr)
+    {
+        YAMA_ASSERT_WARN(ptr, "Attaching yama::vector_t to nullptr");
+        return reinterpret_cast<const vector_t*>(ptr);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // access
+    value_type* data()
+    {
+        return values;
+    }
+
+    constexpr const value_type* data() const
+    {
+        return values;
+    }
+
+    value_type& at(size_type i)
+    {
+        YAMA_ASSERT_CRIT(i < value_count, "yama::vector_t index overflow");
+        return values[i];
+    }
+
+    constexpr const value_type& at(size_type i) const
+    {
+        YAMA_ASSERT_CRIT14(i < value_count, "yama::vector_t index overflow");
+        return values[i];
+    }
+
+    value_type& operator[](size_type i)
+    {
+        return at(i);
+    }
+
+    constexpr const value_type& operator[](size_type i) const
+    {
+        return at(i);
+    }
+
+    ///////////////////////////
+    // cast
+
+    value_type* as_ptr()
+    {
+        return data();
+    }
+
+    const value_type* as_ptr() const
+    {
+        return data();
+    }
+
+    template <typename S>
+    vector_t<S, N> as_vector_t() const
+    {
+        vector_t<S, N> ret;
+        std::copy(begin(), end(), ret.begin());
+        return ret;
+    }
+
+    // to a type with the same number of consecutive values, like vector3_t for N = 3
+    template <typename V>
+    V as() const
+    {
+        static_assert(V::value_count == N, "yama::vector_t::as a type of a different size");
+        return V::from_ptr(data());
+    }
+
+    ///////////////////////////
+    // std
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + value_count;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + value_count;
+    }
+
+    value_type& front()
+    {
+        return at(0);
+    }
+
+    value_type& back()
+    {
+        return at(value_count - 1);
+    }
+
+    constexpr const value_type& front() const
+    {
+        return at(0);
+    }
+
+    constexpr const value_type& back() const
+    {
+        return at(value_count - 1);
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // arithmetic
+
+    constexpr const vector_t& operator+() const
+    {
+        return *this;
+    }
+
+    constexpr vector_t operator-() const
+    {
+        return internal::vector_map<internal::neg_op>(*this, indices());
+    }
+
+    vector_t& operator+=(const vector_t& b)
+    {
+        return *this = internal::vector_zip<internal::add_op>(*this, b, indices());
+    }
+
+    vector_t& operator-=(const vector_t& b)
+    {
+        return *this = internal::vector_zip<internal::sub_op>(*this, b, indices());
+    }
+
+    vector_t& operator*=(const value_type& s)
+    {
+        return *this = internal::vector_zip<internal::mul_op>(*this, s, indices());
+    }
+
+    vector_t& operator/=(const value_type& s)
+    {
+        YAMA_ASSERT_WARN(s != 0, "yama::vector_t division by zero");
+        return *this = internal::vector_zip<internal::div_op>(*this, s, indices());
+    }
+
+    vector_t& mul(const vector_t& b)
+    {
+        return *this = internal::vector_zip<internal::mul_op>(*this, b, indices());
+    }
+
+    vector_t& div(const vector_t& b)
+    {
+        return *this = internal::vector_zip<internal::div_op>(*this, b, indices());
+    }
+
+    constexpr value_type length_sq() const
+    {
+        return internal::strided_dot<N>(values, 1, values, 1);
+    }
+
+    value_type length() const
+    {
+        return std::sqrt(length_sq());
+    }
+
+    value_type manhattan_length() const
+    {
+        return internal::unroll<N>::sum(internal::abs_values<T>{ values });
+    }
+
+    value_type normalize()
+    {
+        auto l = length();
+        YAMA_ASSERT_WARN(l, "Normalizing zero-length yama::vector_t");
+        *this /= l;
+        return l;
+    }
+
+    bool is_normalized() const
+    {
+        return close(length(), value_type(1));
+    }
+};
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> operator+(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::add_op>(a, b, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> operator-(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::sub_op>(a, b, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> operator*(const vector_t<T, N>& a, const T& s)
+{
+    return internal::vector_zip<internal::mul_op>(a, s, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> operator*(const T& s, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::mul_op>(s, b, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+vector_t<T, N> operator/(const vector_t<T, N>& a, const T& s)
+{
+    YAMA_ASSERT_WARN(s != 0, "yama::vector_t division by zero");
+    return internal::vector_zip<internal::div_op>(a, s, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> operator/(const T& s, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::div_op>(s, b, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr bool operator==(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::unroll<N>::all(internal::equal_values<T>{ a.values, b.values });
+}
+
+template <typename T, size_t N>
+constexpr bool operator!=(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return !(a == b);
+}
+
+template <typename T, size_t N>
+bool close(const vector_t<T, N>& a, const vector_t<T, N>& b, const T& epsilon = constants_t<T>::EPSILON())
+{
+    return internal::unroll<N>::all(internal::close_values<T>{ a.values, b.values, epsilon });
+}
+
+template <typename T, size_t N>
+vector_t<T, N> abs(const vector_t<T, N>& a)
+{
+    return internal::vector_map<internal::abs_op>(a, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> mul(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::mul_op>(a, b, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+constexpr vector_t<T, N> div(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::div_op>(a, b, typename internal::make_index_list<N>::type());
+}
+
+template <typename T, size_t N>
+bool isfinite(const vector_t<T, N>& a)
+{
+    return internal::unroll<N>::all(internal::finite_values<T>{ a.values });
+}
+
+#if !defined(min)
+template <typename T, size_t N>
+constexpr vector_t<T, N> min(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::min_op>(a, b, typename internal::make_index_list<N>::type());
+}
+#endif
+
+#if !defined(max)
+template <typename T, size_t N>
+constexpr vector_t<T, N> max(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::vector_zip<internal::max_op>(a, b, typename internal::make_index_list<N>::type());
+}
+#endif
+
+template <typename T, size_t N>
+constexpr T dot(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return internal::strided_dot<N>(a.values, 1, b.values, 1);
+}
+
+template <typename T, size_t N>
+constexpr T distance_sq(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return (a - b).length_sq();
+}
+
+template <typename T, size_t N>
+T distance(const vector_t<T, N>& a, const vector_t<T, N>& b)
+{
+    return std::sqrt(distance_sq(a, b));
+}
+
+template <typename T, size_t N>
+vector_t<T, N> normalize(const vector_t<T, N>& a)
+{
+    auto l = a.length();
+    YAMA_ASSERT_WARN(l, "Normalizing zero-length yama::vector_t");
+    return a / l;
+}
+
+// type traits
+template <typename T, size_t N>
+struct is_yama<vector_t<T, N>> : public std::true_type {};
+
+template <typename T, size_t N>
+struct is_vector<vector_t<T, N>> : public std::true_type {};
+
+// shorthand
+#if !defined(YAMA_NO_SHORTHAND)
+
+template <size_t N>
+using vectorn = vector_t<preferred_type, N>;
+
+#endif
+
+}
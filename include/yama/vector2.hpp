@@ -13,8 +13,10 @@
 #include <algorithm>
 
 #include "util.hpp"
+#include "simd.hpp"
 #include "shorthand.hpp"
 #include "type_traits.hpp"
+#include "strided.hpp"
 
 namespace yama
 {
@@ -102,6 +104,17 @@ public:
         return reinterpret_cast<const vector2_t*>(ptr);
     }
 
+    // count vectors, stride bytes apart, like a member of the vertices of an interleaved buffer
+    static strided_span<vector2_t> attach_to_strided(value_type* ptr, size_t stride, size_t count)
+    {
+        return strided_span<vector2_t>::from_ptr(reinterpret_cast<vector2_t*>(ptr), stride, count);
+    }
+
+    static strided_span<const vector2_t> attach_to_strided(const value_type* ptr, size_t stride, size_t count)
+    {
+        return strided_span<const vector2_t>::from_ptr(reinterpret_cast<const vector2_t*>(ptr), stride, count);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // access
     value_type* data()
@@ -310,6 +323,24 @@ public:
         return l;
     }
 
+    // 1/length(), see internal::rsqrt for the precision
+    // Zero-length vectors give a large finite value.
+    value_type rsqrt_length() const
+    {
+        return internal::rsqrt(length_sq());
+    }
+
+    // normalize() with a reciprocal square root instead of a square root and a division
+    // Zero-length vectors stay zero. Returns the length.
+    value_type fast_normalize()
+    {
+        const auto l_sq = length_sq();
+        const auto r = internal::rsqrt(l_sq);
+        x *= r;
+        y *= r;
+        return l_sq * r;
+    }
+
     bool is_normalized() const
     {
         return close(length(), value_type(1));
@@ -527,6 +558,19 @@ vector2_t<T> normalize(const vector2_t<T>& a)
     return vector2_t<T>::coord(a.x / l, a.y / l);
 }
 
+template <typename T>
+T rsqrt_length(const vector2_t<T>& a)
+{
+    return a.rsqrt_length();
+}
+
+template <typename T>
+vector2_t<T> fast_normalize(const vector2_t<T>& a)
+{
+    const auto r = a.rsqrt_length();
+    return vector2_t<T>::coord(a.x * r, a.y * r);
+}
+
 template <typename T>
 bool orthogonal(const vector2_t<T>& a, const vector2_t<T>& b)
 {
@@ -13,8 +13,10 @@
 #include <algorithm>
 
 #include "util.hpp"
+#include "simd.hpp"
 #include "shorthand.hpp"
 #include "type_traits.hpp"
+#include "strided.hpp"
 
 namespace yama
 {
@@ -107,6 +109,17 @@ public:
         return reinterpret_cast<const vector3_t*>(ptr);
     }
 
+    // count vectors, stride bytes apart, like a member of the vertices of an interleaved buffer
+    static strided_span<vector3_t> attach_to_strided(value_type* ptr, size_t stride, size_t count)
+    {
+        return strided_span<vector3_t>::from_ptr(reinterpret_cast<vector3_t*>(ptr), stride, count);
+    }
+
+    static strided_span<const vector3_t> attach_to_strided(const value_type* ptr, size_t stride, size_t count)
+    {
+        return strided_span<const vector3_t>::from_ptr(reinterpret_cast<const vector3_t*>(ptr), stride, count);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // access
     value_type* data()
@@ -324,6 +337,25 @@ public:
         return l;
     }
 
+    // 1/length(), see internal::rsqrt for the precision
+    // Zero-length vectors give a large finite value.
+    value_type rsqrt_length() const
+    {
+        return internal::rsqrt(length_sq());
+    }
+
+    // normalize() with a reciprocal square root instead of a square root and a division
+    // Zero-length vectors stay zero. Returns the length.
+    value_type fast_normalize()
+    {
+        const auto l_sq = length_sq();
+        const auto r = internal::rsqrt(l_sq);
+        x *= r;
+        y *= r;
+        z *= r;
+        return l_sq * r;
+    }
+
     bool is_normalized() const
     {
         return close(length(), value_type(1));
@@ -575,6 +607,19 @@ vector3_t<T> normalize(const vector3_t<T>& a)
     return vector3_t<T>::coord(a.x / l, a.y / l, a.z / l);
 }
 
+template <typename T>
+T rsqrt_length(const vector3_t<T>& a)
+{
+    return a.rsqrt_length();
+}
+
+template <typename T>
+vector3_t<T> fast_normalize(const vector3_t<T>& a)
+{
+    const auto r = a.rsqrt_length();
+    return vector3_t<T>::coord(a.x * r, a.y * r, a.z * r);
+}
+
 template <typename T>
 bool orthogonal(const vector3_t<T>& a, const vector3_t<T>& b)
 {
@@ -589,9 +634,9 @@ bool collinear(const vector3_t<T>& a, const vector3_t<T>& b)
 
     for (int i = 0; i < 3; ++i)
     {
-        if (close(a[i], 0.f))
+        if (close(a[i], T(0)))
         {
-            if (close(b[i], 0.f))
+            if (close(b[i], T(0)))
             {
                 continue;
             }
@@ -13,8 +13,10 @@
 #include <algorithm>
 
 #include "util.hpp"
+#include "simd.hpp"
 #include "shorthand.hpp"
 #include "type_traits.hpp"
+#include "strided.hpp"
 
 namespace yama
 {
@@ -112,6 +114,17 @@ public:
         return reinterpret_cast<const vector4_t*>(ptr);
     }
 
+    // count vectors, stride bytes apart, like a member of the vertices of an interleaved buffer
+    static strided_span<vector4_t> attach_to_strided(value_type* ptr, size_t stride, size_t count)
+    {
+        return strided_span<vector4_t>::from_ptr(reinterpret_cast<vector4_t*>(ptr), stride, count);
+    }
+
+    static strided_span<const vector4_t> attach_to_strided(const value_type* ptr, size_t stride, size_t count)
+    {
+        return strided_span<const vector4_t>::from_ptr(reinterpret_cast<const vector4_t*>(ptr), stride, count);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // access
     value_type* data()
@@ -340,6 +353,26 @@ public:
         return l;
     }
 
+    // 1/length(), see internal::rsqrt for the precision
+    // Zero-length vectors give a large finite value.
+    value_type rsqrt_length() const
+    {
+        return internal::rsqrt(length_sq());
+    }
+
+    // normalize() with a reciprocal square root instead of a square root and a division
+    // Zero-length vectors stay zero. Returns the length.
+    value_type fast_normalize()
+    {
+        const auto l_sq = length_sq();
+        const auto r = internal::rsqrt(l_sq);
+        x *= r;
+        y *= r;
+        z *= r;
+        w *= r;
+        return l_sq * r;
+    }
+
     bool is_normalized() const
     {
         return close(length(), value_type(1));
@@ -556,6 +589,19 @@ vector4_t<T> normalize(const vector4_t<T>& a)
     return vector4_t<T>::coord(a.x / l, a.y / l, a.z / l, a.w / l);
 }
 
+template <typename T>
+T rsqrt_length(const vector4_t<T>& a)
+{
+    return a.rsqrt_length();
+}
+
+template <typename T>
+vector4_t<T> fast_normalize(const vector4_t<T>& a)
+{
+    const auto r = a.rsqrt_length();
+    return vector4_t<T>::coord(a.x * r, a.y * r, a.z * r, a.w * r);
+}
+
 template <typename T>
 bool orthogonal(const vector4_t<T>& a, const vector4_t<T>& b)
 {
@@ -570,9 +616,9 @@ bool collinear(const vector4_t<T>& a, const vector4_t<T>& b)
 
     for (int i = 0; i < 4; ++i)
     {
-        if (close(a[i], 0.f))
+        if (close(a[i], T(0)))
         {
-            if (close(b[i], 0.f))
+            if (close(b[i], T(0)))
             {
                 continue;
             }
@@ -10,5 +10,10 @@
 #include "dim.hpp"
 #include "vector_xyzw.hpp"
 #include "quaternion.hpp"
+#include "matrix2x3.hpp"
+#include "matrix3x3.hpp"
 #include "matrix3x4.hpp"
 #include "matrix4x4.hpp"
+#include "vector.hpp"
+#include "matrix.hpp"
+#include "transform.hpp"
@@ -0,0 +1,261 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// the detection of the instruction set and the calls through its table
+// This file must not include the math headers: it is compiled with the
+// flags of the application, which may enable any YAMA_SIMD level.
+#include "yama/dispatch.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+// the x86 kernels are compiled (src/CMakeLists.txt defines it)
+#if !defined(YAMA_DISPATCH_X86)
+#   if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#       define YAMA_DISPATCH_X86 1
+#   else
+#       define YAMA_DISPATCH_X86 0
+#   endif
+#endif
+
+#if YAMA_DISPATCH_X86 && defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+namespace yama
+{
+namespace internal
+{
+namespace
+{
+
+#if YAMA_DISPATCH_X86
+
+#if defined(_MSC_VER)
+
+bool cpu_supports(dispatch::isa_t isa)
+{
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] >> 26) & 1;
+    const bool fma = (info[2] >> 12) & 1;
+    const bool osxsave = (info[2] >> 27) & 1;
+    const bool avx = (info[2] >> 28) & 1;
+    if (isa == dispatch::isa_sse2) return sse2;
+    if (!osxsave || !avx || !fma || max_leaf < 7) return false;
+
+    // the OS saves the registers: xmm and ymm, then opmask and zmm
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] >> 5) & 1;
+    if (isa == dispatch::isa_avx2) return avx2 && (xcr0 & 0x6) == 0x6;
+
+    const bool avx512 = ((info[1] >> 16) & 1) && ((info[1] >> 17) & 1) && ((info[1] >> 30) & 1) && ((info[1] >> 31) & 1); // F DQ BW VL
+    return isa == dispatch::isa_avx512 && avx2 && avx512 && (xcr0 & 0xe6) == 0xe6;
+}
+
+#else
+
+bool cpu_supports(dispatch::isa_t isa)
+{
+    __builtin_cpu_init();
+    switch (isa)
+    {
+    case dispatch::isa_sse2:
+        return __builtin_cpu_supports("sse2");
+    case dispatch::isa_avx2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case dispatch::isa_avx512:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+            && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")
+            && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw");
+    default:
+        return false;
+    }
+}
+
+#endif
+
+#endif
+
+// null for the ones which aren't compiled
+const dispatch_kernels* compiled_kernels(dispatch::isa_t isa)
+{
+    switch (isa)
+    {
+    case dispatch::isa_scalar: return &dispatch_kernels_scalar();
+#if YAMA_DISPATCH_X86
+    case dispatch::isa_sse2: return &dispatch_kernels_sse2();
+    case dispatch::isa_avx2: return &dispatch_kernels_avx2();
+    case dispatch::isa_avx512: return &dispatch_kernels_avx512();
+#endif
+    default: return nullptr;
+    }
+}
+
+struct dispatch_state
+{
+    dispatch::isa_t detected;
+    bool supported[dispatch::isa_count];
+    std::atomic<const dispatch_kernels*> active;
+
+    dispatch_state()
+        : detected(dispatch::isa_scalar)
+    {
+        supported[dispatch::isa_scalar] = true;
+        for (int i = dispatch::isa_scalar + 1; i < dispatch::isa_count; ++i)
+        {
+            const auto isa = dispatch::isa_t(i);
+#if YAMA_DISPATCH_X86
+            supported[i] = compiled_kernels(isa) && cpu_supports(isa);
+#else
+            supported[i] = false;
+#endif
+            if (supported[i]) detected = isa;
+        }
+        active = compiled_kernels(detected);
+
+        // the override for testing
+        if (const char* name = std::getenv("YAMA_DISPATCH_ISA"))
+        {
+            for (int i = 0; i < dispatch::isa_count; ++i)
+            {
+                const auto isa = dispatch::isa_t(i);
+                if (std::strcmp(name, dispatch::isa_name(isa)) == 0 && supported[i])
+                {
+                    active = compiled_kernels(isa);
+                }
+            }
+        }
+    }
+};
+
+dispatch_state& state()
+{
+    static dispatch_state s;
+    return s;
+}
+
+const dispatch_kernels& kernels()
+{
+    return *state().active.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+const float* floats(const T* ptr)
+{
+    return reinterpret_cast<const float*>(ptr);
+}
+
+template <typename T>
+float* floats(T* ptr)
+{
+    return reinterpret_cast<float*>(ptr);
+}
+
+}
+}
+
+namespace dispatch
+{
+
+const char* isa_name(isa_t isa)
+{
+    switch (isa)
+    {
+    case isa_scalar: return "scalar";
+    case isa_sse2: return "sse2";
+    case isa_avx2: return "avx2";
+    case isa_avx512: return "avx512";
+    default: return "unknown";
+    }
+}
+
+bool is_supported(isa_t isa)
+{
+    return unsigned(isa) < unsigned(isa_count) && internal::state().supported[isa];
+}
+
+isa_t detected_isa()
+{
+    return internal::state().detected;
+}
+
+isa_t active_isa()
+{
+    return internal::kernels().isa;
+}
+
+bool force_isa(isa_t isa)
+{
+    if (!is_supported(isa)) return false;
+    internal::state().active = internal::compiled_kernels(isa);
+    return true;
+}
+
+void reset_isa()
+{
+    force_isa(detected_isa());
+}
+
+void transform_coords(const matrix4x4_t<float>& m, const vector3_t<float>* in, vector3_t<float>* out, size_t count)
+{
+    internal::kernels().transform_coords_4x4(internal::floats(&m), internal::floats(in), internal::floats(out), count);
+}
+
+void transform_coords(const matrix3x4_t<float>& m, const vector3_t<float>* in, vector3_t<float>* out, size_t count)
+{
+    internal::kernels().transform_coords_3x4(internal::floats(&m), internal::floats(in), internal::floats(out), count);
+}
+
+void transform_directions(const matrix4x4_t<float>& m, const vector3_t<float>* in, vector3_t<float>* out, size_t count)
+{
+    internal::kernels().transform_directions_4x4(internal::floats(&m), internal::floats(in), internal::floats(out), count);
+}
+
+void fast_normalize(const vector3_t<float>* in, vector3_t<float>* out, size_t count)
+{
+    internal::kernels().fast_normalize3(internal::floats(in), internal::floats(out), count);
+}
+
+void normalize(const quaternion_t<float>* in, quaternion_t<float>* out, size_t count)
+{
+    internal::kernels().normalize_quaternions(internal::floats(in), internal::floats(out), count);
+}
+
+void multiply(const quaternion_t<float>* a, const quaternion_t<float>* b, quaternion_t<float>* out, size_t count)
+{
+    internal::kernels().multiply_quaternions(internal::floats(a), internal::floats(b), internal::floats(out), count);
+}
+
+void rotate(const quaternion_t<float>& q, const vector3_t<float>* in, vector3_t<float>* out, size_t count)
+{
+    internal::kernels().rotate(internal::floats(&q), internal::floats(in), internal::floats(out), count);
+}
+
+void nlerp(const quaternion_t<float>* from, const quaternion_t<float>* to, float ratio, quaternion_t<float>* out, size_t count)
+{
+    internal::kernels().nlerp(internal::floats(from), internal::floats(to), ratio, internal::floats(out), count);
+}
+
+void cull_spheres(const frustum_t<float>& f, const vector4_soa_t<float>& spheres, uint32_t* out)
+{
+    internal::kernels().cull_spheres(internal::floats(&f), &spheres, out);
+}
+
+void cull_aabbs(const frustum_t<float>& f, const vector3_soa_t<float>& mins, const vector3_soa_t<float>& maxs, uint32_t* out)
+{
+    internal::kernels().cull_aabbs(internal::floats(&f), &mins, &maxs, out);
+}
+
+}
+}
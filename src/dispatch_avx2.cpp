@@ -0,0 +1,15 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// the dispatched kernels for AVX2 and FMA3
+#undef YAMA_SIMD
+#define YAMA_SIMD YAMA_SIMD_AVX2
+#define YAMA_DISPATCH_ISA yama::dispatch::isa_avx2
+#define YAMA_DISPATCH_NAMESPACE yama_dispatch_avx2
+#define YAMA_DISPATCH_KERNELS dispatch_kernels_avx2
+#include "dispatch_kernels.inl"
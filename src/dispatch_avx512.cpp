@@ -0,0 +1,15 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// the dispatched kernels for AVX-512 F, VL, DQ and BW
+#undef YAMA_SIMD
+#define YAMA_SIMD YAMA_SIMD_AVX512
+#define YAMA_DISPATCH_ISA yama::dispatch::isa_avx512
+#define YAMA_DISPATCH_NAMESPACE yama_dispatch_avx512
+#define YAMA_DISPATCH_KERNELS dispatch_kernels_avx512
+#include "dispatch_kernels.inl"
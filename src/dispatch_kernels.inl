@@ -0,0 +1,120 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// The kernels of one instruction set, included by src/dispatch_<isa>.cpp
+// after defining:
+//  YAMA_SIMD the level to compile the kernels with
+//  YAMA_DISPATCH_ISA its yama::dispatch::isa_t
+//  YAMA_DISPATCH_NAMESPACE the name replacing yama in the headers
+//  YAMA_DISPATCH_KERNELS the name of the function returning the table
+
+#include "yama/dispatch.hpp"
+
+// every inline function of the headers gets a name of its own, so the
+// linker can't pick the copy of another instruction set
+#define yama YAMA_DISPATCH_NAMESPACE
+#include "yama/batch.hpp"
+#include "yama/frustum.hpp"
+#undef yama
+
+namespace
+{
+
+namespace isa = YAMA_DISPATCH_NAMESPACE;
+
+typedef isa::vector3_t<float> vector3;
+typedef isa::quaternion_t<float> quaternion;
+
+template <typename T>
+const T& as(const void* ptr)
+{
+    return *static_cast<const T*>(ptr);
+}
+
+const vector3* vectors(const float* ptr) { return reinterpret_cast<const vector3*>(ptr); }
+vector3* vectors(float* ptr) { return reinterpret_cast<vector3*>(ptr); }
+const quaternion* quaternions(const float* ptr) { return reinterpret_cast<const quaternion*>(ptr); }
+quaternion* quaternions(float* ptr) { return reinterpret_cast<quaternion*>(ptr); }
+
+void transform_coords_4x4(const float* m, const float* in, float* out, size_t count)
+{
+    isa::transform_coords(as<isa::matrix4x4_t<float>>(m), vectors(in), vectors(out), count);
+}
+
+void transform_coords_3x4(const float* m, const float* in, float* out, size_t count)
+{
+    isa::transform_coords(as<isa::matrix3x4_t<float>>(m), vectors(in), vectors(out), count);
+}
+
+void transform_directions_4x4(const float* m, const float* in, float* out, size_t count)
+{
+    isa::transform_directions(as<isa::matrix4x4_t<float>>(m), vectors(in), vectors(out), count);
+}
+
+void fast_normalize3(const float* in, float* out, size_t count)
+{
+    isa::fast_normalize(vectors(in), vectors(out), count);
+}
+
+void normalize_quaternions(const float* in, float* out, size_t count)
+{
+    isa::normalize(quaternions(in), quaternions(out), count);
+}
+
+void multiply_quaternions(const float* a, const float* b, float* out, size_t count)
+{
+    isa::multiply(quaternions(a), quaternions(b), quaternions(out), count);
+}
+
+void rotate(const float* q, const float* in, float* out, size_t count)
+{
+    isa::rotate(as<quaternion>(q), vectors(in), vectors(out), count);
+}
+
+void nlerp(const float* from, const float* to, float ratio, float* out, size_t count)
+{
+    isa::nlerp(quaternions(from), quaternions(to), ratio, quaternions(out), count);
+}
+
+void cull_spheres(const float* planes, const void* spheres, uint32_t* out)
+{
+    isa::cull_spheres(as<isa::frustum_t<float>>(planes), as<isa::vector4_soa_t<float>>(spheres), out);
+}
+
+void cull_aabbs(const float* planes, const void* mins, const void* maxs, uint32_t* out)
+{
+    isa::cull_aabbs(as<isa::frustum_t<float>>(planes), as<isa::vector3_soa_t<float>>(mins), as<isa::vector3_soa_t<float>>(maxs), out);
+}
+
+}
+
+namespace yama
+{
+namespace internal
+{
+
+const dispatch_kernels& YAMA_DISPATCH_KERNELS()
+{
+    static const dispatch_kernels k = {
+        YAMA_DISPATCH_ISA,
+        transform_coords_4x4,
+        transform_coords_3x4,
+        transform_directions_4x4,
+        fast_normalize3,
+        normalize_quaternions,
+        multiply_quaternions,
+        rotate,
+        nlerp,
+        cull_spheres,
+        cull_aabbs,
+    };
+    return k;
+}
+
+}
+}
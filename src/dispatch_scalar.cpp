@@ -0,0 +1,15 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// the dispatched kernels without SIMD, for any CPU
+#undef YAMA_SIMD
+#define YAMA_SIMD YAMA_SIMD_NONE
+#define YAMA_DISPATCH_ISA yama::dispatch::isa_scalar
+#define YAMA_DISPATCH_NAMESPACE yama_dispatch_scalar
+#define YAMA_DISPATCH_KERNELS dispatch_kernels_scalar
+#include "dispatch_kernels.inl"
@@ -0,0 +1,15 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// the dispatched kernels for SSE2
+#undef YAMA_SIMD
+#define YAMA_SIMD YAMA_SIMD_SSE2
+#define YAMA_DISPATCH_ISA yama::dispatch::isa_sse2
+#define YAMA_DISPATCH_NAMESPACE yama_dispatch_sse2
+#define YAMA_DISPATCH_KERNELS dispatch_kernels_sse2
+#include "dispatch_kernels.inl"
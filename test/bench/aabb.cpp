@@ -0,0 +1,117 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/aabb.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration processes all points or boxes
+const size_t N = 16384;
+
+struct data_t
+{
+    data_t()
+        : points(N)
+        , boxes(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            points[i] = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+            boxes[i] = aabb::from_center_half_extents(points[i], v(r.next(0, 1), r.next(0, 1), r.next(0, 1)));
+        }
+        points_soa = vector3_soa::from_array(points.data(), N);
+        boxes_soa = aabb_soa::from_array(boxes.data(), N);
+        out = boxes_soa;
+
+        m = matrix3x4::translation(1, 2, 3) * matrix3x4::rotation_axis(v(1, 2, 3), 0.3f);
+    }
+
+    std::vector<vector3> points;
+    std::vector<aabb> boxes;
+    vector3_soa points_soa;
+    aabb_soa boxes_soa, out;
+    matrix3x4 m;
+};
+
+data_t& data()
+{
+    static data_t d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("aabb bounds x16384 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = aabb::empty();
+        for (const auto& p : d.points) b.merge(p);
+        bench::do_not_optimize(b);
+    }
+}
+
+YAMA_BENCH("aabb bounds x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = bounds(d.points.data(), N);
+        bench::do_not_optimize(b);
+    }
+}
+
+YAMA_BENCH("aabb bounds soa x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = bounds(d.points_soa);
+        bench::do_not_optimize(b);
+    }
+}
+
+YAMA_BENCH("aabb transform_aabb x16384 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = transform_aabb(d.boxes[i], d.m);
+        }
+        bench::do_not_optimize(d.out.min_x()[0]);
+    }
+}
+
+YAMA_BENCH("aabb transform_aabbs x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_aabbs(d.m, d.boxes_soa, d.out);
+        bench::do_not_optimize(d.out.min_x()[0]);
+    }
+}
+
+YAMA_BENCH("aabb merge soa x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        merge(d.boxes_soa, d.boxes_soa, d.out);
+        bench::do_not_optimize(d.out.min_x()[0]);
+    }
+}
@@ -0,0 +1,91 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/batch.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration transforms all points
+const size_t N = 1024;
+
+struct points
+{
+    points()
+        : in(N)
+        , out(N)
+        , ain(N)
+        , aout(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            in[i] = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+            ain[i] = in[i];
+        }
+        m = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    }
+
+    std::vector<vector3> in, out;
+    std::vector<vector3a, aligned_allocator<vector3a>> ain, aout;
+    matrix3x4 m;
+};
+
+points& data()
+{
+    static points d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x1024 (vector3)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x1024 (vector3a)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m, d.ain.data(), d.aout.data(), N);
+        bench::do_not_optimize(d.aout.front());
+    }
+}
+
+YAMA_BENCH("rotate x1024 (vector3)")
+{
+    auto& d = data();
+    const auto q = quaternion::rotation_axis(v(1, 2, 3), 0.3f);
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        rotate(q, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("rotate x1024 (vector3a)")
+{
+    auto& d = data();
+    const auto q = quaternion::rotation_axis(v(1, 2, 3), 0.3f);
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        rotate(q, d.ain.data(), d.aout.data(), N);
+        bench::do_not_optimize(d.aout.front());
+    }
+}
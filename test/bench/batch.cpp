@@ -0,0 +1,451 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/batch.hpp"
+#include "yama/soa.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration transforms all points
+const size_t N = 1024;
+
+struct points
+{
+    points()
+        : in(N)
+        , out(N)
+        , in2(N)
+        , out2(N)
+        , trs(N)
+        , mats(N)
+        , trs_mats(N)
+        , trs_out(N)
+    {
+        bench::random r;
+        for (auto& p : in)
+        {
+            p = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+        }
+
+        for (auto& p : in2)
+        {
+            p = v(r.next(-10, 10), r.next(-10, 10));
+        }
+
+        m34 = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+        m44 = matrix::perspective_fov_rh(1.2f, 1.5f, 1, 100) * matrix::translation(1, 2, -30);
+        m23 = matrix2x3::translation(3, 4) * matrix2x3::rotation(0.3f) * matrix2x3::scaling(2, 3);
+        tr = transform::trs(v(1, 2, 3), quaternion::rotation_axis(v(1, 2, 3), 0.3f), v(2, 3, 4));
+
+        for (auto& t : trs)
+        {
+            t = transform::trs(v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10)), quaternion::rotation_axis(v(r.next(-1, 1), r.next(-1, 1), 1), r.next(-3, 3)), r.next(0.5f, 2));
+        }
+        to_matrix3x4(trs.data(), trs_mats.data(), N);
+    }
+
+    std::vector<vector3> in, out;
+    std::vector<vector2> in2, out2;
+    matrix3x4 m34;
+    matrix4x4 m44;
+    matrix2x3 m23;
+    transform tr;
+    std::vector<transform> trs;
+    std::vector<matrix3x4> mats, trs_mats;
+    std::vector<transform> trs_out;
+};
+
+// an iteration interpolates all rotations
+struct rotations
+{
+    rotations()
+        : from(N)
+        , to(N)
+        , out(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            from[i] = quaternion::rotation_axis(normalize(v(r.next(-1, 1), r.next(-1, 1), 1)), r.next(-3, 3));
+            to[i] = quaternion::rotation_axis(normalize(v(r.next(-1, 1), 1, r.next(-1, 1))), r.next(-3, 3));
+            if (dot(from[i], to[i]) < 0) to[i] = -to[i]; // slerp doesn't take the shortest path
+        }
+        from_soa.assign(from.data(), N);
+        to_soa.assign(to.data(), N);
+    }
+
+    std::vector<quaternion> from, to, out;
+    quaternion_soa from_soa, to_soa, out_soa;
+};
+
+points& data()
+{
+    static points d;
+    return d;
+}
+
+rotations& rotation_data()
+{
+    static rotations d;
+    return d;
+}
+
+// an iteration builds a rotation for every angle
+struct angles
+{
+    angles()
+        : in(N)
+        , s(N)
+        , c(N)
+        , q(N)
+        , m(N)
+    {
+        bench::random r;
+        for (auto& a : in) a = r.next(-10, 10);
+    }
+
+    std::vector<float> in, s, c;
+    std::vector<quaternion> q;
+    std::vector<matrix3x4> m;
+};
+
+angles& angle_data()
+{
+    static angles d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("transform_coord matrix3x4 x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = transform_coord(d.in[i], d.m34);
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m34, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coord matrix4x4 x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = transform_coord(d.in[i], d.m44);
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coords matrix4x4 x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m44, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coord matrix2x3 x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out2[i] = transform_coord(d.in2[i], d.m23);
+        }
+        bench::do_not_optimize(d.out2.front());
+    }
+}
+
+YAMA_BENCH("transform_coords matrix2x3 x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m23, d.in2.data(), d.out2.data(), N);
+        bench::do_not_optimize(d.out2.front());
+    }
+}
+
+YAMA_BENCH("transform_coord transform x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = transform_coord(d.in[i], d.tr);
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coords transform x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.tr, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform to_matrix3x4 x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.mats[i] = d.trs[i].to_matrix3x4();
+        }
+        bench::do_not_optimize(d.mats.front());
+    }
+}
+
+YAMA_BENCH("transform to_matrix3x4 x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        to_matrix3x4(d.trs.data(), d.mats.data(), N);
+        bench::do_not_optimize(d.mats.front());
+    }
+}
+
+YAMA_BENCH("decompose x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.trs_out[i] = decompose(d.trs_mats[i]);
+        }
+        bench::do_not_optimize(d.trs_out.front());
+    }
+}
+
+YAMA_BENCH("decompose x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        decompose(d.trs_mats.data(), d.trs_out.data(), N);
+        bench::do_not_optimize(d.trs_out.front());
+    }
+}
+
+YAMA_BENCH("normalize x1024 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = normalize(d.in[i]);
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("fast_normalize x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        fast_normalize(d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("slerp x1024 (loop)")
+{
+    auto& d = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = slerp(d.from[i], d.to[i], 0.3f);
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("fast_slerp x1024")
+{
+    auto& d = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        fast_slerp(d.from.data(), d.to.data(), 0.3f, d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("fast_slerp soa x1024")
+{
+    auto& d = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        fast_slerp(d.from_soa, d.to_soa, 0.3f, d.out_soa);
+        bench::do_not_optimize(d.out_soa.x()[0]);
+    }
+}
+
+YAMA_BENCH("nlerp x1024")
+{
+    auto& d = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        nlerp(d.from.data(), d.to.data(), 0.3f, d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("quaternion multiply x1024 (loop)")
+{
+    auto& d = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = d.from[i] * d.to[i];
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("quaternion multiply x1024")
+{
+    auto& d = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        multiply(d.from.data(), d.to.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("quaternion rotate x1024 (loop)")
+{
+    auto& d = data();
+    auto& q = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.out[i] = rotate(d.in[i], q.from[i]);
+        }
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("quaternion rotate x1024")
+{
+    auto& d = data();
+    auto& q = rotation_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        rotate(q.from.data(), d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("sin and cos x1024 (loop)")
+{
+    auto& d = angle_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            sincos(d.in[i], d.s[i], d.c[i]);
+        }
+        bench::do_not_optimize(d.s.front());
+    }
+}
+
+YAMA_BENCH("fast_sincos x1024")
+{
+    auto& d = angle_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        fast_sincos(d.in.data(), d.s.data(), d.c.data(), N);
+        bench::do_not_optimize(d.s.front());
+    }
+}
+
+YAMA_BENCH("quaternion rotation_x x1024 (loop)")
+{
+    auto& d = angle_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.q[i] = quaternion::rotation_x(d.in[i]);
+        }
+        bench::do_not_optimize(d.q.front());
+    }
+}
+
+YAMA_BENCH("quaternion rotation_x x1024")
+{
+    auto& d = angle_data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        rotation_x(d.in.data(), d.q.data(), N);
+        bench::do_not_optimize(d.q.front());
+    }
+}
+
+YAMA_BENCH("matrix3x4 rotation_naxis x1024 (loop)")
+{
+    auto& d = angle_data();
+    const auto axis = normalize(v(1, 2, 3));
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.m[i] = matrix3x4::rotation_naxis(axis, d.in[i]);
+        }
+        bench::do_not_optimize(d.m.front());
+    }
+}
+
+YAMA_BENCH("matrix3x4 rotation_naxis x1024")
+{
+    auto& d = angle_data();
+    const auto axis = normalize(v(1, 2, 3));
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        rotation_naxis(axis, d.in.data(), d.m.data(), N);
+        bench::do_not_optimize(d.m.front());
+    }
+}
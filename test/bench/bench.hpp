@@ -0,0 +1,190 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+#include "yama/yama.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+namespace bench
+{
+
+// runs the measured code `iterations` times
+typedef void(*function)(size_t iterations);
+
+struct benchmark
+{
+    const char* name;
+    const char* type; // the scalar type
+    function func;
+};
+
+inline std::vector<benchmark>& registry()
+{
+    static std::vector<benchmark> r;
+    return r;
+}
+
+struct registrar
+{
+    registrar(const char* name, const char* type, function func)
+    {
+        benchmark b = { name, type, func };
+        registry().push_back(b);
+    }
+};
+
+template <typename T> const char* type_name();
+template <> inline const char* type_name<float>() { return "float"; }
+template <> inline const char* type_name<double>() { return "double"; }
+
+// keeps the compiler from optimizing away values which are never read
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// deterministic pseudo-random numbers in [min, max)
+class random
+{
+public:
+    explicit random(unsigned seed = 42) : m_state(seed) {}
+
+    float next(float min = 0, float max = 1)
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return min + (max - min) * float(m_state >> 8) / float(1 << 24);
+    }
+
+private:
+    unsigned m_state;
+};
+
+inline void randomize(float& s, random& r) { s = r.next(-1, 1); }
+inline void randomize(double& s, random& r) { s = r.next(-1, 1); }
+
+// any yama type: every component in [-1, 1)
+template <typename Y>
+void randomize(Y& y, random& r)
+{
+    for (auto& e : y) randomize(e, r);
+}
+
+// quaternions are rotations, as most of their operations expect unit length
+template <typename T>
+void randomize(yama::quaternion_t<T>& q, random& r)
+{
+    auto axis = yama::vector3_t<T>::coord(r.next(-1, 1), r.next(-1, 1), 1);
+    q = yama::quaternion_t<T>::rotation_axis(axis, r.next(-3, 3));
+}
+
+// transforms have a random rotation and a positive scale
+template <typename T>
+void randomize(yama::transform_t<T>& t, random& r)
+{
+    randomize(t.position, r);
+    randomize(t.orientation, r);
+    t.scale = yama::vector3_t<T>::coord(r.next(0.5f, 2), r.next(0.5f, 2), r.next(0.5f, 2));
+}
+
+// how many inputs the micro-benchmarks cycle through
+// small enough for the inputs to stay in the cache
+const size_t num_values = 1024;
+
+// num_values random values of a type
+// each set has a different seed, so that a and b in binary benchmarks differ
+template <typename Y>
+const std::vector<Y>& values(unsigned set)
+{
+    static std::vector<Y> sets[3];
+    auto& ret = sets[set];
+    if (ret.empty())
+    {
+        random r(42 + set);
+        ret.resize(num_values);
+        for (auto& y : ret) randomize(y, r);
+    }
+    return ret;
+}
+
+// run op on consecutive random inputs and keep the results
+template <typename A, typename Op>
+void run_unary(size_t iterations, Op op)
+{
+    auto& a = values<A>(0);
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        const auto i = it % num_values;
+        auto r = op(a[i]);
+        do_not_optimize(r);
+    }
+}
+
+template <typename A, typename B, typename Op>
+void run_binary(size_t iterations, Op op)
+{
+    auto& a = values<A>(0);
+    auto& b = values<B>(1);
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        const auto i = it % num_values;
+        auto r = op(a[i], b[i]);
+        do_not_optimize(r);
+    }
+}
+
+template <typename A, typename B, typename C, typename Op>
+void run_ternary(size_t iterations, Op op)
+{
+    auto& a = values<A>(0);
+    auto& b = values<B>(1);
+    auto& c = values<C>(2);
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        const auto i = it % num_values;
+        auto r = op(a[i], b[i], c[i]);
+        do_not_optimize(r);
+    }
+}
+
+}
+
+#define YAMA_BENCH_CAT_IMPL(a, b) a##b
+#define YAMA_BENCH_CAT(a, b) YAMA_BENCH_CAT_IMPL(a, b)
+
+// a benchmark of the preferred type
+#define YAMA_BENCH(name) \
+    static void YAMA_BENCH_CAT(bench_func_, __LINE__)(size_t iterations); \
+    static ::bench::registrar YAMA_BENCH_CAT(bench_reg_, __LINE__)(name, ::bench::type_name<yama::preferred_type>(), YAMA_BENCH_CAT(bench_func_, __LINE__)); \
+    static void YAMA_BENCH_CAT(bench_func_, __LINE__)(size_t iterations)
+
+// a benchmark template on the scalar type T, registered for float and double
+#define YAMA_BENCH_T(name) \
+    template <typename T> static void YAMA_BENCH_CAT(bench_func_, __LINE__)(size_t iterations); \
+    static ::bench::registrar YAMA_BENCH_CAT(bench_reg_f_, __LINE__)(name, "float", YAMA_BENCH_CAT(bench_func_, __LINE__)<float>); \
+    static ::bench::registrar YAMA_BENCH_CAT(bench_reg_d_, __LINE__)(name, "double", YAMA_BENCH_CAT(bench_func_, __LINE__)<double>); \
+    template <typename T> static void YAMA_BENCH_CAT(bench_func_, __LINE__)(size_t iterations)
+
+// micro-benchmarks of a single expression of random inputs `a`, `b` and `c` of the given types
+// the types may depend on T, for example YAMA_BENCH_BINARY("vector3 dot", vector3_t<T>, vector3_t<T>, dot(a, b))
+#define YAMA_BENCH_UNARY(name, A, expr) \
+    YAMA_BENCH_T(name) { ::bench::run_unary<A>(iterations, [](A a) { return expr; }); }
+
+#define YAMA_BENCH_BINARY(name, A, B, expr) \
+    YAMA_BENCH_T(name) { ::bench::run_binary<A, B>(iterations, [](A a, B b) { return expr; }); }
+
+#define YAMA_BENCH_TERNARY(name, A, B, C, expr) \
+    YAMA_BENCH_T(name) { ::bench::run_ternary<A, B, C>(iterations, [](A a, B b, C c) { return expr; }); }
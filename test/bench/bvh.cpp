@@ -0,0 +1,155 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/bvh.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// a mesh of N triangles, queried by R rays
+const size_t N = 65536;
+const size_t R = 64;
+
+struct data_t
+{
+    data_t()
+        : bounds(N)
+        , moved(N)
+        , hits(R)
+    {
+        bench::random r;
+
+        // a bumpy grid, like terrain
+        const size_t side = 182;
+        for (size_t y = 0; y < side; ++y)
+        {
+            for (size_t x = 0; x < side; ++x)
+            {
+                vertices.push_back(v(float(x), r.next(-1, 1), float(y)));
+            }
+        }
+        for (size_t y = 0; y + 1 < side && indices.size() < N * 3; ++y)
+        {
+            for (size_t x = 0; x + 1 < side && indices.size() < N * 3; ++x)
+            {
+                const uint32_t i = uint32_t(y * side + x);
+                const uint32_t quad[] = { i, i + 1, i + uint32_t(side), i + 1, i + uint32_t(side) + 1, i + uint32_t(side) };
+                indices.insert(indices.end(), quad, quad + 6);
+            }
+        }
+        indices.resize(N * 3);
+        triangle_bounds(vertices.data(), indices.data(), N, bounds.data());
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            moved[i] = aabb::from_min_max(bounds[i].min + v(0, 0.1f, 0), bounds[i].max + v(0, 0.1f, 0));
+        }
+
+        tree.build(bounds.data(), N);
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            const auto target = v(r.next(0, 180), 0, r.next(0, 180));
+            rays.push_back(ray::from_points(target + v(r.next(-50, 50), 30, r.next(-50, 50)), target));
+        }
+    }
+
+    std::vector<vector3> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<aabb> bounds, moved;
+    bvh tree;
+    std::vector<ray> rays;
+    std::vector<ray_hit> hits;
+};
+
+data_t& data()
+{
+    static data_t d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("bvh build x65536")
+{
+    auto& d = data();
+    bvh b;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        b.build(d.bounds.data(), N);
+        bench::do_not_optimize(b.nodes()[0]);
+    }
+}
+
+YAMA_BENCH("bvh build x65536 (pool)")
+{
+    auto& d = data();
+    bvh b;
+    parallel::thread_pool pool;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        b.build(pool, d.bounds.data(), N);
+        bench::do_not_optimize(b.nodes()[0]);
+    }
+}
+
+YAMA_BENCH("bvh refit x65536")
+{
+    auto& d = data();
+    bvh b = d.tree;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        b.refit(it % 2 ? d.bounds.data() : d.moved.data());
+        bench::do_not_optimize(b.nodes()[0]);
+    }
+}
+
+YAMA_BENCH("bvh ray x64 mesh x65536 (batch)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        intersect(d.rays.data(), R, d.vertices.data(), d.indices.data(), N, d.hits.data());
+        bench::do_not_optimize(d.hits[0]);
+    }
+}
+
+YAMA_BENCH("bvh ray x64 mesh x65536")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            d.hits[i] = intersect(d.rays[i], d.tree, d.vertices.data(), d.indices.data());
+        }
+        bench::do_not_optimize(d.hits[0]);
+    }
+}
+
+YAMA_BENCH("bvh nearest x64 mesh x65536")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            const auto p = d.rays[i].origin;
+            float dist = std::numeric_limits<float>::max();
+            const auto n = d.tree.nearest(p, dist, [&](size_t tri) {
+                const auto c = (d.bounds[tri].center() - p);
+                return dot(c, c);
+            });
+            bench::do_not_optimize(n);
+        }
+    }
+}
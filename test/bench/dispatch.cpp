@@ -0,0 +1,78 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/dispatch.hpp"
+#include "yama/batch.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration transforms and rotates all points with the kernels of one
+// instruction set, or does nothing if the CPU doesn't support it
+const size_t N = 1024;
+
+struct points
+{
+    points()
+        : in(N)
+        , out(N)
+    {
+        bench::random r;
+        for (auto& p : in)
+        {
+            p = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+        }
+        m = matrix::perspective_fov_rh(1.2f, 1.5f, 1, 100) * matrix::translation(1, 2, -30);
+        q = quaternion::rotation_axis(v(1, 2, 3), 0.3f);
+    }
+
+    std::vector<vector3> in, out;
+    matrix4x4 m;
+    quaternion q;
+};
+
+points& data()
+{
+    static points p;
+    return p;
+}
+
+void run(dispatch::isa_t isa, size_t iterations)
+{
+    auto& d = data();
+    if (!dispatch::force_isa(isa)) return;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        dispatch::transform_coords(d.m, d.in.data(), d.out.data(), N);
+        dispatch::rotate(d.q, d.out.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out[0]);
+    }
+    dispatch::reset_isa();
+}
+
+}
+
+YAMA_BENCH("dispatch transform_coords+rotate x1024 (header)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m, d.in.data(), d.out.data(), N);
+        rotate(d.q, d.out.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out[0]);
+    }
+}
+
+YAMA_BENCH("dispatch transform_coords+rotate x1024 (scalar)") { run(dispatch::isa_scalar, iterations); }
+YAMA_BENCH("dispatch transform_coords+rotate x1024 (sse2)") { run(dispatch::isa_sse2, iterations); }
+YAMA_BENCH("dispatch transform_coords+rotate x1024 (avx2)") { run(dispatch::isa_avx2, iterations); }
+YAMA_BENCH("dispatch transform_coords+rotate x1024 (avx512)") { run(dispatch::isa_avx512, iterations); }
@@ -0,0 +1,93 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/expr.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration updates all particles
+const size_t N = 16384;
+
+struct particles
+{
+    particles()
+        : position(N)
+        , velocity(N)
+        , drag(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            position[i] = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+            velocity[i] = v(r.next(-1, 1), r.next(-1, 1), r.next(-1, 1));
+            drag[i] = r.next(0.9f, 1);
+        }
+        position_soa.assign(position.data(), N);
+        velocity_soa.assign(velocity.data(), N);
+    }
+
+    std::vector<vector3> position, velocity;
+    std::vector<float> drag;
+    vector3_soa position_soa, velocity_soa;
+};
+
+particles& data()
+{
+    static particles d;
+    return d;
+}
+
+const float dt = 0.01f;
+// no zero components, which would decay to denormals
+const vector3 force = v(0.5f, -9.8f, 0.3f);
+
+}
+
+YAMA_BENCH("particles x16384 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.velocity[i] = d.velocity[i] * d.drag[i] + force * dt;
+            d.position[i] = d.position[i] + d.velocity[i] * dt;
+        }
+        bench::do_not_optimize(d.position.front());
+    }
+}
+
+YAMA_BENCH("particles x16384 (expr)")
+{
+    auto& d = data();
+    const auto p = expr::ref(d.position.data(), N);
+    const auto vel = expr::ref(d.velocity.data(), N);
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        expr::assign(d.velocity.data(), vel * expr::ref(d.drag.data(), N) + force * dt);
+        expr::assign(d.position.data(), p + vel * dt);
+        bench::do_not_optimize(d.position.front());
+    }
+}
+
+YAMA_BENCH("particles x16384 (soa expr)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        const auto vel = expr::ref(d.velocity_soa);
+        expr::assign(d.velocity_soa, vel * expr::ref(d.drag.data(), N) + force * dt);
+        expr::assign(d.position_soa, expr::ref(d.position_soa) + vel * dt);
+        bench::do_not_optimize(d.position_soa.x()[0]);
+    }
+}
@@ -0,0 +1,100 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/frustum.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration culls all objects, like a view of a large scene
+const size_t N = 200000;
+
+struct scene
+{
+    scene()
+        : mask((N + 31) / 32)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto c = v(r.next(-500, 500), r.next(-50, 50), r.next(-500, 500));
+            const auto e = v(r.next(0.5f, 5), r.next(0.5f, 5), r.next(0.5f, 5));
+            spheres.push_back(vector4::coord(c.x, c.y, c.z, e.length()));
+            mins.push_back(c - e);
+            maxs.push_back(c + e);
+            centers.push_back(c);
+            extents.push_back(e);
+            orientations.push_back(quaternion::rotation_axis(v(r.next(-1, 1), r.next(-1, 1), 1), r.next(-3, 3)));
+        }
+
+        const auto view = matrix::look_at_rh(v(0, 10, 0), v(100, 0, -100), v(0, 1, 0));
+        f = frustum::from_view_projection(matrix::perspective_fov_rh(1.2f, 1.6f, 0.5f, 400) * view);
+    }
+
+    vector4_soa spheres;
+    vector3_soa mins, maxs, centers, extents;
+    quaternion_soa orientations;
+    std::vector<uint32_t> mask;
+    frustum f;
+};
+
+scene& data()
+{
+    static scene d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("frustum cull_spheres x200000")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        cull_spheres(d.f, d.spheres, d.mask.data());
+        bench::do_not_optimize(d.mask[0]);
+    }
+}
+
+YAMA_BENCH("frustum intersects_sphere x200000 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            const vector4 s = d.spheres[i];
+            d.mask[i / 32] |= uint32_t(d.f.intersects_sphere(v(s.x, s.y, s.z), s.w)) << (i % 32);
+        }
+        bench::do_not_optimize(d.mask[0]);
+    }
+}
+
+YAMA_BENCH("frustum cull_aabbs x200000")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        cull_aabbs(d.f, d.mins, d.maxs, d.mask.data());
+        bench::do_not_optimize(d.mask[0]);
+    }
+}
+
+YAMA_BENCH("frustum cull_obbs x200000")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        cull_obbs(d.f, d.centers, d.extents, d.orientations, d.mask.data());
+        bench::do_not_optimize(d.mask[0]);
+    }
+}
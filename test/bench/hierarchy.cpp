@@ -0,0 +1,133 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/hierarchy.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration updates the world transformations of a scene of N nodes
+const size_t N = 65536;
+const size_t root_count = 16;
+
+// a random tree, parents before children, and a few nodes which change every frame
+struct data_t
+{
+    data_t()
+        : parents(N)
+        , locals(N)
+        , children(N)
+        , worlds(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            parents[i] = i < root_count ? hierarchy::no_parent : size_t(r.next(0, float(i)));
+            locals[i] = matrix3x4::translation(r.next(-1, 1), r.next(-1, 1), r.next(-1, 1)) * matrix3x4::rotation_axis(v(r.next(-1, 1), r.next(-1, 1), 1), r.next(-3, 3));
+            if (i >= root_count) children[parents[i]].push_back(i);
+            if (i % 100 == 0) moving.push_back(i);
+        }
+        h = hierarchy(parents.data(), locals.data(), N);
+    }
+
+    // the recursive walk over child lists which hierarchy_t replaces
+    void walk(size_t i, const matrix3x4& parent_world)
+    {
+        worlds[i] = parent_world * locals[i];
+        for (auto c : children[i]) walk(c, worlds[i]);
+    }
+
+    std::vector<size_t> parents;
+    std::vector<matrix3x4> locals;
+    std::vector<std::vector<size_t>> children;
+    std::vector<matrix3x4> worlds;
+    std::vector<size_t> moving;
+    hierarchy h;
+};
+
+data_t& data()
+{
+    static data_t d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("hierarchy recursive walk x65536 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < root_count; ++i) d.walk(i, matrix3x4::identity());
+        bench::do_not_optimize(d.worlds.back());
+    }
+}
+
+YAMA_BENCH("hierarchy update x65536")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < root_count; ++i) d.h.mark_dirty(i);
+        d.h.update();
+        bench::do_not_optimize(d.h.worlds()[N - 1]);
+    }
+}
+
+YAMA_BENCH("hierarchy update x65536, 1% changed")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (auto i : d.moving) d.h.set_local(i, d.locals[i]);
+        d.h.update();
+        bench::do_not_optimize(d.h.worlds()[N - 1]);
+    }
+}
+
+// a leaf deep in the tree, which costs about as much as its subtree
+YAMA_BENCH("hierarchy update x65536, one leaf changed")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        d.h.set_local(N - 1, d.locals[N - 1]);
+        d.h.update();
+        bench::do_not_optimize(d.h.worlds()[N - 1]);
+    }
+}
+
+YAMA_BENCH("hierarchy update x65536, static")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        d.h.update();
+        bench::do_not_optimize(d.h.worlds()[N - 1]);
+    }
+}
+
+#if YAMA_THREADS
+
+YAMA_BENCH("hierarchy update x65536 (pool)")
+{
+    auto& d = data();
+    parallel::thread_pool pool;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < root_count; ++i) d.h.mark_dirty(i);
+        d.h.update(pool);
+        bench::do_not_optimize(d.h.worlds()[N - 1]);
+    }
+}
+
+#endif
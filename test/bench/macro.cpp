@@ -0,0 +1,220 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+// macro-benchmarks: whole scenarios, built with the scalar api only
+// their times are per scenario run, not per element
+
+using namespace yama;
+
+namespace
+{
+
+template <typename T>
+matrix3x4_t<T> random_rigid(bench::random& r)
+{
+    auto axis = vector3_t<T>::coord(r.next(-1, 1), r.next(-1, 1), 1);
+    return matrix3x4_t<T>::translation(r.next(-5, 5), r.next(-5, 5), r.next(-5, 5))
+        * matrix3x4_t<T>::rotation_axis(axis, r.next(-3, 3));
+}
+
+// a scene graph of nodes with a transformation relative to their parent
+// the nodes are sorted so that parents come before their children
+template <typename T>
+struct scene
+{
+    static const size_t node_count = 1023;
+
+    scene()
+    {
+        bench::random r(1);
+        for (size_t i = 0; i < node_count; ++i)
+        {
+            parents[i] = i == 0 ? 0 : size_t(r.next(0, float(i)));
+            locals[i] = random_rigid<T>(r) * matrix3x4_t<T>::scaling_uniform(r.next(0.5f, 2));
+        }
+    }
+
+    void update()
+    {
+        worlds[0] = locals[0];
+        for (size_t i = 1; i < node_count; ++i)
+        {
+            worlds[i] = worlds[parents[i]] * locals[i];
+        }
+    }
+
+    size_t parents[node_count];
+    matrix3x4_t<T> locals[node_count];
+    matrix3x4_t<T> worlds[node_count];
+};
+
+// linear blend skinning of a mesh with up to four bones per vertex
+template <typename T>
+struct skinned_mesh
+{
+    static const size_t vertex_count = 2048;
+    static const size_t bone_count = 64;
+
+    struct vertex
+    {
+        vector3_t<T> position;
+        vector3_t<T> normal;
+        unsigned bones[4];
+        T weights[4];
+    };
+
+    skinned_mesh()
+    {
+        bench::random r(2);
+        for (auto& b : palette)
+        {
+            b = random_rigid<T>(r);
+        }
+
+        for (auto& v : vertices)
+        {
+            v.position = vector3_t<T>::coord(r.next(-1, 1), r.next(-1, 1), r.next(-1, 1));
+            v.normal = normalize(vector3_t<T>::coord(r.next(-1, 1), r.next(-1, 1), 1));
+
+            T sum = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                v.bones[i] = unsigned(r.next(0, float(bone_count)));
+                v.weights[i] = r.next(0.1f, 1);
+                sum += v.weights[i];
+            }
+            for (auto& w : v.weights) w /= sum;
+        }
+    }
+
+    void skin()
+    {
+        for (size_t i = 0; i < vertex_count; ++i)
+        {
+            const auto& v = vertices[i];
+            auto m = palette[v.bones[0]] * v.weights[0];
+            m += palette[v.bones[1]] * v.weights[1];
+            m += palette[v.bones[2]] * v.weights[2];
+            m += palette[v.bones[3]] * v.weights[3];
+
+            positions[i] = transform_coord(v.position, m);
+            normals[i] = normalize(m.column_vector(0) * v.normal.x + m.column_vector(1) * v.normal.y + m.column_vector(2) * v.normal.z);
+        }
+    }
+
+    matrix3x4_t<T> palette[bone_count];
+    vertex vertices[vertex_count];
+    vector3_t<T> positions[vertex_count];
+    vector3_t<T> normals[vertex_count];
+};
+
+// bounding spheres tested against the planes of a view frustum
+template <typename T>
+struct culling
+{
+    static const size_t object_count = 4096;
+
+    culling()
+    {
+        bench::random r(3);
+        for (size_t i = 0; i < object_count; ++i)
+        {
+            centers[i] = vector3_t<T>::coord(r.next(-100, 100), r.next(-100, 100), r.next(-100, 100));
+            radii[i] = r.next(0.5f, 5);
+        }
+    }
+
+    // the planes of a view-projection matrix with a [0, 1] depth range, pointing inwards
+    void set_camera(const matrix4x4_t<T>& view_proj)
+    {
+        const auto r0 = view_proj.row_vector(0);
+        const auto r1 = view_proj.row_vector(1);
+        const auto r2 = view_proj.row_vector(2);
+        const auto r3 = view_proj.row_vector(3);
+        planes[0] = r3 + r0;
+        planes[1] = r3 - r0;
+        planes[2] = r3 + r1;
+        planes[3] = r3 - r1;
+        planes[4] = r2;
+        planes[5] = r3 - r2;
+
+        for (auto& p : planes)
+        {
+            p /= std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        }
+    }
+
+    size_t cull()
+    {
+        size_t visible = 0;
+        for (size_t i = 0; i < object_count; ++i)
+        {
+            const auto& c = centers[i];
+            bool inside = true;
+            for (const auto& p : planes)
+            {
+                if (p.x*c.x + p.y*c.y + p.z*c.z + p.w < -radii[i])
+                {
+                    inside = false;
+                    break;
+                }
+            }
+            visible += inside;
+        }
+        return visible;
+    }
+
+    vector3_t<T> centers[object_count];
+    T radii[object_count];
+    vector4_t<T> planes[6];
+};
+
+template <typename Scenario>
+Scenario& instance()
+{
+    static Scenario s;
+    return s;
+}
+
+}
+
+YAMA_BENCH_T("scene graph update (1023 nodes)")
+{
+    auto& s = instance<scene<T>>();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        s.update();
+        bench::do_not_optimize(s.worlds[scene<T>::node_count - 1]);
+    }
+}
+
+YAMA_BENCH_T("skinning (2048 vertices, 4 bones)")
+{
+    auto& s = instance<skinned_mesh<T>>();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        s.skin();
+        bench::do_not_optimize(s.positions[skinned_mesh<T>::vertex_count - 1]);
+    }
+}
+
+YAMA_BENCH_T("culling (4096 spheres)")
+{
+    auto& s = instance<culling<T>>();
+    const auto proj = matrix4x4_t<T>::perspective_fov_rh(T(1), T(1.5), T(1), T(200));
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        // a camera turning around the origin, so that the visible set changes
+        const auto angle = T(it % 64) * T(0.1);
+        const auto eye = vector3_t<T>::coord(std::cos(angle), 0, std::sin(angle)) * T(10);
+        s.set_camera(proj * matrix4x4_t<T>::look_at_rh(eye, vector3_t<T>::zero(), vector3_t<T>::coord(0, 1, 0)));
+        auto visible = s.cull();
+        bench::do_not_optimize(visible);
+    }
+}
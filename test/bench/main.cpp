@@ -0,0 +1,115 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using std::chrono::duration;
+using std::chrono::high_resolution_clock;
+
+namespace
+{
+
+double run_seconds(size_t iterations, bench::function func)
+{
+    auto start = high_resolution_clock::now();
+    func(iterations);
+    return duration<double>(high_resolution_clock::now() - start).count();
+}
+
+struct result
+{
+    const bench::benchmark* b;
+    size_t iterations;
+    double ns;
+};
+
+void print_json_string(FILE* f, const char* str)
+{
+    fputc('"', f);
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\') fputc('\\', f);
+        fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+bool write_json(const char* path, const std::vector<result>& results)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+
+    fprintf(f, "{\n    \"simd\": %d,\n    \"benchmarks\": [\n", YAMA_SIMD);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        fprintf(f, "        { \"name\": ");
+        print_json_string(f, r.b->name);
+        fprintf(f, ", \"type\": ");
+        print_json_string(f, r.b->type);
+        fprintf(f, ", \"iterations\": %zu, \"ns_per_iter\": %.3f }%s\n", r.iterations, r.ns, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "    ]\n}\n");
+
+    return fclose(f) == 0;
+}
+
+}
+
+// yama-bench [--json <file>] [filter]
+int main(int argc, char* argv[])
+{
+    const char* filter = nullptr;
+    const char* json = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            json = argv[++i];
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    std::vector<result> results;
+
+    printf("%-48s %-8s %14s %12s\n", "benchmark", "type", "iterations", "ns/iter");
+
+    for (auto& b : bench::registry())
+    {
+        if (filter && !strstr(b.name, filter))
+            continue;
+
+        // grow the iteration count until a run takes long enough to be measured reliably
+        size_t iterations = 1;
+        double time = run_seconds(iterations, b.func);
+        while (time < 0.1)
+        {
+            iterations *= time < 0.01 ? 10 : 2;
+            time = run_seconds(iterations, b.func);
+        }
+
+        result r = { &b, iterations, time * 1e9 / double(iterations) };
+        results.push_back(r);
+
+        printf("%-48s %-8s %14zu %12.3f\n", b.name, b.type, iterations, r.ns);
+    }
+
+    if (json && !write_json(json, results))
+    {
+        fprintf(stderr, "yama-bench: could not write %s\n", json);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+// construction
+YAMA_BENCH_UNARY("matrix2x3 rotation", T, matrix2x3_t<T>::rotation(a))
+
+// arithmetic
+YAMA_BENCH_BINARY("matrix2x3 operator*", matrix2x3_t<T>, matrix2x3_t<T>, a * b)
+YAMA_BENCH_BINARY("matrix2x3 operator*=", matrix2x3_t<T>, matrix2x3_t<T>, a *= b)
+YAMA_BENCH_UNARY("matrix2x3 inverse", matrix2x3_t<T>, inverse(a))
+
+// transformations
+YAMA_BENCH_BINARY("matrix2x3 transform_coord", vector2_t<T>, matrix2x3_t<T>, transform_coord(a, b))
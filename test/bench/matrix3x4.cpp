@@ -0,0 +1,45 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+// construction
+YAMA_BENCH_BINARY("matrix3x4 rotation_axis", vector3_t<T>, T, matrix3x4_t<T>::rotation_axis(a, b))
+YAMA_BENCH_BINARY("matrix3x4 rotation_naxis", vector3_t<T>, T, matrix3x4_t<T>::rotation_naxis(normalize(a), b))
+YAMA_BENCH_UNARY("matrix3x4 rotation_x", T, matrix3x4_t<T>::rotation_x(a))
+YAMA_BENCH_UNARY("matrix3x4 rotation_y", T, matrix3x4_t<T>::rotation_y(a))
+YAMA_BENCH_UNARY("matrix3x4 rotation_z", T, matrix3x4_t<T>::rotation_z(a))
+YAMA_BENCH_BINARY("matrix3x4 rotation_x_sincos", T, T, matrix3x4_t<T>::rotation_x_sincos(a, b))
+YAMA_BENCH_BINARY("matrix3x4 rotation_vectors", vector3_t<T>, vector3_t<T>, matrix3x4_t<T>::rotation_vectors(normalize(a), normalize(b)))
+YAMA_BENCH_UNARY("matrix3x4 rotation_quaternion", quaternion_t<T>, matrix3x4_t<T>::rotation_quaternion(a))
+YAMA_BENCH_UNARY("matrix3x4 translation", vector3_t<T>, matrix3x4_t<T>::translation(a))
+YAMA_BENCH_UNARY("matrix3x4 scaling", vector3_t<T>, matrix3x4_t<T>::scaling(a))
+YAMA_BENCH_UNARY("matrix3x4 scaling_uniform", T, matrix3x4_t<T>::scaling_uniform(a))
+// a rotation, as to_quaternion expects one
+YAMA_BENCH_UNARY("matrix3x4 to_quaternion", quaternion_t<T>, matrix3x4_t<T>::rotation_quaternion(a).to_quaternion())
+
+// arithmetic
+YAMA_BENCH_BINARY("matrix3x4 operator+", matrix3x4_t<T>, matrix3x4_t<T>, a + b)
+YAMA_BENCH_BINARY("matrix3x4 operator-", matrix3x4_t<T>, matrix3x4_t<T>, a - b)
+YAMA_BENCH_BINARY("matrix3x4 operator/ (scalar)", matrix3x4_t<T>, T, a / b)
+YAMA_BENCH_BINARY("matrix3x4 operator==", matrix3x4_t<T>, matrix3x4_t<T>, a == b)
+YAMA_BENCH_BINARY("matrix3x4 close", matrix3x4_t<T>, matrix3x4_t<T>, close(a, b))
+YAMA_BENCH_UNARY("matrix3x4 abs", matrix3x4_t<T>, abs(a))
+YAMA_BENCH_UNARY("matrix3x4 isfinite", matrix3x4_t<T>, isfinite(a))
+YAMA_BENCH_BINARY("matrix3x4 operator* (scalar)", matrix3x4_t<T>, T, a * b)
+YAMA_BENCH_BINARY("matrix3x4 operator*", matrix3x4_t<T>, matrix3x4_t<T>, a * b)
+YAMA_BENCH_BINARY("matrix3x4 operator*=", matrix3x4_t<T>, matrix3x4_t<T>, a *= b)
+YAMA_BENCH_UNARY("matrix3x4 transpose", matrix3x4_t<T>, a.transpose())
+YAMA_BENCH_UNARY("matrix3x4 determinant", matrix3x4_t<T>, a.determinant())
+YAMA_BENCH_UNARY("matrix3x4 inverse", matrix3x4_t<T>, inverse(a))
+YAMA_BENCH_UNARY("matrix3x4 inverse_rigid", matrix3x4_t<T>, inverse_rigid(a))
+YAMA_BENCH_UNARY("matrix3x4 inverse_affine", matrix3x4_t<T>, inverse_affine(a))
+
+// transformations
+YAMA_BENCH_BINARY("matrix3x4 transform_coord", vector3_t<T>, matrix3x4_t<T>, transform_coord(a, b))
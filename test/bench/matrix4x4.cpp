@@ -0,0 +1,151 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+namespace
+{
+
+const size_t N = 1024;
+
+struct matrices
+{
+    matrices()
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            for (auto& e : a[i]) e = r.next(-1, 1);
+            for (auto& e : b[i]) e = r.next(-1, 1);
+            rigid[i] = matrix::rotation_axis(v(r.next(-1, 1), r.next(-1, 1), 1), r.next(-3, 3)) * matrix::translation(r.next(-9, 9), r.next(-9, 9), r.next(-9, 9));
+        }
+    }
+
+    matrix4x4 a[N], b[N], c[N];
+    matrix4x4 rigid[N]; // rotation and translation, like cameras and bones
+};
+
+matrices& data()
+{
+    static matrices d;
+    return d;
+}
+
+}
+
+// operator*<float> explicitly picks the generic scalar template
+YAMA_BENCH("matrix4x4 operator* (scalar)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto i = it % N;
+        d.c[i] = operator*<float>(d.a[i], d.b[i]);
+        bench::do_not_optimize(d.c[i]);
+    }
+}
+
+YAMA_BENCH("matrix4x4 operator*")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto i = it % N;
+        d.c[i] = d.a[i] * d.b[i];
+        bench::do_not_optimize(d.c[i]);
+    }
+}
+
+YAMA_BENCH("matrix4x4 operator*=")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto i = it % N;
+        d.c[i] = d.a[i];
+        d.c[i] *= d.b[i];
+        bench::do_not_optimize(d.c[i]);
+    }
+}
+
+// the results are kept on the stack, as storing them to c would 4K-alias the loads from rigid
+
+YAMA_BENCH("matrix4x4 inverse")
+{
+    auto& d = data();
+    float det;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto m = inverse(d.rigid[it % N], det);
+        bench::do_not_optimize(m);
+    }
+}
+
+YAMA_BENCH("matrix4x4 inverse_affine")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto m = inverse_affine(d.rigid[it % N]);
+        bench::do_not_optimize(m);
+    }
+}
+
+YAMA_BENCH("matrix4x4 inverse_rigid")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto m = inverse_rigid(d.rigid[it % N]);
+        bench::do_not_optimize(m);
+    }
+}
+
+// micro-benchmarks of random inputs, for float and double
+
+YAMA_BENCH_BINARY("matrix4x4 look_at_rh", vector3_t<T>, vector3_t<T>, matrix4x4_t<T>::look_at_rh(a, b, vector3_t<T>::coord(0, 1, 0)))
+YAMA_BENCH_BINARY("matrix4x4 perspective_fov_rh", T, T, matrix4x4_t<T>::perspective_fov_rh(T(1) + a * T(0.5), T(1.5) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 look_at_lh", vector3_t<T>, vector3_t<T>, matrix4x4_t<T>::look_at_lh(a, b, vector3_t<T>::coord(0, 1, 0)))
+YAMA_BENCH_BINARY("matrix4x4 look_towards_rh", vector3_t<T>, vector3_t<T>, matrix4x4_t<T>::look_towards_rh(a, b, vector3_t<T>::coord(0, 1, 0)))
+YAMA_BENCH_BINARY("matrix4x4 look_towards_lh", vector3_t<T>, vector3_t<T>, matrix4x4_t<T>::look_towards_lh(a, b, vector3_t<T>::coord(0, 1, 0)))
+YAMA_BENCH_TERNARY("matrix4x4 basis_transform", vector3_t<T>, vector3_t<T>, vector3_t<T>, matrix4x4_t<T>::basis_transform(a, b, c, cross(b, c)))
+YAMA_BENCH_BINARY("matrix4x4 perspective_fov_lh", T, T, matrix4x4_t<T>::perspective_fov_lh(T(1) + a * T(0.5), T(1.5) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 perspective_fov_rh_cube", T, T, matrix4x4_t<T>::perspective_fov_rh_cube(T(1) + a * T(0.5), T(1.5) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 perspective_rh", T, T, matrix4x4_t<T>::perspective_rh(T(2) + a, T(2) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 perspective_lh", T, T, matrix4x4_t<T>::perspective_lh(T(2) + a, T(2) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 perspective_rh (off-center)", T, T, matrix4x4_t<T>::perspective_rh(a - T(2), a + T(2), b - T(2), b + T(2), T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 ortho_rh", T, T, matrix4x4_t<T>::ortho_rh(T(2) + a, T(2) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 ortho_lh", T, T, matrix4x4_t<T>::ortho_lh(T(2) + a, T(2) + b, T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 ortho_rh (off-center)", T, T, matrix4x4_t<T>::ortho_rh(a - T(2), a + T(2), b - T(2), b + T(2), T(1), T(1000)))
+YAMA_BENCH_BINARY("matrix4x4 rotation_axis", vector3_t<T>, T, matrix4x4_t<T>::rotation_axis(a, b))
+YAMA_BENCH_BINARY("matrix4x4 rotation_naxis", vector3_t<T>, T, matrix4x4_t<T>::rotation_naxis(normalize(a), b))
+YAMA_BENCH_UNARY("matrix4x4 rotation_x", T, matrix4x4_t<T>::rotation_x(a))
+YAMA_BENCH_UNARY("matrix4x4 rotation_y", T, matrix4x4_t<T>::rotation_y(a))
+YAMA_BENCH_UNARY("matrix4x4 rotation_z", T, matrix4x4_t<T>::rotation_z(a))
+YAMA_BENCH_BINARY("matrix4x4 rotation_x_sincos", T, T, matrix4x4_t<T>::rotation_x_sincos(a, b))
+YAMA_BENCH_BINARY("matrix4x4 rotation_vectors", vector3_t<T>, vector3_t<T>, matrix4x4_t<T>::rotation_vectors(normalize(a), normalize(b)))
+YAMA_BENCH_UNARY("matrix4x4 rotation_quaternion", quaternion_t<T>, matrix4x4_t<T>::rotation_quaternion(a))
+YAMA_BENCH_UNARY("matrix4x4 translation", vector3_t<T>, matrix4x4_t<T>::translation(a))
+YAMA_BENCH_UNARY("matrix4x4 scaling", vector3_t<T>, matrix4x4_t<T>::scaling(a))
+YAMA_BENCH_UNARY("matrix4x4 scaling_uniform", T, matrix4x4_t<T>::scaling_uniform(a))
+// a rotation, as to_quaternion expects one
+YAMA_BENCH_UNARY("matrix4x4 to_quaternion", quaternion_t<T>, matrix4x4_t<T>::rotation_quaternion(a).to_quaternion())
+YAMA_BENCH_BINARY("matrix4x4 operator+", matrix4x4_t<T>, matrix4x4_t<T>, a + b)
+YAMA_BENCH_BINARY("matrix4x4 operator-", matrix4x4_t<T>, matrix4x4_t<T>, a - b)
+YAMA_BENCH_BINARY("matrix4x4 operator/ (scalar)", matrix4x4_t<T>, T, a / b)
+YAMA_BENCH_BINARY("matrix4x4 operator==", matrix4x4_t<T>, matrix4x4_t<T>, a == b)
+YAMA_BENCH_BINARY("matrix4x4 close", matrix4x4_t<T>, matrix4x4_t<T>, close(a, b))
+YAMA_BENCH_UNARY("matrix4x4 abs", matrix4x4_t<T>, abs(a))
+YAMA_BENCH_UNARY("matrix4x4 isfinite", matrix4x4_t<T>, isfinite(a))
+YAMA_BENCH_BINARY("matrix4x4 operator* (random)", matrix4x4_t<T>, matrix4x4_t<T>, a * b)
+YAMA_BENCH_UNARY("matrix4x4 transpose", matrix4x4_t<T>, a.transpose())
+YAMA_BENCH_UNARY("matrix4x4 determinant", matrix4x4_t<T>, a.determinant())
+YAMA_BENCH_UNARY("matrix4x4 inverse (random)", matrix4x4_t<T>, inverse(a))
+YAMA_BENCH_UNARY("matrix4x4 inverse_affine (random)", matrix4x4_t<T>, inverse_affine(a))
+YAMA_BENCH_BINARY("matrix4x4 transform_coord", vector3_t<T>, matrix4x4_t<T>, transform_coord(a, b))
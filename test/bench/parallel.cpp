@@ -0,0 +1,100 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/batch.hpp"
+#include "yama/aabb.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration processes all points
+const size_t N = 262144;
+
+struct points
+{
+    points()
+        : in(N)
+        , out(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            in[i] = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+        }
+        m = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    }
+
+    std::vector<vector3> in, out;
+    matrix3x4 m;
+    // one thread per hardware thread
+    parallel::thread_pool pool;
+};
+
+points& data()
+{
+    static points d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x262144")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x262144 (pool)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.pool, d.m, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+// a pool started by every call, like the functions which take a thread count
+YAMA_BENCH("transform_coords matrix3x4 x262144 (new pool)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        parallel::thread_pool pool;
+        transform_coords(pool, d.m, d.in.data(), d.out.data(), N);
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("bounds x262144")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = bounds(d.in.data(), N);
+        bench::do_not_optimize(b);
+    }
+}
+
+YAMA_BENCH("bounds x262144 (pool)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = bounds(d.pool, d.in.data(), N);
+        bench::do_not_optimize(b);
+    }
+}
@@ -0,0 +1,60 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+namespace
+{
+
+template <typename T>
+vector4_t<T> axis_angle(const quaternion_t<T>& q)
+{
+    vector3_t<T> axis;
+    T angle;
+    q.to_axis_angle(axis, angle);
+    return vector4_t<T>::coord(axis.x, axis.y, axis.z, angle);
+}
+
+}
+
+// construction
+YAMA_BENCH_BINARY("quaternion rotation_axis", vector3_t<T>, T, quaternion_t<T>::rotation_axis(a, b))
+YAMA_BENCH_BINARY("quaternion rotation_naxis", vector3_t<T>, T, quaternion_t<T>::rotation_naxis(normalize(a), b))
+YAMA_BENCH_UNARY("quaternion rotation_x", T, quaternion_t<T>::rotation_x(a))
+YAMA_BENCH_UNARY("quaternion rotation_y", T, quaternion_t<T>::rotation_y(a))
+YAMA_BENCH_UNARY("quaternion rotation_z", T, quaternion_t<T>::rotation_z(a))
+YAMA_BENCH_BINARY("quaternion rotation_vectors", vector3_t<T>, vector3_t<T>, quaternion_t<T>::rotation_vectors(normalize(a), normalize(b)))
+
+// arithmetic
+YAMA_BENCH_BINARY("quaternion operator+", quaternion_t<T>, quaternion_t<T>, a + b)
+YAMA_BENCH_BINARY("quaternion operator-", quaternion_t<T>, quaternion_t<T>, a - b)
+YAMA_BENCH_UNARY("quaternion operator- (unary)", quaternion_t<T>, -a)
+YAMA_BENCH_BINARY("quaternion operator* (scalar)", quaternion_t<T>, T, a * b)
+YAMA_BENCH_BINARY("quaternion operator*", quaternion_t<T>, quaternion_t<T>, a * b)
+YAMA_BENCH_BINARY("quaternion operator*=", quaternion_t<T>, quaternion_t<T>, a *= b)
+YAMA_BENCH_BINARY("quaternion operator/", quaternion_t<T>, quaternion_t<T>, a / b)
+YAMA_BENCH_BINARY("quaternion operator==", quaternion_t<T>, quaternion_t<T>, a == b)
+YAMA_BENCH_BINARY("quaternion close", quaternion_t<T>, quaternion_t<T>, close(a, b))
+YAMA_BENCH_BINARY("quaternion dot", quaternion_t<T>, quaternion_t<T>, dot(a, b))
+YAMA_BENCH_UNARY("quaternion length", quaternion_t<T>, a.length())
+YAMA_BENCH_UNARY("quaternion length_sq", quaternion_t<T>, a.length_sq())
+YAMA_BENCH_UNARY("quaternion rsqrt_length", quaternion_t<T>, rsqrt_length(a))
+YAMA_BENCH_UNARY("quaternion is_normalized", quaternion_t<T>, a.is_normalized())
+YAMA_BENCH_UNARY("quaternion normalize", quaternion_t<T>, normalize(a))
+YAMA_BENCH_UNARY("quaternion fast_normalize", quaternion_t<T>, fast_normalize(a))
+YAMA_BENCH_UNARY("quaternion conjugate", quaternion_t<T>, conjugate(a))
+YAMA_BENCH_UNARY("quaternion inverse", quaternion_t<T>, inverse(a))
+
+// rotations
+YAMA_BENCH_BINARY("quaternion rotate", vector3_t<T>, quaternion_t<T>, rotate(a, b))
+YAMA_BENCH_TERNARY("quaternion lerp", quaternion_t<T>, quaternion_t<T>, T, lerp(a, b, c))
+YAMA_BENCH_TERNARY("quaternion slerp", quaternion_t<T>, quaternion_t<T>, T, slerp(a, b, c))
+YAMA_BENCH_TERNARY("quaternion nlerp", quaternion_t<T>, quaternion_t<T>, T, nlerp(a, b, c))
+YAMA_BENCH_TERNARY("quaternion fast_slerp", quaternion_t<T>, quaternion_t<T>, T, fast_slerp(a, b, c))
+YAMA_BENCH_UNARY("quaternion to_axis_angle", quaternion_t<T>, axis_angle(a))
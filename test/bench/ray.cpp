@@ -0,0 +1,134 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/ray.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration casts R rays against N boxes or T triangles
+const size_t N = 16384;
+const size_t T = 4096;
+const size_t R = 64;
+
+struct data_t
+{
+    data_t()
+        : boxes(N)
+        , mask((N + 31) / 32)
+        , hits(R)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto c = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+            boxes[i] = aabb::from_center_half_extents(c, v(r.next(0, 1), r.next(0, 1), r.next(0, 1)));
+        }
+        boxes_soa = aabb_soa::from_array(boxes.data(), N);
+
+        // a triangle soup with shared vertices
+        for (size_t i = 0; i < T; ++i)
+        {
+            const auto c = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+            for (size_t k = 0; k < 2; ++k)
+            {
+                vertices.push_back(c + v(r.next(-1, 1), r.next(-1, 1), r.next(-1, 1)));
+            }
+            indices.push_back(uint32_t(vertices.size() - 2));
+            indices.push_back(uint32_t(vertices.size() - 1));
+            indices.push_back(uint32_t(r.next() * float(vertices.size())));
+        }
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            rays.push_back(ray::from_points(v(r.next(-20, 20), r.next(-20, 20), -20), v(r.next(-5, 5), r.next(-5, 5), 0)));
+        }
+    }
+
+    std::vector<aabb> boxes;
+    aabb_soa boxes_soa;
+    std::vector<uint32_t> mask;
+    std::vector<vector3> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<ray> rays;
+    std::vector<ray_hit> hits;
+};
+
+data_t& data()
+{
+    static data_t d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("ray intersects aabb x16384 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        const auto& r = d.rays[it % R];
+        std::fill(d.mask.begin(), d.mask.end(), 0);
+        for (size_t i = 0; i < N; ++i)
+        {
+            d.mask[i / 32] |= uint32_t(intersects(r, d.boxes[i])) << (i % 32);
+        }
+        bench::do_not_optimize(d.mask[0]);
+    }
+}
+
+YAMA_BENCH("ray intersects aabb soa x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        intersects(d.rays[it % R], d.boxes_soa, d.mask.data());
+        bench::do_not_optimize(d.mask[0]);
+    }
+}
+
+YAMA_BENCH("ray intersect mesh x4096 x64 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t j = 0; j < R; ++j)
+        {
+            auto& h = d.hits[j];
+            h = ray_hit::none();
+            for (size_t i = 0; i < T; ++i)
+            {
+                float t, u, w;
+                const uint32_t* tri = d.indices.data() + i * 3;
+                if (intersect(d.rays[j], d.vertices[tri[0]], d.vertices[tri[1]], d.vertices[tri[2]], t, u, w, h.t))
+                {
+                    h.t = t;
+                    h.u = u;
+                    h.v = w;
+                    h.triangle = i;
+                }
+            }
+        }
+        bench::do_not_optimize(d.hits[0]);
+    }
+}
+
+YAMA_BENCH("ray intersect mesh x4096 x64")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        intersect(d.rays.data(), R, d.vertices.data(), d.indices.data(), T, d.hits.data());
+        bench::do_not_optimize(d.hits[0]);
+    }
+}
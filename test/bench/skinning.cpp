@@ -0,0 +1,194 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/skinning.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration skins all vertices with 4 influences from a 64-bone palette
+const size_t N = 16384;
+const size_t bone_count = 64;
+
+struct vertex
+{
+    vector3 position;
+    vector3 normal;
+    uint16_t bones[4];
+    float weights[4];
+};
+
+struct data_t
+{
+    data_t()
+        : palette(bone_count)
+        , vertices(N)
+        , positions(N)
+        , normals(N)
+    {
+        bench::random r;
+        for (auto& m : palette)
+        {
+            m = matrix3x4::translation(r.next(-1, 1), r.next(-1, 1), r.next(-1, 1)) * matrix3x4::rotation_axis(normalize(v(r.next(-1, 1), r.next(-1, 1), 1)), r.next(-3, 3));
+            dq_palette.push_back(dual_quaternion::from_matrix(m));
+        }
+
+        for (auto& vx : vertices)
+        {
+            vx.position = v(r.next(-1, 1), r.next(-1, 1), r.next(-1, 1));
+            vx.normal = normalize(v(r.next(-1, 1), r.next(-1, 1), 1));
+            float sum = 0;
+            for (size_t k = 0; k < 4; ++k)
+            {
+                vx.bones[k] = uint16_t(r.next(0, bone_count - 1));
+                vx.weights[k] = r.next(0, 1);
+                sum += vx.weights[k];
+            }
+            for (auto& w : vx.weights) w /= sum;
+
+            positions_soa.push_back(vx.position);
+            normals_soa.push_back(vx.normal);
+            for (size_t k = 0; k < 4; ++k)
+            {
+                bones[k].push_back(vx.bones[k]);
+                weights[k].push_back(vx.weights[k]);
+            }
+        }
+
+        for (size_t k = 0; k < 4; ++k)
+        {
+            bone_streams[k] = bones[k].data();
+            weight_streams[k] = weights[k].data();
+        }
+
+        const size_t stride = sizeof(vertex);
+        const skinning_input_t<float, uint16_t> i = {
+            &vertices[0].position, stride,
+            &vertices[0].normal, stride,
+            vertices[0].bones, stride,
+            vertices[0].weights, stride,
+        };
+        in = i;
+        const skinning_output_t<float> o = { positions.data(), sizeof(vector3), normals.data(), sizeof(vector3) };
+        out = o;
+    }
+
+    std::vector<matrix3x4> palette;
+    std::vector<dual_quaternion> dq_palette;
+    std::vector<vertex> vertices;
+    std::vector<vector3> positions, normals;
+    skinning_input_t<float, uint16_t> in;
+    skinning_output_t<float> out;
+
+    vector3_soa positions_soa, normals_soa, out_positions, out_normals;
+    std::vector<uint16_t> bones[4];
+    std::vector<float> weights[4];
+    const uint16_t* bone_streams[4];
+    const float* weight_streams[4];
+};
+
+data_t& data()
+{
+    static data_t d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("skinning x16384 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto& vx = d.vertices[i];
+            auto m = d.palette[vx.bones[0]] * vx.weights[0];
+            for (size_t k = 1; k < 4; ++k)
+            {
+                m += d.palette[vx.bones[k]] * vx.weights[k];
+            }
+            d.positions[i] = transform_coord(vx.position, m);
+            d.normals[i] = normalize(transform_coord(vx.normal, m) - v(m.m03, m.m13, m.m23));
+        }
+        bench::do_not_optimize(d.positions[0]);
+    }
+}
+
+YAMA_BENCH("skinning x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        skin<4>(d.palette.data(), d.in, d.out, N);
+        bench::do_not_optimize(d.positions[0]);
+    }
+}
+
+YAMA_BENCH("skinning soa x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        skin<4>(d.palette.data(), d.positions_soa, d.normals_soa, d.bone_streams, d.weight_streams, d.out_positions, d.out_normals);
+        bench::do_not_optimize(d.out_positions.x()[0]);
+    }
+}
+
+YAMA_BENCH("skinning dual quaternion x16384 (loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto& vx = d.vertices[i];
+            const auto& q0 = d.dq_palette[vx.bones[0]];
+            auto q = q0 * vx.weights[0];
+            for (size_t k = 1; k < 4; ++k)
+            {
+                const auto& qk = d.dq_palette[vx.bones[k]];
+                q += qk * (dot(qk.real, q0.real) < 0 ? -vx.weights[k] : vx.weights[k]);
+            }
+            q.normalize();
+            d.positions[i] = transform_coord(vx.position, q);
+            d.normals[i] = rotate(vx.normal, q);
+        }
+        bench::do_not_optimize(d.positions[0]);
+    }
+}
+
+YAMA_BENCH("skinning dual quaternion x16384")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        skin<4>(d.dq_palette.data(), d.in, d.out, N);
+        bench::do_not_optimize(d.positions[0]);
+    }
+}
+
+#if YAMA_THREADS
+
+YAMA_BENCH("skinning x16384 (pool)")
+{
+    auto& d = data();
+    parallel::thread_pool pool;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        skin<4>(pool, d.palette.data(), d.in, d.out, N);
+        bench::do_not_optimize(d.positions[0]);
+    }
+}
+
+#endif
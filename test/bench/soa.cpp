@@ -0,0 +1,111 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/soa.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration processes all points
+const size_t N = 1024;
+
+struct points
+{
+    points()
+        : aos(N)
+    {
+        bench::random r;
+        for (auto& p : aos)
+        {
+            p = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+        }
+        a = vector3_soa::from_array(aos.data(), N);
+        b = a;
+        out.resize(N);
+        lengths.resize(N);
+
+        m34 = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    }
+
+    std::vector<vector3> aos;
+    vector3_soa a, b, out;
+    std::vector<float> lengths;
+    matrix3x4 m34;
+};
+
+points& data()
+{
+    static points d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("soa transform_coords matrix3x4 x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m34, d.a, d.out);
+        bench::do_not_optimize(d.out.x()[0]);
+    }
+}
+
+YAMA_BENCH("soa dot x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        dot(d.a, d.b, d.lengths.data());
+        bench::do_not_optimize(d.lengths.front());
+    }
+}
+
+YAMA_BENCH("soa cross x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        cross(d.a, d.b, d.out);
+        bench::do_not_optimize(d.out.x()[0]);
+    }
+}
+
+YAMA_BENCH("soa normalize x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        normalize(d.a, d.out);
+        bench::do_not_optimize(d.out.x()[0]);
+    }
+}
+
+YAMA_BENCH("soa fast_normalize x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        fast_normalize(d.a, d.out);
+        bench::do_not_optimize(d.out.x()[0]);
+    }
+}
+
+YAMA_BENCH("soa from_array x1024")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        d.out.assign(d.aos.data(), N);
+        bench::do_not_optimize(d.out.x()[0]);
+    }
+}
@@ -0,0 +1,133 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+#include "yama/batch.hpp"
+#include "yama/aabb.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+namespace
+{
+
+// an iteration processes all vertices
+const size_t N = 1024;
+
+struct vertex
+{
+    vector3 position;
+    vector3 normal;
+    vector2 uv;
+};
+
+struct vertices
+{
+    vertices()
+        : in(N)
+        , out(N)
+        , packed_in(N)
+        , packed_out(N)
+    {
+        bench::random r;
+        for (size_t i = 0; i < N; ++i)
+        {
+            in[i].position = v(r.next(-10, 10), r.next(-10, 10), r.next(-10, 10));
+            in[i].normal = normalize(v(r.next(-1, 1), r.next(-1, 1), 1));
+            in[i].uv = v(r.next(0, 1), r.next(0, 1));
+            packed_in[i] = in[i].position;
+        }
+        m = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    }
+
+    strided_span<const vector3> positions() const
+    {
+        return strided_span<const vector3>::from_ptr(&in[0].position, sizeof(vertex), N);
+    }
+
+    strided_span<vector3> out_positions()
+    {
+        return strided_span<vector3>::from_ptr(&out[0].position, sizeof(vertex), N);
+    }
+
+    std::vector<vertex> in, out;
+    std::vector<vector3> packed_in, packed_out;
+    matrix3x4 m;
+};
+
+vertices& data()
+{
+    static vertices d;
+    return d;
+}
+
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x1024 (packed)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m, strided_span<const vector3>::from_array(d.packed_in.data(), N), strided_span<vector3>::from_array(d.packed_out.data(), N));
+        bench::do_not_optimize(d.packed_out.front());
+    }
+}
+
+YAMA_BENCH("transform_coords matrix3x4 x1024 (interleaved)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        transform_coords(d.m, d.positions(), d.out_positions());
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+// what the views save: copying the positions out and back
+YAMA_BENCH("transform_coords matrix3x4 x1024 (interleaved, copied)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < N; ++i) d.packed_in[i] = d.in[i].position;
+        transform_coords(d.m, d.packed_in.data(), d.packed_out.data(), N);
+        for (size_t i = 0; i < N; ++i) d.out[i].position = d.packed_out[i];
+        bench::do_not_optimize(d.out.front());
+    }
+}
+
+YAMA_BENCH("bounds x1024 (packed)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = bounds(d.packed_in.data(), N);
+        bench::do_not_optimize(b);
+    }
+}
+
+YAMA_BENCH("bounds x1024 (interleaved)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = bounds(d.positions());
+        bench::do_not_optimize(b);
+    }
+}
+
+YAMA_BENCH("bounds x1024 (interleaved, loop)")
+{
+    auto& d = data();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        auto b = aabb::empty();
+        for (const auto& p : d.positions()) b.merge(p);
+        bench::do_not_optimize(b);
+    }
+}
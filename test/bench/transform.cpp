@@ -0,0 +1,29 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+// conversion
+YAMA_BENCH_UNARY("transform to_matrix3x4", transform_t<T>, a.to_matrix3x4())
+YAMA_BENCH_UNARY("transform to_matrix4x4", transform_t<T>, a.to_matrix4x4())
+
+// random matrices have shear and take the polar decomposition
+YAMA_BENCH_UNARY("transform decompose", transform_t<T>, decompose(a.to_matrix3x4()))
+YAMA_BENCH_UNARY("transform decompose sheared", matrix3x4_t<T>, decompose(a))
+
+// arithmetic
+// the same composition through matrices, as it is done without transform_t
+YAMA_BENCH_BINARY("transform operator*", transform_t<T>, transform_t<T>, a * b)
+YAMA_BENCH_BINARY("transform operator* via matrix3x4", transform_t<T>, transform_t<T>, a.to_matrix3x4() * b.to_matrix3x4())
+YAMA_BENCH_BINARY("transform operator* via matrix4x4", transform_t<T>, transform_t<T>, a.to_matrix4x4() * b.to_matrix4x4())
+YAMA_BENCH_UNARY("transform inverse", transform_t<T>, inverse(a))
+YAMA_BENCH_TERNARY("transform nlerp", transform_t<T>, transform_t<T>, T, nlerp(a, b, std::abs(c)))
+
+// transformations
+YAMA_BENCH_BINARY("transform transform_coord", vector3_t<T>, transform_t<T>, transform_coord(a, b))
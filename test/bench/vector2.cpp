@@ -0,0 +1,60 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+// arithmetic
+YAMA_BENCH_UNARY("vector2 operator- (unary)", vector2_t<T>, -a)
+YAMA_BENCH_BINARY("vector2 operator+", vector2_t<T>, vector2_t<T>, a + b)
+YAMA_BENCH_BINARY("vector2 operator-", vector2_t<T>, vector2_t<T>, a - b)
+YAMA_BENCH_BINARY("vector2 operator* (scalar)", vector2_t<T>, T, a * b)
+YAMA_BENCH_BINARY("vector2 operator/ (scalar)", vector2_t<T>, T, a / b)
+YAMA_BENCH_BINARY("vector2 operator+=", vector2_t<T>, vector2_t<T>, a += b)
+YAMA_BENCH_BINARY("vector2 operator-=", vector2_t<T>, vector2_t<T>, a -= b)
+YAMA_BENCH_BINARY("vector2 operator*= (scalar)", vector2_t<T>, T, a *= b)
+YAMA_BENCH_BINARY("vector2 operator/= (scalar)", vector2_t<T>, T, a /= b)
+YAMA_BENCH_BINARY("vector2 mul", vector2_t<T>, vector2_t<T>, mul(a, b))
+YAMA_BENCH_BINARY("vector2 div", vector2_t<T>, vector2_t<T>, div(a, b))
+YAMA_BENCH_BINARY("vector2 operator==", vector2_t<T>, vector2_t<T>, a == b)
+YAMA_BENCH_BINARY("vector2 operator!=", vector2_t<T>, vector2_t<T>, a != b)
+YAMA_BENCH_BINARY("vector2 close", vector2_t<T>, vector2_t<T>, close(a, b))
+YAMA_BENCH_UNARY("vector2 isfinite", vector2_t<T>, isfinite(a))
+
+// geometry
+YAMA_BENCH_UNARY("vector2 length", vector2_t<T>, a.length())
+YAMA_BENCH_UNARY("vector2 length_sq", vector2_t<T>, a.length_sq())
+YAMA_BENCH_UNARY("vector2 manhattan_length", vector2_t<T>, a.manhattan_length())
+YAMA_BENCH_UNARY("vector2 rsqrt_length", vector2_t<T>, rsqrt_length(a))
+YAMA_BENCH_UNARY("vector2 is_normalized", vector2_t<T>, a.is_normalized())
+YAMA_BENCH_UNARY("vector2 product", vector2_t<T>, a.product())
+YAMA_BENCH_UNARY("vector2 normalize", vector2_t<T>, normalize(a))
+YAMA_BENCH_UNARY("vector2 normalize (member)", vector2_t<T>, (a.normalize(), a))
+YAMA_BENCH_UNARY("vector2 fast_normalize", vector2_t<T>, fast_normalize(a))
+YAMA_BENCH_UNARY("vector2 homogenous_normalize", vector2_t<T>, (a.homogenous_normalize(), a))
+YAMA_BENCH_BINARY("vector2 dot", vector2_t<T>, vector2_t<T>, dot(a, b))
+YAMA_BENCH_BINARY("vector2 reflection", vector2_t<T>, vector2_t<T>, a.reflection(normalize(b)))
+YAMA_BENCH_BINARY("vector2 orthogonal", vector2_t<T>, vector2_t<T>, orthogonal(a, b))
+YAMA_BENCH_BINARY("vector2 collinear", vector2_t<T>, vector2_t<T>, collinear(a, b))
+YAMA_BENCH_BINARY("vector2 cross_magnitude", vector2_t<T>, vector2_t<T>, cross_magnitude(a, b))
+YAMA_BENCH_UNARY("vector2 get_orthogonal", vector2_t<T>, a.get_orthogonal())
+YAMA_BENCH_BINARY("vector2 distance", vector2_t<T>, vector2_t<T>, distance(a, b))
+YAMA_BENCH_BINARY("vector2 distance_sq", vector2_t<T>, vector2_t<T>, distance_sq(a, b))
+YAMA_BENCH_TERNARY("vector2 lerp", vector2_t<T>, vector2_t<T>, T, lerp(a, b, c))
+
+// component-wise
+YAMA_BENCH_UNARY("vector2 abs", vector2_t<T>, abs(a))
+YAMA_BENCH_UNARY("vector2 floor", vector2_t<T>, floor(a))
+YAMA_BENCH_UNARY("vector2 ceil", vector2_t<T>, ceil(a))
+YAMA_BENCH_UNARY("vector2 round", vector2_t<T>, round(a))
+YAMA_BENCH_UNARY("vector2 frac", vector2_t<T>, frac(a))
+YAMA_BENCH_BINARY("vector2 mod", vector2_t<T>, vector2_t<T>, mod(a, b))
+YAMA_BENCH_UNARY("vector2 sign", vector2_t<T>, sign(a))
+YAMA_BENCH_BINARY("vector2 min", vector2_t<T>, vector2_t<T>, min(a, b))
+YAMA_BENCH_BINARY("vector2 max", vector2_t<T>, vector2_t<T>, max(a, b))
+YAMA_BENCH_TERNARY("vector2 clamp", vector2_t<T>, vector2_t<T>, vector2_t<T>, clamp(a, min(b, c), max(b, c)))
@@ -0,0 +1,60 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+// arithmetic
+YAMA_BENCH_UNARY("vector3 operator- (unary)", vector3_t<T>, -a)
+YAMA_BENCH_BINARY("vector3 operator+", vector3_t<T>, vector3_t<T>, a + b)
+YAMA_BENCH_BINARY("vector3 operator-", vector3_t<T>, vector3_t<T>, a - b)
+YAMA_BENCH_BINARY("vector3 operator* (scalar)", vector3_t<T>, T, a * b)
+YAMA_BENCH_BINARY("vector3 operator/ (scalar)", vector3_t<T>, T, a / b)
+YAMA_BENCH_BINARY("vector3 operator+=", vector3_t<T>, vector3_t<T>, a += b)
+YAMA_BENCH_BINARY("vector3 operator-=", vector3_t<T>, vector3_t<T>, a -= b)
+YAMA_BENCH_BINARY("vector3 operator*= (scalar)", vector3_t<T>, T, a *= b)
+YAMA_BENCH_BINARY("vector3 operator/= (scalar)", vector3_t<T>, T, a /= b)
+YAMA_BENCH_BINARY("vector3 mul", vector3_t<T>, vector3_t<T>, mul(a, b))
+YAMA_BENCH_BINARY("vector3 div", vector3_t<T>, vector3_t<T>, div(a, b))
+YAMA_BENCH_BINARY("vector3 operator==", vector3_t<T>, vector3_t<T>, a == b)
+YAMA_BENCH_BINARY("vector3 operator!=", vector3_t<T>, vector3_t<T>, a != b)
+YAMA_BENCH_BINARY("vector3 close", vector3_t<T>, vector3_t<T>, close(a, b))
+YAMA_BENCH_UNARY("vector3 isfinite", vector3_t<T>, isfinite(a))
+
+// geometry
+YAMA_BENCH_UNARY("vector3 length", vector3_t<T>, a.length())
+YAMA_BENCH_UNARY("vector3 length_sq", vector3_t<T>, a.length_sq())
+YAMA_BENCH_UNARY("vector3 manhattan_length", vector3_t<T>, a.manhattan_length())
+YAMA_BENCH_UNARY("vector3 rsqrt_length", vector3_t<T>, rsqrt_length(a))
+YAMA_BENCH_UNARY("vector3 is_normalized", vector3_t<T>, a.is_normalized())
+YAMA_BENCH_UNARY("vector3 product", vector3_t<T>, a.product())
+YAMA_BENCH_UNARY("vector3 normalize", vector3_t<T>, normalize(a))
+YAMA_BENCH_UNARY("vector3 normalize (member)", vector3_t<T>, (a.normalize(), a))
+YAMA_BENCH_UNARY("vector3 fast_normalize", vector3_t<T>, fast_normalize(a))
+YAMA_BENCH_UNARY("vector3 homogenous_normalize", vector3_t<T>, (a.homogenous_normalize(), a))
+YAMA_BENCH_BINARY("vector3 dot", vector3_t<T>, vector3_t<T>, dot(a, b))
+YAMA_BENCH_BINARY("vector3 reflection", vector3_t<T>, vector3_t<T>, a.reflection(normalize(b)))
+YAMA_BENCH_BINARY("vector3 orthogonal", vector3_t<T>, vector3_t<T>, orthogonal(a, b))
+YAMA_BENCH_BINARY("vector3 collinear", vector3_t<T>, vector3_t<T>, collinear(a, b))
+YAMA_BENCH_BINARY("vector3 cross", vector3_t<T>, vector3_t<T>, cross(a, b))
+YAMA_BENCH_UNARY("vector3 get_orthogonal", vector3_t<T>, a.get_orthogonal())
+YAMA_BENCH_BINARY("vector3 distance", vector3_t<T>, vector3_t<T>, distance(a, b))
+YAMA_BENCH_BINARY("vector3 distance_sq", vector3_t<T>, vector3_t<T>, distance_sq(a, b))
+YAMA_BENCH_TERNARY("vector3 lerp", vector3_t<T>, vector3_t<T>, T, lerp(a, b, c))
+
+// component-wise
+YAMA_BENCH_UNARY("vector3 abs", vector3_t<T>, abs(a))
+YAMA_BENCH_UNARY("vector3 floor", vector3_t<T>, floor(a))
+YAMA_BENCH_UNARY("vector3 ceil", vector3_t<T>, ceil(a))
+YAMA_BENCH_UNARY("vector3 round", vector3_t<T>, round(a))
+YAMA_BENCH_UNARY("vector3 frac", vector3_t<T>, frac(a))
+YAMA_BENCH_BINARY("vector3 mod", vector3_t<T>, vector3_t<T>, mod(a, b))
+YAMA_BENCH_UNARY("vector3 sign", vector3_t<T>, sign(a))
+YAMA_BENCH_BINARY("vector3 min", vector3_t<T>, vector3_t<T>, min(a, b))
+YAMA_BENCH_BINARY("vector3 max", vector3_t<T>, vector3_t<T>, max(a, b))
+YAMA_BENCH_TERNARY("vector3 clamp", vector3_t<T>, vector3_t<T>, vector3_t<T>, clamp(a, min(b, c), max(b, c)))
@@ -0,0 +1,58 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "bench.hpp"
+
+using namespace yama;
+
+// arithmetic
+YAMA_BENCH_UNARY("vector4 operator- (unary)", vector4_t<T>, -a)
+YAMA_BENCH_BINARY("vector4 operator+", vector4_t<T>, vector4_t<T>, a + b)
+YAMA_BENCH_BINARY("vector4 operator-", vector4_t<T>, vector4_t<T>, a - b)
+YAMA_BENCH_BINARY("vector4 operator* (scalar)", vector4_t<T>, T, a * b)
+YAMA_BENCH_BINARY("vector4 operator/ (scalar)", vector4_t<T>, T, a / b)
+YAMA_BENCH_BINARY("vector4 operator+=", vector4_t<T>, vector4_t<T>, a += b)
+YAMA_BENCH_BINARY("vector4 operator-=", vector4_t<T>, vector4_t<T>, a -= b)
+YAMA_BENCH_BINARY("vector4 operator*= (scalar)", vector4_t<T>, T, a *= b)
+YAMA_BENCH_BINARY("vector4 operator/= (scalar)", vector4_t<T>, T, a /= b)
+YAMA_BENCH_BINARY("vector4 mul", vector4_t<T>, vector4_t<T>, mul(a, b))
+YAMA_BENCH_BINARY("vector4 div", vector4_t<T>, vector4_t<T>, div(a, b))
+YAMA_BENCH_BINARY("vector4 operator==", vector4_t<T>, vector4_t<T>, a == b)
+YAMA_BENCH_BINARY("vector4 operator!=", vector4_t<T>, vector4_t<T>, a != b)
+YAMA_BENCH_BINARY("vector4 close", vector4_t<T>, vector4_t<T>, close(a, b))
+YAMA_BENCH_UNARY("vector4 isfinite", vector4_t<T>, isfinite(a))
+
+// geometry
+YAMA_BENCH_UNARY("vector4 length", vector4_t<T>, a.length())
+YAMA_BENCH_UNARY("vector4 length_sq", vector4_t<T>, a.length_sq())
+YAMA_BENCH_UNARY("vector4 manhattan_length", vector4_t<T>, a.manhattan_length())
+YAMA_BENCH_UNARY("vector4 rsqrt_length", vector4_t<T>, rsqrt_length(a))
+YAMA_BENCH_UNARY("vector4 is_normalized", vector4_t<T>, a.is_normalized())
+YAMA_BENCH_UNARY("vector4 product", vector4_t<T>, a.product())
+YAMA_BENCH_UNARY("vector4 normalize", vector4_t<T>, normalize(a))
+YAMA_BENCH_UNARY("vector4 normalize (member)", vector4_t<T>, (a.normalize(), a))
+YAMA_BENCH_UNARY("vector4 fast_normalize", vector4_t<T>, fast_normalize(a))
+YAMA_BENCH_UNARY("vector4 homogenous_normalize", vector4_t<T>, (a.homogenous_normalize(), a))
+YAMA_BENCH_BINARY("vector4 dot", vector4_t<T>, vector4_t<T>, dot(a, b))
+YAMA_BENCH_BINARY("vector4 reflection", vector4_t<T>, vector4_t<T>, a.reflection(normalize(b)))
+YAMA_BENCH_BINARY("vector4 orthogonal", vector4_t<T>, vector4_t<T>, orthogonal(a, b))
+YAMA_BENCH_BINARY("vector4 collinear", vector4_t<T>, vector4_t<T>, collinear(a, b))
+YAMA_BENCH_BINARY("vector4 distance", vector4_t<T>, vector4_t<T>, distance(a, b))
+YAMA_BENCH_BINARY("vector4 distance_sq", vector4_t<T>, vector4_t<T>, distance_sq(a, b))
+YAMA_BENCH_TERNARY("vector4 lerp", vector4_t<T>, vector4_t<T>, T, lerp(a, b, c))
+
+// component-wise
+YAMA_BENCH_UNARY("vector4 abs", vector4_t<T>, abs(a))
+YAMA_BENCH_UNARY("vector4 floor", vector4_t<T>, floor(a))
+YAMA_BENCH_UNARY("vector4 ceil", vector4_t<T>, ceil(a))
+YAMA_BENCH_UNARY("vector4 round", vector4_t<T>, round(a))
+YAMA_BENCH_UNARY("vector4 frac", vector4_t<T>, frac(a))
+YAMA_BENCH_BINARY("vector4 mod", vector4_t<T>, vector4_t<T>, mod(a, b))
+YAMA_BENCH_UNARY("vector4 sign", vector4_t<T>, sign(a))
+YAMA_BENCH_BINARY("vector4 min", vector4_t<T>, vector4_t<T>, min(a, b))
+YAMA_BENCH_BINARY("vector4 max", vector4_t<T>, vector4_t<T>, max(a, b))
+YAMA_BENCH_TERNARY("vector4 clamp", vector4_t<T>, vector4_t<T>, vector4_t<T>, clamp(a, min(b, c), max(b, c)))
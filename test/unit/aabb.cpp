@@ -0,0 +1,216 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/aabb.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("aabb");
+
+namespace
+{
+
+// not a multiple of the padding or the mask word size
+const size_t N = 101;
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+vector3 rnd_point()
+{
+    return v(rnd(-10, 10), rnd(-10, 10), rnd(-10, 10));
+}
+
+aabb rnd_box()
+{
+    return aabb::from_center_half_extents(rnd_point(), v(rnd(0, 3), rnd(0, 3), rnd(0, 3)));
+}
+
+bool bit(const std::vector<uint32_t>& mask, size_t i)
+{
+    return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+}
+
+TEST_CASE("basic")
+{
+    auto b = aabb::from_min_max(v(1, 2, 3), v(4, 6, 8));
+    CHECK(b.min == v(1, 2, 3));
+    CHECK(b.max == v(4, 6, 8));
+    CHECK(b.center() == v(2.5f, 4, 5.5f));
+    CHECK(b.half_extents() == v(1.5f, 2, 2.5f));
+    CHECK(b.size() == v(3, 4, 5));
+    CHECK(b.volume() == 60);
+    CHECK(b.surface_area() == 94);
+    CHECK(!b.is_empty());
+    CHECK(aabb::from_center_half_extents(b.center(), b.half_extents()) == b);
+    CHECK(aabb::from_point(v(1, 2, 3)).volume() == 0);
+
+    auto e = aabb::empty();
+    CHECK(e.is_empty());
+    CHECK(merge(e, b) == b);
+    e.merge(v(1, 1, 1));
+    CHECK(e == aabb::from_point(v(1, 1, 1)));
+    e.merge(b);
+    CHECK(e == aabb::from_min_max(v(1, 1, 1), v(4, 6, 8)));
+    CHECK(merge(b, v(0, 10, 5)) == aabb::from_min_max(v(0, 2, 3), v(4, 10, 8)));
+
+    CHECK(b.contains(v(1, 2, 3)));
+    CHECK(b.contains(v(2, 5, 7)));
+    CHECK(!b.contains(v(0, 5, 7)));
+    CHECK(b.contains(aabb::from_min_max(v(2, 3, 4), v(3, 4, 5))));
+    CHECK(!b.contains(aabb::from_min_max(v(2, 3, 4), v(5, 4, 5))));
+
+    const auto c = aabb::from_min_max(v(4, 0, 0), v(5, 3, 4));
+    CHECK(intersects(b, c)); // touching
+    CHECK(intersection(b, c) == aabb::from_min_max(v(4, 2, 3), v(4, 3, 4)));
+    const auto d = aabb::from_min_max(v(4.5f, 0, 0), v(5, 3, 4));
+    CHECK(!intersects(b, d));
+    CHECK(intersection(b, d).is_empty());
+}
+
+TEST_CASE("transform")
+{
+    const auto b = aabb::from_min_max(v(-1, -2, 0), v(3, 1, 2));
+    const auto m = matrix3x4::translation(1, 2, 3) * matrix3x4::rotation_axis(v(1, 2, 3), 0.7f) * matrix3x4::scaling(1, 2, 0.5f);
+
+    // the box of the 8 transformed corners
+    auto ref = aabb::empty();
+    for (int i = 0; i < 8; ++i)
+    {
+        const auto corner = v(i & 1 ? b.max.x : b.min.x, i & 2 ? b.max.y : b.min.y, i & 4 ? b.max.z : b.min.z);
+        ref.merge(transform_coord(corner, m));
+    }
+
+    CHECK(close(transform_aabb(b, m), ref, 1e-5f));
+
+    const auto m44 = matrix::translation(1, 2, 3) * matrix::rotation_axis(v(1, 2, 3), 0.7f) * matrix::scaling(1, 2, 0.5f);
+    CHECK(close(transform_aabb(b, m44), ref, 1e-5f));
+
+    CHECK(transform_aabb(aabb::empty(), m).is_empty());
+}
+
+TEST_CASE("bounds")
+{
+    std::srand(3);
+
+    // every count up to a few packs, so that all tails are covered
+    std::vector<vector3> points;
+    for (size_t count = 0; count < 40; ++count)
+    {
+        auto ref = aabb::empty();
+        for (const auto& p : points) ref.merge(p);
+
+        CHECK(bounds(points.data(), points.size()) == ref);
+
+        const auto soa = vector3_soa::from_array(points.data(), points.size());
+        CHECK(bounds(soa) == ref);
+
+        points.push_back(rnd_point());
+    }
+
+    std::vector<aabb> boxes;
+    auto ref = aabb::empty();
+    for (size_t i = 0; i < N; ++i)
+    {
+        boxes.push_back(rnd_box());
+        ref.merge(boxes.back());
+    }
+    const auto soa = aabb_soa::from_array(boxes.data(), N);
+    CHECK(bounds(soa) == ref);
+}
+
+TEST_CASE("soa")
+{
+    std::srand(4);
+
+    aabb_soa s;
+    s.push_back(aabb::from_min_max(v(1, 2, 3), v(4, 5, 6)));
+    CHECK(s.size() == 1);
+    CHECK(s[0] == aabb::from_min_max(v(1, 2, 3), v(4, 5, 6)));
+    CHECK(s.max_y()[0] == 5);
+    s[0].min = v(0, 0, 0);
+    CHECK(s[0] == aabb::from_min_max(v(0, 0, 0), v(4, 5, 6)));
+    s[0] = aabb::from_point(v(1, 1, 1));
+    CHECK(s.min_z()[0] == 1);
+
+    std::vector<aabb> va, vb;
+    std::vector<vector3> vp;
+    for (size_t i = 0; i < N; ++i)
+    {
+        va.push_back(rnd_box());
+        vb.push_back(rnd_box());
+        vp.push_back(rnd_point() * 0.3f);
+    }
+    const auto a = aabb_soa::from_array(va.data(), N);
+    const auto b = aabb_soa::from_array(vb.data(), N);
+    const auto p = vector3_soa::from_array(vp.data(), N);
+
+    std::vector<aabb> back(N);
+    a.copy_to(back.data());
+    CHECK(back == va);
+
+    aabb_soa out;
+    merge(a, b, out);
+    CHECK(out.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(out[i] == merge(va[i], vb[i]));
+    }
+
+    intersection(a, b, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(out[i] == intersection(va[i], vb[i]));
+    }
+
+    std::vector<uint32_t> mask((N + 31) / 32);
+    size_t hits = 0;
+    intersects(a, b, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(bit(mask, i) == intersects(va[i], vb[i]));
+        hits += bit(mask, i);
+    }
+    CHECK(hits > 0);
+    CHECK(hits < N);
+    CHECK((mask.back() >> (N % 32)) == 0);
+
+    hits = 0;
+    contains(a, p, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(bit(mask, i) == va[i].contains(vp[i]));
+        hits += bit(mask, i);
+    }
+    CHECK(hits > 0);
+    CHECK(hits < N);
+
+    // the kernels may use fused multiply-adds, hence the epsilon
+    const auto m = matrix3x4::translation(1, 2, 3) * matrix3x4::rotation_axis(v(1, 2, 3), 0.7f) * matrix3x4::scaling(1, 2, 0.5f);
+    transform_aabbs(m, a, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(aabb(out[i]), transform_aabb(va[i], m), 1e-4f));
+    }
+
+    const auto m44 = matrix::translation(1, 2, 3) * matrix::rotation_axis(v(1, 2, 3), 0.7f);
+    auto c = a;
+    transform_aabbs(m44, c, c);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(aabb(c[i]), transform_aabb(va[i], m44), 1e-4f));
+    }
+}
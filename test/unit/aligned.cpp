@@ -0,0 +1,196 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/aligned.hpp"
+#include "yama/batch.hpp"
+
+#include <vector>
+#include <memory>
+
+using namespace yama;
+
+TEST_SUITE("aligned");
+
+namespace
+{
+
+// not a multiple of any pack width
+const size_t N = 37;
+
+vector3 point(size_t i)
+{
+    const float f = float(i);
+    return v(f - 10, 2 * f + 1, 5 - f * 0.5f);
+}
+
+template <typename T>
+bool is_aligned(const T* ptr, size_t alignment)
+{
+    return reinterpret_cast<size_t>(ptr) % alignment == 0;
+}
+
+}
+
+TEST_CASE("layout")
+{
+    CHECK(sizeof(vector3a) == 16u);
+    CHECK(alignof(vector3a) == 16u);
+    CHECK(sizeof(vector4a) == 16u);
+    CHECK(alignof(vector4a) == 16u);
+    CHECK(alignof(quaterniona) == 16u);
+    CHECK(alignof(matrix4x4a) == 64u);
+    CHECK(sizeof(matrix4x4a) == 64u);
+
+    CHECK(sizeof(vector3a_t<double>) == 32u);
+    CHECK(alignof(vector3a_t<double>) == 32u);
+
+    static_assert(is_yama<vector3a>::value, "vector3a must be a yama type");
+    static_assert(is_matrix<matrix4x4a>::value, "matrix4x4a must be a yama matrix");
+}
+
+TEST_CASE("conversions")
+{
+    vector3a a = v(1, 2, 3);
+    CHECK(a == v(1, 2, 3));
+    CHECK(a.length_sq() == 14);
+
+    vector3 b = a + v(1, 1, 1);
+    CHECK(b == v(2, 3, 4));
+
+    a = b;
+    CHECK(a.x == 2);
+    CHECK(a.z == 4);
+
+    const vector4a c = vector4::coord(1, 2, 3, 4);
+    CHECK(c.w == 4);
+
+    const quaterniona q = quaternion::rotation_axis(v(1, 2, 3), 0.5f);
+    CHECK(q.is_normalized());
+
+    const matrix4x4a m = matrix4x4::translation(1, 2, 3);
+    CHECK(m == matrix4x4::translation(1, 2, 3));
+    CHECK(transform_coord(v(1, 1, 1), m) == v(2, 3, 4));
+}
+
+TEST_CASE("new")
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        std::unique_ptr<vector3a> v3(new vector3a);
+        CHECK(is_aligned(v3.get(), 16));
+
+        std::unique_ptr<matrix4x4a> m(new matrix4x4a(matrix4x4::identity()));
+        CHECK(is_aligned(m.get(), 64));
+        CHECK(*m == matrix4x4::identity());
+
+        std::unique_ptr<matrix4x4a[]> ms(new matrix4x4a[3]);
+        CHECK(is_aligned(ms.get(), 64));
+        CHECK(is_aligned(ms.get() + 1, 64));
+    }
+}
+
+TEST_CASE("allocator")
+{
+    std::vector<matrix4x4a, aligned_allocator<matrix4x4a>> ms;
+    std::vector<float, aligned_allocator<float, 32>> fs;
+    for (size_t i = 0; i < N; ++i)
+    {
+        ms.push_back(matrix4x4::translation(float(i), 0, 0));
+        fs.push_back(float(i));
+        CHECK(is_aligned(ms.data(), 64));
+        CHECK(is_aligned(fs.data(), 32));
+    }
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(ms[i].m03 == float(i));
+        CHECK(fs[i] == float(i));
+    }
+
+    CHECK(aligned_allocator<float>() == aligned_allocator<int>());
+
+    // n * sizeof(T) would wrap around
+    aligned_allocator<matrix4x4a> a;
+    CHECK(a.max_size() < size_t(-1) / sizeof(matrix4x4a));
+    CHECK_THROWS_AS(a.allocate(size_t(-1) / 8), const std::bad_array_new_length&);
+    CHECK_THROWS_AS(a.allocate(a.max_size() + 1), const std::bad_array_new_length&);
+}
+
+TEST_CASE("batch")
+{
+    std::vector<vector3> in(N), out(N);
+    std::vector<vector3a, aligned_allocator<vector3a>> ain(N), aout(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        in[i] = point(i);
+        ain[i] = point(i);
+    }
+
+    const auto m34 = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    transform_coords(m34, in.data(), out.data(), N);
+    transform_coords(m34, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    const auto m33 = matrix3x3::rotation_axis(v(1, 0, 1), 0.8f);
+    transform_coords(m33, in.data(), out.data(), N);
+    transform_coords(m33, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    const auto proj = matrix4x4::perspective_lh(2, 1, 1, 100);
+    transform_coords(proj, in.data(), out.data(), N);
+    transform_coords(proj, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    const auto t = transform::trs(v(1, 2, 3), quaternion::rotation_axis(v(1, 2, 3), 0.3f), v(2, 3, 4));
+    transform_coords(t, in.data(), out.data(), N);
+    transform_coords(t, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    const auto m44 = matrix4x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix4x4::scaling(1, 2, 3);
+    transform_directions(m44, in.data(), out.data(), N);
+    transform_directions(m44, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    transform_normals(m44, in.data(), out.data(), N);
+    transform_normals(m44, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    const auto q = quaternion::rotation_axis(v(3, 2, 1), 1.2f);
+    rotate(q, in.data(), out.data(), N);
+    rotate(q, ain.data(), aout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(aout[i])) == out[i]);
+    }
+
+    // in place
+    fast_normalize(in.data(), in.data(), N);
+    fast_normalize(ain.data(), ain.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(ain[i])) == in[i]);
+    }
+}
@@ -0,0 +1,479 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/batch.hpp"
+
+#include <vector>
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("batch");
+
+namespace
+{
+
+// odd count, so that both the packs and the tail are exercised
+// the results are compared with a looser epsilon as the batch may use fused multiply-adds
+const size_t N = 37;
+
+std::vector<vector3> points()
+{
+    std::vector<vector3> ret;
+    for (size_t i = 0; i < N; ++i)
+    {
+        float f = float(i);
+        ret.push_back(v(f - 10, 2 * f + 1, 5 - f * 0.5f));
+    }
+    return ret;
+}
+
+struct vertex
+{
+    vector3 pos;
+    vector3 normal;
+    float u, v;
+};
+
+}
+
+TEST_CASE("transform_coords")
+{
+    const auto in = points();
+    std::vector<vector3> out(N);
+
+    const auto m34 = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3) * matrix3x4::scaling(2, 3, 4);
+    transform_coords(m34, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], m34));
+    }
+
+    const auto m33 = matrix3x3::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x3::scaling(2, 3, 4);
+    transform_coords(m33, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], m33));
+    }
+
+    // affine matrix4x4 takes the path without the divide
+    const auto m44 = matrix::rotation_axis(v(1, 2, 3), 0.3f) * matrix::translation(1, 2, 3) * matrix::scaling(2, 3, 4);
+    transform_coords(m44, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], m44));
+    }
+
+    const auto proj = matrix::perspective_fov_rh(1.2f, 1.5f, 1, 100) * m44;
+    transform_coords(proj, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], proj));
+    }
+
+    // in place
+    out = in;
+    transform_coords(proj, out.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], proj));
+    }
+
+    transform_coords(m34, in.data(), out.data(), 0);
+}
+
+TEST_CASE("transform_coords 2d")
+{
+    std::vector<vector2> in;
+    for (size_t i = 0; i < N; ++i)
+    {
+        float f = float(i);
+        in.push_back(v(f - 10, 5 - f * 0.5f));
+    }
+    std::vector<vector2> out(N);
+
+    const auto m = matrix2x3::translation(3, -1) * matrix2x3::rotation(0.8f) * matrix2x3::scaling(2, 0.5f);
+    transform_coords(m, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], m));
+    }
+
+    // interleaved sprite vertices
+    struct sprite_vertex
+    {
+        vector2 pos;
+        vector2 uv;
+    };
+    std::vector<sprite_vertex> vertices(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        vertices[i].pos = in[i];
+        vertices[i].uv = v(float(i), 1);
+    }
+    transform_coords(m, &vertices[0].pos, sizeof(sprite_vertex), &vertices[0].pos, sizeof(sprite_vertex), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vertices[i].pos).epsilon(1e-4f) == transform_coord(in[i], m));
+        CHECK(vertices[i].uv == v(float(i), 1));
+    }
+}
+
+TEST_CASE("transforms")
+{
+    const auto in = points();
+    std::vector<vector3> out(N);
+
+    const auto t = transform::trs(v(1, 2, 3), quaternion::rotation_axis(v(1, 2, 3), 0.3f), v(2, 3, 4));
+    transform_coords(t, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], t));
+    }
+
+    std::vector<transform> trs;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const float f = float(i);
+        trs.push_back(transform::trs(in[i], quaternion::rotation_axis(v(1, f, 3), 0.1f * f), v(1 + f, 2, 0.5f)));
+    }
+
+    std::vector<matrix3x4> m34(N);
+    to_matrix3x4(trs.data(), m34.data(), N);
+    std::vector<matrix4x4> m44(N);
+    to_matrix4x4(trs.data(), m44.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(m34[i], trs[i].to_matrix3x4(), 1e-4f));
+        CHECK(close(m44[i], trs[i].to_matrix4x4(), 1e-4f));
+    }
+}
+
+TEST_CASE("strided")
+{
+    const auto in = points();
+
+    std::vector<vertex> vertices(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        vertices[i].pos = in[i];
+        vertices[i].normal = vector3::unit_z();
+        vertices[i].u = vertices[i].v = float(i);
+    }
+
+    const auto m = matrix3x4::rotation_x(1.1f) * matrix3x4::translation(-1, 5, 2);
+
+    // interleaved to packed
+    std::vector<vector3> out(N);
+    transform_coords(m, &vertices[0].pos, sizeof(vertex), out.data(), sizeof(vector3), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], m));
+    }
+
+    // interleaved in place
+    transform_coords(m, &vertices[0].pos, sizeof(vertex), &vertices[0].pos, sizeof(vertex), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vertices[i].pos).epsilon(1e-4f) == transform_coord(in[i], m));
+        CHECK(vertices[i].normal == vector3::unit_z());
+        CHECK(vertices[i].u == float(i));
+        CHECK(vertices[i].v == float(i));
+    }
+}
+
+TEST_CASE("directions_and_normals")
+{
+    const auto in = points();
+    std::vector<vector3> out(N);
+
+    const auto m = matrix::translation(10, 20, 30) * matrix::rotation_z(0.4f) * matrix::scaling(1, 4, 0.5f);
+    const auto o = transform_coord(vector3::zero(), m);
+
+    transform_directions(m, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], m) - o);
+    }
+
+    // a normal stays perpendicular to the transformed surface
+    const auto t0 = v(1, 1, 0);
+    const auto t1 = v(0, 1, 1);
+    const auto n = cross(t0, t1);
+
+    vector3 tangents[2] = { t0, t1 };
+    transform_directions(m, tangents, tangents, 2);
+
+    vector3 tn;
+    transform_normals(m, &n, &tn, 1);
+    CHECK(Approx(dot(tn, tangents[0])) == 0);
+    CHECK(Approx(dot(tn, tangents[1])) == 0);
+
+    const auto m34 = matrix3x4::rotation_z(0.4f) * matrix3x4::scaling(1, 4, 0.5f);
+    vector3 tn34;
+    transform_normals(m34, &n, &tn34, 1);
+    CHECK(YamaApprox(tn34) == tn);
+
+    // rigid transforms leave normals as they are rotated
+    const auto r = matrix3x4::rotation_axis(v(3, 2, 1), 2.f) * matrix3x4::translation(4, 5, 6);
+    transform_normals(r, in.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(in[i], r) - transform_coord(vector3::zero(), r));
+    }
+}
+
+TEST_CASE("quaternions")
+{
+    std::vector<quaternion> qa, qb;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const float f = float(i);
+        qa.push_back(quaternion::rotation_axis(v(1, f, 3), 0.1f * f));
+        qb.push_back(quaternion::rotation_axis(v(f - 5, 2, 1), 6 - 0.3f * f)); // some on the opposite side
+    }
+    const auto p = points();
+
+    std::vector<quaternion> q(N);
+    multiply(qa.data(), qb.data(), q.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], qa[i] * qb[i], 1e-5f));
+    }
+
+    std::vector<quaternion> s = q;
+    for (auto& e : s) e *= 3.f;
+    normalize(s.data(), s.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(s[i], q[i], 1e-5f));
+    }
+
+    std::vector<vector3> r(N);
+    rotate(qa[7], p.data(), r.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(r[i], rotate(p[i], qa[7]), 1e-4f));
+    }
+
+    rotate(qa.data(), p.data(), r.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(r[i], rotate(p[i], qa[i]), 1e-4f));
+    }
+
+    std::vector<vertex> vertices(N);
+    for (size_t i = 0; i < N; ++i) vertices[i].pos = p[i];
+    rotate(qb[3], &vertices[0].pos, sizeof(vertex), &vertices[0].normal, sizeof(vertex), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vertices[i].normal, rotate(p[i], qb[3]), 1e-4f));
+    }
+
+    nlerp(qa.data(), qb.data(), 0.3f, q.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], nlerp(qa[i], qb[i], 0.3f), 1e-5f));
+    }
+
+    fast_slerp(qa.data(), qb.data(), 0.7f, q.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], fast_slerp(qa[i], qb[i], 0.7f), 1e-5f));
+    }
+}
+
+TEST_CASE("fast_normalize")
+{
+    auto p = points();
+    p[3] = vector3::zero();
+
+    std::vector<vector3> n(N);
+    std::vector<float> r(N);
+    fast_normalize(p.data(), n.data(), N);
+    rsqrt_length(p.data(), r.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (i == 3) continue;
+        CHECK(close(n[i], normalize(p[i]), 1e-6f));
+        CHECK(r[i] == Approx(1 / p[i].length()).epsilon(1e-6));
+    }
+    CHECK(n[3] == vector3::zero());
+    CHECK(std::isfinite(r[3]));
+
+    std::vector<vertex> vertices(N);
+    for (size_t i = 0; i < N; ++i) vertices[i].normal = p[i];
+    fast_normalize(&vertices[0].normal, sizeof(vertex), &vertices[0].normal, sizeof(vertex), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vertices[i].normal, n[i], 1e-6f));
+    }
+
+    std::vector<quaternion> q;
+    std::vector<vector4> v4;
+    for (const auto& e : p)
+    {
+        q.push_back(quaternion::xyzw(e.x, e.y, e.z, 1));
+        v4.push_back(vector4::coord(e.x, e.y, e.z, 2));
+    }
+
+    std::vector<quaternion> qn(N);
+    fast_normalize(q.data(), qn.data(), N);
+    rsqrt_length(q.data(), r.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(qn[i], normalize(q[i]), 1e-6f));
+        CHECK(r[i] == Approx(1 / q[i].length()).epsilon(1e-6));
+    }
+
+    fast_normalize(v4.data(), v4.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(v4[i], normalize(vector4::coord(p[i].x, p[i].y, p[i].z, 2)), 1e-6f));
+    }
+}
+
+TEST_CASE("trigonometry")
+{
+    std::vector<float> x, s(N), c(N), r(N);
+    for (size_t i = 0; i < N; ++i) x.push_back(float(i) * 0.9f - 16);
+
+    fast_sincos(x.data(), s.data(), c.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(s[i] == Approx(std::sin(x[i])).epsilon(1e-6));
+        CHECK(c[i] == Approx(std::cos(x[i])).epsilon(1e-6));
+    }
+
+    fast_sin(x.data(), r.data(), N);
+    CHECK(r == s);
+    fast_cos(x.data(), r.data(), N);
+    CHECK(r == c);
+
+    // quadrant boundaries
+    const float q[] = { 0, constants::PI_D4(), constants::PI_HALF(), constants::PI(), -constants::PI_HALF(), 3 * constants::PI_HALF(), 1000 };
+    for (float a : q)
+    {
+        float qs, qc;
+        fast_sincos(&a, &qs, &qc, 1);
+        CHECK(close(qs, std::sin(a), 1e-7f));
+        CHECK(close(qc, std::cos(a), 1e-7f));
+    }
+
+    for (size_t i = 0; i < N; ++i) x[i] = float(i) / (N - 1) * 2 - 1;
+    fast_acos(x.data(), r.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(r[i] == Approx(std::acos(x[i])).epsilon(1e-6));
+    }
+    x[0] = -1.5f;
+    x[1] = 2;
+    fast_acos(x.data(), r.data(), 2);
+    CHECK(r[0] == Approx(constants::PI()));
+    CHECK(r[1] == 0);
+
+    std::vector<double> xd(N), sd(N), cd(N);
+    for (size_t i = 0; i < N; ++i) xd[i] = double(i) - 16;
+    fast_sincos(xd.data(), sd.data(), cd.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(sd[i] == std::sin(xd[i]));
+        CHECK(cd[i] == std::cos(xd[i]));
+    }
+}
+
+TEST_CASE("rotations from angles")
+{
+    std::vector<float> a;
+    for (size_t i = 0; i < N; ++i) a.push_back(float(i) * 0.3f - 5);
+    const auto axis = v(1, 2, 3);
+
+    std::vector<quaternion> q(N);
+    std::vector<matrix3x4> m34(N);
+    std::vector<matrix> m44(N);
+
+    rotation_x(a.data(), q.data(), N);
+    rotation_x(a.data(), m34.data(), N);
+    rotation_x(a.data(), m44.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], quaternion::rotation_x(a[i]), 1e-6f));
+        CHECK(close(m34[i], matrix3x4::rotation_x(a[i]), 1e-6f));
+        CHECK(close(m44[i], matrix::rotation_x(a[i]), 1e-6f));
+    }
+
+    rotation_y(a.data(), q.data(), N);
+    rotation_y(a.data(), m34.data(), N);
+    rotation_y(a.data(), m44.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], quaternion::rotation_y(a[i]), 1e-6f));
+        CHECK(close(m34[i], matrix3x4::rotation_y(a[i]), 1e-6f));
+        CHECK(close(m44[i], matrix::rotation_y(a[i]), 1e-6f));
+    }
+
+    rotation_z(a.data(), q.data(), N);
+    rotation_z(a.data(), m34.data(), N);
+    rotation_z(a.data(), m44.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], quaternion::rotation_z(a[i]), 1e-6f));
+        CHECK(close(m34[i], matrix3x4::rotation_z(a[i]), 1e-6f));
+        CHECK(close(m44[i], matrix::rotation_z(a[i]), 1e-6f));
+    }
+
+    std::vector<matrix3x3> m33(N);
+    rotation_z(a.data(), m33.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(m33[i], matrix3x3::rotation_z(a[i]), 1e-6f));
+    }
+
+    rotation_axis(axis, a.data(), q.data(), N);
+    rotation_axis(axis, a.data(), m34.data(), N);
+    rotation_naxis(normalize(axis), a.data(), m44.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(q[i], quaternion::rotation_axis(axis, a[i]), 1e-6f));
+        CHECK(close(m34[i], matrix3x4::rotation_axis(axis, a[i]), 1e-6f));
+        CHECK(close(m44[i], matrix::rotation_axis(axis, a[i]), 1e-6f));
+    }
+}
+
+TEST_CASE("decompose")
+{
+    std::vector<matrix3x4> m34;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const float f = float(i);
+        const auto s = v(1 + f * 0.1f, i % 5 == 1 ? -2.f : 2.f, 0.5f);
+        m34.push_back(transform::trs(v(f, -f, 1), quaternion::rotation_axis(v(1, f, 3), 0.2f * f), s).to_matrix3x4());
+    }
+    // shear and singular matrices take the scalar path
+    m34[3] = m34[3] * matrix3x4::rows(1, 0.5f, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0);
+    m34[5] = matrix3x4::scaling(0, 1, 2);
+    m34[6] = matrix3x4::zero();
+
+    std::vector<transform> out(N);
+    decompose(m34.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto d = decompose(m34[i]);
+        CHECK(close(out[i].position, d.position));
+        CHECK((close(out[i].orientation, d.orientation, 1e-5f) || close(out[i].orientation, -d.orientation, 1e-5f)));
+        CHECK(close(out[i].scale, d.scale, 1e-4f));
+    }
+
+    std::vector<matrix4x4> m44(N);
+    for (size_t i = 0; i < N; ++i) m44[i] = out[i].to_matrix4x4();
+    decompose(m44.data(), out.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(out[i].to_matrix4x4(), m44[i], 1e-4f));
+    }
+}
@@ -0,0 +1,304 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/bvh.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("bvh");
+
+namespace
+{
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+vector3 rnd_point(float r)
+{
+    return v(rnd(-r, r), rnd(-r, r), rnd(-r, r));
+}
+
+struct mesh
+{
+    std::vector<vector3> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<aabb> bounds;
+
+    explicit mesh(size_t triangle_count)
+    {
+        for (size_t i = 0; i < triangle_count; ++i)
+        {
+            // clusters of small triangles
+            const auto c = i % 3 ? rnd_point(3) + v(10, 0, 0) : rnd_point(20);
+            for (size_t k = 0; k < 3; ++k)
+            {
+                indices.push_back(uint32_t(vertices.size()));
+                vertices.push_back(c + rnd_point(0.5f));
+            }
+        }
+        update_bounds();
+    }
+
+    size_t size() const { return indices.size() / 3; }
+
+    void update_bounds()
+    {
+        bounds.resize(size());
+        triangle_bounds(vertices.data(), indices.data(), size(), bounds.data());
+    }
+
+    ray_hit brute_force(const ray& r) const
+    {
+        return intersect(r, vertices.data(), indices.data(), size());
+    }
+};
+
+// the boxes of the nodes contain their children and every primitive is in one leaf
+void check_structure(const bvh& b, const std::vector<aabb>& bounds)
+{
+    std::vector<int> seen(bounds.size(), 0);
+    for (size_t i = 0; i < b.node_count(); ++i)
+    {
+        const auto& nd = b.nodes()[i];
+        CHECK(nd.occupied() != 0);
+        for (size_t s = 0; s < bvh::node_type::width; ++s)
+        {
+            if (nd.is_inner(s))
+            {
+                CHECK(nd.child[s] > i);
+                CHECK(nd.box(s).contains(b.nodes()[nd.child[s]].union_box()));
+            }
+            else if (nd.is_leaf(s))
+            {
+                CHECK(nd.count[s] <= 4);
+                for (uint32_t p = nd.child[s]; p < nd.child[s] + nd.count[s]; ++p)
+                {
+                    const auto id = b.primitives()[p];
+                    CHECK(nd.box(s).contains(bounds[id]));
+                    ++seen[id];
+                }
+            }
+        }
+    }
+    for (auto s : seen)
+    {
+        CHECK(s == 1);
+    }
+}
+
+void check_rays(const bvh& b, const mesh& m)
+{
+    size_t hits = 0;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        const auto r = ray::from_points(rnd_point(30), rnd_point(10) + v(i % 2 ? 10.f : 0.f, 0, 0));
+        const auto ref = m.brute_force(r);
+        const auto h = intersect(r, b, m.vertices.data(), m.indices.data());
+        CHECK(h.hit() == ref.hit());
+        if (!ref.hit()) continue;
+        ++hits;
+        CHECK(h.t == Approx(ref.t).epsilon(1e-4));
+    }
+    CHECK(hits > 20);
+}
+
+}
+
+TEST_CASE("build")
+{
+    const bvh empty;
+    CHECK(empty.empty());
+    CHECK(empty.node_count() == 0);
+    float t = 100;
+    CHECK(!empty.raycast(ray::from_origin_direction(v(0, 0, 0), v(1, 0, 0)), t, [](size_t, float&) { return true; }));
+
+    // a single primitive
+    const auto one = aabb::from_min_max(v(1, 1, 1), v(2, 2, 2));
+    const bvh single(&one, 1);
+    CHECK(single.size() == 1);
+    CHECK(single.node_count() == 1);
+    CHECK(single.bounds() == one);
+    check_structure(single, std::vector<aabb>(1, one));
+
+    // identical boxes can't be split by their centroids
+    const std::vector<aabb> same(100, one);
+    const bvh stacked(same.data(), same.size());
+    check_structure(stacked, same);
+
+    const mesh m(5000);
+    const bvh b(m.bounds.data(), m.size());
+    CHECK(b.size() == m.size());
+    CHECK(close(b.bounds(), bounds(m.vertices.data(), m.vertices.size())));
+    check_structure(b, m.bounds);
+
+    // the same tree with threads
+    bvh p;
+    p.build_parallel(m.bounds.data(), m.size(), 3);
+    REQUIRE(p.node_count() == b.node_count());
+    CHECK(memcmp(p.nodes(), b.nodes(), b.node_count() * sizeof(bvh::node_type)) == 0);
+    CHECK(memcmp(p.primitives(), b.primitives(), b.size() * sizeof(uint32_t)) == 0);
+
+    parallel::thread_pool pool(3);
+    bvh q;
+    q.build(pool, m.bounds.data(), m.size());
+    REQUIRE(q.node_count() == b.node_count());
+    CHECK(memcmp(q.nodes(), b.nodes(), b.node_count() * sizeof(bvh::node_type)) == 0);
+    CHECK(memcmp(q.primitives(), b.primitives(), b.size() * sizeof(uint32_t)) == 0);
+}
+
+TEST_CASE("ray")
+{
+    mesh m(3000);
+    bvh b(m.bounds.data(), m.size());
+    check_rays(b, m);
+
+    // t_max
+    const auto r = ray::from_points(v(-30, 0, 0), v(30, 0, 0));
+    const auto h = intersect(r, b, m.vertices.data(), m.indices.data());
+    if (h.hit())
+    {
+        CHECK(!intersect(r, b, m.vertices.data(), m.indices.data(), h.t).hit());
+        CHECK(intersect(r, b, m.vertices.data(), m.indices.data(), h.t * 1.01f).t == h.t);
+    }
+
+    // move the vertices and refit
+    for (auto& vert : m.vertices)
+    {
+        vert += v(rnd(-1, 1), rnd(-1, 1), rnd(-1, 1));
+    }
+    m.update_bounds();
+    b.refit(m.bounds.data());
+    check_structure(b, m.bounds);
+    check_rays(b, m);
+
+    // in parallel: the same boxes
+    bvh p(b), q(b);
+    for (auto& vert : m.vertices)
+    {
+        vert *= 1.1f;
+    }
+    m.update_bounds();
+    b.refit(m.bounds.data());
+    p.refit_parallel(m.bounds.data(), 3);
+    CHECK(memcmp(p.nodes(), b.nodes(), b.node_count() * sizeof(bvh::node_type)) == 0);
+    check_rays(p, m);
+
+    parallel::thread_pool pool(3);
+    q.refit(pool, m.bounds.data());
+    CHECK(memcmp(q.nodes(), b.nodes(), b.node_count() * sizeof(bvh::node_type)) == 0);
+}
+
+TEST_CASE("queries")
+{
+    const size_t N = 3000;
+    std::vector<vector3> points;
+    std::vector<aabb> bounds;
+    for (size_t i = 0; i < N; ++i)
+    {
+        points.push_back(rnd_point(20));
+        bounds.push_back(aabb::from_point(points.back()));
+    }
+    const bvh b(bounds.data(), N);
+    check_structure(b, bounds);
+
+    auto distance_sq = [&](size_t i, const vector3& p) {
+        const auto d = points[i] - p;
+        return dot(d, d);
+    };
+
+    for (size_t q = 0; q < 50; ++q)
+    {
+        const auto p = rnd_point(25);
+
+        // nearest
+        size_t ref = 0;
+        for (size_t i = 1; i < N; ++i)
+        {
+            if (distance_sq(i, p) < distance_sq(ref, p)) ref = i;
+        }
+        float d = std::numeric_limits<float>::max();
+        CHECK(b.nearest(p, d, [&](size_t i) { return distance_sq(i, p); }) == ref);
+        CHECK(d == distance_sq(ref, p));
+
+        // within a radius
+        float small = 0.01f;
+        const auto none = b.nearest(p, small, [&](size_t i) { return distance_sq(i, p); });
+        CHECK((none == bvh::no_primitive || distance_sq(none, p) < 0.01f));
+
+        // sphere: each primitive reported once, the ones inside included
+        const float radius = 4;
+        std::vector<int> reported(N, 0);
+        b.overlap_sphere(p, radius, [&](size_t i) { ++reported[i]; });
+        for (size_t i = 0; i < N; ++i)
+        {
+            CHECK(reported[i] <= 1);
+            if (distance_sq(i, p) <= radius * radius) CHECK(reported[i] == 1);
+        }
+    }
+
+    const auto f = frustum::from_view_projection(matrix4x4::perspective_fov_rh(1.f, 1.3f, 1, 50) * matrix4x4::look_at_rh(v(0, 0, -30), v(2, 1, 0), v(0, 1, 0)));
+
+    std::vector<int> reported(N, 0);
+    b.overlap_frustum(f, [&](size_t i) { ++reported[i]; });
+    size_t visible = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(reported[i] <= 1);
+        if (f.contains(points[i]))
+        {
+            CHECK(reported[i] == 1);
+            ++visible;
+        }
+    }
+    CHECK(visible > 0);
+    CHECK(visible < N);
+}
+
+TEST_CASE("double")
+{
+    std::vector<aabb_t<double>> bounds;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        const auto c = vector3_t<double>::coord(rnd(-10, 10), rnd(-10, 10), rnd(-10, 10));
+        bounds.push_back(aabb_t<double>::from_center_half_extents(c, vector3_t<double>::uniform(0.5)));
+    }
+    const bvh_t<double> b(bounds.data(), bounds.size());
+
+    const auto r = ray_t<double>::from_points(vector3_t<double>::coord(-20, -20, -20), vector3_t<double>::coord(20, 20, 20));
+    double t_max = std::numeric_limits<double>::max();
+    size_t nearest = bvh_t<double>::no_primitive;
+    b.raycast(r, t_max, [&](size_t i, double& t) {
+        double ht;
+        if (!intersect(r, bounds[i], ht, t) || ht >= t) return false;
+        t = ht;
+        nearest = i;
+        return true;
+    });
+
+    double ref_t = std::numeric_limits<double>::max();
+    size_t ref = bvh_t<double>::no_primitive;
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+        double ht;
+        if (intersect(r, bounds[i], ht) && ht < ref_t)
+        {
+            ref_t = ht;
+            ref = i;
+        }
+    }
+    CHECK(nearest == ref);
+    CHECK(t_max == ref_t);
+}
@@ -11,6 +11,7 @@
 #include "doctest/doctest.h"
 
 #include <cstring>
+#include <limits>
 
 
 template <typename Y>
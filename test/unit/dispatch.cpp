@@ -0,0 +1,186 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/dispatch.hpp"
+#include "yama/batch.hpp"
+#include "yama/frustum.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace yama;
+
+TEST_SUITE("dispatch");
+
+namespace
+{
+
+// not a multiple of any pack width
+const size_t N = 203;
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+vector3 rnd_vector(float r)
+{
+    return v(rnd(-r, r), rnd(-r, r), rnd(-r, r));
+}
+
+quaternion rnd_rotation()
+{
+    return quaternion::rotation_axis(rnd_vector(1) + v(0, 0, 2), rnd(-3, 3));
+}
+
+bool bit(const std::vector<uint32_t>& mask, size_t i)
+{
+    return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+template <typename V>
+void check_close(const std::vector<V>& a, const std::vector<V>& b)
+{
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        CHECK(close(a[i], b[i], 1e-4f));
+    }
+}
+
+// the kernels of the active instruction set against the header-only functions
+void check_kernels()
+{
+    std::vector<vector3> points(N), out(N), ref(N);
+    std::vector<quaternion> qa(N), qb(N), qout(N), qref(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        points[i] = rnd_vector(10);
+        qa[i] = rnd_rotation() * rnd(0.5f, 2);
+        qb[i] = rnd_rotation();
+    }
+
+    const auto m = matrix::translation(1, 2, 3) * matrix::rotation_axis(v(1, 1, 0), 0.7f) * matrix::scaling_uniform(2);
+    dispatch::transform_coords(m, points.data(), out.data(), N);
+    transform_coords(m, points.data(), ref.data(), N);
+    check_close(out, ref);
+
+    const auto m34 = matrix3x4::translation(-1, 0, 4) * matrix3x4::rotation_quaternion(qb[0]);
+    dispatch::transform_coords(m34, points.data(), out.data(), N);
+    transform_coords(m34, points.data(), ref.data(), N);
+    check_close(out, ref);
+
+    dispatch::transform_directions(m, points.data(), out.data(), N);
+    transform_directions(m, points.data(), ref.data(), N);
+    check_close(out, ref);
+
+    dispatch::fast_normalize(points.data(), out.data(), N);
+    fast_normalize(points.data(), ref.data(), N);
+    check_close(out, ref);
+
+    dispatch::rotate(qb[1], points.data(), out.data(), N);
+    rotate(qb[1], points.data(), ref.data(), N);
+    check_close(out, ref);
+
+    dispatch::normalize(qa.data(), qout.data(), N);
+    normalize(qa.data(), qref.data(), N);
+    check_close(qout, qref);
+
+    dispatch::multiply(qa.data(), qb.data(), qout.data(), N);
+    multiply(qa.data(), qb.data(), qref.data(), N);
+    check_close(qout, qref);
+
+    dispatch::nlerp(qb.data(), qa.data(), 0.3f, qout.data(), N);
+    nlerp(qb.data(), qa.data(), 0.3f, qref.data(), N);
+    check_close(qout, qref);
+
+    // culling, where volumes within epsilon of a plane can go either way
+    const auto f = frustum::from_view_projection(matrix::perspective_fov_rh(1.2f, 1, 1, 50) * matrix::look_at_rh(v(0, 0, 20), v(0, 0, 0), v(0, 1, 0)));
+    const float eps = 1e-3f;
+    const auto ev = vector3::uniform(eps);
+    vector4_soa spheres;
+    vector3_soa mins, maxs;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto c = rnd_vector(25);
+        const auto e = v(rnd(0, 2), rnd(0, 2), rnd(0, 2));
+        spheres.push_back(vector4::coord(c.x, c.y, c.z, rnd(0, 2)));
+        mins.push_back(c - e);
+        maxs.push_back(c + e);
+    }
+
+    std::vector<uint32_t> mask((N + 31) / 32);
+    size_t visible = 0;
+    dispatch::cull_spheres(f, spheres, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector4 s = spheres[i];
+        const auto c = v(s.x, s.y, s.z);
+        const bool in = f.intersects_sphere(c, s.w + eps);
+        if (in == f.intersects_sphere(c, s.w - eps))
+        {
+            CHECK(bit(mask, i) == in);
+        }
+        visible += bit(mask, i);
+    }
+    CHECK((mask.back() >> (N % 32)) == 0);
+    CHECK(visible > 0);
+    CHECK(visible < N);
+
+    dispatch::cull_aabbs(f, mins, maxs, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector3 a = mins[i], b = maxs[i];
+        const bool in = f.intersects_aabb(a - ev, b + ev);
+        if (in == f.intersects_aabb(a + ev, b - ev))
+        {
+            CHECK(bit(mask, i) == in);
+        }
+    }
+    CHECK((mask.back() >> (N % 32)) == 0);
+}
+
+}
+
+TEST_CASE("isa")
+{
+    CHECK(std::strcmp(dispatch::isa_name(dispatch::isa_scalar), "scalar") == 0);
+    CHECK(std::strcmp(dispatch::isa_name(dispatch::isa_avx512), "avx512") == 0);
+
+    // scalar is always there and the detected one is the best
+    CHECK(dispatch::is_supported(dispatch::isa_scalar));
+    const auto detected = dispatch::detected_isa();
+    CHECK(dispatch::is_supported(detected));
+    for (int i = detected + 1; i < dispatch::isa_count; ++i)
+    {
+        CHECK(!dispatch::is_supported(dispatch::isa_t(i)));
+    }
+    CHECK(!dispatch::is_supported(dispatch::isa_count));
+
+    CHECK(dispatch::force_isa(dispatch::isa_scalar));
+    CHECK(dispatch::active_isa() == dispatch::isa_scalar);
+    CHECK(!dispatch::force_isa(dispatch::isa_count));
+    CHECK(dispatch::active_isa() == dispatch::isa_scalar);
+
+    dispatch::reset_isa();
+    CHECK(dispatch::active_isa() == detected);
+}
+
+TEST_CASE("kernels")
+{
+    for (int i = 0; i < dispatch::isa_count; ++i)
+    {
+        const auto isa = dispatch::isa_t(i);
+        CHECK(dispatch::force_isa(isa) == dispatch::is_supported(isa));
+        if (!dispatch::is_supported(isa)) continue;
+
+        CHECK(dispatch::active_isa() == isa);
+        check_kernels();
+    }
+    dispatch::reset_isa();
+}
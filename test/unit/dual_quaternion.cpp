@@ -0,0 +1,108 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/dual_quaternion.hpp"
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("dual_quaternion");
+
+TEST_CASE("construction")
+{
+    const auto i = dual_quaternion::identity();
+    CHECK(i.real == quaternion::identity());
+    CHECK(i.dual == quaternion::zero());
+    CHECK(i.is_normalized());
+    CHECK(sizeof(dual_quaternion) == 8 * sizeof(float));
+
+    const float f[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const auto a = dual_quaternion::from_ptr(f);
+    CHECK(a.real == quaternion::xyzw(1, 2, 3, 4));
+    CHECK(a.dual == quaternion::xyzw(5, 6, 7, 8));
+    CHECK(memcmp(f, a.data(), sizeof(f)) == 0);
+    CHECK(dual_quaternion::attach_to_array(f)[0] == a);
+
+    const auto t = dual_quaternion::translation(1, 2, 3);
+    CHECK(t.is_normalized());
+    CHECK(t.translation_vector() == v(1, 2, 3));
+    CHECK(transform_coord(v(1, 1, 1), t) == v(2, 3, 4));
+
+    const auto q = quaternion::rotation_axis(v(1, 2, 3), 0.7f);
+    const auto rt = dual_quaternion::rotation_translation(q, v(4, 5, 6));
+    CHECK(rt.is_normalized());
+    CHECK(rt.real == q);
+    CHECK(close(rt.translation_vector(), v(4, 5, 6), 1e-5f));
+    CHECK(close(transform_coord(v(1, 2, 3), rt), rotate(v(1, 2, 3), q) + v(4, 5, 6), 1e-5f));
+    CHECK(close(rotate(v(1, 2, 3), rt), rotate(v(1, 2, 3), q)));
+
+    const auto r = dual_quaternion::rotation(q);
+    CHECK(close(r * dual_quaternion::translation(v(4, 5, 6)), dual_quaternion::rotation_translation(q, rotate(v(4, 5, 6), q)), 1e-5f));
+    CHECK(close(dual_quaternion::translation(v(4, 5, 6)) * r, rt, 1e-5f));
+}
+
+TEST_CASE("matrix")
+{
+    const quaternion rotations[] = {
+        quaternion::identity(),
+        quaternion::rotation_axis(v(1, 2, 3), 0.7f),
+        quaternion::rotation_x(3.1f),
+        quaternion::rotation_y(-3.1f),
+        quaternion::rotation_z(3.f),
+        quaternion::rotation_axis(v(-1, 1, 0), 3.1f),
+    };
+
+    for (const auto& q : rotations)
+    {
+        const auto m = matrix3x4::translation(1, 2, 3) * matrix3x4::rotation_quaternion(q);
+        const auto dq = dual_quaternion::from_matrix(m);
+        CHECK(dq.is_normalized());
+
+        // the same rotation, maybe with the opposite sign
+        CHECK((close(dq.real, q, 1e-5f) || close(dq.real, -q, 1e-5f)));
+        CHECK(close(dq.translation_vector(), v(1, 2, 3), 1e-5f));
+        CHECK(close(dq.to_matrix3x4(), m, 1e-5f));
+
+        const auto p = v(-3, 5, 2);
+        CHECK(close(transform_coord(p, dq), transform_coord(p, m), 1e-5f));
+    }
+}
+
+TEST_CASE("operations")
+{
+    const auto a = dual_quaternion::rotation_translation(quaternion::rotation_axis(v(1, 2, 3), 0.7f), v(4, 5, 6));
+    const auto b = dual_quaternion::rotation_translation(quaternion::rotation_axis(v(-3, 1, 0), 2.1f), v(-1, 0, 2));
+    const auto p = v(1, -2, 3);
+
+    // a*b applies b first
+    const auto ab = a * b;
+    CHECK(close(transform_coord(p, ab), transform_coord(transform_coord(p, b), a), 1e-5f));
+    CHECK(close(ab.to_matrix3x4(), a.to_matrix3x4() * b.to_matrix3x4(), 1e-5f));
+
+    auto c = a;
+    c *= b;
+    CHECK(close(c, ab, 1e-6f));
+
+    // the conjugate of a unit dual quaternion is its inverse
+    CHECK(close(a * conjugate(a), dual_quaternion::identity(), 1e-6f));
+    CHECK(close(transform_coord(transform_coord(p, a), conjugate(a)), p, 1e-5f));
+    c = a;
+    c.conjugate();
+    CHECK(c == conjugate(a));
+
+    const auto s = (a + b) * 0.5f;
+    CHECK(!s.is_normalized());
+    const auto n = normalize(s);
+    CHECK(n.is_normalized());
+    c = s;
+    CHECK(c.normalize() == Approx(s.real.length()));
+    CHECK(c == n);
+    CHECK(a - a == dual_quaternion::zero());
+    CHECK(2.f * a == a + a);
+    CHECK(a != b);
+}
@@ -0,0 +1,165 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/expr.hpp"
+
+#include <vector>
+
+using namespace yama;
+
+TEST_SUITE("expr");
+
+namespace
+{
+
+// not a multiple of any pack width
+const size_t N = 37;
+
+vector3 point(size_t i)
+{
+    const float f = float(i);
+    return v(f - 10, 2 * f + 1, 5 - f * 0.5f);
+}
+
+vector4 coord4(size_t i)
+{
+    const float f = float(i);
+    return vector4::coord(f, -f, 1 + f * f, 3);
+}
+
+struct particle
+{
+    vector3 position;
+    float age;
+};
+
+}
+
+TEST_CASE("soa")
+{
+    vector3_soa p, vel, out;
+    std::vector<float> mass(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        p.push_back(point(i));
+        vel.push_back(point(N - i) * 0.1f);
+        mass[i] = 1 + float(i);
+    }
+    const auto g = v(0, -9.8f, 0);
+
+    expr::assign(out, expr::ref(p) + expr::ref(vel) * 0.5f - g / expr::ref(mass.data(), N));
+    CHECK(out.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector3 pi = p[i], vi = vel[i];
+        const vector3 e = pi + vi * 0.5f - g / mass[i];
+        CHECK(YamaApprox(vector3(out[i])).epsilon(1e-4f) == e);
+    }
+
+    // in place
+    const auto ref = out;
+    expr::assign(out, -expr::ref(out) * expr::ref(vel) + 2);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector3 e = mul(-vector3(ref[i]), vector3(vel[i])) + vector3::uniform(2);
+        CHECK(YamaApprox(vector3(out[i])).epsilon(1e-4f) == e);
+    }
+
+    vector4_soa q, qout;
+    for (size_t i = 0; i < N; ++i) q.push_back(coord4(i));
+    const auto w = vector4::coord(1, 2, 3, 4);
+    expr::assign(qout, w * expr::ref(q) + expr::ref(q) * expr::ref(q));
+    CHECK(qout.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector4 a = q[i];
+        CHECK(YamaApprox(vector4(qout[i])).epsilon(1e-3f) == mul(w, a) + mul(a, a));
+    }
+}
+
+TEST_CASE("arrays")
+{
+    std::vector<vector3> a(N), b(N), out(N);
+    std::vector<vector4> a4(N), out4(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        a[i] = point(i);
+        b[i] = point(2 * i);
+        a4[i] = coord4(i);
+    }
+
+    expr::assign(out.data(), (expr::ref(a.data(), N) - expr::ref(b.data(), N)) / 4);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == (a[i] - b[i]) / 4.f);
+    }
+
+    expr::assign(out4.data(), expr::ref(a4.data(), N) * 3 + vector4::coord(1, 1, 1, 1));
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out4[i]).epsilon(1e-4f) == a4[i] * 3.f + vector4::coord(1, 1, 1, 1));
+    }
+
+    // scalars
+    std::vector<float> s(N), t(N), sout(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        s[i] = float(i);
+        t[i] = 1 - float(i);
+    }
+    expr::assign(sout.data(), expr::ref(s.data(), N) * expr::ref(t.data(), N) - 1);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(doctest::Approx(sout[i]) == s[i] * t[i] - 1);
+    }
+
+    // SoA from arrays
+    vector3_soa soa;
+    expr::assign(soa, expr::ref(a.data(), N) + expr::ref(b.data(), N));
+    CHECK(soa.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vector3(soa[i])) == a[i] + b[i]);
+    }
+}
+
+TEST_CASE("strided")
+{
+    std::vector<particle> ps(N);
+    std::vector<vector3> vel(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        ps[i].position = point(i);
+        ps[i].age = float(i);
+        vel[i] = point(N - i);
+    }
+
+    const auto pos = strided_span<vector3>::from_ptr(&ps[0].position, sizeof(particle), N);
+    expr::assign(pos, expr::ref(pos) + expr::ref(vel.data(), N) * 0.25f);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(ps[i].position).epsilon(1e-4f) == point(i) + vel[i] * 0.25f);
+        CHECK(ps[i].age == float(i));
+    }
+
+    // interleaved vector4
+    struct vertex { vector4 color; float u; };
+    std::vector<vertex> vs(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        vs[i].color = coord4(i);
+        vs[i].u = float(i);
+    }
+    const auto colors = strided_span<vector4>::from_ptr(&vs[0].color, sizeof(vertex), N);
+    expr::assign(colors, expr::ref(colors) * 0.5f);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vs[i].color) == coord4(i) * 0.5f);
+        CHECK(vs[i].u == float(i));
+    }
+}
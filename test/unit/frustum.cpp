@@ -0,0 +1,175 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/frustum.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("frustum");
+
+namespace
+{
+
+// not a multiple of the mask word size
+const size_t N = 1000;
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+bool bit(const std::vector<uint32_t>& mask, size_t i)
+{
+    return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+// a camera at (0, 0, 5) looking at -z with a 90 degree field of view
+matrix view_projection()
+{
+    return matrix::perspective_fov_rh(constants::PI() / 2, 1, 1, 100) * matrix::look_at_rh(v(0, 0, 5), v(0, 0, 0), v(0, 1, 0));
+}
+
+matrix view_projection_cube()
+{
+    return matrix::perspective_fov_rh_cube(constants::PI() / 2, 1, 1, 100) * matrix::look_at_rh(v(0, 0, 5), v(0, 0, 0), v(0, 1, 0));
+}
+
+}
+
+TEST_CASE("planes")
+{
+    const frustum fs[] = { frustum::from_view_projection(view_projection()), frustum::from_view_projection_cube(view_projection_cube()) };
+
+    for (const auto& f : fs)
+    {
+        for (const auto& p : f.planes)
+        {
+            CHECK(Approx(p.x*p.x + p.y*p.y + p.z*p.z) == 1);
+        }
+
+        CHECK(f.distance(frustum::near_plane, v(0, 0, 4)) == Approx(0).epsilon(1e-4));
+        CHECK(f.distance(frustum::far_plane, v(0, 0, -95)) == Approx(0).epsilon(1e-3));
+        CHECK(f.distance(frustum::near_plane, v(3, 2, 0)) == Approx(4));
+        CHECK(f.distance(frustum::right_plane, v(10, 0, -5)) == Approx(0).epsilon(1e-4));
+        CHECK(f.distance(frustum::left_plane, v(-10, 0, -5)) == Approx(0).epsilon(1e-4));
+        CHECK(f.distance(frustum::top_plane, v(0, 10, -5)) == Approx(0).epsilon(1e-4));
+        CHECK(f.distance(frustum::bottom_plane, v(0, -10, -5)) == Approx(0).epsilon(1e-4));
+
+        CHECK(f.contains(v(0, 0, 0)));
+        CHECK(f.contains(v(9, -9, -5)));
+        CHECK(!f.contains(v(0, 0, 4.5f)));
+        CHECK(!f.contains(v(0, 0, 10)));
+        CHECK(!f.contains(v(0, 0, -96)));
+        CHECK(!f.contains(v(11, 0, -5)));
+        CHECK(!f.contains(v(0, -11, -5)));
+    }
+}
+
+TEST_CASE("volumes")
+{
+    const auto f = frustum::from_view_projection(view_projection());
+
+    // 2/sqrt(2) outside of the right plane
+    CHECK(!f.intersects_sphere(v(12, 0, -5), 1));
+    CHECK(f.intersects_sphere(v(12, 0, -5), 1.5f));
+    CHECK(f.intersects_sphere(v(0, 0, -5), 1000));
+
+    CHECK(f.intersects_aabb(v(-1, -1, -6), v(1, 1, -4)));
+    CHECK(f.intersects_aabb(v(9, -1, -6), v(11, 1, -4)));
+    CHECK(!f.intersects_aabb(v(12, -1, -6), v(14, 1, -4)));
+    CHECK(!f.intersects_aabb(v(-1, -1, 4.5f), v(1, 1, 8)));
+
+    // a thin box, 2/sqrt(2) outside of the right plane, which reaches into
+    // the frustum unless its long side is parallel to the plane
+    const auto c = v(12, 0, -5);
+    const auto e = v(3, 0.1f, 0.1f);
+    CHECK(f.intersects_obb(c, e, quaternion::identity()));
+    CHECK(!f.intersects_obb(c, e, quaternion::rotation_y(constants::PI() / 4)));
+    CHECK(f.intersects_obb(c, e, quaternion::rotation_y(-constants::PI() / 4)));
+}
+
+TEST_CASE("batch")
+{
+    const auto f = frustum::from_view_projection(view_projection());
+    std::srand(7);
+
+    vector4_soa spheres;
+    vector3_soa mins, maxs, centers, extents;
+    quaternion_soa orientations;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto c = v(rnd(-30, 30), rnd(-30, 30), rnd(-120, 10));
+        const auto e = v(rnd(0, 5), rnd(0, 5), rnd(0, 5));
+        spheres.push_back(vector4::coord(c.x, c.y, c.z, rnd(0, 5)));
+        mins.push_back(c - e);
+        maxs.push_back(c + e);
+        centers.push_back(c);
+        extents.push_back(e);
+        orientations.push_back(quaternion::rotation_axis(v(rnd(-1, 1), rnd(-1, 1), 1), rnd(-3, 3)));
+    }
+
+    // the batch functions may use fused multiply-adds, so volumes within
+    // epsilon of a plane can go either way
+    const float eps = 1e-3f;
+    const auto ev = vector3::uniform(eps);
+
+    std::vector<uint32_t> mask((N + 31) / 32);
+    size_t visible = 0;
+
+    cull_spheres(f, spheres, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector4 s = spheres[i];
+        const auto c = v(s.x, s.y, s.z);
+        const bool in = f.intersects_sphere(c, s.w + eps);
+        if (in == f.intersects_sphere(c, s.w - eps))
+        {
+            CHECK(bit(mask, i) == in);
+        }
+        visible += bit(mask, i);
+    }
+    // the bits after the last sphere are clear
+    CHECK((mask.back() >> (N % 32)) == 0);
+    // some visible and some culled
+    CHECK(visible > 0);
+    CHECK(visible < N);
+
+    cull_aabbs(f, mins, maxs, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector3 a = mins[i], b = maxs[i];
+        const bool in = f.intersects_aabb(a - ev, b + ev);
+        if (in == f.intersects_aabb(a + ev, b - ev))
+        {
+            CHECK(bit(mask, i) == in);
+        }
+    }
+    CHECK((mask.back() >> (N % 32)) == 0);
+
+    cull_obbs(f, centers, extents, orientations, mask.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        const vector3 c = centers[i], e = extents[i];
+        const quaternion q = orientations[i];
+        const bool in = f.intersects_obb(c, e + ev, q);
+        if (in == f.intersects_obb(c, e - ev, q))
+        {
+            CHECK(bit(mask, i) == in);
+        }
+    }
+    CHECK((mask.back() >> (N % 32)) == 0);
+
+    // empty input writes nothing
+    uint32_t word = 0xffffffff;
+    cull_spheres(f, vector4_soa(), &word);
+    CHECK(word == 0xffffffff);
+}
@@ -0,0 +1,221 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/hierarchy.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace yama;
+
+TEST_SUITE("hierarchy");
+
+namespace
+{
+
+const size_t no_parent = hierarchy::no_parent;
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+// parents come before their children, with a few roots
+std::vector<size_t> random_parents(size_t count)
+{
+    std::vector<size_t> ret;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ret.push_back(i == 0 || std::rand() % 50 == 0 ? no_parent : size_t(std::rand()) % i);
+    }
+    return ret;
+}
+
+transform random_transform()
+{
+    return transform::trs(v(rnd(-5, 5), rnd(-5, 5), rnd(-5, 5)), quaternion::rotation_axis(v(rnd(-1, 1), rnd(-1, 1), 1), rnd(-3, 3)), v(rnd(0.5f, 2), rnd(0.5f, 2), rnd(0.5f, 2)));
+}
+
+// the world transformations in the original order
+template <typename Local>
+std::vector<matrix3x4> reference_worlds(const std::vector<size_t>& parents, const std::vector<Local>& locals)
+{
+    std::vector<matrix3x4> ret;
+    for (size_t i = 0; i < parents.size(); ++i)
+    {
+        const auto l = internal::local_matrix(locals[i]);
+        ret.push_back(parents[i] == no_parent ? l : ret[parents[i]] * l);
+    }
+    return ret;
+}
+
+template <typename Local>
+void check_worlds(const hierarchy_t<Local>& h, const std::vector<size_t>& parents, const std::vector<Local>& locals)
+{
+    const auto ref = reference_worlds(parents, locals);
+    for (size_t i = 0; i < parents.size(); ++i)
+    {
+        CHECK(close(h.world(i), ref[i], 1e-3f));
+    }
+}
+
+}
+
+TEST_CASE("structure")
+{
+    const size_t parents[] = { no_parent, 0, 1, 0, no_parent, 4, 2, 3 };
+    const size_t depths[] = { 0, 1, 2, 1, 0, 1, 3, 2 };
+    const size_t count = 8;
+    const std::vector<matrix3x4> locals(count, matrix3x4::identity());
+
+    const hierarchy h(parents, locals.data(), count);
+    CHECK(h.size() == count);
+    CHECK(h.level_count() == 4);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        CHECK(h.parent(i) == parents[i]);
+        CHECK(h.depth(i) == depths[i]);
+        CHECK(h.id(h.slot(i)) == i);
+    }
+
+    // breadth-first, parents in the previous level and in the order of the
+    // level above
+    const size_t order[] = { 0, 4, 1, 3, 5, 2, 7, 6 };
+    for (size_t s = 0; s < count; ++s)
+    {
+        CHECK(h.id(s) == order[s]);
+    }
+    for (size_t d = 1; d < h.level_count(); ++d)
+    {
+        for (size_t s = h.level_begin(d); s < h.level_end(d); ++s)
+        {
+            CHECK(h.parent_slots()[s] >= h.level_begin(d - 1));
+            CHECK(h.parent_slots()[s] < h.level_end(d - 1));
+            if (s > h.level_begin(d)) CHECK(h.parent_slots()[s] >= h.parent_slots()[s - 1]);
+        }
+    }
+
+    // the children of every slot are consecutive
+    const size_t first_children[] = { 2, 4, 5, 6, 7, 7, 8, 8, 8 };
+    for (size_t s = 0; s <= count; ++s)
+    {
+        CHECK(h.first_child_slots()[s] == first_children[s]);
+    }
+    for (size_t s = 0; s < count; ++s)
+    {
+        for (size_t c = h.first_child_slots()[s]; c < h.first_child_slots()[s + 1]; ++c)
+        {
+            CHECK(h.parent_slots()[c] == s);
+        }
+    }
+
+    const hierarchy empty;
+    CHECK(empty.empty());
+    CHECK(empty.level_count() == 0);
+}
+
+TEST_CASE("update")
+{
+    const size_t N = 301;
+    const auto parents = random_parents(N);
+    std::vector<matrix3x4> locals;
+    for (size_t i = 0; i < N; ++i) locals.push_back(random_transform().to_matrix3x4());
+
+    hierarchy h(parents.data(), locals.data(), N);
+    CHECK(h.update() == N);
+    check_worlds(h, parents, locals);
+
+    // nothing changed
+    CHECK(h.update() == 0);
+
+    // only the subtree of the changed node
+    const size_t changed = 17;
+    locals[changed] = random_transform().to_matrix3x4();
+    h.set_local(changed, locals[changed]);
+    CHECK(h.local(changed) == locals[changed]);
+
+    std::vector<bool> in_subtree(N, false);
+    size_t subtree_size = 0;
+    for (size_t i = changed; i < N; ++i)
+    {
+        in_subtree[i] = i == changed || (parents[i] != no_parent && in_subtree[parents[i]]);
+        subtree_size += in_subtree[i];
+    }
+    CHECK(h.update() == subtree_size);
+    check_worlds(h, parents, locals);
+
+    // several nodes, some of them in each other's subtrees
+    for (size_t i = 0; i < N; i += 37)
+    {
+        locals[i] = random_transform().to_matrix3x4();
+        h.set_local(i, locals[i]);
+    }
+    h.update();
+    check_worlds(h, parents, locals);
+
+    h.mark_dirty(0);
+    CHECK(h.update() > 0);
+    CHECK(h.update() == 0);
+}
+
+TEST_CASE("trs")
+{
+    const size_t N = 301;
+    const auto parents = random_parents(N);
+    std::vector<transform> locals;
+    for (size_t i = 0; i < N; ++i) locals.push_back(random_transform());
+
+    transform_hierarchy h(parents.data(), locals.data(), N);
+    h.update();
+    check_worlds(h, parents, locals);
+
+    locals[5] = random_transform();
+    h.set_local(5, locals[5]);
+    h.update();
+    check_worlds(h, parents, locals);
+}
+
+TEST_CASE("parallel")
+{
+    // wide enough for the levels to be split between threads
+    const size_t N = 5000;
+    std::vector<size_t> parents;
+    for (size_t i = 0; i < N; ++i)
+    {
+        parents.push_back(i < 4 ? no_parent : size_t(std::rand()) % (i / 4));
+    }
+    std::vector<matrix3x4> locals;
+    for (size_t i = 0; i < N; ++i) locals.push_back(random_transform().to_matrix3x4());
+
+    hierarchy h(parents.data(), locals.data(), N);
+    h.update_parallel(3);
+    check_worlds(h, parents, locals);
+
+    for (size_t i = 0; i < N; i += 101)
+    {
+        locals[i] = random_transform().to_matrix3x4();
+        h.set_local(i, locals[i]);
+    }
+    h.update_parallel(3);
+    check_worlds(h, parents, locals);
+    CHECK(h.update() == 0);
+
+    // on a pool, with the same count as the serial update
+    parallel::thread_pool pool(3);
+    hierarchy s(h);
+    for (size_t i = 7; i < N; i += 53)
+    {
+        locals[i] = random_transform().to_matrix3x4();
+        h.set_local(i, locals[i]);
+        s.set_local(i, locals[i]);
+    }
+    CHECK(h.update(pool) == s.update());
+    check_worlds(h, parents, locals);
+    CHECK(h.update(pool) == 0);
+}
@@ -0,0 +1,146 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("matrix");
+
+// matrix2x3 is the same type as the shorthand for matrix2x3_t<float>
+typedef matrix_t<float, 2, 3> matrix2x3;
+typedef matrix_t<float, 3, 2> matrix3x2;
+
+TEST_CASE("construction")
+{
+    auto m0 = matrix2x3::zero();
+    for (auto f : m0) CHECK(f == 0);
+    CHECK(sizeof(m0) == 6 * sizeof(float));
+
+    const float cols[] = { 1, 2, 3, 4, 5, 6 };
+    auto m1 = matrix2x3::columns(1, 2, 3, 4, 5, 6);
+    CHECK(memcmp(cols, &m1, sizeof(cols)) == 0);
+    CHECK(m1(0, 0) == 1);
+    CHECK(m1(1, 0) == 2);
+    CHECK(m1(0, 1) == 3);
+    CHECK(m1(1, 2) == 6);
+
+    auto m2 = matrix2x3::rows(
+        1, 3, 5,
+        2, 4, 6);
+    CHECK(m2 == m1);
+    CHECK(m1.column(1)[1] == 4);
+    CHECK(m1.column_vector(2) == vector2::coord(5, 6));
+    CHECK(m1.row_vector(1) == vector3::coord(2, 4, 6));
+
+    auto m3 = matrix2x3::from_ptr(cols);
+    CHECK(m3 == m1);
+    m3.column_vector(0) = vector2::uniform(7);
+    CHECK(m3(1, 0) == 7);
+
+    auto i = matrix3x2::identity();
+    CHECK(i == matrix3x2::rows(
+        1, 0,
+        0, 1,
+        0, 0));
+
+    CHECK(transpose(m1) == matrix3x2::rows(
+        1, 2,
+        3, 4,
+        5, 6));
+
+    static_assert(matrix2x3::identity().m11 == 1, "constexpr identity");
+    static_assert(transpose(matrix2x3::columns(1, 2, 3, 4, 5, 6)).values[5] == 6, "constexpr transpose");
+    static_assert((matrix2x3::uniform(1) * matrix3x2::uniform(2)).values[2] == 6, "constexpr product");
+    static_assert(matrixn<2, 5>::value_count == 10, "shorthand");
+    static_assert(is_matrix<matrix2x3>::value && is_yama<matrix2x3>::value, "traits");
+    static_assert(std::is_same<matrix2x3, matrix2x3_t<float>>::value, "matrix_t specialisation");
+}
+
+TEST_CASE("named types")
+{
+    auto m44 = matrix4x4::rotation_axis(vector3::coord(1, 2, 3), 1.2f) * matrix4x4::translation(1, 2, 3);
+    auto n44 = matrix4x4::scaling(2, 3, 4) * matrix4x4::rotation_x(0.3f);
+    auto g44 = matrix_t<float, 4, 4>::from(m44);
+    auto h44 = matrix_t<float, 4, 4>::from(n44);
+    CHECK(memcmp(&g44, &m44, sizeof(m44)) == 0);
+
+    CHECK(close((g44 * h44).as<matrix4x4>(), m44 * n44));
+    CHECK((g44 + h44).as<matrix4x4>() == m44 + n44);
+    CHECK((g44 - h44).as<matrix4x4>() == m44 - n44);
+    CHECK((g44 * 2.f).as<matrix4x4>() == m44 * 2.f);
+
+    auto g = g44;
+    g *= h44;
+    CHECK(g == g44 * h44);
+
+    auto m34 = matrix3x4::rotation_axis(vector3::coord(3, 1, -1), 0.7f) * matrix3x4::translation(5, -2, 1);
+    auto g34 = matrix_t<float, 3, 4>::from(m34);
+    CHECK(g34(1, 3) == m34.m13);
+
+    auto p = vector3::coord(1, -4, 2);
+    auto gp = g34 * vector_t<float, 4>::coord(p.x, p.y, p.z, 1.f);
+    CHECK(close(gp.as<vector3>(), transform_coord(p, m34)));
+}
+
+TEST_CASE("arithmetic")
+{
+    auto a = matrix2x3::columns(1, 2, 3, 4, 5, 6);
+    auto b = a;
+    b += matrix2x3::uniform(1);
+    CHECK(b == matrix2x3::columns(2, 3, 4, 5, 6, 7));
+    b -= a;
+    CHECK(b == matrix2x3::uniform(1));
+    b *= 6;
+    b /= 3;
+    CHECK(b == matrix2x3::uniform(2));
+    CHECK(-a == a * -1.f);
+    CHECK(a / 2.f == 0.5f * a);
+    CHECK(mul(a, b) == a * 2.f);
+    CHECK(div(a, b) == a / 2.f);
+    CHECK(abs(-a) == a);
+    CHECK(close(a, a + matrix2x3::uniform(0.00001f), 0.0001f));
+
+    // 2x3 * 3x2 and the product with a vector
+    auto c = a * transpose(a);
+    CHECK((c == matrix_t<float, 2, 2>::rows(
+        35, 44,
+        44, 56)));
+    CHECK((a * vector_t<float, 3>::coord(1, 0, -1) == vector_t<float, 2>::coord(-4, -4)));
+
+    CHECK(isfinite(a));
+    a(1, 1) = std::numeric_limits<float>::quiet_NaN();
+    CHECK(!isfinite(a));
+}
+
+TEST_CASE("square")
+{
+    auto a = matrix_t<float, 2, 2>::rows(
+        4, 7,
+        2, 6);
+    CHECK(a.determinant() == 10);
+    static_assert(matrix_t<float, 2, 2>::rows(1, 2, 3, 4).determinant() == -2, "constexpr determinant");
+
+    float det;
+    auto ia = inverse(a, det);
+    CHECK(det == 10);
+    CHECK(close(ia, matrix_t<float, 2, 2>::rows(
+        0.6f, -0.7f,
+        -0.2f, 0.4f)));
+    CHECK(close(ia * a, matrix_t<float, 2, 2>::identity()));
+
+    auto b = matrix_t<float, 3, 3>::rows(
+        2, 0, 1,
+        1, 3, 2,
+        1, 1, 2);
+    CHECK(b.determinant() == Approx(6));
+    auto ib = b;
+    CHECK(ib.inverse() == Approx(6));
+    CHECK(close(ib * b, matrix_t<float, 3, 3>::identity(), 0.0001f));
+    CHECK(close(inverse(b), ib));
+}
@@ -0,0 +1,126 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("matrix2x3");
+
+TEST_CASE("construction")
+{
+    double d0[] = {
+        0, 0,
+        0, 0,
+        0, 0,
+    };
+
+    auto m0 = matrix2x3_t<double>::zero();
+    CHECK(memcmp(d0, &m0, 6 * sizeof(double)) == 0);
+    CHECK(sizeof(m0) == 6 * sizeof(double));
+
+    float f1[] = { 1, 2, 3, 4, 5, 6 };
+    auto m1 = matrix2x3::columns(1, 2, 3, 4, 5, 6);
+    CHECK(m1.m00 == 1);
+    CHECK(m1.m10 == 2);
+    CHECK(m1.m01 == 3);
+    CHECK(m1.m11 == 4);
+    CHECK(m1.m02 == 5);
+    CHECK(m1.m12 == 6);
+    CHECK(memcmp(f1, &m1, 6 * sizeof(float)) == 0);
+
+    auto m2 = matrix2x3::rows(1, 3, 5, 2, 4, 6);
+    CHECK(m2 == m1);
+    CHECK(m2(1, 2) == 6);
+    CHECK(m2.column_vector(2) == v(5, 6));
+    CHECK(m2.row_vector(0) == v(1, 3, 5));
+
+    CHECK(matrix2x3::from_ptr(f1) == m1);
+    CHECK(m1.as_matrix2x3_t<double>().m12 == 6);
+
+    auto i = matrix2x3::identity();
+    CHECK(i == matrix2x3::scaling_uniform(1));
+    CHECK(i == matrix2x3::translation(0, 0));
+    CHECK(i == matrix2x3::rotation(0));
+    CHECK(i == matrix2x3::skew(0, 0));
+}
+
+TEST_CASE("transforms")
+{
+    const auto p = v(3, -2);
+
+    CHECK(transform_coord(p, matrix2x3::translation(1, 2)) == v(4, 0));
+    CHECK(transform_coord(p, matrix2x3::translation(v(1, 2))) == v(4, 0));
+    CHECK(transform_coord(p, matrix2x3::scaling(2, 3)) == v(6, -6));
+    CHECK(transform_coord(p, matrix2x3::scaling(v(2, 3))) == v(6, -6));
+    CHECK(transform_coord(p, matrix2x3::scaling_uniform(2)) == v(6, -4));
+
+    CHECK(close(transform_coord(v(1, 0), matrix2x3::rotation(constants::PI() / 2)), v(0, 1)));
+    CHECK(close(transform_coord(v(0, 1), matrix2x3::rotation(constants::PI() / 2)), v(-1, 0)));
+
+    auto s = matrix2x3::skew(constants::PI() / 4, 0);
+    CHECK(close(transform_coord(v(0, 2), s), v(2, 2)));
+    CHECK(close(transform_coord(v(2, 0), s), v(2, 0)));
+    CHECK(matrix2x3::skew_factors(0.5f, 2) == matrix2x3::rows(1, 0.5f, 0, 2, 1, 0));
+
+    // composition applies the right one first
+    auto m = matrix2x3::translation(5, 1) * matrix2x3::rotation(0.7f) * matrix2x3::scaling(2, 3);
+    auto stepwise = transform_coord(transform_coord(transform_coord(p, matrix2x3::scaling(2, 3)), matrix2x3::rotation(0.7f)), matrix2x3::translation(5, 1));
+    CHECK(close(transform_coord(p, m), stepwise));
+
+    auto m2 = matrix2x3::translation(5, 1);
+    m2 *= matrix2x3::rotation(0.7f);
+    m2 *= matrix2x3::scaling(2, 3);
+    CHECK(close(m2, m));
+
+    // the same as the 3D transform in the xy plane
+    auto p3 = transform_coord(v(p.x, p.y, 7), m.to_matrix4x4());
+    CHECK(close(p3, v(stepwise.x, stepwise.y, 7)));
+}
+
+TEST_CASE("inverse")
+{
+    auto m = matrix2x3::translation(5, 1) * matrix2x3::rotation(0.7f) * matrix2x3::scaling(2, 3) * matrix2x3::skew(0.2f, 0.1f);
+
+    float det;
+    auto im = inverse(m, det);
+    CHECK(det == Approx(m.determinant()));
+    CHECK(close(im * m, matrix2x3::identity(), 0.0001f));
+    CHECK(close(m * im, matrix2x3::identity(), 0.0001f));
+
+    auto r = matrix2x3::translation(-3, 4) * matrix2x3::rotation(1.3f);
+    CHECK(close(inverse_rigid(r), inverse(r)));
+    CHECK(r.determinant() == Approx(1));
+}
+
+TEST_CASE("arithmetic")
+{
+    auto a = matrix2x3::columns(1, 2, 3, 4, 5, 6);
+    auto b = matrix2x3::uniform(2);
+
+    CHECK(a + b == matrix2x3::columns(3, 4, 5, 6, 7, 8));
+    CHECK(a - b == matrix2x3::columns(-1, 0, 1, 2, 3, 4));
+    CHECK(a * 2.f == mul(a, b));
+    CHECK(2.f * a == a * 2.f);
+    CHECK(a / 2.f == div(a, b));
+    CHECK(12.f / a == matrix2x3::columns(12, 6, 4, 3, 2.4f, 2));
+    CHECK(-a == a * -1.f);
+    CHECK(abs(-a) == a);
+
+    auto c = a;
+    c += b;
+    c -= b;
+    CHECK(c == a);
+    c *= 3;
+    c /= 3;
+    CHECK(close(c, a));
+
+    CHECK(isfinite(a));
+    a.m02 = std::numeric_limits<float>::quiet_NaN();
+    CHECK(!isfinite(a));
+}
@@ -0,0 +1,191 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("matrix3x3");
+
+TEST_CASE("construction")
+{
+    double d0[] = {
+        0, 0, 0,
+        0, 0, 0,
+        0, 0, 0,
+    };
+
+    auto m0 = matrix3x3_t<double>::zero();
+    CHECK(memcmp(d0, &m0, 9 * sizeof(double)) == 0);
+    CHECK(sizeof(m0) == 9 * sizeof(double));
+
+    float f1[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    auto m1 = matrix3x3::columns(1, 2, 3, 4, 5, 6, 7, 8, 9);
+    CHECK(m1.m00 == 1);
+    CHECK(m1.m10 == 2);
+    CHECK(m1.m20 == 3);
+    CHECK(m1.m01 == 4);
+    CHECK(m1.m11 == 5);
+    CHECK(m1.m21 == 6);
+    CHECK(m1.m02 == 7);
+    CHECK(m1.m12 == 8);
+    CHECK(m1.m22 == 9);
+    CHECK(memcmp(f1, &m1, 9 * sizeof(float)) == 0);
+
+    auto m2 = matrix3x3::rows(1, 4, 7, 2, 5, 8, 3, 6, 9);
+    CHECK(m2 == m1);
+    CHECK(m2(1, 2) == 8);
+    CHECK(m2.column_vector(1) == vector3::coord(4, 5, 6));
+    CHECK(m2.row_vector(1) == vector3::coord(2, 5, 8));
+    CHECK(m2.main_diagonal() == vector3::coord(1, 5, 9));
+    CHECK(m2.trace() == 15);
+
+    auto m3 = matrix3x3::from_ptr(f1);
+    CHECK(m3 == m1);
+
+    auto i = matrix3x3::identity();
+    CHECK(i == matrix3x3::scaling_uniform(1));
+    CHECK(matrix3x3::scaling(2, 3, 4).main_diagonal() == vector3::coord(2, 3, 4));
+
+    auto md = m1.as_matrix3x3_t<double>();
+    CHECK(md.m21 == 6);
+
+    // the specialisation of the generic matrix
+    static_assert(std::is_same<matrix3x3, matrix_t<float, 3, 3>>::value, "matrix_t specialisation");
+    static_assert(matrix3x3::identity().determinant() == 1, "constexpr determinant");
+    static_assert(transpose(matrix3x3::columns(1, 2, 3, 4, 5, 6, 7, 8, 9)).m01 == 2, "constexpr transpose");
+    static_assert((matrix3x3::uniform(1) * matrix3x3::uniform(2)).m21 == 6, "constexpr product");
+    CHECK((m1 * vector_t<float, 3>::coord(1, 0, 0) == vector_t<float, 3>::from(m1.column_vector(0))));
+    CHECK((matrix_t<float, 3, 3>::from(m1).as<matrix3x3>() == m1));
+}
+
+TEST_CASE("conversions")
+{
+    auto m34 = matrix3x4::rotation_axis(vector3::coord(1, 2, 3), 0.7f) * matrix3x4::translation(4, 5, 6);
+    auto m33 = matrix3x3::from_matrix(m34);
+    CHECK(m33.m00 == m34.m00);
+    CHECK(m33.m12 == m34.m12);
+    CHECK(m33.m21 == m34.m21);
+
+    auto back34 = m33.to_matrix3x4();
+    CHECK(close(back34, matrix3x4::rotation_axis(vector3::coord(1, 2, 3), 0.7f)));
+
+    auto m44 = matrix4x4::rotation_x(0.3f) * matrix4x4::scaling(1, 2, 3);
+    CHECK(matrix3x3::from_matrix(m44).to_matrix4x4() == m44);
+
+    auto q = quaternion::rotation_axis(vector3::coord(-1, 2, 0.5f), 1.1f);
+    auto mq = matrix3x3::rotation_quaternion(q);
+    CHECK(close(mq.to_matrix3x4(), matrix3x4::rotation_quaternion(q)));
+
+    auto q2 = mq.to_quaternion();
+    CHECK((close(q2, q, 0.0001f) || close(q2, -q, 0.0001f)));
+}
+
+TEST_CASE("rotations")
+{
+    const auto axis = normalize(vector3::coord(2, -1, 3));
+    CHECK(close(matrix3x3::rotation_naxis(axis, 0.4f).to_matrix3x4(), matrix3x4::rotation_naxis(axis, 0.4f)));
+    CHECK(close(matrix3x3::rotation_x(0.4f).to_matrix3x4(), matrix3x4::rotation_x(0.4f)));
+    CHECK(close(matrix3x3::rotation_y(0.4f).to_matrix3x4(), matrix3x4::rotation_y(0.4f)));
+    CHECK(close(matrix3x3::rotation_z(0.4f).to_matrix3x4(), matrix3x4::rotation_z(0.4f)));
+
+    auto r = matrix3x3::rotation_vectors(vector3::unit_x(), vector3::unit_y());
+    CHECK(close(transform_coord(vector3::unit_x(), r), vector3::unit_y()));
+    CHECK(close(inverse_rigid(r), inverse(r)));
+    CHECK(r.determinant() == Approx(1));
+}
+
+TEST_CASE("arithmetic")
+{
+    auto a = matrix3x3::rotation_axis(vector3::coord(1, 1, 0), 0.5f) * matrix3x3::scaling(2, 3, 4);
+    auto b = matrix3x3::rotation_z(1.2f);
+
+    auto a34 = a.to_matrix3x4();
+    auto b34 = b.to_matrix3x4();
+
+    CHECK(close((a * b).to_matrix3x4(), a34 * b34));
+    auto c = a;
+    c *= b;
+    CHECK(c == a * b);
+
+    CHECK((a + b).to_matrix3x4() == a34 + b34);
+    CHECK((a - b).to_matrix3x4() == a34 - b34);
+    CHECK(a * 2.f == 2.f * a);
+    CHECK(a / 2.f == a * 0.5f);
+    CHECK(-a == a * -1.f);
+    CHECK(abs(-a) == abs(a));
+    CHECK(mul(a, b) == matrix3x3::from_matrix(mul(a34, b34)));
+
+    CHECK(a.determinant() == Approx(a34.determinant()));
+    float det;
+    auto ia = inverse(a, det);
+    CHECK(det == Approx(24));
+    CHECK(close(ia * a, matrix3x3::identity(), 0.0001f));
+    CHECK(close(ia.to_matrix3x4(), inverse(a34), 0.0001f));
+
+    auto t = transpose(a);
+    CHECK(t.m01 == a.m10);
+    CHECK(t.m20 == a.m02);
+    CHECK(t.transpose() == a);
+
+    auto v = vector3::coord(1, -2, 3);
+    CHECK(close(transform_coord(v, a), transform_coord(v, a34)));
+
+    // normals stay perpendicular to the transformed surface
+    auto m = matrix3x4::scaling(1, 4, 2) * matrix3x4::rotation_x(0.3f);
+    auto n = matrix3x3::normal_matrix(m);
+    auto tangent = vector3::coord(1, 1, 0);
+    auto normal = vector3::coord(1, -1, 2);
+    CHECK(dot(transform_coord(tangent, matrix3x3::from_matrix(m)), transform_coord(normal, n)) == Approx(0).epsilon(0.0001));
+
+    CHECK(isfinite(a));
+    a.m11 = std::numeric_limits<float>::infinity();
+    CHECK(!isfinite(a));
+}
+
+TEST_CASE("padded")
+{
+    auto a = matrix3x3::rotation_axis(vector3::coord(3, 1, -2), 0.9f) * matrix3x3::scaling(2, 1, 3);
+    auto b = matrix3x3::rotation_y(-0.4f);
+
+    auto pa = padded_matrix3x3::from(a);
+    auto pb = padded_matrix3x3::from(b);
+    CHECK(sizeof(pa) == 12 * sizeof(float));
+    CHECK(reinterpret_cast<size_t>(&pa) % 16 == 0);
+    CHECK(pa.to_matrix3x3() == a);
+    CHECK(pa(2, 1) == a(2, 1));
+    CHECK(pa.p0 == 0);
+
+    CHECK(close((pa * pb).to_matrix3x3(), a * b));
+
+    auto v = vector3::coord(1, 2, -3);
+    CHECK(close(transform_coord(v, pa), transform_coord(v, a)));
+}
+
+TEST_CASE("polar decomposition")
+{
+    const auto r = matrix3x3::rotation_axis(v(1, 2, 3), 0.7f);
+    const auto s = matrix3x3::rows(
+        2, 0.3f, -0.1f,
+        0.3f, 3, 0.5f,
+        -0.1f, 0.5f, 4
+    );
+
+    matrix3x3 stretch;
+    const auto pr = polar_decomposition(r * s, stretch);
+    CHECK(close(pr, r, 1e-5f));
+    CHECK(close(stretch, s, 1e-4f));
+    CHECK(close(pr * transpose(pr), matrix3x3::identity(), 1e-5f));
+
+    // reflections keep the sign of the determinant
+    const auto pm = polar_decomposition(r * s * -1.f);
+    CHECK(close(pm, r * -1.f, 1e-5f));
+    CHECK(pm.determinant() == Approx(-1));
+
+    CHECK(close(polar_decomposition(r), r, 1e-6f));
+}
@@ -435,6 +435,37 @@ TEST_CASE("ops")
         matrix3x4::rows(3, 22, 12, 17, 8, 24, 19, 27, 3, 10, 7, 11));
 }
 
+TEST_CASE("inverse")
+{
+    auto m0 = matrix3x4::rows(
+        1, 2, 3, 4,
+        5, 3, 2, 2,
+        2, 1, 4, 1
+    );
+    CHECK(m0.determinant() == -25);
+
+    float det;
+    auto m1 = inverse(m0, det);
+    CHECK(det == -25);
+    CHECK(YamaApprox(m0 * m1) == matrix3x4::identity());
+    CHECK(YamaApprox(m1 * m0) == matrix3x4::identity());
+    CHECK(inverse(m0) == m1);
+    CHECK(inverse_affine(m0) == m1);
+
+    auto m2 = m0;
+    CHECK(m2.inverse() == -25);
+    CHECK(m2 == m1);
+
+    const auto rigid = matrix3x4::rotation_axis(v(1, 2, 3), 0.7f) * matrix3x4::translation(3, -1, 8);
+    CHECK(YamaApprox(inverse_rigid(rigid)) == inverse(rigid));
+    CHECK(YamaApprox(rigid * inverse_rigid(rigid)) == matrix3x4::identity());
+
+    // aliasing
+    m2 = m0;
+    m2 *= m2;
+    CHECK(m2 == m0 * m0);
+}
+
 TEST_CASE("transform")
 {
     const auto i = matrix3x4::identity();
@@ -481,6 +481,68 @@ TEST_CASE("ops")
     CHECK(YamaApprox(m1 * m2) == matrix::identity());
 }
 
+TEST_CASE("multiplication")
+{
+    // whatever the backend, float multiplication must stay close to the reference
+    const auto a = matrix::rows(
+        1.5f, -2, 3.25f, 4,
+        5, 3.1f, -2, 0.2f,
+        2, 1, 1.75f, -1,
+        -5, 6, 10, 2
+    );
+    const auto b = matrix::rotation_axis(v(1, 2, 3), 0.7f) * matrix::translation(3, -1, 8);
+
+    auto da = a.as_matrix4x4_t<double>();
+    auto db = b.as_matrix4x4_t<double>();
+
+    auto ab = a * b;
+    CHECK(YamaApprox(ab) == (da * db).as_matrix4x4_t<float>());
+    CHECK(YamaApprox(b * a) == (db * da).as_matrix4x4_t<float>());
+    CHECK(YamaApprox(ab) == operator*<float>(a, b));
+
+    auto m = a;
+    m *= b;
+    CHECK(m == ab);
+
+    m = a;
+    m *= m;
+    CHECK(YamaApprox(m) == (da * da).as_matrix4x4_t<float>());
+}
+
+TEST_CASE("inverse")
+{
+    // whatever the backend, the inverse must stay close to the reference
+    const auto a = matrix::rows(
+        1.5f, -2, 3.25f, 4,
+        5, 3.1f, -2, 0.2f,
+        2, 1, 1.75f, -1,
+        -5, 6, 10, 2
+    );
+
+    auto da = a.as_matrix4x4_t<double>();
+    double ddet;
+    auto dinv = inverse(da, ddet);
+
+    float det;
+    auto inv = inverse(a, det);
+    CHECK(det == Approx(float(ddet)));
+    CHECK(YamaApprox(inv) == dinv.as_matrix4x4_t<float>());
+    CHECK(YamaApprox(a * inv) == matrix::identity());
+    CHECK(YamaApprox(inverse(a)) == inv);
+
+    auto m = a;
+    CHECK(m.inverse() == Approx(float(ddet)));
+    CHECK(YamaApprox(m) == inv);
+
+    const auto affine = matrix::rotation_axis(v(1, 2, 3), 0.7f) * matrix::translation(3, -1, 8) * matrix::scaling(1, 2, 3);
+    CHECK(YamaApprox(inverse_affine(affine)) == inverse(affine));
+    CHECK(YamaApprox(affine * inverse_affine(affine)) == matrix::identity());
+
+    const auto rigid = matrix::rotation_axis(v(1, 2, 3), 0.7f) * matrix::translation(3, -1, 8);
+    CHECK(YamaApprox(inverse_rigid(rigid)) == inverse(rigid));
+    CHECK(YamaApprox(rigid * inverse_rigid(rigid)) == matrix::identity());
+}
+
 TEST_CASE("transform")
 {
     const auto i = matrix::identity();
@@ -49,4 +49,34 @@ TEST_CASE("test")
     );
     sout << m4;
     CHECK(sout.str() == "((1, 2, 3, 4), (5, 6, 7, 8), (9, 10, 11, 12), (13, 14, 15, 16))");
+
+    clr(sout);
+
+    auto m3 = matrix3x3::rows(
+        1, 2, 3,
+        4, 5, 6,
+        7, 8, 9
+    );
+    sout << m3;
+    CHECK(sout.str() == "((1, 2, 3), (4, 5, 6), (7, 8, 9))");
+
+    clr(sout);
+
+    auto v5 = vectorn<5>::coord(1, 2, 3, 4, 5);
+    sout << v5;
+    CHECK(sout.str() == "(1, 2, 3, 4, 5)");
+
+    clr(sout);
+
+    auto m23 = matrixn<2, 3>::rows(
+        1, 2, 3,
+        4, 5, 6
+    );
+    sout << m23;
+    CHECK(sout.str() == "((1, 2, 3), (4, 5, 6))");
+
+    clr(sout);
+
+    sout << transform::trs(v(1, 2, 3), quaternion::identity(), 2);
+    CHECK(sout.str() == "((1, 2, 3), (0, 0, 0, 1), (2, 2, 2))");
 }
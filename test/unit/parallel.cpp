@@ -0,0 +1,335 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/parallel.hpp"
+#include "yama/batch.hpp"
+#include "yama/aabb.hpp"
+#include "yama/frustum.hpp"
+#include "yama/ray.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+#if YAMA_THREADS
+
+using namespace yama;
+
+TEST_SUITE("parallel");
+
+namespace
+{
+
+// more than a few chunks on every pool and not a multiple of any granularity
+const size_t N = 20011;
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+vector3 rnd_point(float r)
+{
+    return v(rnd(-r, r), rnd(-r, r), rnd(-r, r));
+}
+
+// for the kernels whose multiply-adds the compiler may contract differently
+// when they are inlined in the chunks
+bool close_all(const std::vector<vector3>& a, const std::vector<vector3>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (!close(a[i], b[i], 1e-3f)) return false;
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("run")
+{
+    for (size_t threads : { 1, 2, 5 })
+    {
+        parallel::thread_pool pool(threads);
+        CHECK(pool.thread_count() == threads);
+
+        // doctest checks aren't thread-safe, so the chunks count their errors
+        std::vector<int> visits(N);
+        std::atomic<int> bad_chunks(0);
+        pool.run(N, 100, [&](size_t first, size_t n) {
+            if (first % 100 != 0 || (n != 100 && first + n != N)) ++bad_chunks;
+            for (size_t i = first; i < first + n; ++i) ++visits[i];
+        });
+        CHECK(bad_chunks == 0);
+        CHECK(std::count(visits.begin(), visits.end(), 1) == int(N));
+
+        // granularity
+        std::fill(visits.begin(), visits.end(), 0);
+        parallel::for_each_chunk(pool, N, 64, [&](size_t first, size_t n) {
+            if (first % 64 != 0) ++bad_chunks;
+            for (size_t i = first; i < first + n; ++i) ++visits[i];
+        });
+        CHECK(bad_chunks == 0);
+        CHECK(std::count(visits.begin(), visits.end(), 1) == int(N));
+
+        // nested calls from the chunks of another one
+        std::atomic<size_t> sum(0);
+        parallel::for_each_chunk(pool, 40, 1, [&](size_t first, size_t n) {
+            for (size_t i = first; i < first + n; ++i)
+            {
+                parallel::for_each_chunk(pool, 1000, 10, [&](size_t, size_t m) {
+                    sum += m;
+                });
+            }
+        });
+        CHECK(sum == 40000u);
+
+        parallel::for_each_chunk(pool, 0, 64, [&](size_t, size_t) {
+            ++bad_chunks;
+        });
+        CHECK(bad_chunks == 0);
+    }
+}
+
+TEST_CASE("reduce")
+{
+    std::srand(3);
+    std::vector<float> values(N);
+    for (auto& v : values) v = rnd(-1, 1) * rnd(0, 1000);
+
+    // the same blocks summed in the same order on any pool
+    const size_t block = 1000;
+    float expected = 0;
+    for (size_t first = 0; first < N; first += block)
+    {
+        float s = 0;
+        for (size_t i = first; i < first + block && i < N; ++i) s += values[i];
+        expected += s;
+    }
+
+    for (size_t threads : { 1, 2, 3, 8 })
+    {
+        parallel::thread_pool pool(threads);
+        const float sum = parallel::reduce(pool, N, block, 0.f, [&](size_t first, size_t n) {
+            float s = 0;
+            for (size_t i = first; i < first + n; ++i) s += values[i];
+            return s;
+        }, [](float a, float b) { return a + b; });
+        CHECK(sum == expected);
+    }
+
+    parallel::thread_pool pool(3);
+    CHECK(parallel::reduce(pool, 0, block, 5, [](size_t, size_t) { return 1; }, [](int a, int b) { return a + b; }) == 5);
+}
+
+TEST_CASE("batch")
+{
+    parallel::thread_pool pool(3);
+    std::srand(5);
+
+    std::vector<vector3> in(N), out(N), expected(N);
+    for (auto& p : in) p = rnd_point(100);
+
+    const auto m = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    transform_coords(m, in.data(), expected.data(), N);
+    transform_coords(pool, m, in.data(), out.data(), N);
+    CHECK(out == expected);
+
+    const auto proj = matrix4x4::perspective_lh(2, 1, 1, 100);
+    transform_coords(proj, in.data(), expected.data(), N);
+    transform_coords(pool, proj, in.data(), out.data(), N);
+    CHECK(close_all(out, expected));
+
+    transform_normals(m, in.data(), expected.data(), N);
+    transform_normals(pool, m, in.data(), out.data(), N);
+    CHECK(close_all(out, expected));
+
+    // strided, every other element
+    const auto sin = strided_span<const vector3>::from_ptr(in.data(), 2 * sizeof(vector3), N / 2);
+    const auto sout = strided_span<vector3>::from_ptr(out.data(), 2 * sizeof(vector3), N / 2);
+    const auto sexp = strided_span<vector3>::from_ptr(expected.data(), 2 * sizeof(vector3), N / 2);
+    transform_directions(m, sin, sexp);
+    transform_directions(pool, m, sin, sout);
+    CHECK(out == expected);
+
+    const auto q = quaternion::rotation_axis(v(3, 2, 1), 1.2f);
+    rotate(q, in.data(), expected.data(), N);
+    rotate(pool, q, in.data(), out.data(), N);
+    CHECK(out == expected);
+
+    fast_normalize(in.data(), expected.data(), N);
+    fast_normalize(pool, in.data(), out.data(), N);
+    CHECK(out == expected);
+
+    std::vector<quaternion> qa(N), qb(N), qout(N), qexp(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        qa[i] = quaternion::rotation_axis(rnd_point(1) + v(0, 0, 2), rnd(-3, 3));
+        qb[i] = quaternion::rotation_axis(rnd_point(1) + v(0, 2, 0), rnd(-3, 3));
+    }
+    multiply(qa.data(), qb.data(), qexp.data(), N);
+    multiply(pool, qa.data(), qb.data(), qout.data(), N);
+    CHECK(qout == qexp);
+
+    rotate(qa.data(), in.data(), expected.data(), N);
+    rotate(pool, qa.data(), in.data(), out.data(), N);
+    CHECK(out == expected);
+
+    fast_slerp(qa.data(), qb.data(), 0.3f, qexp.data(), N);
+    fast_slerp(pool, qa.data(), qb.data(), 0.3f, qout.data(), N);
+    CHECK(qout == qexp);
+
+    std::vector<transform> trs(N), tout(N);
+    std::vector<matrix3x4> ms(N), mexp(N);
+    for (size_t i = 0; i < N; ++i) trs[i] = transform::trs(in[i], qa[i], v(1, 2, 3));
+    to_matrix3x4(trs.data(), mexp.data(), N);
+    to_matrix3x4(pool, trs.data(), ms.data(), N);
+    CHECK(ms == mexp);
+
+    std::vector<transform> texp(N);
+    decompose(mexp.data(), texp.data(), N);
+    decompose(pool, mexp.data(), tout.data(), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(tout[i].position == texp[i].position);
+        CHECK(tout[i].orientation == texp[i].orientation);
+        CHECK(tout[i].scale == texp[i].scale);
+    }
+}
+
+TEST_CASE("soa")
+{
+    parallel::thread_pool pool(4);
+    std::srand(7);
+
+    vector3_soa in, out, expected;
+    quaternion_soa qs;
+    for (size_t i = 0; i < N; ++i)
+    {
+        in.push_back(rnd_point(100));
+        qs.push_back(quaternion::rotation_axis(rnd_point(1) + v(0, 0, 2), rnd(-3, 3)));
+    }
+
+    const auto m = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    transform_coords(m, in, expected);
+    transform_coords(pool, m, in, out);
+    CHECK(out.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(vector3(out[i]) == vector3(expected[i]));
+    }
+
+    rotate(in, qs, expected);
+    rotate(pool, in, qs, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(vector3(out[i]) == vector3(expected[i]));
+    }
+
+    quaternion_soa qout, qexp;
+    normalize(qs, qexp);
+    normalize(pool, qs, qout);
+    CHECK(qout.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(quaternion(qout[i]) == quaternion(qexp[i]));
+    }
+}
+
+TEST_CASE("bounds")
+{
+    std::srand(11);
+    // several reduction blocks
+    const size_t count = 70001;
+    std::vector<vector3> points(count);
+    vector3_soa soa;
+    aabb_soa boxes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        points[i] = rnd_point(1000);
+        soa.push_back(points[i]);
+        boxes.push_back(aabb::from_center_half_extents(points[i], v(1, 2, 3)));
+    }
+
+    for (size_t threads : { 1, 3 })
+    {
+        parallel::thread_pool pool(threads);
+        CHECK(bounds(pool, points.data(), count) == bounds(points.data(), count));
+        CHECK(bounds(pool, soa) == bounds(soa));
+        CHECK(bounds(pool, boxes) == bounds(boxes));
+
+        const auto span = strided_span<vector3>::from_ptr(points.data(), 3 * sizeof(vector3), count / 3);
+        CHECK(bounds(pool, span) == bounds(span));
+    }
+
+    parallel::thread_pool pool(3);
+    CHECK(bounds(pool, points.data(), 0) == aabb::empty());
+
+    aabb_soa tout, texp;
+    const auto m = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    transform_aabbs(m, boxes, texp);
+    transform_aabbs(pool, m, boxes, tout);
+    CHECK(tout.size() == count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        CHECK(aabb(tout[i]) == aabb(texp[i]));
+    }
+}
+
+TEST_CASE("masks")
+{
+    parallel::thread_pool pool(3);
+    std::srand(13);
+
+    const auto f = frustum::from_view_projection(matrix4x4::perspective_lh(2, 1, 1, 100));
+    vector4_soa spheres;
+    aabb_soa boxes;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto c = v(rnd(-30, 30), rnd(-30, 30), rnd(-10, 120));
+        spheres.push_back(vector4::coord(c.x, c.y, c.z, rnd(0, 5)));
+        boxes.push_back(aabb::from_center_half_extents(c, v(1, 1, 1)));
+    }
+
+    // garbage in the output, which must be cleared
+    std::vector<uint32_t> mask((N + 31) / 32, 0xffffffff), expected((N + 31) / 32);
+    cull_spheres(f, spheres, expected.data());
+    cull_spheres(pool, f, spheres, mask.data());
+    CHECK(mask == expected);
+
+    const auto r = ray::from_origin_direction(v(0, 0, 0), v(0.1f, 0.2f, 1));
+    intersects(r, boxes, expected.data());
+    intersects(pool, r, boxes, mask.data());
+    CHECK(mask == expected);
+
+    // rays against a mesh
+    std::vector<vector3> vertices;
+    std::vector<uint16_t> indices;
+    for (size_t i = 0; i < 300; ++i)
+    {
+        vertices.push_back(rnd_point(10));
+        indices.push_back(uint16_t(i));
+    }
+    std::vector<ray> rays;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        rays.push_back(ray::from_origin_direction(rnd_point(20), rnd_point(1)));
+    }
+    std::vector<ray_hit> hits(rays.size()), hexp(rays.size());
+    intersect(rays.data(), rays.size(), vertices.data(), indices.data(), 100, hexp.data());
+    intersect(pool, rays.data(), rays.size(), vertices.data(), indices.data(), 100, hits.data());
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        CHECK(hits[i].triangle == hexp[i].triangle);
+        CHECK(hits[i].t == hexp[i].t);
+    }
+}
+
+#endif
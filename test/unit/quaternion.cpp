@@ -454,3 +454,56 @@ TEST_CASE("rotate")
     q0 = quaternion::rotation_vectors(v0, v1);
     CHECK(YamaApprox(rotate(v0, q0)) == v1);
 }
+
+TEST_CASE("interpolation")
+{
+    const auto q0 = quaternion::rotation_axis(v(1, 2, 3), 0.4f);
+    const auto q1 = quaternion::rotation_axis(v(-2, 1, 1), 2.9f);
+    REQUIRE(dot(q0, q1) > 0);
+
+    for (float t = 0; t <= 1; t += 0.125f)
+    {
+        const auto s = slerp(q0, q1, t);
+        CHECK(close(fast_slerp(q0, q1, t), s, 5e-5f));
+        CHECK(close(fast_slerp(q0, -q1, t), s, 5e-5f));
+        CHECK(close(nlerp(q0, -q1, t), nlerp(q0, q1, t), 1e-6f));
+        CHECK(nlerp(q0, q1, t).is_normalized());
+    }
+
+    CHECK(close(fast_slerp(q0, q1, 0.f), q0, 1e-6f));
+    CHECK(close(fast_slerp(q0, q1, 1.f), q1, 1e-6f));
+    CHECK(close(nlerp(q0, q1, 0.f), q0, 1e-6f));
+    CHECK(close(nlerp(q0, q1, 1.f), q1, 1e-6f));
+    CHECK(close(fast_slerp(q0, q0, 0.3f), q0, 1e-6f));
+
+    // the angle from q0 is proportional to the ratio
+    const auto h = fast_slerp(q0, q1, 0.5f);
+    CHECK(dot(q0, h) == Approx(dot(h, q1)).epsilon(1e-4));
+    CHECK(close(h, slerp(q0, q1, 0.5f), 5e-5f));
+
+    // opposite rotations, 180 degrees apart
+    const auto a = quaternion::rotation_x(0.f);
+    const auto b = quaternion::rotation_x(constants::PI() - 0.001f);
+    CHECK(fast_slerp(a, b, 0.5f).length() == Approx(1).epsilon(5e-5));
+    CHECK(close(fast_slerp(a, b, 0.5f), quaternion::rotation_x(constants::PI_HALF() - 0.0005f), 5e-5f));
+}
+
+TEST_CASE("fast_normalize")
+{
+    const auto a = quaternion::xyzw(1, 2, 4, 10);
+    const float l = a.length();
+    CHECK(rsqrt_length(a) == Approx(1 / l).epsilon(1e-6));
+    CHECK(close(fast_normalize(a), normalize(a), 1e-6f));
+
+    auto b = a;
+    CHECK(b.fast_normalize() == Approx(l).epsilon(1e-6));
+    CHECK(b == fast_normalize(a));
+    CHECK(b.is_normalized());
+
+    // zero stays zero
+    CHECK(fast_normalize(quaternion::zero()) == quaternion::zero());
+    CHECK(std::isfinite(rsqrt_length(quaternion::zero())));
+
+    const quaternion_t<double> d = quaternion_t<double>::zero();
+    CHECK(fast_normalize(d) == d);
+}
@@ -0,0 +1,268 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/ray.hpp"
+
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("ray");
+
+namespace
+{
+
+// not a multiple of the padding, the mask word size or the triangle block
+const size_t N = 101;
+
+template <typename T>
+T rnd(T min, T max)
+{
+    return min + (max - min) * T(std::rand()) / T(RAND_MAX);
+}
+
+template <typename T>
+vector3_t<T> rnd_point(T r)
+{
+    return vector3_t<T>::coord(rnd(-r, r), rnd(-r, r), rnd(-r, r));
+}
+
+bool bit(const std::vector<uint32_t>& mask, size_t i)
+{
+    return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+// a random soup of triangles around the origin
+template <typename T>
+void rnd_mesh(size_t triangle_count, std::vector<vector3_t<T>>& vertices, std::vector<uint16_t>& indices)
+{
+    for (size_t i = 0; i < triangle_count; ++i)
+    {
+        const auto c = rnd_point<T>(5);
+        vertices.push_back(c + rnd_point<T>(1));
+        vertices.push_back(c + rnd_point<T>(1));
+        vertices.push_back(c + rnd_point<T>(1));
+
+        // some shared vertices too
+        indices.push_back(uint16_t(vertices.size() - 3));
+        indices.push_back(uint16_t(i % 7 == 0 ? std::rand() % vertices.size() : vertices.size() - 2));
+        indices.push_back(uint16_t(vertices.size() - 1));
+    }
+}
+
+template <typename T>
+ray_hit_t<T> nearest_hit(const ray_t<T>& r, const std::vector<vector3_t<T>>& vertices, const std::vector<uint16_t>& indices, T t_max)
+{
+    auto ret = ray_hit_t<T>::none(t_max);
+    for (size_t i = 0; i < indices.size() / 3; ++i)
+    {
+        T t, u, v;
+        if (intersect(r, vertices[indices[i * 3]], vertices[indices[i * 3 + 1]], vertices[indices[i * 3 + 2]], t, u, v, ret.t))
+        {
+            ret.t = t;
+            ret.u = u;
+            ret.v = v;
+            ret.triangle = i;
+        }
+    }
+    return ret;
+}
+
+template <typename T>
+void check_meshes(T epsilon)
+{
+    std::vector<vector3_t<T>> vertices;
+    std::vector<uint16_t> indices;
+    const size_t triangle_count = 200;
+    rnd_mesh(triangle_count, vertices, indices);
+
+    std::vector<ray_t<T>> rays;
+    for (size_t i = 0; i < N; ++i)
+    {
+        rays.push_back(ray_t<T>::from_points(rnd_point<T>(10), rnd_point<T>(3)));
+    }
+
+    for (auto t_max : { std::numeric_limits<T>::max(), T(1) })
+    {
+        std::vector<ray_hit_t<T>> hits(N);
+        intersect(rays.data(), N, vertices.data(), indices.data(), triangle_count, hits.data(), t_max);
+
+        size_t hit_count = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto ref = nearest_hit(rays[i], vertices, indices, t_max);
+            const auto& h = hits[i];
+            CHECK(h.hit() == ref.hit());
+            if (!ref.hit()) continue;
+
+            ++hit_count;
+            CHECK(h.triangle == ref.triangle);
+            CHECK(std::abs(h.t - ref.t) <= epsilon);
+            CHECK(h.t < t_max);
+
+            // the barycentric coordinates give back the hit point
+            const auto& v0 = vertices[indices[h.triangle * 3]];
+            const auto& v1 = vertices[indices[h.triangle * 3 + 1]];
+            const auto& v2 = vertices[indices[h.triangle * 3 + 2]];
+            const auto b = h.barycentric();
+            CHECK(close(v0 * b.x + v1 * b.y + v2 * b.z, rays[i].point_at(h.t), epsilon * 10));
+
+            const auto single = intersect(rays[i], vertices.data(), indices.data(), triangle_count, t_max);
+            CHECK(single.triangle == h.triangle);
+            CHECK(single.t == h.t);
+        }
+        CHECK(hit_count > 0);
+    }
+
+    const auto none = intersect(rays[0], vertices.data(), indices.data(), 0);
+    CHECK(!none.hit());
+}
+
+template <typename T>
+void check_boxes()
+{
+    aabb_soa_t<T> boxes;
+    for (size_t i = 0; i < N; ++i)
+    {
+        boxes.push_back(aabb_t<T>::from_center_half_extents(rnd_point<T>(10), vector3_t<T>::coord(rnd<T>(0, 2), rnd<T>(0, 2), rnd<T>(0, 2))));
+    }
+
+    std::vector<ray_t<T>> rays;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        rays.push_back(ray_t<T>::from_points(rnd_point<T>(15), rnd_point<T>(5)));
+    }
+    // parallel to two axes
+    rays.push_back(ray_t<T>::from_origin_direction(vector3_t<T>::coord(-20, 1, 1), vector3_t<T>::coord(1, 0, 0)));
+    rays.push_back(ray_t<T>::from_origin_direction(vector3_t<T>::coord(1, 20, -1), vector3_t<T>::coord(0, -1, 0)));
+
+    std::vector<uint32_t> mask((N + 31) / 32, ~0u);
+    for (const auto& r : rays)
+    {
+        for (auto t_max : { std::numeric_limits<T>::max(), T(1) })
+        {
+            intersects(r, boxes, mask.data(), t_max);
+            for (size_t i = 0; i < N; ++i)
+            {
+                CHECK(bit(mask, i) == intersects(r, boxes[i].value(), t_max));
+            }
+        }
+    }
+    CHECK((mask.back() >> (N % 32)) == 0);
+}
+
+}
+
+TEST_CASE("construction")
+{
+    const auto r = ray::from_origin_direction(v(1, 2, 3), v(2, -4, 0));
+    CHECK(r.origin == v(1, 2, 3));
+    CHECK(r.direction == v(2, -4, 0));
+    CHECK(r.inv_direction.x == 0.5f);
+    CHECK(r.inv_direction.y == -0.25f);
+    CHECK(r.inv_direction.z == std::numeric_limits<float>::infinity());
+    CHECK(r.point_at(2) == v(5, -6, 3));
+
+    const auto p = ray::from_points(v(1, 2, 3), v(3, 3, 3));
+    CHECK(p.direction == v(2, 1, 0));
+    CHECK(p.point_at(1) == v(3, 3, 3));
+
+    auto s = p;
+    s.set_direction(v(-1, 4, 8));
+    CHECK(s.direction == v(-1, 4, 8));
+    CHECK(s.inv_direction == v(-1, 0.25f, 0.125f));
+
+    const auto h = ray_hit::none();
+    CHECK(!h.hit());
+    CHECK(h.t == std::numeric_limits<float>::max());
+}
+
+TEST_CASE("aabb")
+{
+    const auto b = aabb::from_min_max(v(1, 1, 1), v(3, 3, 3));
+
+    float t;
+    CHECK(intersect(ray::from_origin_direction(v(0, 2, 2), v(1, 0, 0)), b, t));
+    CHECK(t == 1);
+    CHECK(intersect(ray::from_origin_direction(v(4, 2, 2), v(-2, 0, 0)), b, t));
+    CHECK(t == 0.5f);
+    CHECK(intersect(ray::from_origin_direction(v(0, 0, 0), v(1, 1, 1)), b, t));
+    CHECK(t == 1);
+
+    // inside
+    CHECK(intersect(ray::from_origin_direction(v(2, 2, 2), v(1, 2, 3)), b, t));
+    CHECK(t == 0);
+
+    // behind, beside, too short
+    CHECK(!intersects(ray::from_origin_direction(v(4, 2, 2), v(1, 0, 0)), b));
+    CHECK(!intersects(ray::from_origin_direction(v(0, 4, 2), v(1, 0, 0)), b));
+    CHECK(!intersects(ray::from_origin_direction(v(0, 2, 2), v(1, 0, 0)), b, 0.5f));
+    CHECK(intersects(ray::from_points(v(0, 2, 2), v(1, 2, 2)), b, 1.f));
+
+    // parallel to a face, on its plane
+    CHECK(intersects(ray::from_origin_direction(v(0, 1, 2), v(1, 0, 0)), b));
+    CHECK(intersects(ray::from_origin_direction(v(0, 3, 2), v(1, 0, 0)), b));
+
+    CHECK(!intersects(ray::from_origin_direction(v(0, 0, 0), v(1, 1, 1)), aabb::empty()));
+
+    check_boxes<float>();
+    check_boxes<double>();
+}
+
+TEST_CASE("triangle")
+{
+    const auto v0 = v(0, 0, 0), v1 = v(2, 0, 0), v2 = v(0, 2, 0);
+
+    float t, a, b;
+    CHECK(intersect(ray::from_origin_direction(v(0.5f, 1, 4), v(0, 0, -2)), v0, v1, v2, t, a, b));
+    CHECK(t == 2);
+    CHECK(a == Approx(0.25f));
+    CHECK(b == Approx(0.5f));
+
+    // two-sided
+    CHECK(intersect(ray::from_origin_direction(v(0.5f, 1, -4), v(0, 0, 1)), v0, v1, v2, t, a, b));
+    CHECK(t == 4);
+
+    // outside, behind, too far, in the plane, degenerate
+    CHECK(!intersect(ray::from_origin_direction(v(1.5f, 1, 4), v(0, 0, -1)), v0, v1, v2, t, a, b));
+    CHECK(!intersect(ray::from_origin_direction(v(0.5f, 1, 4), v(0, 0, 1)), v0, v1, v2, t, a, b));
+    CHECK(!intersect(ray::from_origin_direction(v(0.5f, 1, 4), v(0, 0, -1)), v0, v1, v2, t, a, b, 4.f));
+    CHECK(!intersect(ray::from_origin_direction(v(-1, 0.5f, 0), v(1, 0, 0)), v0, v1, v2, t, a, b));
+    CHECK(!intersect(ray::from_origin_direction(v(0.5f, 1, 4), v(0, 0, -1)), v0, v1, v1, t, a, b));
+
+    // edges and vertices are hit
+    CHECK(intersect(ray::from_origin_direction(v(1, 0, 1), v(0, 0, -1)), v0, v1, v2, t, a, b));
+    CHECK(intersect(ray::from_origin_direction(v(2, 0, 1), v(0, 0, -1)), v0, v1, v2, t, a, b));
+}
+
+TEST_CASE("mesh")
+{
+    // two quads, the nearer one is hit
+    const vector3 vertices[] = {
+        v(-1, -1, 5), v(1, -1, 5), v(1, 1, 5), v(-1, 1, 5),
+        v(-1, -1, 3), v(1, -1, 3), v(1, 1, 3), v(-1, 1, 3),
+    };
+    const uint32_t indices[] = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+
+    const auto r = ray::from_origin_direction(v(-0.5f, 0.5f, 0), v(0, 0, 1));
+    const auto h = intersect(r, vertices, indices, 4);
+    CHECK(h.hit());
+    CHECK(h.triangle == 3);
+    CHECK(h.t == 3);
+    CHECK(close(h.barycentric(), v(0.25f, 0.25f, 0.5f)));
+
+    CHECK(intersect(r, vertices, indices, 2).t == 5);
+    CHECK(!intersect(r, vertices, indices, 4, 2.f).hit());
+    CHECK(!intersect(ray::from_origin_direction(v(2, 0, 0), v(0, 0, 1)), vertices, indices, 4).hit());
+
+    check_meshes<float>(1e-4f);
+    check_meshes<double>(1e-9);
+}
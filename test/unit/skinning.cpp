@@ -0,0 +1,324 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/skinning.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace yama;
+
+TEST_SUITE("skinning");
+
+namespace
+{
+
+const size_t N = 301;
+const size_t bone_count = 16;
+
+float rnd(float min, float max)
+{
+    return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+}
+
+vector3 rnd_point()
+{
+    return v(rnd(-10, 10), rnd(-10, 10), rnd(-10, 10));
+}
+
+// an interleaved vertex, as in a typical vertex buffer
+template <size_t Influences>
+struct vertex
+{
+    vector3 position;
+    vector3 normal;
+    uint16_t bones[Influences];
+    float weights[Influences];
+};
+
+template <size_t Influences>
+struct fixture
+{
+    fixture()
+    {
+        for (size_t b = 0; b < bone_count; ++b)
+        {
+            palette.push_back(matrix3x4::translation(rnd_point()) * matrix3x4::rotation_axis(normalize(rnd_point()), rnd(-3, 3)) * matrix3x4::scaling_uniform(rnd(0.5f, 2)));
+        }
+
+        vertices.resize(N);
+        for (auto& vx : vertices)
+        {
+            vx.position = rnd_point();
+            vx.normal = normalize(rnd_point());
+
+            float sum = 0;
+            for (size_t k = 0; k < Influences; ++k)
+            {
+                vx.bones[k] = uint16_t(std::rand() % bone_count);
+                vx.weights[k] = rnd(0, 1);
+                sum += vx.weights[k];
+            }
+            for (auto& w : vx.weights) w /= sum;
+        }
+    }
+
+    // the blended matrix, applied with the regular functions
+    void reference(const vertex<Influences>& vx, vector3& p, vector3& n) const
+    {
+        matrix3x4 m = palette[vx.bones[0]] * vx.weights[0];
+        for (size_t k = 1; k < Influences; ++k)
+        {
+            m += palette[vx.bones[k]] * vx.weights[k];
+        }
+        p = transform_coord(vx.position, m);
+        n = normalize(transform_coord(vx.normal, m) - transform_coord(vector3::zero(), m));
+    }
+
+    skinning_input_t<float, uint16_t> input() const
+    {
+        const size_t stride = sizeof(vertex<Influences>);
+        skinning_input_t<float, uint16_t> in = {
+            &vertices[0].position, stride,
+            &vertices[0].normal, stride,
+            vertices[0].bones, stride,
+            vertices[0].weights, stride,
+        };
+        return in;
+    }
+
+    std::vector<matrix3x4> palette;
+    std::vector<vertex<Influences>> vertices;
+};
+
+template <size_t Influences>
+void test_interleaved()
+{
+    const fixture<Influences> f;
+
+    // positions and normals into separate tight arrays
+    std::vector<vector3> positions(N), normals(N);
+    const skinning_output_t<float> out = { positions.data(), sizeof(vector3), normals.data(), sizeof(vector3) };
+    skin<Influences>(f.palette.data(), f.input(), out, N);
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        vector3 p, n;
+        f.reference(f.vertices[i], p, n);
+        CHECK(close(positions[i], p, 1e-4f));
+        CHECK(close(normals[i], n, 1e-5f));
+    }
+
+    // in place, without normals
+    auto vertices = f.vertices;
+    auto in = f.input();
+    in.positions = &vertices[0].position;
+    in.normals = nullptr;
+    const skinning_output_t<float> in_place = { &vertices[0].position, sizeof(vertex<Influences>), nullptr, 0 };
+    skin<Influences>(f.palette.data(), in, in_place, N);
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        vector3 p, n;
+        f.reference(f.vertices[i], p, n);
+        CHECK(close(vertices[i].position, p, 1e-4f));
+        CHECK(vertices[i].normal == f.vertices[i].normal);
+    }
+
+#if YAMA_THREADS
+    std::vector<vector3> pp(N), pn(N);
+    const skinning_output_t<float> pout = { pp.data(), sizeof(vector3), pn.data(), sizeof(vector3) };
+    skin_parallel<Influences>(f.palette.data(), f.input(), pout, N, 3);
+    CHECK(pp == positions);
+    CHECK(pn == normals);
+
+    parallel::thread_pool pool(3);
+    std::fill(pp.begin(), pp.end(), vector3::zero());
+    std::fill(pn.begin(), pn.end(), vector3::zero());
+    skin<Influences>(pool, f.palette.data(), f.input(), pout, N);
+    CHECK(pp == positions);
+    CHECK(pn == normals);
+#endif
+}
+
+template <size_t Influences>
+void test_soa()
+{
+    const fixture<Influences> f;
+
+    vector3_soa positions, normals;
+    std::vector<uint16_t> bones[Influences];
+    std::vector<float> weights[Influences];
+    for (const auto& vx : f.vertices)
+    {
+        positions.push_back(vx.position);
+        normals.push_back(vx.normal);
+        for (size_t k = 0; k < Influences; ++k)
+        {
+            bones[k].push_back(vx.bones[k]);
+            weights[k].push_back(vx.weights[k]);
+        }
+    }
+
+    const uint16_t* bone_streams[Influences];
+    const float* weight_streams[Influences];
+    for (size_t k = 0; k < Influences; ++k)
+    {
+        bone_streams[k] = bones[k].data();
+        weight_streams[k] = weights[k].data();
+    }
+
+    vector3_soa out_positions, out_normals;
+    skin<Influences>(f.palette.data(), positions, normals, bone_streams, weight_streams, out_positions, out_normals);
+    CHECK(out_positions.size() == N);
+    CHECK(out_normals.size() == N);
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        vector3 p, n;
+        f.reference(f.vertices[i], p, n);
+        CHECK(close(vector3(out_positions[i]), p, 1e-4f));
+        CHECK(close(vector3(out_normals[i]), n, 1e-5f));
+    }
+
+    vector3_soa only_positions;
+    skin<Influences>(f.palette.data(), positions, bone_streams, weight_streams, only_positions);
+    CHECK(only_positions.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(vector3(only_positions[i]) == vector3(out_positions[i]));
+    }
+
+#if YAMA_THREADS
+    vector3_soa pp, pn;
+    skin_parallel<Influences>(f.palette.data(), positions, normals, bone_streams, weight_streams, pp, pn, 3);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(vector3(pp[i]) == vector3(out_positions[i]));
+        CHECK(vector3(pn[i]) == vector3(out_normals[i]));
+    }
+
+    parallel::thread_pool pool(3);
+    vector3_soa qp, qn;
+    skin<Influences>(pool, f.palette.data(), positions, normals, bone_streams, weight_streams, qp, qn);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(vector3(qp[i]) == vector3(out_positions[i]));
+        CHECK(vector3(qn[i]) == vector3(out_normals[i]));
+    }
+#endif
+}
+
+}
+
+TEST_CASE("interleaved")
+{
+    std::srand(5);
+    test_interleaved<1>();
+    test_interleaved<4>();
+    test_interleaved<8>();
+}
+
+TEST_CASE("soa")
+{
+    std::srand(6);
+    test_soa<4>();
+    test_soa<8>();
+}
+
+TEST_CASE("identity")
+{
+    // all influences of the same bone, weights adding up to 1
+    const matrix3x4 palette[] = { matrix3x4::identity(), matrix3x4::translation(1, 2, 3) };
+    const vector3 positions[] = { v(1, 2, 3), v(-4, 5, 0) };
+    const vector3 normals[] = { v(1, 0, 0), v(0, 0, 1) };
+    const int bones[] = { 1, 1, 0, 0 };
+    const float weights[] = { 0.25f, 0.75f, 0.5f, 0.5f };
+
+    vector3 p[2], n[2];
+    const skinning_input_t<float, int> in = { positions, sizeof(vector3), normals, sizeof(vector3), bones, 2 * sizeof(int), weights, 2 * sizeof(float) };
+    const skinning_output_t<float> out = { p, sizeof(vector3), n, sizeof(vector3) };
+    skin<2>(palette, in, out, 2);
+
+    CHECK(p[0] == v(2, 4, 6));
+    CHECK(p[1] == v(-4, 5, 0));
+    CHECK(n[0] == v(1, 0, 0));
+    CHECK(n[1] == v(0, 0, 1));
+}
+
+TEST_CASE("dual quaternion")
+{
+    std::srand(7);
+    const fixture<4> f;
+
+    // the rigid part of the palette
+    std::vector<dual_quaternion> palette;
+    for (size_t b = 0; b < bone_count; ++b)
+    {
+        auto dq = dual_quaternion::rotation_translation(quaternion::rotation_axis(rnd_point(), rnd(-3, 3)), rnd_point());
+        palette.push_back(b % 2 ? dq : dual_quaternion::real_dual(-dq.real, -dq.dual)); // both signs
+    }
+
+    std::vector<vector3> positions(N), normals(N);
+    const skinning_output_t<float> out = { positions.data(), sizeof(vector3), normals.data(), sizeof(vector3) };
+    skin<4>(palette.data(), f.input(), out, N);
+
+    vector3_soa soa_positions, soa_normals, out_positions, out_normals;
+    std::vector<uint16_t> bones[4];
+    std::vector<float> weights[4];
+    for (const auto& vx : f.vertices)
+    {
+        soa_positions.push_back(vx.position);
+        soa_normals.push_back(vx.normal);
+        for (size_t k = 0; k < 4; ++k)
+        {
+            bones[k].push_back(vx.bones[k]);
+            weights[k].push_back(vx.weights[k]);
+        }
+    }
+    const uint16_t* bone_streams[] = { bones[0].data(), bones[1].data(), bones[2].data(), bones[3].data() };
+    const float* weight_streams[] = { weights[0].data(), weights[1].data(), weights[2].data(), weights[3].data() };
+    skin<4>(palette.data(), soa_positions, soa_normals, bone_streams, weight_streams, out_positions, out_normals);
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        // the normalized blend, all on the side of the first bone
+        const auto& vx = f.vertices[i];
+        const auto& q0 = palette[vx.bones[0]];
+        auto blend = q0 * vx.weights[0];
+        for (size_t k = 1; k < 4; ++k)
+        {
+            const auto& q = palette[vx.bones[k]];
+            blend += q * (dot(q.real, q0.real) < 0 ? -vx.weights[k] : vx.weights[k]);
+        }
+        blend.normalize();
+
+        const auto p = transform_coord(vx.position, blend);
+        const auto n = rotate(vx.normal, blend);
+        CHECK(close(positions[i], p, 1e-4f));
+        CHECK(close(normals[i], n, 1e-5f));
+        CHECK(close(vector3(out_positions[i]), p, 1e-4f));
+        CHECK(close(vector3(out_normals[i]), n, 1e-5f));
+    }
+
+    // a single bone is its transformation
+    const auto dq = palette[3];
+    const skinning_input_t<float, uint16_t> one = { &f.vertices[0].position, 0, &f.vertices[0].normal, 0, nullptr, 0, nullptr, 0 };
+    const uint16_t bone = 3;
+    const float weight = 1;
+    auto in = one;
+    in.bones = &bone;
+    in.weights = &weight;
+    vector3 p, n;
+    const skinning_output_t<float> single = { &p, 0, &n, 0 };
+    skin<1>(palette.data(), in, single, 1);
+    CHECK(close(p, transform_coord(f.vertices[0].position, dq), 1e-5f));
+    CHECK(close(n, rotate(f.vertices[0].normal, dq), 1e-5f));
+}
@@ -0,0 +1,363 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/soa.hpp"
+
+#include <vector>
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("soa");
+
+namespace
+{
+
+// not a multiple of the padding, so that the conversions exercise their tails
+const size_t N = 37;
+
+std::vector<vector3> points(float offset)
+{
+    std::vector<vector3> ret;
+    for (size_t i = 0; i < N; ++i)
+    {
+        float f = float(i) + offset;
+        ret.push_back(v(f - 10, 2 * f + 1, 5 - f * 0.5f));
+    }
+    return ret;
+}
+
+std::vector<vector4> points4(float offset)
+{
+    std::vector<vector4> ret;
+    for (size_t i = 0; i < N; ++i)
+    {
+        float f = float(i) + offset;
+        ret.push_back(vector4::coord(f - 10, 2 * f + 1, 5 - f * 0.5f, f));
+    }
+    return ret;
+}
+
+}
+
+TEST_CASE("container")
+{
+    vector3_soa s;
+    CHECK(s.empty());
+    CHECK(s.size() == 0);
+
+    s.push_back(v(1, 2, 3));
+    s.push_back(v(4, 5, 6));
+    CHECK(s.size() == 2);
+    CHECK(s.capacity() % vector3_soa::lane_padding == 0);
+    CHECK(s.padded_size() == vector3_soa::lane_padding);
+    CHECK(reinterpret_cast<size_t>(s.x()) % vector3_soa::alignment == 0);
+
+    CHECK(s[0] == v(1, 2, 3));
+    CHECK(s[1].value() == v(4, 5, 6));
+    CHECK(s.y()[1] == 5);
+
+    // proxies
+    s[0].x = 10;
+    CHECK(s[0] == v(10, 2, 3));
+    s[1] = v(7, 8, 9);
+    CHECK(s.z()[1] == 9);
+    s[1] += v(1, 1, 1);
+    CHECK(s[1] == v(8, 9, 10));
+    s[1] *= 2.f;
+    CHECK(s[1] == v(16, 18, 20));
+    s[0] = s[1];
+    CHECK(s[0] == v(16, 18, 20));
+    vector3 c = s[0];
+    CHECK(c == v(16, 18, 20));
+    CHECK(dot(vector3(s[0]), v(1, 0, 0)) == 16);
+
+    s[0] = v(3, 0, 4);
+    CHECK(s[0].length() == 5);
+    CHECK(s[0].normalize() == 5);
+    CHECK(close(vector3(s[0]), v(0.6f, 0, 0.8f)));
+
+    // growth keeps the contents
+    for (size_t i = 0; i < 100; ++i)
+    {
+        s.push_back(v(float(i), 0, 0));
+    }
+    CHECK(s.size() == 102);
+    CHECK(s[1] == v(16, 18, 20));
+    CHECK(s[101] == v(99, 0, 0));
+
+    auto copy = s;
+    CHECK(copy.size() == 102);
+    CHECK(copy[101] == v(99, 0, 0));
+    copy[101] = v(1, 1, 1);
+    CHECK(s[101] == v(99, 0, 0));
+
+    s.resize(200);
+    CHECK(s[199] == v(0, 0, 0));
+    s.clear();
+    CHECK(s.empty());
+
+    const vector3_soa sized(5);
+    CHECK(sized.size() == 5);
+    CHECK(sized[4] == v(0, 0, 0));
+}
+
+TEST_CASE("conversion")
+{
+    const auto p = points(0);
+
+    auto s = vector3_soa::from_array(p.data(), N);
+    CHECK(s.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(s[i] == p[i]);
+        CHECK(s.x()[i] == p[i].x);
+        CHECK(s.y()[i] == p[i].y);
+        CHECK(s.z()[i] == p[i].z);
+    }
+
+    std::vector<vector3> back(N);
+    s.copy_to(back.data());
+    CHECK(back == p);
+
+    const auto p4 = points4(0);
+    auto s4 = vector4_soa::from_array(p4.data(), N);
+    std::vector<vector4> back4(N);
+    s4.copy_to(back4.data());
+    CHECK(back4 == p4);
+
+    quaternion_soa sq;
+    sq.push_back(quaternion::identity());
+    CHECK(sq[0] == quaternion::identity());
+    sq[0] *= quaternion::rotation_z(1.f);
+    CHECK(close(quaternion(sq[0]), quaternion::rotation_z(1.f)));
+}
+
+TEST_CASE("vector3 kernels")
+{
+    const auto pa = points(0);
+    const auto pb = points(3.5f);
+    const auto a = vector3_soa::from_array(pa.data(), N);
+    const auto b = vector3_soa::from_array(pb.data(), N);
+
+    vector3_soa out;
+
+    // the kernels may use fused multiply-adds, hence the epsilon
+    std::vector<float> d(N);
+    dot(a, b, d.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(d[i] == Approx(dot(pa[i], pb[i])).epsilon(1e-4));
+    }
+
+    cross(a, b, out);
+    CHECK(out.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(out[i]), cross(pa[i], pb[i]), 1e-3f));
+    }
+
+    normalize(a, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(out[i]), normalize(pa[i]), 1e-5f));
+    }
+
+    lerp(a, b, 0.25f, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(out[i]), lerp(pa[i], pb[i], 0.25f), 1e-5f));
+    }
+
+    min(a, b, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(out[i] == min(pa[i], pb[i]));
+    }
+
+    max(a, b, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(out[i] == max(pa[i], pb[i]));
+    }
+
+    const auto m34 = matrix3x4::rotation_axis(v(1, 2, 3), 0.3f) * matrix3x4::translation(1, 2, 3);
+    transform_coords(m34, a, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(out[i]), transform_coord(pa[i], m34), 1e-4f));
+    }
+
+    const auto m44 = matrix::perspective_fov_rh(1.2f, 1.5f, 1, 100) * matrix::translation(1, 2, -30);
+    transform_coords(m44, a, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(out[i]), transform_coord(pa[i], m44), 1e-4f));
+    }
+
+    // in place
+    auto c = a;
+    cross(c, b, c);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(c[i]), cross(pa[i], pb[i]), 1e-3f));
+    }
+}
+
+TEST_CASE("vector4 and quaternion kernels")
+{
+    const auto pa = points4(0);
+    const auto pb = points4(3.5f);
+    const auto a = vector4_soa::from_array(pa.data(), N);
+    const auto b = vector4_soa::from_array(pb.data(), N);
+
+    vector4_soa out;
+
+    std::vector<float> d(N);
+    dot(a, b, d.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(d[i] == Approx(dot(pa[i], pb[i])).epsilon(1e-4));
+    }
+
+    normalize(a, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector4(out[i]), normalize(pa[i]), 1e-5f));
+    }
+
+    lerp(a, b, 0.75f, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector4(out[i]), lerp(pa[i], pb[i], 0.75f), 1e-5f));
+    }
+
+    min(a, b, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(out[i] == min(pa[i], pb[i]));
+    }
+
+    max(a, b, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(out[i] == max(pa[i], pb[i]));
+    }
+
+    quaternion_soa qa, qb, qout;
+    for (size_t i = 0; i < N; ++i)
+    {
+        qa.push_back(quaternion::rotation_axis(v(1, 2, 3), float(i) * 0.1f));
+        qb.push_back(quaternion::rotation_axis(v(3, 2, 1), float(i) * 0.2f));
+    }
+
+    dot(qa, qb, d.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(d[i] == Approx(dot(quaternion(qa[i]), quaternion(qb[i]))));
+    }
+
+    lerp(qa, qb, 0.5f, qout);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(quaternion(qout[i]), lerp(quaternion(qa[i]), quaternion(qb[i]), 0.5f), 1e-5f));
+    }
+
+    normalize(qout, qout);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(qout[i].length() == Approx(1));
+    }
+}
+
+TEST_CASE("quaternion rotations")
+{
+    std::vector<quaternion> pa, pb;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const float f = float(i);
+        pa.push_back(quaternion::rotation_axis(v(1, f, 3), 0.1f * f));
+        pb.push_back(quaternion::rotation_axis(v(f - 5, 2, 1), 6 - 0.3f * f));
+    }
+    const auto a = quaternion_soa::from_array(pa.data(), N);
+    const auto b = quaternion_soa::from_array(pb.data(), N);
+    const auto p = points(0);
+    const auto pv = vector3_soa::from_array(p.data(), N);
+
+    quaternion_soa out;
+    multiply(a, b, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(quaternion(out[i]), pa[i] * pb[i], 1e-5f));
+    }
+
+    nlerp(a, b, 0.3f, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(quaternion(out[i]), nlerp(pa[i], pb[i], 0.3f), 1e-5f));
+    }
+
+    fast_slerp(a, b, 0.7f, out);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(quaternion(out[i]), fast_slerp(pa[i], pb[i], 0.7f), 1e-5f));
+    }
+
+    vector3_soa r;
+    rotate(pv, a, r);
+    CHECK(r.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(r[i]), rotate(p[i], pa[i]), 1e-4f));
+    }
+
+    rotate(pb[5], pv, r);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector3(r[i]), rotate(p[i], pb[5]), 1e-4f));
+    }
+}
+
+TEST_CASE("fast_normalize")
+{
+    auto p = points(0);
+    p[5] = vector3::zero();
+    const auto a = vector3_soa::from_array(p.data(), N);
+
+    vector3_soa out;
+    std::vector<float> r(N);
+    fast_normalize(a, out);
+    rsqrt_length(a, r.data());
+    CHECK(out.size() == N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (i == 5) continue;
+        CHECK(close(vector3(out[i]), normalize(p[i]), 1e-6f));
+        CHECK(r[i] == Approx(1 / p[i].length()).epsilon(1e-6));
+    }
+    CHECK(out[5] == vector3::zero());
+
+    const auto p4 = points4(1);
+    const auto a4 = vector4_soa::from_array(p4.data(), N);
+    vector4_soa out4;
+    fast_normalize(a4, out4);
+    rsqrt_length(a4, r.data());
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(vector4(out4[i]), normalize(p4[i]), 1e-6f));
+        CHECK(r[i] == Approx(1 / p4[i].length()).epsilon(1e-6));
+    }
+
+    quaternion_soa q, qout;
+    for (const auto& e : p4) q.push_back(quaternion::xyzw(e.x, e.y, e.z, e.w));
+    fast_normalize(q, qout);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(close(quaternion(qout[i]), normalize(quaternion(q[i])), 1e-6f));
+    }
+}
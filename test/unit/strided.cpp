@@ -0,0 +1,215 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/strided.hpp"
+#include "yama/batch.hpp"
+#include "yama/aabb.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace yama;
+
+TEST_SUITE("strided");
+
+namespace
+{
+
+// not a multiple of any pack width
+const size_t N = 37;
+
+struct vertex
+{
+    vector3 pos;
+    vector3 normal;
+    vector2 uv;
+    float pad;
+};
+
+std::vector<vertex> vertices()
+{
+    std::vector<vertex> ret(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const float f = float(i);
+        ret[i].pos = v(f - 10, 2 * f + 1, 5 - f * 0.5f);
+        ret[i].normal = v(f, 1, -f);
+        ret[i].uv = v(f, -f);
+        ret[i].pad = f;
+    }
+    return ret;
+}
+
+strided_span<vector3> positions(std::vector<vertex>& vs)
+{
+    return strided_span<vector3>::from_ptr(&vs[0].pos, sizeof(vertex), vs.size());
+}
+
+strided_span<vector3> normals(std::vector<vertex>& vs)
+{
+    return vector3::attach_to_strided(vs[0].normal.data(), sizeof(vertex), vs.size());
+}
+
+}
+
+TEST_CASE("span")
+{
+    auto vs = vertices();
+    const auto s = positions(vs);
+
+    CHECK(s.size() == N);
+    CHECK(s.stride() == sizeof(vertex));
+    CHECK(!s.empty());
+    CHECK(!s.contiguous());
+    CHECK(s.data() == &vs[0].pos);
+    CHECK(&s[5] == &vs[5].pos);
+    CHECK(&s.back() == &vs[N - 1].pos);
+
+    // writes go to the buffer
+    s[3] = vector3::zero();
+    CHECK(vs[3].pos == vector3::zero());
+    CHECK(vs[3].normal == v(3, 1, -3));
+
+    // const view
+    strided_span<const vector3> cs = s;
+    CHECK(cs.data() == s.data());
+    CHECK(cs.stride() == s.stride());
+    CHECK(cs.size() == s.size());
+
+    const auto sub = s.subspan(10, 5);
+    CHECK(sub.size() == 5);
+    CHECK(&sub[0] == &vs[10].pos);
+    CHECK(&sub[4] == &vs[14].pos);
+    CHECK(s.subspan(N, 0).empty());
+
+    std::vector<vector2> uvs(N);
+    const auto c = strided_span<vector2>::from_array(uvs.data(), N);
+    CHECK(c.contiguous());
+    CHECK(c.stride() == sizeof(vector2));
+
+    const auto a = vector2::attach_to_strided(vs[0].uv.data(), sizeof(vertex), N);
+    CHECK(&a[7] == &vs[7].uv);
+
+    strided_span<vector4> e;
+    CHECK(e.empty());
+    CHECK(e.begin() == e.end());
+}
+
+TEST_CASE("iterators")
+{
+    auto vs = vertices();
+    const auto s = positions(vs);
+
+    size_t i = 0;
+    for (auto& p : s)
+    {
+        CHECK(&p == &vs[i].pos);
+        ++i;
+    }
+    CHECK(i == N);
+
+    auto b = s.begin();
+    const auto e = s.end();
+    CHECK(e - b == ptrdiff_t(N));
+    CHECK(b < e);
+    CHECK(&b[4] == &vs[4].pos);
+    CHECK(&*(b + 6) == &vs[6].pos);
+    CHECK(&*(e - 1) == &vs[N - 1].pos);
+    b += 3;
+    CHECK(b->x == vs[3].pos.x);
+    --b;
+    CHECK(&*b == &vs[2].pos);
+
+    // standard algorithms
+    const auto m = std::max_element(s.begin(), s.end(), [](const vector3& a, const vector3& b) { return a.y < b.y; });
+    CHECK(m - s.begin() == ptrdiff_t(N - 1));
+    std::fill(s.begin(), s.begin() + 2, vector3::unit_x());
+    CHECK(vs[1].pos == vector3::unit_x());
+    CHECK(vs[2].pos != vector3::unit_x());
+
+    // value-initialized
+    const strided_span<vector3>::iterator n1, n2;
+    CHECK(n1 == n2);
+    CHECK(n1 - n2 == 0);
+    CHECK(!(n1 < n2));
+}
+
+TEST_CASE("batch")
+{
+    auto vs = vertices();
+    const auto ref = vertices();
+    const auto m = matrix::translation(1, 2, 3) * matrix::rotation_axis(v(1, 1, 0), 0.7f) * matrix::scaling(2, 1, 3);
+    const auto o = transform_coord(vector3::zero(), m);
+    const auto q = quaternion::rotation_axis(v(0, 1, 1), 1.2f);
+
+    // interleaved to packed and back
+    std::vector<vector3> out(N);
+    const auto packed = strided_span<vector3>::from_array(out.data(), N);
+    transform_coords(m, strided_span<const vector3>(positions(vs)), packed);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(ref[i].pos, m));
+    }
+
+    transform_coords(m, positions(vs), positions(vs));
+    transform_normals(m, normals(vs), normals(vs));
+    for (size_t i = 0; i < N; ++i)
+    {
+        vector3 n;
+        transform_normals(m, &ref[i].normal, &n, 1);
+        CHECK(YamaApprox(vs[i].pos).epsilon(1e-4f) == transform_coord(ref[i].pos, m));
+        CHECK(YamaApprox(vs[i].normal).epsilon(1e-4f) == n);
+        CHECK(vs[i].uv == ref[i].uv);
+        CHECK(vs[i].pad == ref[i].pad);
+    }
+
+    vs = vertices();
+    transform_directions(m, normals(vs), packed);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(out[i]).epsilon(1e-4f) == transform_coord(ref[i].normal, m) - o);
+    }
+
+    fast_normalize(normals(vs), normals(vs));
+    rotate(q, packed, positions(vs));
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vs[i].normal).epsilon(1e-3f) == normalize(ref[i].normal));
+        CHECK(YamaApprox(vs[i].pos).epsilon(1e-4f) == rotate(out[i], q));
+    }
+
+    const auto t = matrix2x3::rotation(0.5f) * matrix2x3::translation(1, -1);
+    const auto uvs = vector2::attach_to_strided(vs[0].uv.data(), sizeof(vertex), N);
+    transform_coords(t, uvs, uvs);
+    for (size_t i = 0; i < N; ++i)
+    {
+        CHECK(YamaApprox(vs[i].uv).epsilon(1e-4f) == transform_coord(ref[i].uv, t));
+    }
+}
+
+TEST_CASE("bounds")
+{
+    auto vs = vertices();
+    vs[20].pos = v(-100, 100, 0);
+    vs[N - 1].pos = v(0, -200, 300);
+
+    auto b = aabb::empty();
+    for (auto& vx : vs) b.merge(vx.pos);
+
+    CHECK(bounds(positions(vs)) == b);
+    CHECK(bounds(strided_span<const vector3>(positions(vs))) == b);
+
+    // contiguous
+    std::vector<vector3> ps(N);
+    for (size_t i = 0; i < N; ++i) ps[i] = vs[i].pos;
+    CHECK(bounds(strided_span<const vector3>::from_array(ps.data(), N)) == b);
+
+    // fewer than a pack
+    CHECK(bounds(positions(vs).subspan(0, 2)) == merge(aabb::from_point(vs[0].pos), vs[1].pos));
+    CHECK(bounds(positions(vs).subspan(0, 0)).is_empty());
+}
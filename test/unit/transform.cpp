@@ -0,0 +1,164 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+#include "yama/transform.hpp"
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("transform");
+
+TEST_CASE("construction")
+{
+    const auto i = transform::identity();
+    CHECK(i.position == vector3::zero());
+    CHECK(i.orientation == quaternion::identity());
+    CHECK(i.scale == vector3::uniform(1));
+    CHECK(i.has_uniform_scale());
+    CHECK(sizeof(transform) == 10 * sizeof(float));
+
+    const float f[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    const auto a = transform::from_ptr(f);
+    CHECK(a.position == v(1, 2, 3));
+    CHECK(a.orientation == quaternion::xyzw(4, 5, 6, 7));
+    CHECK(a.scale == v(8, 9, 10));
+    CHECK(memcmp(f, a.data(), sizeof(f)) == 0);
+    CHECK(transform::attach_to_array(f)[0] == a);
+
+    const auto q = quaternion::rotation_axis(v(1, 2, 3), 0.7f);
+    const auto t = transform::trs(v(1, 2, 3), q, 2);
+    CHECK(t.scale == v(2, 2, 2));
+    CHECK(t.has_uniform_scale());
+    CHECK(!transform::scaling(1, 2, 1).has_uniform_scale());
+
+    CHECK(transform::translation(1, 2, 3) == transform::trs(v(1, 2, 3), quaternion::identity(), 1));
+    CHECK(transform::rotation(q) == transform::trs(vector3::zero(), q, 1));
+    CHECK(transform::scaling(v(1, 2, 3)) == transform::trs(vector3::zero(), quaternion::identity(), v(1, 2, 3)));
+    CHECK(transform::scaling_uniform(3) == transform::scaling(3, 3, 3));
+}
+
+TEST_CASE("matrix")
+{
+    const auto q = quaternion::rotation_axis(v(1, 2, 3), 0.7f);
+    const auto t = transform::trs(v(4, 5, 6), q, v(2, 3, 4));
+
+    const auto m34 = matrix3x4::translation(4, 5, 6) * matrix3x4::rotation_quaternion(q) * matrix3x4::scaling(2, 3, 4);
+    CHECK(close(t.to_matrix3x4(), m34, 1e-5f));
+
+    const auto m44 = matrix4x4::translation(4, 5, 6) * matrix4x4::rotation_quaternion(q) * matrix4x4::scaling(2, 3, 4);
+    CHECK(close(t.to_matrix4x4(), m44, 1e-5f));
+
+    const auto p = v(-3, 5, 2);
+    CHECK(close(transform_coord(p, t), transform_coord(p, m34), 1e-5f));
+    CHECK(close(transform_direction(p, t), transform_coord(p, m34) - v(4, 5, 6), 1e-5f));
+}
+
+TEST_CASE("operations")
+{
+    const auto a = transform::trs(v(4, 5, 6), quaternion::rotation_axis(v(1, 2, 3), 0.7f), 2);
+    const auto b = transform::trs(v(-1, 0, 2), quaternion::rotation_axis(v(-3, 1, 0), 2.1f), v(1, 2, 3));
+    const auto p = v(1, -2, 3);
+
+    // exact for the uniformly scaled a
+    const auto ab = a * b;
+    CHECK(close(transform_coord(p, ab), transform_coord(transform_coord(p, b), a), 1e-4f));
+    CHECK(close(ab.to_matrix3x4(), a.to_matrix3x4() * b.to_matrix3x4(), 1e-4f));
+
+    auto c = a;
+    c *= b;
+    CHECK(c == ab);
+
+    // only the translation of the non-uniformly scaled b is exact
+    CHECK(close(transform_coord(vector3::zero(), b * a), transform_coord(transform_coord(vector3::zero(), a), b), 1e-4f));
+
+    const auto ia = inverse(a);
+    CHECK(close(ia * a, transform::identity(), 1e-5f));
+    CHECK(close(a * ia, transform::identity(), 1e-5f));
+    CHECK(close(transform_coord(transform_coord(p, a), ia), p, 1e-5f));
+    CHECK(close(ia.to_matrix3x4(), inverse(a.to_matrix3x4()), 1e-5f));
+
+    c = a;
+    c.invert();
+    CHECK(c == ia);
+
+    CHECK(a != b);
+    CHECK(close(nlerp(a, b, 0.f), a, 1e-6f));
+    CHECK(close(nlerp(a, b, 1.f), b, 1e-6f));
+
+    const auto mid = nlerp(a, b, 0.5f);
+    CHECK(close(mid.position, (a.position + b.position) / 2.f));
+    CHECK(close(mid.scale, (a.scale + b.scale) / 2.f));
+    CHECK(close(mid.orientation, nlerp(a.orientation, b.orientation, 0.5f)));
+}
+
+TEST_CASE("decompose")
+{
+    const quaternion rotations[] = {
+        quaternion::identity(),
+        quaternion::rotation_axis(v(1, 2, 3), 0.7f),
+        quaternion::rotation_x(3.1f),
+        quaternion::rotation_y(-3.1f),
+        quaternion::rotation_z(3.f),
+        quaternion::rotation_axis(v(-1, 1, 0), 3.1f),
+    };
+    const vector3 scales[] = { v(1, 1, 1), v(2, 3, 4), v(0.01f, 100, 1), v(-2, 3, 4), v(-1, -1, -1) };
+
+    for (const auto& q : rotations)
+    {
+        for (const auto& s : scales)
+        {
+            const auto t = transform::trs(v(4, 5, 6), q, s);
+            const auto m = t.to_matrix3x4();
+            const auto d = decompose(m);
+            CHECK(d.orientation.is_normalized());
+            CHECK(close(d.to_matrix3x4(), m, 1e-4f));
+            CHECK(close(decompose(t.to_matrix4x4()).to_matrix3x4(), m, 1e-4f));
+            CHECK(d.position == v(4, 5, 6));
+
+            // the same rotation and scale, unless the scale has a reflection
+            if (s.x > 0)
+            {
+                CHECK((close(d.orientation, q, 1e-5f) || close(d.orientation, -q, 1e-5f)));
+                CHECK(close(d.scale, s, 1e-4f));
+            }
+        }
+
+        const auto q34 = matrix3x4::rotation_quaternion(q).to_quaternion();
+        CHECK((close(q34, q, 1e-5f) || close(q34, -q, 1e-5f)));
+        const auto q44 = matrix4x4::rotation_quaternion(q).to_quaternion();
+        CHECK((close(q44, q, 1e-5f) || close(q44, -q, 1e-5f)));
+    }
+
+    const auto m33 = matrix3x3::rotation_axis(v(1, 2, 3), 0.7f) * matrix3x3::scaling(2, 3, 4);
+    const auto d33 = decompose(m33);
+    CHECK(d33.position == vector3::zero());
+    CHECK(close(d33.scale, v(2, 3, 4), 1e-5f));
+    CHECK(close(matrix3x3::from_matrix(d33.to_matrix3x4()), m33, 1e-5f));
+
+    // shear: the closest rotation and the best fitting scale
+    const auto r = quaternion::rotation_axis(v(1, 2, 3), 0.7f);
+    const auto sheared = matrix3x4::rotation_quaternion(r) * matrix3x4::rows(
+        2, 0.3f, 0, 0,
+        0.3f, 3, 0, 0,
+        0, 0, 4, 0
+    );
+    const auto ds = decompose(sheared);
+    CHECK(ds.orientation.is_normalized());
+    CHECK((close(ds.orientation, r, 1e-5f) || close(ds.orientation, -r, 1e-5f)));
+    CHECK(close(ds.scale, v(2, 3, 4), 1e-5f));
+
+    // singular: the rotation is completed
+    const auto flat = matrix3x4::rotation_quaternion(r) * matrix3x4::scaling(2, 0, 4);
+    const auto df = decompose(flat);
+    CHECK(df.orientation.is_normalized());
+    CHECK(close(df.to_matrix3x4(), flat, 1e-5f));
+
+    const auto dz = decompose(matrix3x4::zero());
+    CHECK(dz.orientation == quaternion::identity());
+    CHECK(dz.scale == vector3::zero());
+}
@@ -59,6 +59,11 @@ TEST_CASE("functions")
     CHECK(Approx(deg_to_rad(60.f)) == constants::PI() / 3);
     CHECK(Approx(deg_to_rad(90.f)) == constants::PI_HALF());
 
+    float s, c;
+    sincos(0.5f, s, c);
+    CHECK(s == std::sin(0.5f));
+    CHECK(c == std::cos(0.5f));
+
     CHECK(close(1, 3, 3));
     CHECK(close(1, 1));
     CHECK(!close(1.0, 1.1));
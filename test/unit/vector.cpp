@@ -0,0 +1,112 @@
+// Yama
+// Copyright (c) 2016 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "common.hpp"
+
+using namespace yama;
+using doctest::Approx;
+
+TEST_SUITE("vector");
+
+typedef vector_t<float, 5> vector5;
+
+TEST_CASE("construction")
+{
+    auto v0 = vector5::zero();
+    for (auto f : v0) CHECK(f == 0);
+    CHECK(sizeof(v0) == 5 * sizeof(float));
+
+    const float f1[] = { 1, 2, 3, 4, 5 };
+    auto v1 = vector5::coord(1, 2, 3, 4, 5);
+    CHECK(memcmp(f1, &v1, sizeof(f1)) == 0);
+    CHECK(v1.size() == 5);
+    CHECK(v1.front() == 1);
+    CHECK(v1.back() == 5);
+    CHECK(v1[2] == 3);
+
+    auto v2 = vector5::uniform(3);
+    for (auto f : v2) CHECK(f == 3);
+
+    auto v3 = vector5::unit(3);
+    CHECK(v3 == vector5::coord(0, 0, 0, 1, 0));
+
+    auto v4 = vector5::from_ptr(f1);
+    CHECK(v4 == v1);
+
+    auto& v5 = vector5::attach_to_ptr(v4.data());
+    v5[0] = 10;
+    CHECK(v4[0] == 10);
+
+    auto v6 = v1.as_vector_t<double>();
+    CHECK((v6 == vector_t<double, 5>::coord(1., 2., 3., 4., 5.)));
+
+    static_assert(vector5::coord(1, 2, 3, 4, 5).length_sq() == 55, "constexpr length_sq");
+    static_assert(dot(vector5::uniform(2), vector5::unit(1)) == 2, "constexpr dot");
+    static_assert(vector5::coord(1, 2, 3, 4, 5) + vector5::uniform(1) == vector5::coord(2, 3, 4, 5, 6), "constexpr add");
+    static_assert(vectorn<7>::value_count == 7, "shorthand");
+}
+
+TEST_CASE("named types")
+{
+    auto v3 = vector3::coord(1, 2, 3);
+    auto g3 = vector_t<float, 3>::from(v3);
+    CHECK((g3 == vector_t<float, 3>::coord(1, 2, 3)));
+    CHECK(g3.as<vector3>() == v3);
+
+    auto v4 = vector4::coord(1, -2, 3, 5);
+    auto u4 = vector4::coord(2, 7, -1, 0.5f);
+    auto g4 = vector_t<float, 4>::from(v4);
+    auto h4 = vector_t<float, 4>::from(u4);
+
+    CHECK((g4 + h4).as<vector4>() == v4 + u4);
+    CHECK((g4 - h4).as<vector4>() == v4 - u4);
+    CHECK((g4 * 3.f).as<vector4>() == v4 * 3.f);
+    CHECK((2.f / h4).as<vector4>() == 2.f / u4);
+    CHECK(mul(g4, h4).as<vector4>() == mul(v4, u4));
+    CHECK(dot(g4, h4) == dot(v4, u4));
+    CHECK(g4.length() == Approx(v4.length()));
+    CHECK(g4.manhattan_length() == v4.manhattan_length());
+    CHECK(distance(g4, h4) == Approx(distance(v4, u4)));
+    CHECK(close(normalize(g4).as<vector4>(), normalize(v4)));
+    CHECK(abs(g4).as<vector4>() == abs(v4));
+    CHECK(min(g4, h4).as<vector4>() == min(v4, u4));
+    CHECK(max(g4, h4).as<vector4>() == max(v4, u4));
+
+    // dimensions without a named type
+    static_assert(std::is_same<dim<5>::vector_t<float>, vector5>::value, "dim fallback");
+    static_assert(std::is_same<dim<3>::vector_t<float>, vector3>::value, "dim named");
+    static_assert(is_vector<vector5>::value && is_yama<vector5>::value, "traits");
+}
+
+TEST_CASE("arithmetic")
+{
+    auto a = vector5::coord(1, 2, 3, 4, 5);
+    auto b = a;
+    b += vector5::uniform(1);
+    CHECK(b == vector5::coord(2, 3, 4, 5, 6));
+    b -= a;
+    CHECK(b == vector5::uniform(1));
+    b *= 4;
+    CHECK(b == vector5::uniform(4));
+    b /= 2;
+    CHECK(b == vector5::uniform(2));
+    b.mul(a);
+    CHECK(b == vector5::coord(2, 4, 6, 8, 10));
+    b.div(a);
+    CHECK(b == vector5::uniform(2));
+    CHECK(-a == vector5::coord(-1, -2, -3, -4, -5));
+    CHECK(+a == a);
+    CHECK(a != b);
+
+    CHECK(distance_sq(a, vector5::zero()) == 55);
+    auto l = a.normalize();
+    CHECK(l == Approx(std::sqrt(55.f)));
+    CHECK(a.is_normalized());
+    CHECK(isfinite(a));
+    a[2] = std::numeric_limits<float>::infinity();
+    CHECK(!isfinite(a));
+}
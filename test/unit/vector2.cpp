@@ -340,3 +340,23 @@ TEST_CASE("ops")
     CHECK(YamaApprox(lerp(v1, v2, 0.f)) == v1);
     CHECK(YamaApprox(lerp(v1, v2, 1.f)) == v2);
 }
+
+TEST_CASE("fast_normalize")
+{
+    const auto a = vector2::coord(3, 4);
+    const float l = a.length();
+    CHECK(rsqrt_length(a) == Approx(1 / l).epsilon(1e-6));
+    CHECK(close(fast_normalize(a), normalize(a), 1e-6f));
+
+    auto b = a;
+    CHECK(b.fast_normalize() == Approx(l).epsilon(1e-6));
+    CHECK(b == fast_normalize(a));
+    CHECK(b.is_normalized());
+
+    // zero stays zero
+    CHECK(fast_normalize(vector2::zero()) == vector2::zero());
+    CHECK(std::isfinite(rsqrt_length(vector2::zero())));
+
+    const vector2_t<double> d = vector2_t<double>::zero();
+    CHECK(fast_normalize(d) == d);
+}
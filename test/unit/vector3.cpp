@@ -343,6 +343,7 @@ TEST_CASE("ops")
     CHECK(collinear(v(3, 0, 6), v(5, 0, 10)));
     CHECK(collinear(v(0, 2, 1), v(0, -4, -2)));
     CHECK(collinear(v(4, 2, 10), v(1, 0.5f, 2.5f)));
+    CHECK(collinear(vector3_t<double>::coord(0, 2, 1), vector3_t<double>::coord(0, -4, -2)));
 
     v0 = v(-1.723f, 5.23f, 2.522f);
     CHECK(floor(v0) == v(-2, 5, 2));
@@ -379,3 +380,23 @@ TEST_CASE("ops")
     CHECK(YamaApprox(lerp(v1, v2, 0.f)) == v1);
     CHECK(YamaApprox(lerp(v1, v2, 1.f)) == v2);
 }
+
+TEST_CASE("fast_normalize")
+{
+    const auto a = v(2, 3, 6);
+    const float l = a.length();
+    CHECK(rsqrt_length(a) == Approx(1 / l).epsilon(1e-6));
+    CHECK(close(fast_normalize(a), normalize(a), 1e-6f));
+
+    auto b = a;
+    CHECK(b.fast_normalize() == Approx(l).epsilon(1e-6));
+    CHECK(b == fast_normalize(a));
+    CHECK(b.is_normalized());
+
+    // zero stays zero
+    CHECK(fast_normalize(vector3::zero()) == vector3::zero());
+    CHECK(std::isfinite(rsqrt_length(vector3::zero())));
+
+    const vector3_t<double> d = vector3_t<double>::zero();
+    CHECK(fast_normalize(d) == d);
+}
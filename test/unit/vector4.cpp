@@ -357,6 +357,7 @@ TEST_CASE("ops")
     CHECK(collinear(v(1, 2, 0, 3), v(5, 10, 0, 15)));
     CHECK(collinear(v(3, 0, 6, 6), v(5, 0, 10, 10)));
     CHECK(collinear(v(4, 2, 10, 8), v(1, 0.5f, 2.5f, 2)));
+    CHECK(collinear(vector4_t<double>::coord(0, 2, 1, 0), vector4_t<double>::coord(0, -4, -2, 0)));
 
     v0 = v(-1.723f, 5.23f, 2.522f, -2.222f);
     CHECK(floor(v0) == v(-2, 5, 2, -3));
@@ -392,3 +393,23 @@ TEST_CASE("ops")
     CHECK(YamaApprox(lerp(v1, v2, 0.f)) == v1);
     CHECK(YamaApprox(lerp(v1, v2, 1.f)) == v2);
 }
+
+TEST_CASE("fast_normalize")
+{
+    const auto a = vector4::coord(1, 2, 4, 10);
+    const float l = a.length();
+    CHECK(rsqrt_length(a) == Approx(1 / l).epsilon(1e-6));
+    CHECK(close(fast_normalize(a), normalize(a), 1e-6f));
+
+    auto b = a;
+    CHECK(b.fast_normalize() == Approx(l).epsilon(1e-6));
+    CHECK(b == fast_normalize(a));
+    CHECK(b.is_normalized());
+
+    // zero stays zero
+    CHECK(fast_normalize(vector4::zero()) == vector4::zero());
+    CHECK(std::isfinite(rsqrt_length(vector4::zero())));
+
+    const vector4_t<double> d = vector4_t<double>::zero();
+    CHECK(fast_normalize(d) == d);
+}